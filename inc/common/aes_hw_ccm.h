@@ -0,0 +1,95 @@
+/*
+   Copyright (c) 2026 Fraunhofer AISEC. See the COPYRIGHT
+   file at the top-level directory of this distribution.
+
+   Licensed under the Apache License, Version 2.0 <LICENSE-APACHE or
+   http://www.apache.org/licenses/LICENSE-2.0> or the MIT license
+   <LICENSE-MIT or http://opensource.org/licenses/MIT>, at your
+   option. This file may not be copied, modified, or distributed
+   except according to those terms.
+*/
+#ifndef AES_HW_CCM_H
+#define AES_HW_CCM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "byte_array.h"
+#include "oscore_edhoc_error.h"
+
+/*
+ * AES-128-CCM implemented with the AES instructions of the CPU (AES-NI on
+ * x86/x86_64, Cryptography Extensions on ARMv8). The backend is enabled with
+ * the AES_HW flag in makefile_config.mk. It is used only if the CPU
+ * supports the instructions at runtime; otherwise the crypto wrapper falls
+ * back to the TINYCRYPT or MBEDTLS engine.
+ */
+
+/*Size of the expanded AES-128 key (11 round keys)*/
+#define AES_HW_ROUND_KEYS_LEN 176
+
+/**
+ * @brief			Checks whether the CPU supports the AES
+ *				instructions and the backend is enabled.
+ *
+ * @return 			True if the backend can be used.
+ */
+bool aes_hw_available(void);
+
+/**
+ * @brief			Enables or disables the backend at runtime,
+ *				e.g. to compare it against the fallback engine.
+ *				The backend is enabled by default.
+ *
+ * @param enable		False forces the fallback engine.
+ */
+void aes_hw_enable(bool enable);
+
+/**
+ * @brief			Expands an AES-128 key.
+ *
+ * @param[in] key		The 16 byte key.
+ * @param[out] round_keys	The expanded key.
+ * @return 			Ok or error code.
+ */
+enum err aes_hw_key_expand(const struct byte_array *key,
+			   uint8_t round_keys[AES_HW_ROUND_KEYS_LEN]);
+
+/**
+ * @brief			AES-CCM encryption, see RFC3610. The CBC-MAC
+ *				and CTR passes are interleaved.
+ *
+ * @param[in] round_keys	The key expanded by aes_hw_key_expand().
+ * @param[in] in		The plaintext.
+ * @param[in] nonce		The nonce (7 to 13 bytes).
+ * @param[in] aad		Additional authenticated data.
+ * @param[out] out		The ciphertext. The buffer must have room for
+ *				in->len + tag->len bytes, the tag is appended.
+ * @param[out] tag		The authentication tag (4 to 16 bytes).
+ * @return 			Ok or error code.
+ */
+enum err aes_hw_ccm_encrypt(const uint8_t *round_keys,
+			    const struct byte_array *in,
+			    const struct byte_array *nonce,
+			    const struct byte_array *aad,
+			    struct byte_array *out, struct byte_array *tag);
+
+/**
+ * @brief			AES-CCM decryption and verification, see
+ *				RFC3610.
+ *
+ * @param[in] round_keys	The key expanded by aes_hw_key_expand().
+ * @param[in] in		The ciphertext followed by the tag.
+ * @param[in] nonce		The nonce (7 to 13 bytes).
+ * @param[in] aad		Additional authenticated data.
+ * @param[out] out		The plaintext. Can be the same buffer as in.
+ * @param tag_len		Length of the authentication tag.
+ * @return 			Ok or error code.
+ */
+enum err aes_hw_ccm_decrypt(const uint8_t *round_keys,
+			    const struct byte_array *in,
+			    const struct byte_array *nonce,
+			    const struct byte_array *aad,
+			    struct byte_array *out, uint32_t tag_len);
+
+#endif
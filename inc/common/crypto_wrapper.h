@@ -16,6 +16,19 @@
 
 #include "edhoc/suites.h"
 
+#ifdef TINYCRYPT
+#include <tinycrypt/aes.h>
+#include <tinycrypt/sha256.h>
+#endif
+
+#ifdef MBEDTLS
+#include <psa/crypto.h>
+#endif
+
+#ifdef AES_HW
+#include "aes_hw_ccm.h"
+#endif
+
 /*Indicates what kind of operation a symmetric cipher will execute*/
 enum aes_operation {
 	ENCRYPT,
@@ -39,6 +52,63 @@ enum err aead(enum aes_operation op, const struct byte_array *in,
 	      const struct byte_array *aad, struct byte_array *out,
 	      struct byte_array *tag);
 
+/*Size in words of the expanded AES-128 key (11 round keys) kept in a bound key*/
+#define AEAD_KEY_SCHED_WORDS 44
+
+/*
+ * Symmetric AEAD key bound to a long-lived crypto engine handle. The key is 
+ * imported once by aead_key_init() and can then be used for an arbitrary 
+ * number of aead_with_key() calls until it is released by aead_key_deinit().
+ * The key schedule and the AES_HW state are present with every engine, so 
+ * that the layout of the struct doesn't depend on the crypto flags.
+ */
+struct aead_key {
+	struct byte_array key; /*raw key, used by engines without key handles*/
+	uint32_t tag_len;
+	uint32_t handle; /*engine specific key handle, 0 if not bound*/
+	uint32_t sched[AEAD_KEY_SCHED_WORDS]; /*precomputed AES key schedule, the round keys of the AES instructions of the CPU (AES_HW) or of engines without key handles (TinyCrypt)*/
+	bool hw; /*true if the AES instructions of the CPU are used, with AES_HW only*/
+};
+
+/**
+ * @brief			Binds a symmetric key to an AEAD key handle.
+ * 
+ * @param[in] key		The symmetric key. The buffer must stay valid 
+ *				until aead_key_deinit() is called.
+ * @param tag_len		Length of the authentication tag.
+ * @param[out] out		The bound key.
+ * @return 			Ok or error code.
+ */
+enum err aead_key_init(const struct byte_array *key, uint32_t tag_len,
+		       struct aead_key *out);
+
+/**
+ * @brief			Releases an AEAD key handle. Calling it on a 
+ *				key that is not bound has no effect.
+ * 
+ * @param[in,out] key		The key to be released.
+ * @return 			Ok or error code.
+ */
+enum err aead_key_deinit(struct aead_key *key);
+
+/**
+ * @brief			Calculates AEAD encryption decryption with a 
+ *				key bound by aead_key_init().
+ * 
+ * @param op 			Operation to be executed (ENCRYPT or DECRYPT).
+ * @param[in] in		Input message.
+ * @param[in] key 		The bound key.
+ * @param[in] nonce 		The nonce.
+ * @param[in] aad 		Additional authenticated data.
+ * @param[out] out 		The cipher text.
+ * @param[in,out] tag 		The authentication tag.
+ * @return 			Ok or error code.
+ */
+enum err aead_with_key(enum aes_operation op, const struct byte_array *in,
+		       const struct aead_key *key, struct byte_array *nonce,
+		       const struct byte_array *aad, struct byte_array *out,
+		       struct byte_array *tag);
+
 /**
  * @brief			Derives ECDH shared secret.
  * 
@@ -76,6 +146,58 @@ enum err hkdf_extract(enum hash_alg alg, const struct byte_array *salt,
 enum err hkdf_expand(enum hash_alg alg, const struct byte_array *prk,
 		     const struct byte_array *info, struct byte_array *out);
 
+/*
+ * HKDF context keyed with a PRK once. The inner and outer padded keys of 
+ * HMAC are absorbed into two hash states by hkdf_ctx_init(); every HMAC 
+ * computed by hkdf_ctx_expand() starts from copies of these states instead 
+ * of rehashing the key. A context can be used for an arbitrary number of 
+ * expansions until it is released by hkdf_ctx_deinit().
+ */
+struct hkdf_ctx {
+	enum hash_alg alg;
+	struct byte_array prk; /*raw PRK, used by engines without hash states*/
+#if defined(TINYCRYPT)
+	struct tc_sha256_state_struct inner; /*state after H(K ^ ipad)*/
+	struct tc_sha256_state_struct outer; /*state after H(K ^ opad)*/
+#elif defined(MBEDTLS)
+	psa_hash_operation_t inner; /*state after H(K ^ ipad)*/
+	psa_hash_operation_t outer; /*state after H(K ^ opad)*/
+#endif
+};
+
+/**
+ * @brief			Keys an HKDF context with a PRK.
+ * 
+ * @param alg			Hash algorithm to be used.
+ * @param[in] prk 		Pseudo random key. The buffer must stay valid 
+ *				until hkdf_ctx_deinit() is called.
+ * @param[out] ctx		The keyed context.
+ * @return 			Ok or error code.
+ */
+enum err hkdf_ctx_init(enum hash_alg alg, const struct byte_array *prk,
+		       struct hkdf_ctx *ctx);
+
+/**
+ * @brief			HKDF expand function, see rfc5869, with a PRK 
+ *				keyed by hkdf_ctx_init().
+ * 
+ * @param[in] ctx 		The keyed context.
+ * @param[in] info 		Info input parameter.
+ * @param[out] out		The result.
+ * @return 			Ok or error code.
+ */
+enum err hkdf_ctx_expand(const struct hkdf_ctx *ctx,
+			 const struct byte_array *info, struct byte_array *out);
+
+/**
+ * @brief			Releases an HKDF context and wipes its hash 
+ *				states.
+ * 
+ * @param[in,out] ctx		The context to be released.
+ * @return 			Ok or error code.
+ */
+enum err hkdf_ctx_deinit(struct hkdf_ctx *ctx);
+
 /**
  * @brief			Computes a hash.
  * 
@@ -79,6 +79,14 @@ enum err {
 	oscore_interaction_duplicated_token = 221,
 	oscore_interaction_not_found = 222,
 	oscore_wrong_uri_path = 223,
+	oscore_max_contexts = 224,
+	oscore_context_duplicated = 225,
+	oscore_rate_limited = 226,
+	oscore_duplicate_request = 227,
+	oscore_nvm_io_error = 228,
+	oscore_nvm_key_not_found = 229,
+	echo_val_expired = 230,
+	oscore_nvm_write_deferred = 231,
 };
 
 /*This macro checks if a function returns an error and if so it propagates 
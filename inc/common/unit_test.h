@@ -49,8 +49,9 @@ enum err oscore_option_generate(struct byte_array *piv, struct byte_array *kid,
 				struct byte_array *kid_context,
 				struct oscore_option *oscore_option);
 
-enum err derive(struct common_context *cc, struct byte_array *id,
-		enum derive_type type, struct byte_array *out);
+enum err derive(struct common_context *cc, const struct hkdf_ctx *prk,
+		struct byte_array *id, enum derive_type type,
+		struct byte_array *out);
 
 #else
 #define STATIC static
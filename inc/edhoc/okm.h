@@ -16,6 +16,7 @@
 #include "hkdf_info.h"
 #include "suites.h"
 
+#include "common/crypto_wrapper.h"
 #include "common/oscore_edhoc_error.h"
 
 /**
@@ -32,4 +33,19 @@ enum err edhoc_kdf(enum hash_alg hash_alg, const struct byte_array *prk,
 		   uint8_t label, struct byte_array *context,
 		   struct byte_array *okm);
 
+/**
+ * @brief                       Derives output keying material from a PRK 
+ *                              keyed once with hkdf_ctx_init(). Use it when 
+ *                              several values are derived from the same PRK.
+ * 
+ * @param[in] prk               HKDF context keyed with the pseudorandom key.
+ * @param[in] label             Predefined integer value.
+ * @param[in] context           Relevant only for MAC_2 and MAC_3.
+ * @param[out] okm              The result.
+ * @retval                      Ok or error code.
+ */
+enum err edhoc_kdf_with_ctx(const struct hkdf_ctx *prk, uint8_t label,
+			    struct byte_array *context,
+			    struct byte_array *okm);
+
 #endif
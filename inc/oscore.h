@@ -17,6 +17,9 @@
 
 #include "oscore/security_context.h"
 #include "oscore/supported_algorithm.h"
+#include "oscore/oscore_coap.h"
+#include "oscore/oscore_context_table.h"
+#include "oscore/oscore_context_store.h"
 #include "oscore/nvm.h"
 
 #include "common/byte_array.h"
@@ -38,6 +41,19 @@
 #define F_NVM_MAX_WRITE_FAILURE 10
 #endif
 
+/*
+ * Bounds of the storing interval of a context when it adapts to the message 
+ * rate, see ssn_clock in struct oscore_init_params. Without a clock the 
+ * interval is K_SSN_NVM_STORE_INTERVAL.
+ */
+#ifndef OSCORE_SSN_INTERVAL_MIN
+#define OSCORE_SSN_INTERVAL_MIN 2
+#endif
+
+#ifndef OSCORE_SSN_INTERVAL_MAX
+#define OSCORE_SSN_INTERVAL_MAX 4096
+#endif
+
 #ifndef OSCORE_MAX_PLAINTEXT_LEN
 #define OSCORE_E_OPTIONS_LEN 40
 #define OSCORE_COAP_PAYLOAD_LEN 1024
@@ -85,6 +101,61 @@ struct oscore_init_params {
 	/*True if the combination of master secret and master salt are unique at every boot of the device, e.g., they are computed with EDHOC.
 	If not, OSCORE_NVM_SUPPORT flag must be defined, for proper non-volatile memory management.*/
 	const bool fresh_master_secret_salt;
+	/*replay_window_size is optional (default OSCORE_SERVER_REPLAY_WINDOW_SIZE), at most OSCORE_SERVER_REPLAY_WINDOW_MAX_SIZE*/
+	const uint32_t replay_window_size;
+	/*replay_window_bitmap is needed only for windows larger than OSCORE_SERVER_REPLAY_WINDOW_SIZE. 
+	It must hold REPLAY_WINDOW_WORDS(replay_window_size) words and stay valid as long as the context is used*/
+	uint64_t *replay_window_bitmap;
+	/*interactions_count is optional (default OSCORE_INTERACTIONS_COUNT), the number of requests and observations 
+	that can be outstanding at the same time, at most OSCORE_INTERACTIONS_MAX_COUNT*/
+	const uint32_t interactions_count;
+	/*interactions is needed only for more than OSCORE_INTERACTIONS_COUNT interactions. It must hold 
+	interactions_count records and stay valid as long as the context is used*/
+	struct oscore_interaction_t *interactions;
+	/*interactions_clock is optional. If given, the least recently used interaction is replaced when 
+	all are in use, and interactions idle for longer than interactions_idle_timeout (in units of the 
+	clock, 0 for no timeout) expire, see oscore_interactions_expiry_set()*/
+	oscore_interactions_clock_t interactions_clock;
+	const uint32_t interactions_idle_timeout;
+	/*failure_limit_clock is optional. If given, at most failure_limit_burst failed decryptions and 
+	replays are tolerated in a row, and one more every failure_limit_interval (in units of the clock). 
+	Further packets are rejected with oscore_rate_limited before their decryption, see 
+	struct oscore_rate_limit. The counters are kept in c->rc.failure_limit also without clock*/
+	oscore_rate_limit_clock_t failure_limit_clock;
+	const uint32_t failure_limit_burst;
+	const uint32_t failure_limit_interval;
+	/*responses is optional. If given, the last responses_count piggybacked responses are kept for 
+	responses_lifetime (in units of responses_clock, which is then required), so that retransmitted 
+	confirmable requests are answered with the same bytes, see struct oscore_response_cache*/
+	struct oscore_cached_response *responses;
+	const uint32_t responses_count;
+	oscore_response_cache_clock_t responses_clock;
+	const uint32_t responses_lifetime;
+	/*ssn_write_request is optional, used with OSCORE_NVM_SUPPORT only. If given, the SSN is written 
+	in NVM behind the packets by oscore_ssn_flush(), which the hook has to arrange, instead of 
+	synchronously while a packet is protected*/
+	oscore_ssn_write_request_t ssn_write_request;
+	/*ssn_clock is optional, used with OSCORE_NVM_SUPPORT only. If given, the number of SSNs reserved 
+	by each NVM write adapts to the message rate, so that the SSN is written about once every 
+	ssn_write_period (in units of the clock). It starts at K_SSN_NVM_STORE_INTERVAL and stays 
+	between OSCORE_SSN_INTERVAL_MIN and OSCORE_SSN_INTERVAL_MAX. It is stored with the SSN, see 
+	nvm_write_ssn_interval()*/
+	oscore_ssn_clock_t ssn_clock;
+	const uint32_t ssn_write_period;
+	/*replay_bound_interval is optional, used with OSCORE_NVM_SUPPORT only. If given, a bound above 
+	the SSNs of all accepted requests is stored in NVM about once every replay_bound_interval 
+	requests, see nvm_write_replay_bound(). A context which is not fresh restores its replay window 
+	from the bound and accepts requests above it without the ECHO challenge. Older requests, e.g., 
+	of a client that sent less than replay_bound_interval requests since the last write, still get 
+	the challenge*/
+	const uint32_t replay_bound_interval;
+	/*echo_key is optional. If given, the Echo values of the ECHO challenge are created by the 
+	application with oscore_echo_create() and verified with the key instead of being cached in the 
+	context. The value may then be created by another thread than the one that got 
+	first_request_after_reboot, but only values created after the challenge of the context are 
+	accepted, so that requests recorded before the context was restored are not accepted again. 
+	The key must stay valid as long as the context is used*/
+	const struct oscore_echo_key *echo_key;
 };
 
 /**
@@ -98,6 +169,30 @@ struct oscore_init_params {
 enum err oscore_context_init(struct oscore_init_params *params,
 			     struct context *c);
 
+/**
+ * @brief Releases the resources bound to a security context by 
+ * oscore_context_init(), e.g. the AEAD key handles of the sender and 
+ * recipient keys. Must be called before a context is discarded or 
+ * initialized again.
+ * 
+ * @param	c a struct containing the contexts
+ * @return  err
+ */
+enum err oscore_context_deinit(struct context *c);
+
+/**
+ * @brief Removes the expired interactions of a context, see 
+ * oscore_interactions_sweep(). Long-running servers call it periodically, 
+ * so that requests which never got a response and abandoned observations 
+ * don't occupy the interactions table.
+ * 
+ * @param	c a struct containing the contexts
+ * @param	removed number of removed interactions, can be NULL
+ * @return  err
+ */
+enum err oscore_context_interactions_sweep(struct context *c,
+					   uint32_t *removed);
+
 /**
  * @brief  	Checks if the packet in buf_in is a OSCORE packet.
  * 		If so it converts it to a CoAP packet and sets the oscore_pkg to
@@ -113,11 +208,198 @@ enum err oscore_context_init(struct oscore_init_params *params,
  * @param	flag  indicates if the 
  * @param 	c pointer to a security context
  * @param 	oscore_pkg indicates if an incoming packet is OSCORE
- * @return	err
+ * @return	err, oscore_duplicate_request if the packet is a byte-identical
+ * 		retransmission of a confirmable request whose response is 
+ * 		cached (see the responses field of struct oscore_init_params).
+ * 		buf_out then holds the OSCORE response to be sent again as it
+ * 		is. Other packets with the same PIV and Message ID go through
+ * 		the replay protection. Also oscore2coap_table(), 
+ * 		oscore2coap_store() and oscore2coap_batch() do so, the other 
+ * 		variants reject retransmissions as replays.
  */
 enum err oscore2coap(uint8_t *buf_in, uint32_t buf_in_len, uint8_t *buf_out,
 		     uint32_t *buf_out_len, struct context *c);
 
+/**
+ *@brief 	Converts an OSCORE packet to a CoAP packet like oscore2coap(), 
+ *		but within the receive buffer: the payload is decrypted in 
+ *		place and the header and the options are rewritten directly in 
+ *		front of it. No output buffer and no plaintext buffer of 
+ *		MAX_PLAINTEXT_LEN bytes are needed.
+ *
+ *@param	buf a buffer containing the OSCORE packet. Its content is 
+ *		modified, on error it is undefined.
+ *@param	buf_len length of the OSCORE packet in buf
+ *@param	coap start of the CoAP packet on return, points into buf
+ *@param	coap_len length of the CoAP packet on return
+ *@param	c a struct containing the OSCORE context
+ *@return	err
+ */
+enum err oscore2coap_in_place(uint8_t *buf, uint32_t buf_len, uint8_t **coap,
+			      uint32_t *coap_len, struct context *c);
+
+/**
+ *@brief 	Converts an OSCORE packet to a CoAP packet like oscore2coap(), 
+ *		but the output is split into two segments, e.g. for writev() 
+ *		or sendmsg(): the header, token, options and payload marker, 
+ *		and the payload. The payload is decrypted directly into its 
+ *		segment, no plaintext buffer of MAX_PLAINTEXT_LEN bytes is 
+ *		needed.
+ *
+ *@param	buf_in a buffer containing the OSCORE packet
+ *@param	buf_in_len length of the OSCORE packet
+ *@param	coap_header buffer and size of the header segment on input, 
+ *		length of the header on return. buf_in_len bytes are always 
+ *		enough.
+ *@param	coap_payload buffer and size of the payload segment on input, 
+ *		length of the payload on return. The buffer must hold the 
+ *		whole plaintext, i.e. the ciphertext without the 
+ *		authentication tag. If it is too small, buffer_to_small is 
+ *		returned with the required size, before the packet is 
+ *		decrypted.
+ *@param	c a struct containing the OSCORE context
+ *@return	err
+ */
+enum err oscore2coap_iov(uint8_t *buf_in, uint32_t buf_in_len,
+			 struct byte_array *coap_header,
+			 struct byte_array *coap_payload, struct context *c);
+
+/**
+ *@brief 	Converts an OSCORE packet to a CoAP packet like oscore2coap(), 
+ *		but returns the parsed CoAP packet instead of serializing it. 
+ *		The token and the Class U options point into buf_in, the Class 
+ *		E options and the payload into the plaintext.
+ *
+ *@param	buf_in a buffer containing the OSCORE packet
+ *@param	buf_in_len length of the OSCORE packet
+ *@param	plaintext buffer and size for the plaintext on input, the 
+ *		plaintext on return. If it is too small, buffer_to_small is 
+ *		returned with the required size, before the packet is 
+ *		decrypted. If NULL, the plaintext is decrypted in place in 
+ *		buf_in, which is modified then.
+ *@param	coap the resulting CoAP packet, valid as long as buf_in and the
+ *		plaintext are
+ *@param	c a struct containing the OSCORE context
+ *@return	err
+ */
+enum err oscore2coap_packet(uint8_t *buf_in, uint32_t buf_in_len,
+			    struct byte_array *plaintext,
+			    struct o_coap_packet *coap, struct context *c);
+
+/**
+ *@brief 	Converts an OSCORE packet to a CoAP packet with the context 
+ *		selected out of a table of contexts. Requests are routed by 
+ *		their KID context and KID in constant time, responses by their 
+ *		token, which requires a search over all contexts of the table.
+ *		A request without a KID context matches a context with its KID 
+ *		as Recipient ID and any ID Context, since the ID Context is 
+ *		known to both peers and may be omitted (RFC 8613 p. 5.1). A 
+ *		context without an ID Context is found in constant time, 
+ *		otherwise all contexts are searched as for responses, so the 
+ *		Recipient IDs of contexts with an ID Context should be unique 
+ *		if clients omit it. The same rule is used by 
+ *		oscore2coap_store(), oscore2coap_batch() and the prefilters.
+ *
+ *@param	buf_in a buffer containing the OSCORE packet
+ *@param	buf_in_len length of the data in the buf_in
+ *@param	buf_out the resulting CoAP packet
+ *@param	buf_out_len size of buf_out on input, length of the CoAP 
+ *		packet on return
+ *@param	table the contexts of the server
+ *@param	c the context the packet was routed to, NULL if none
+ *@return	err, oscore_kid_recipient_id_mismatch if no context matches a 
+ *		request, oscore_interaction_not_found if no context matches a 
+ *		response
+ */
+enum err oscore2coap_table(uint8_t *buf_in, uint32_t buf_in_len,
+			   uint8_t *buf_out, uint32_t *buf_out_len,
+			   struct oscore_context_table *table,
+			   struct context **c);
+
+/**
+ *@brief 	Converts an OSCORE packet to a CoAP packet with the context 
+ *		selected out of a context store, see oscore2coap_table(). 
+ *		Several threads can call this function on the same store.
+ *
+ *@param	buf_in a buffer containing the OSCORE packet
+ *@param	buf_in_len length of the data in the buf_in
+ *@param	buf_out the resulting CoAP packet
+ *@param	buf_out_len size of buf_out on input, length of the CoAP 
+ *		packet on return
+ *@param	store the contexts of the server
+ *@param	c the context the packet was routed to, NULL if none
+ *@return	err, oscore_kid_recipient_id_mismatch if no context matches a 
+ *		request, oscore_interaction_not_found if no context matches a 
+ *		response
+ */
+enum err oscore2coap_store(uint8_t *buf_in, uint32_t buf_in_len,
+			   uint8_t *buf_out, uint32_t *buf_out_len,
+			   struct oscore_context_store *store,
+			   struct context **c);
+
+/**
+ *@brief 	Reads the header, the token and the options of an incoming 
+ *		packet up to the OSCORE option, and the KID, KID context and 
+ *		PIV in it. The options after the OSCORE option and the payload 
+ *		are not touched.
+ *
+ *@param	buf_in a buffer containing the OSCORE packet
+ *@param	buf_in_len length of the data in the buf_in
+ *@param	packet the header, the token and the options up to the OSCORE 
+ *		option, the payload is left empty
+ *@param	oscore_option the fields of the OSCORE option, pointing into 
+ *		buf_in
+ *@return	err, not_oscore_pkt if the packet has no OSCORE option
+ */
+enum err oscore_peek(uint8_t *buf_in, uint32_t buf_in_len,
+		     struct o_coap_packet *packet,
+		     struct compressed_oscore_option *oscore_option);
+
+/**
+ *@brief 	Checks with oscore_peek() only if an incoming packet would be 
+ *		rejected by oscore2coap() before its decryption: a request 
+ *		with a KID different from the Recipient ID, a replayed request 
+ *		or notification, or a context that is no longer fresh. Servers 
+ *		can drop such packets without parsing them completely. The 
+ *		context is not changed. oscore2coap() runs the same checks 
+ *		internally.
+ *
+ *@param	buf_in a buffer containing the OSCORE packet
+ *@param	buf_in_len length of the data in the buf_in
+ *@param	c a struct containing the OSCORE context
+ *@return	err, ok if the packet can be passed to oscore2coap()
+ */
+enum err oscore_prefilter(uint8_t *buf_in, uint32_t buf_in_len,
+			  struct context *c);
+
+/**
+ *@brief 	Like oscore_prefilter(), with the context selected out of a 
+ *		table of contexts as in oscore2coap_table().
+ *
+ *@param	buf_in a buffer containing the OSCORE packet
+ *@param	buf_in_len length of the data in the buf_in
+ *@param	table the contexts of the server
+ *@param	c the context the packet was routed to, NULL if none
+ *@return	err, ok if the packet can be passed to oscore2coap() with c
+ */
+enum err oscore_prefilter_table(uint8_t *buf_in, uint32_t buf_in_len,
+				struct oscore_context_table *table,
+				struct context **c);
+
+/**
+ *@brief 	Like oscore_prefilter(), with the context selected out of a 
+ *		context store as in oscore2coap_store().
+ *
+ *@param	buf_in a buffer containing the OSCORE packet
+ *@param	buf_in_len length of the data in the buf_in
+ *@param	store the contexts of the server
+ *@param	c the context the packet was routed to, NULL if none
+ *@return	err, ok if the packet can be passed to oscore2coap() with c
+ */
+enum err oscore_prefilter_store(uint8_t *buf_in, uint32_t buf_in_len,
+				struct oscore_context_store *store,
+				struct context **c);
+
 /**
  *@brief 	Converts a CoAP packet to OSCORE packet
  *
@@ -132,4 +414,223 @@ enum err coap2oscore(uint8_t *buf_o_coap, uint32_t buf_o_coap_len,
 		     uint8_t *buf_oscore, uint32_t *buf_oscore_len,
 		     struct context *c);
 
+/**
+ *@brief 	Converts a CoAP packet to OSCORE packet like coap2oscore(), 
+ *		but without intermediate copies: the header, the options and 
+ *		the OSCORE option are written first, then the plaintext is 
+ *		written at its final position in buf_oscore and encrypted in 
+ *		place. The size of the plaintext is not limited by 
+ *		MAX_PLAINTEXT_LEN.
+ *@note		buf_o_coap and buf_oscore must not overlap.
+ *
+ *@param	buf_o_coap a buffer containing a CoAP packet
+ *@param	buf_o_coap_len length of the CoAP buffer
+ *@param	buf_oscore a buffer where the OSCORE packet will be written
+ *@param	buf_oscore_len size of buf_oscore on input, length of the 
+ *		OSCORE packet on output. If buf_oscore is too small, 
+ *		buffer_to_small is returned and the required size is written 
+ *		here, before an SSN is used.
+ *@param	c a struct containing the OSCORE context
+ *@return	err
+ */
+enum err coap2oscore_in_place(uint8_t *buf_o_coap, uint32_t buf_o_coap_len,
+			      uint8_t *buf_oscore, uint32_t *buf_oscore_len,
+			      struct context *c);
+
+/**
+ *@brief 	Converts a parsed CoAP packet to an OSCORE packet like 
+ *		coap2oscore_in_place(), without serializing and parsing the 
+ *		CoAP packet first.
+ *
+ *@param	coap the CoAP packet. Its options must be ordered by option 
+ *		number and their deltas set, as done by coap_deserialize().
+ *@param	buf_oscore a buffer where the OSCORE packet will be written
+ *@param	buf_oscore_len size of buf_oscore on input, length of the 
+ *		OSCORE packet on return. If the buffer is too small, 
+ *		buffer_to_small is returned with the required size, without 
+ *		using an SSN.
+ *@param	c a struct containing the OSCORE context
+ *@return	err
+ */
+enum err coap2oscore_packet(struct o_coap_packet *coap, uint8_t *buf_oscore,
+			    uint32_t *buf_oscore_len, struct context *c);
+
+/**
+ *@brief 	Converts a CoAP packet given in segments to an OSCORE packet 
+ *		given in segments, e.g. for writev() or sendmsg(). The payload 
+ *		segments are gathered directly into the ciphertext segment and 
+ *		encrypted there, like in coap2oscore_in_place(), so that 
+ *		neither the CoAP packet nor the OSCORE packet has to be 
+ *		contiguous.
+ *
+ *@param	buf_o_coap the header, token and options of the CoAP packet, 
+ *		without payload marker and payload
+ *@param	buf_o_coap_len length of buf_o_coap
+ *@param	payload payload segments, may be empty
+ *@param	payload_cnt number of payload segments
+ *@param	oscore_header buffer and size of the header segment on input, 
+ *		length of the header, token, options and payload marker of 
+ *		the OSCORE packet on return
+ *@param	oscore_payload buffer and size of the ciphertext segment on 
+ *		input, length of the ciphertext on return. It must not overlap
+ *		the payload segments.
+ *@param	c a struct containing the OSCORE context
+ *@return	err, buffer_to_small with the required sizes in oscore_header 
+ *		and oscore_payload, without using an SSN
+ */
+enum err coap2oscore_iov(uint8_t *buf_o_coap, uint32_t buf_o_coap_len,
+			 const struct byte_array *payload, uint32_t payload_cnt,
+			 struct byte_array *oscore_header,
+			 struct byte_array *oscore_payload, struct context *c);
+
+/**
+ * One packet of a batch processed by coap2oscore_batch() or 
+ * oscore2coap_batch().
+ */
+struct oscore_batch_pkt {
+	/*input packet*/
+	uint8_t *buf_in;
+	uint32_t buf_in_len;
+	/*output buffer, buf_out_len is its size on input and the length of 
+	the output packet on return*/
+	uint8_t *buf_out;
+	uint32_t buf_out_len;
+	/*result of processing this packet*/
+	enum err result;
+	/*context the packet was routed to by oscore2coap_batch(), NULL if none*/
+	struct context *c;
+	/*packet and OSCORE option read by oscore2coap_batch() while routing, 
+	reused for the decryption, see oscore_peek()*/
+	struct o_coap_packet oscore_packet;
+	struct compressed_oscore_option oscore_option;
+};
+
+/**
+ *@brief 	Converts several CoAP packets protected with the same context 
+ *		to OSCORE packets, e.g. a burst of notifications. The SSNs for 
+ *		all packets are reserved in one step and stored in NVM at most 
+ *		once for the whole batch. The packets are processed in order.
+ *
+ *@param	pkts the packets, the result of each packet is written into 
+ *		its result field
+ *@param	pkts_cnt number of packets
+ *@param	c a struct containing the OSCORE context
+ *@return	ok if all packets were converted, otherwise the error of the 
+ *		first failed packet
+ */
+enum err coap2oscore_batch(struct oscore_batch_pkt *pkts, uint32_t pkts_cnt,
+			   struct context *c);
+
+/**
+ * Block of Sender Sequence Numbers reserved by oscore_ssn_block_reserve(), 
+ * e.g., one per worker thread sending with a shared context.
+ */
+struct oscore_ssn_block {
+	/*next SSN to be used*/
+	uint64_t next;
+	/*end of the block, exclusive*/
+	uint64_t end;
+	/*number of SSNs reserved when the block is used up*/
+	uint32_t size;
+};
+
+/**
+ *@brief 	Reserves a block of consecutive SSNs of a context with one 
+ *		atomic operation. Blocks reserved by concurrent threads are 
+ *		disjoint. With OSCORE_NVM_SUPPORT the SSN is stored in NVM 
+ *		before the block is returned whenever the block passes the 
+ *		value in NVM, so that no SSN of the block can be used again 
+ *		after a reboot. Only then the lock of the context is taken.
+ *@note		SSNs of a block that are not used are lost. Larger blocks 
+ *		need fewer reservations and NVM writes, but waste more SSNs 
+ *		when a thread stops sending.
+ *
+ *@param	c a struct containing the OSCORE context
+ *@param	size number of SSNs
+ *@param	block the reserved block
+ *@return	err
+ */
+enum err oscore_ssn_block_reserve(struct context *c, uint32_t size,
+				  struct oscore_ssn_block *block);
+
+/**
+ *@brief 	Writes the SSN of a context in NVM, if a write-behind was 
+ *		requested by the ssn_write_request hook given in struct 
+ *		oscore_init_params. It is called by a background worker or the 
+ *		main loop, not by the hook itself. The NVM is written without 
+ *		the lock of the context, so packets can be protected during 
+ *		the write.
+ *@note		A write is requested when half of the SSNs reserved by the 
+ *		value in NVM (K_SSN_NVM_STORE_INTERVAL, or the adaptive 
+ *		interval, see ssn_clock) are used, and during the ECHO 
+ *		synchronization after a reboot. Only if all of them are used 
+ *		before the write-behind is done, the SSN is written 
+ *		synchronously while the packet is protected, as without the 
+ *		hook. If the write fails, it is done by the next call or 
+ *		synchronously then.
+ *@note		To share one sync of the NVM between the flushes of several 
+ *		contexts, nvm_write_ssn_interval() returns 
+ *		oscore_nvm_write_deferred when called by the flush without 
+ *		syncing. The SSNs covered by the new value are then only used 
+ *		after oscore_ssn_durable() was called for the context, which 
+ *		the application does once the sync is done.
+ *
+ *@param	c a struct containing the OSCORE context
+ *@return	err
+ */
+enum err oscore_ssn_flush(struct context *c);
+
+/**
+ *@brief 	Acknowledges that the value written by the last 
+ *		oscore_ssn_flush() of a context is durable in NVM, after the 
+ *		write was deferred with oscore_nvm_write_deferred. It must only 
+ *		be called after a sync that followed the flush, otherwise the 
+ *		SSNs covered by a value lost on a power failure are used and 
+ *		reused after the reboot.
+ *
+ *@param	c a struct containing the OSCORE context
+ *@return	err
+ */
+enum err oscore_ssn_durable(struct context *c);
+
+/**
+ *@brief 	Converts a CoAP packet to OSCORE packet like coap2oscore(), 
+ *		but takes the SSN from a block owned by the calling thread. A 
+ *		new block of the same size is reserved when the block is used 
+ *		up. The context is locked only while it is read and updated, 
+ *		the encryption runs without the lock, so that several threads 
+ *		can protect packets with the same context in parallel.
+ *
+ *@param	buf_o_coap a buffer containing a CoAP packet
+ *@param	buf_o_coap_len length of the CoAP buffer
+ *@param	buf_oscore a buffer where the OSCORE packet will be written
+ *@param	buf_oscore_len length of the OSCORE packet
+ *@param	c a struct containing the OSCORE context
+ *@param	block SSN block reserved with oscore_ssn_block_reserve()
+ *@return	err
+ */
+enum err coap2oscore_ssn_block(uint8_t *buf_o_coap, uint32_t buf_o_coap_len,
+			       uint8_t *buf_oscore, uint32_t *buf_oscore_len,
+			       struct context *c,
+			       struct oscore_ssn_block *block);
+
+/**
+ *@brief 	Converts several received OSCORE packets to CoAP packets, e.g. 
+ *		all datagrams returned by one recvmmsg() call. Each packet is 
+ *		routed to its context: requests by the KID (and KID context), 
+ *		responses by their token. Replayed packets of the whole batch 
+ *		are rejected before any decryption, then the remaining packets 
+ *		are decrypted in order.
+ *
+ *@param	pkts the packets, the result of each packet is written into 
+ *		its result field and the matching context into its c field
+ *@param	pkts_cnt number of packets
+ *@param	contexts the contexts to which the packets can belong
+ *@param	contexts_cnt number of contexts
+ *@return	ok if all packets were converted, otherwise the error of the 
+ *		first failed packet
+ */
+enum err oscore2coap_batch(struct oscore_batch_pkt *pkts, uint32_t pkts_cnt,
+			   struct context **contexts, uint32_t contexts_cnt);
+
 #endif
@@ -26,6 +26,23 @@ struct nvm_key_t {
 	struct byte_array id_context;
 };
 
+struct context;
+
+/**
+ * @brief Hook asking for a write-behind of the SSN of a context, see oscore_ssn_flush(). It is
+ *        called with the context locked, so it must not block and must not call functions using
+ *        the context. E.g., it submits a work item or sets a flag for the main loop, which then
+ *        calls oscore_ssn_flush().
+ */
+typedef void (*oscore_ssn_write_request_t)(struct context *c);
+
+/**
+ * @brief Clock adapting the SSN interval of a context to its message rate, see the ssn_clock
+ *        field of struct oscore_init_params. Returns the current time in a unit chosen by the
+ *        user, e.g., seconds. The value may wrap around.
+ */
+typedef uint32_t (*oscore_ssn_clock_t)(void);
+
 #ifdef OSCORE_NVM_SUPPORT
 /**
 * @brief When the same OSCORE master secret and salt are reused through
@@ -50,15 +67,57 @@ enum err nvm_write_ssn(const struct nvm_key_t *nvm_key, uint64_t ssn);
 enum err nvm_read_ssn(const struct nvm_key_t *nvm_key, uint64_t *ssn);
 
 /**
- * @brief Periodically stores the SSN in NVM (if needed).
- * 
- * @param nvm_key part of the context that is permitted to be used for identifying the right store slot in NVM.
- * @param ssn SSN to be written in NVM.
- * @param echo_sync_in_progress Indicates if the device is still in the ECHO synchronization mode.
- * @return enum err 
- */
-enum err ssn_store_in_nvm(const struct nvm_key_t *nvm_key, uint64_t ssn,
-			  bool echo_sync_in_progress);
+* @brief Stores the SSN together with the interval reserved after it, i.e., no SSN from 
+*        ssn + interval on is used before the next write. ssn_init() restores the SSN 
+*        ssn + interval + F_NVM_MAX_WRITE_FAILURE after a reboot.
+* @note  The default implementation stores ssn + interval - K_SSN_NVM_STORE_INTERVAL (at 
+*        least 0) with nvm_write_ssn(), so that the values stored before stay valid. It can be 
+*        overwritten together with nvm_read_ssn_interval() to store both values.
+* @param nvm_key part of the context that is permitted to be used for identifying the right store slot in NVM.
+* @param	ssn SSN to be written in NVM.
+* @param	interval Number of SSNs reserved after ssn.
+* @retval ok or error code if storing the SSN was not possible. When called by 
+*         oscore_ssn_flush(), oscore_nvm_write_deferred if the value was stored 
+*         but is not durable before a later sync, see oscore_ssn_durable(). 
+*         When a packet is protected, the value must be durable on return.
+*/
+enum err nvm_write_ssn_interval(const struct nvm_key_t *nvm_key, uint64_t ssn,
+				uint32_t interval);
+
+/**
+* @brief Restores the SSN and the interval stored with nvm_write_ssn_interval().
+* @note  The default implementation reads the SSN with nvm_read_ssn() and returns the interval
+*        K_SSN_NVM_STORE_INTERVAL.
+* @param nvm_key part of the context that is permitted to be used for identifying the right store slot in NVM.
+* @param	ssn SSN read out from NVM.
+* @param	interval Interval read out from NVM.
+* @retval ok or error code if the retrieving the SSN was not possible.
+*/
+enum err nvm_read_ssn_interval(const struct nvm_key_t *nvm_key, uint64_t *ssn,
+			       uint32_t *interval);
+
+/**
+* @brief Stores the replay bound of a recipient context: all requests accepted so far had a 
+*        lower SSN. A server restoring the context after a reboot accepts requests with an SSN 
+*        from the bound on without the ECHO challenge, see replay_bound_interval in struct 
+*        oscore_init_params.
+* @note  The default implementation returns not_implemented. It must be overwritten together 
+*        with nvm_read_replay_bound() if replay_bound_interval is used.
+* @param nvm_key part of the context that is permitted to be used for identifying the right store slot in NVM.
+* @param	bound Replay bound to be written in NVM.
+* @retval ok or error code if storing the bound was not possible.
+*/
+enum err nvm_write_replay_bound(const struct nvm_key_t *nvm_key,
+				uint64_t bound);
+
+/**
+* @brief Restores the replay bound stored with nvm_write_replay_bound().
+* @param nvm_key part of the context that is permitted to be used for identifying the right store slot in NVM.
+* @param	bound Replay bound read out from NVM.
+* @retval ok or error code if no bound is stored, then the ECHO challenge is used.
+*/
+enum err nvm_read_replay_bound(const struct nvm_key_t *nvm_key,
+			       uint64_t *bound);
 #endif
 
 /**
@@ -0,0 +1,159 @@
+/*
+   Copyright (c) 2026 Fraunhofer AISEC. See the COPYRIGHT
+   file at the top-level directory of this distribution.
+
+   Licensed under the Apache License, Version 2.0 <LICENSE-APACHE or
+   http://www.apache.org/licenses/LICENSE-2.0> or the MIT license
+   <LICENSE-MIT or http://opensource.org/licenses/MIT>, at your
+   option. This file may not be copied, modified, or distributed
+   except according to those terms.
+*/
+
+#ifndef NVM_FILE_H
+#define NVM_FILE_H
+
+#if defined(OSCORE_NVM_SUPPORT) && defined(OSCORE_NVM_FILE)
+#include <stddef.h>
+#include <stdint.h>
+
+#include "oscore/nvm.h"
+#include "oscore/oscore_lock.h"
+
+#include "common/oscore_edhoc_error.h"
+
+/*
+ * SSN store for servers with many contexts on POSIX systems (e.g. Linux),
+ * enabled with the OSCORE_NVM_FILE flag in makefile_config.mk. The SSNs are
+ * kept in a memory-mapped file with one fixed-size slot per nvm_key_t. A slot
+ * holds two copies of the record of its key, each with a checksum. A write
+ * never overwrites the only copy which is known to be on the disk, so that
+ * after a crash or power loss each key is restored with its last synced value
+ * or a newer one.
+ *
+ * Writes go to the mapping only. They survive a crash of the process, but a
+ * power loss only after the next oscore_nvm_file_sync(), which writes all
+ * records changed since the last sync with one msync(). The store is used by
+ * overwriting the NVM hooks, e.g.:
+ *
+ *	enum err nvm_write_ssn_interval(const struct nvm_key_t *nvm_key,
+ *					uint64_t ssn, uint32_t interval)
+ *	{
+ *		TRY(oscore_nvm_file_write(&file, nvm_key, ssn, interval));
+ *		return oscore_nvm_file_sync(&file);
+ *	}
+ *
+ * and the same for nvm_read_ssn_interval() with oscore_nvm_file_read(). To
+ * batch the syncs, the contexts are initialized with ssn_write_request and a
+ * worker thread flushes the requesting contexts. The hook skips the sync in
+ * the worker only and returns oscore_nvm_write_deferred instead, so that the
+ * new values are not used before they are durable:
+ *
+ *	static _Thread_local bool in_flush;
+ *
+ *	enum err nvm_write_ssn_interval(const struct nvm_key_t *nvm_key,
+ *					uint64_t ssn, uint32_t interval)
+ *	{
+ *		TRY(oscore_nvm_file_write(&file, nvm_key, ssn, interval));
+ *		if (in_flush) {
+ *			return oscore_nvm_write_deferred;
+ *		}
+ *		return oscore_nvm_file_sync(&file);
+ *	}
+ *
+ * The worker sets in_flush, calls oscore_ssn_flush() for all requesting
+ * contexts, clears in_flush, calls oscore_nvm_file_sync() once and then
+ * oscore_ssn_durable() for the same contexts. Until then the contexts keep
+ * using the SSNs covered by their previous values, and a context which uses
+ * them up writes and syncs its SSN itself while protecting a packet.
+ *
+ * The file has the byte order of the host. Its layout depends on MAX_KID_LEN
+ * and MAX_KID_CONTEXT_LEN.
+ */
+
+/*Length of the file header, the slots follow it*/
+#define OSCORE_NVM_FILE_HEADER_LEN 64
+/*Length of one copy of a record, a slot holds two copies*/
+#define OSCORE_NVM_FILE_RECORD_LEN 64
+
+/*
+ * Number of slots searched for a key, starting at the slot selected by its
+ * hash. Keys which find no free slot within this window can't be stored, so
+ * the file should have at least twice as many slots as keys.
+ */
+#ifndef OSCORE_NVM_FILE_MAX_PROBE
+#define OSCORE_NVM_FILE_MAX_PROBE 32
+#endif
+
+/**
+ * @brief An open SSN store file.
+ */
+struct oscore_nvm_file {
+	int fd;
+	uint8_t *map;
+	size_t map_len;
+	uint32_t slots_cnt; /* power of two */
+	uint32_t keys_cnt; /* slots holding a valid record */
+	uint64_t epoch; /* written into the records, advanced by each sync */
+	uint64_t durable_epoch; /* records of older epochs are on the disk */
+	uint64_t syncing_epoch; /* newest epoch written by the running sync, 0 if none */
+	struct oscore_lock lock; /* used with OSCORE_THREAD_SAFE only */
+	struct oscore_lock sync_lock; /* held by a sync, used with OSCORE_THREAD_SAFE only */
+};
+
+/**
+ * @brief Open a store file, or create it if it doesn't exist. The records of an existing file
+ *        are verified and the newest valid copy of each key is used.
+ * @param f The store.
+ * @param path Path of the file.
+ * @param slots_cnt Number of slots, a power of two. It must be the same as when the file was
+ *        created.
+ * @return enum err ok, wrong_parameter, or oscore_nvm_io_error if the file can't be used.
+ */
+enum err oscore_nvm_file_open(struct oscore_nvm_file *f, const char *path,
+			      uint32_t slots_cnt);
+
+/**
+ * @brief Sync and close a store.
+ * @param f The store.
+ * @return enum err ok, or oscore_nvm_io_error if the sync failed.
+ */
+enum err oscore_nvm_file_close(struct oscore_nvm_file *f);
+
+/**
+ * @brief Store the SSN of a key, see nvm_write_ssn_interval(). The first write of a key takes
+ *        a free slot. If the last record of the key is being written to the disk by a sync of
+ *        another thread, the write waits until the sync is done.
+ * @param f The store.
+ * @param nvm_key The key.
+ * @param ssn SSN to be stored.
+ * @param interval Number of SSNs reserved after ssn.
+ * @return enum err ok, wrong_parameter if an ID of the key is too long, or
+ *         oscore_max_contexts if no free slot was found for a new key.
+ */
+enum err oscore_nvm_file_write(struct oscore_nvm_file *f,
+			       const struct nvm_key_t *nvm_key, uint64_t ssn,
+			       uint32_t interval);
+
+/**
+ * @brief Read the SSN of a key, see nvm_read_ssn_interval().
+ * @param f The store.
+ * @param nvm_key The key.
+ * @param ssn [out] The SSN.
+ * @param interval [out] The interval stored with it.
+ * @return enum err ok, or oscore_nvm_key_not_found if the key was never stored.
+ */
+enum err oscore_nvm_file_read(struct oscore_nvm_file *f,
+			      const struct nvm_key_t *nvm_key, uint64_t *ssn,
+			      uint32_t *interval);
+
+/**
+ * @brief Write all records changed since the last sync to the disk. Writes of other threads
+ *        continue during the msync(), except for keys whose last record is written by it, see
+ *        oscore_nvm_file_write(). Syncs of several threads run one after the other.
+ * @param f The store.
+ * @return enum err ok, or oscore_nvm_io_error if the msync() failed.
+ */
+enum err oscore_nvm_file_sync(struct oscore_nvm_file *f);
+#endif
+
+#endif
@@ -135,6 +135,16 @@ bool get_observe_value(struct o_coap_option *options, uint8_t options_cnt,
 enum err cache_echo_val(struct byte_array *dest, struct o_coap_option *options,
 			uint8_t options_cnt);
 
+/**
+ * @brief	Finds the ECHO option in a decrypted payload.
+ * @param	decrypted_payload the decrypted payload of the message
+ * @param	echo_val [out] points to the value of the option inside the 
+ * 			payload
+ * @retval	ok or no_echo_option
+*/
+enum err echo_val_get(struct byte_array *decrypted_payload,
+		      struct byte_array *echo_val);
+
 /**
  * @brief	Checks if an ECHO value is fresh. It takes a decrypted payload and 
  * 			search in it for an ECHO option. If such is find it compares it 
@@ -173,4 +183,31 @@ enum err oscore_decrypted_payload_parser(struct byte_array *in_payload,
 enum err uri_path_create(struct o_coap_option *options, uint32_t options_size,
 			 uint8_t *uri_path, uint32_t *uri_path_size);
 
+/**
+ * @brief Initial value of uri_path_hash_update(), i.e., the hash of an empty string.
+ */
+#define URI_PATH_HASH_INIT 14695981039346656037ull
+
+/**
+ * @brief Continue a 64 bit FNV-1a hash over given bytes.
+ * @param hash URI_PATH_HASH_INIT or the result of the previous call.
+ * @param data Bytes to be hashed.
+ * @param len Number of bytes.
+ * @return The updated hash.
+ */
+uint64_t uri_path_hash_update(uint64_t hash, const uint8_t *data, uint32_t len);
+
+/**
+ * @brief Hash the URI Path of given options array without composing it. The result equals the hash
+ *        of the URI Path composed by uri_path_create(), e.g., a resource dispatcher can compare it
+ *        with the hash of "path/to/rsc". The length of the path is not limited by
+ *        OSCORE_MAX_URI_PATH_LEN.
+ * @param options Options array.
+ * @param options_size Options array size (number of items).
+ * @param hash [out] Hash of the URI Path.
+ * @return ok or error code
+ */
+enum err uri_path_hash(struct o_coap_option *options, uint32_t options_size,
+		       uint64_t *hash);
+
 #endif
@@ -121,6 +121,34 @@ struct compressed_oscore_option {
  */
 enum err coap_deserialize(struct byte_array *in, struct o_coap_packet *out);
 
+/**
+ * @brief   Reads only the header, the token and the first options of a 
+ *          packet, up to the first option with a number of at least 
+ *          last_option_number. The rest of the packet is not touched and 
+ *          the payload of the output is left empty. Every read is checked 
+ *          against the length of the input.
+ * @param   in: pointer to an input message packet, in byte string format
+ * @param   last_option_number: number of the last option needed
+ * @param   out: pointer to an output OSCORE packet
+ * @return  err
+ */
+enum err coap_header_deserialize(struct byte_array *in,
+				 uint16_t last_option_number,
+				 struct o_coap_packet *out);
+
+/**
+ * @brief   Completes a packet read by coap_header_deserialize(): reads the 
+ *          options after the last option read before and the payload, so 
+ *          that the output is the same as of coap_deserialize().
+ * @param   in: pointer to the input message packet passed to 
+ *          coap_header_deserialize()
+ * @param   out: in: the packet read by coap_header_deserialize(), out: the 
+ *          whole packet
+ * @return  err
+ */
+enum err coap_deserialize_rest(struct byte_array *in,
+			       struct o_coap_packet *out);
+
 /**
  * @brief   Converts a CoAP/OSCORE packet to a byte string
  * @param   in: input CoAP/OSCORE packet
@@ -131,6 +159,36 @@ enum err coap_deserialize(struct byte_array *in, struct o_coap_packet *out);
 enum err coap_serialize(struct o_coap_packet *in, uint8_t *out_byte_string,
 			uint32_t *out_byte_string_len);
 
+/**
+ * @brief   Converts the header, token and options of a CoAP/OSCORE packet 
+ *          to a byte string, followed by the payload marker if the packet 
+ *          has a payload. The payload itself is not copied, it can be 
+ *          written directly behind the returned length.
+ * @param   in: input CoAP/OSCORE packet, only the length of its payload is used
+ * @param   out_byte_string: output byte string
+ * @param   out_byte_string_len: in: size of the output, out: length written
+ * @return  err
+ */
+enum err coap_header_serialize(struct o_coap_packet *in,
+			       uint8_t *out_byte_string,
+			       uint32_t *out_byte_string_len);
+
+/**
+ * @brief   Length of a CoAP/OSCORE packet converted to a byte string
+ * @param   in: input CoAP/OSCORE packet
+ * @return  length in bytes
+ */
+uint32_t coap_serialized_len(struct o_coap_packet *in);
+
+/**
+ * @brief   Length of options converted to a byte string
+ * @param   options: input pointer to an array of options
+ * @param   options_cnt: count number of input options
+ * @return  length in bytes
+ */
+uint32_t options_serialized_len(struct o_coap_option *options,
+				uint8_t options_cnt);
+
 /**
  * @brief   Convert input options into byte string
  * @param   options: input pointer to an array of options
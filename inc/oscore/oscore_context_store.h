@@ -0,0 +1,121 @@
+/*
+   Copyright (c) 2026 Fraunhofer AISEC. See the COPYRIGHT
+   file at the top-level directory of this distribution.
+
+   Licensed under the Apache License, Version 2.0 <LICENSE-APACHE or
+   http://www.apache.org/licenses/LICENSE-2.0> or the MIT license
+   <LICENSE-MIT or http://opensource.org/licenses/MIT>, at your
+   option. This file may not be copied, modified, or distributed
+   except according to those terms.
+*/
+
+#ifndef OSCORE_CONTEXT_STORE_H
+#define OSCORE_CONTEXT_STORE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "oscore/oscore_context_table.h"
+#include "oscore/oscore_lock.h"
+#include "oscore/security_context.h"
+
+#include "common/byte_array.h"
+#include "common/oscore_edhoc_error.h"
+
+/**
+ * @brief One shard of a context store: a context table with its own lock.
+ */
+struct oscore_context_shard {
+	struct oscore_context_table table;
+	struct oscore_lock lock; /* used with OSCORE_THREAD_SAFE only */
+};
+
+/**
+ * @brief Contexts of a server, split into shards by the hash of their ID Context and Recipient
+ *        ID.
+ *
+ * With OSCORE_THREAD_SAFE defined, the store can be used by several threads at the same time:
+ * each shard is locked only while it is searched or modified, and each context is locked by
+ * coap2oscore() and oscore2coap() (and their variants) while a packet is processed. Threads
+ * serving different clients therefore share no lock, except for short lookups in the same
+ * shard. A context must not be deinitialized while another thread may still use it, i.e.,
+ * after oscore_context_store_remove() the application must wait until all threads have
+ * finished the packets they received before.
+ */
+struct oscore_context_store {
+	struct oscore_context_shard *shards;
+	uint32_t shards_cnt;
+	struct oscore_rate_limit *unknown_limit; /* see oscore_context_store_rate_limit_set() */
+};
+
+/**
+ * @brief Initialize an empty store.
+ * @param store Store to be initialized.
+ * @param shards Storage for shards_cnt shards.
+ * @param shards_cnt Number of shards, e.g., the number of threads using the store.
+ * @param slots Storage for shards_cnt * slots_per_shard slots.
+ * @param slots_per_shard Number of slots of each shard, a power of two, see
+ *        oscore_context_table_init().
+ * @return enum err ok, or error if failed.
+ */
+enum err oscore_context_store_init(struct oscore_context_store *store,
+				   struct oscore_context_shard *shards,
+				   uint32_t shards_cnt, struct context **slots,
+				   uint32_t slots_per_shard);
+
+/**
+ * @brief Limit the packets that match no context of the store, see
+ *        oscore_context_table_rate_limit_set(). The limiter is shared by all shards.
+ * @param store The store.
+ * @param limit Limiter initialized with oscore_rate_limit_init(), or NULL for no limit.
+ * @return enum err ok, or error if failed.
+ */
+enum err oscore_context_store_rate_limit_set(struct oscore_context_store *store,
+					     struct oscore_rate_limit *limit);
+
+/**
+ * @brief Add an initialized context to the store.
+ * @param store The store.
+ * @param c The context.
+ * @return enum err ok, oscore_context_duplicated or oscore_max_contexts if the shard of the
+ *         context is full.
+ */
+enum err oscore_context_store_insert(struct oscore_context_store *store,
+				     struct context *c);
+
+/**
+ * @brief Remove a context from the store.
+ * @param store The store.
+ * @param c The context.
+ * @return enum err ok, or oscore_kid_recipient_id_mismatch if the context is not in the store.
+ */
+enum err oscore_context_store_remove(struct oscore_context_store *store,
+				     struct context *c);
+
+/**
+ * @brief Find the context of a request by the KID context and KID of its OSCORE option.
+ * @param store The store.
+ * @param id_context KID context of the request, ID Context of the context.
+ * @param recipient_id KID of the request, Recipient ID of the context.
+ * @param c [out] Pointer to the matching context.
+ * @return enum err ok, or oscore_kid_recipient_id_mismatch if there is no such context.
+ */
+enum err oscore_context_store_find(struct oscore_context_store *store,
+				   const struct byte_array *id_context,
+				   const struct byte_array *recipient_id,
+				   struct context **c);
+
+/**
+ * @brief Search all shards for a context, e.g., for the context of a response by its token.
+ * @param store The store.
+ * @param match Called for the contexts of the store until it returns true. It is called with
+ *        the lock of the shard held and must therefore not use the store.
+ * @param arg Passed to match.
+ * @return The first context for which match returned true, or NULL.
+ */
+struct context *
+oscore_context_store_search(struct oscore_context_store *store,
+			    bool (*match)(struct context *c, void *arg),
+			    void *arg);
+
+#endif
@@ -0,0 +1,116 @@
+/*
+   Copyright (c) 2026 Fraunhofer AISEC. See the COPYRIGHT
+   file at the top-level directory of this distribution.
+
+   Licensed under the Apache License, Version 2.0 <LICENSE-APACHE or
+   http://www.apache.org/licenses/LICENSE-2.0> or the MIT license
+   <LICENSE-MIT or http://opensource.org/licenses/MIT>, at your
+   option. This file may not be copied, modified, or distributed
+   except according to those terms.
+*/
+
+#ifndef OSCORE_CONTEXT_TABLE_H
+#define OSCORE_CONTEXT_TABLE_H
+
+#include <stdint.h>
+
+#include "oscore/oscore_rate_limit.h"
+#include "oscore/security_context.h"
+
+#include "common/byte_array.h"
+#include "common/oscore_edhoc_error.h"
+
+/**
+ * @brief Index of the security contexts of a server, keyed by (ID Context, Recipient ID).
+ *
+ * Open addressing with linear probing over an array of slots provided by the user, so that
+ * the context of an incoming request is found in constant time on average, independent of
+ * the number of contexts. The table stores pointers only: the contexts are owned by the user
+ * and their ID Context and Recipient ID must not change while they are in the table.
+ */
+struct oscore_context_table {
+	struct context **slots; /* NULL for empty slots */
+	uint32_t slots_cnt; /* power of two */
+	uint32_t contexts_cnt;
+	struct oscore_rate_limit *unknown_limit; /* see oscore_context_table_rate_limit_set() */
+};
+
+/**
+ * @brief Initialize an empty table.
+ * @note At most 3/4 of the slots are used, so that lookups stay short. E.g., 16384 slots hold
+ *       up to 12288 contexts.
+ * @param table Table to be initialized.
+ * @param slots Storage for the slots, must stay valid as long as the table is used.
+ * @param slots_cnt Number of slots, a power of two.
+ * @return enum err ok, or error if failed.
+ */
+enum err oscore_context_table_init(struct oscore_context_table *table,
+				   struct context **slots, uint32_t slots_cnt);
+
+/**
+ * @brief Limit the packets that match no context of the table, i.e., requests with an unknown
+ *        KID and responses with an unknown token, with a limiter shared by all such packets.
+ * @note While the limiter is exhausted, requests with an unknown KID are rejected with
+ *       oscore_rate_limited, and responses before the search over all contexts of the table.
+ *       Packets of known contexts are limited by the limiters of their contexts only.
+ * @param table The table.
+ * @param limit Limiter initialized with oscore_rate_limit_init(), or NULL for no limit. It must
+ *        stay valid as long as the table is used. Its counters show the packets which matched
+ *        no context.
+ * @return enum err ok, or error if failed.
+ */
+enum err oscore_context_table_rate_limit_set(struct oscore_context_table *table,
+					     struct oscore_rate_limit *limit);
+
+/**
+ * @brief Add an initialized context to the table.
+ * @param table The table.
+ * @param c The context.
+ * @return enum err ok, oscore_context_duplicated if a context with the same ID Context and
+ *         Recipient ID is already in the table, oscore_max_contexts if the table is full.
+ */
+enum err oscore_context_table_insert(struct oscore_context_table *table,
+				     struct context *c);
+
+/**
+ * @brief Remove a context from the table.
+ * @param table The table.
+ * @param c The context.
+ * @return enum err ok, or oscore_kid_recipient_id_mismatch if the context is not in the table.
+ */
+enum err oscore_context_table_remove(struct oscore_context_table *table,
+				     struct context *c);
+
+/**
+ * @brief Find the context of a request by the KID context and KID of its OSCORE option.
+ * @note A request without KID context matches only contexts without ID Context.
+ * @param table The table.
+ * @param id_context KID context of the request, ID Context of the context.
+ * @param recipient_id KID of the request, Recipient ID of the context.
+ * @param c [out] Pointer to the matching context.
+ * @return enum err ok, or oscore_kid_recipient_id_mismatch if there is no such context.
+ */
+enum err oscore_context_table_find(const struct oscore_context_table *table,
+				   const struct byte_array *id_context,
+				   const struct byte_array *recipient_id,
+				   struct context **c);
+
+/**
+ * @brief Hash of the key of a context. Slots are selected by its low bits.
+ * @param id_context ID Context.
+ * @param recipient_id Recipient ID.
+ * @return The hash.
+ */
+uint32_t oscore_context_table_hash(const struct byte_array *id_context,
+				   const struct byte_array *recipient_id);
+
+/**
+ * @brief Iterate over all contexts of the table. The table must not be modified while iterating.
+ * @param table The table.
+ * @param iterator Position of the iteration, must be set to 0 before the first call.
+ * @return The next context, or NULL after the last one.
+ */
+struct context *oscore_context_table_next(const struct oscore_context_table *table,
+					  uint32_t *iterator);
+
+#endif
@@ -13,6 +13,7 @@
 #define OSCORE_COSE_H
 
 #include "common/byte_array.h"
+#include "common/crypto_wrapper.h"
 #include "common/oscore_edhoc_error.h"
 
 /**
@@ -21,13 +22,13 @@
  * @param out_plaintext: output plaintext
  * @param nonce the nonce
  * @param aad the aad
- * @param recipient_key the recipient key
+ * @param recipient_key the recipient key bound at context initialization
  * @return err
  */
 enum err oscore_cose_decrypt(struct byte_array *in_ciphertext,
 			     struct byte_array *out_plaintext,
 			     struct byte_array *nonce, struct byte_array *aad,
-			     struct byte_array *recipient_key);
+			     const struct aead_key *recipient_key);
 
 /**
  * @brief Encrypt the plaintext
@@ -35,12 +36,12 @@ enum err oscore_cose_decrypt(struct byte_array *in_ciphertext,
  * @param out_ciphertext: output ciphertext with authentication tag (8 bytes)
  * @param nonce the nonce
  * @param sender_aad the aad
- * @param key the sender key
+ * @param key the sender key bound at context initialization
  * @return err
  */
 enum err oscore_cose_encrypt(struct byte_array *in_plaintext,
 			     struct byte_array *out_ciphertext,
 			     struct byte_array *nonce,
 			     struct byte_array *sender_aad,
-			     struct byte_array *key);
+			     const struct aead_key *key);
 #endif
@@ -0,0 +1,106 @@
+/*
+   Copyright (c) 2026 Fraunhofer AISEC. See the COPYRIGHT
+   file at the top-level directory of this distribution.
+
+   Licensed under the Apache License, Version 2.0 <LICENSE-APACHE or
+   http://www.apache.org/licenses/LICENSE-2.0> or the MIT license
+   <LICENSE-MIT or http://opensource.org/licenses/MIT>, at your
+   option. This file may not be copied, modified, or distributed
+   except according to those terms.
+*/
+
+#ifndef OSCORE_ECHO_H
+#define OSCORE_ECHO_H
+
+#include <stdint.h>
+
+#include "common/byte_array.h"
+#include "common/crypto_wrapper.h"
+#include "common/oscore_edhoc_error.h"
+
+/*Echo values are a 4 byte timestamp followed by a tag of this length*/
+#define OSCORE_ECHO_TAG_LEN 8
+#define OSCORE_ECHO_VAL_LEN (4 + OSCORE_ECHO_TAG_LEN)
+
+/*Longest server secret, one block of the hash*/
+#define OSCORE_ECHO_SECRET_MAX_LEN 32
+
+/**
+ * @brief Clock of the Echo values. Returns the current time in a unit chosen by the user, e.g.,
+ *        seconds. The value may wrap around.
+ */
+typedef uint32_t (*oscore_echo_clock_t)(void);
+
+/**
+ * @brief Server secret for stateless Echo values, see RFC 9175 Appendix A.2.
+ *
+ * An Echo value is the time of its creation and a tag over the time, the ID Context and the
+ * Recipient ID of the context, keyed by the secret. It is verified by recomputing the tag, so the
+ * contexts store no Echo value, and an Echo value sent by one thread or process is accepted by
+ * any other that uses the same secret and a synchronized clock. A context accepts only values
+ * created after it sent the challenge itself, since a request recorded before it was restored
+ * may carry an older value which is still valid. One key is shared by all contexts of a server.
+ * It is read-only after oscore_echo_key_init() and can be used by several threads without a
+ * lock.
+ */
+struct oscore_echo_key {
+	struct hkdf_ctx prf; /* keyed with secret */
+	uint8_t secret[OSCORE_ECHO_SECRET_MAX_LEN];
+	oscore_echo_clock_t clock;
+	uint32_t lifetime; /* in units of the clock */
+};
+
+/**
+ * @brief Initialize a key. The key must not be moved or copied afterwards.
+ * @param key The key.
+ * @param secret Random server secret of 16 to OSCORE_ECHO_SECRET_MAX_LEN bytes. It should be
+ *        created at every boot, at least if the clock does not keep counting across reboots,
+ *        so that Echo values created before are rejected.
+ * @param clock Clock of the Echo values.
+ * @param lifetime Time after which an Echo value is rejected, in units of the clock.
+ * @return enum err ok, or error if failed.
+ */
+enum err oscore_echo_key_init(struct oscore_echo_key *key,
+			      const struct byte_array *secret,
+			      oscore_echo_clock_t clock, uint32_t lifetime);
+
+/**
+ * @brief Release a key and wipe the secret.
+ * @param key The key.
+ * @return enum err ok, or error if failed.
+ */
+enum err oscore_echo_key_deinit(struct oscore_echo_key *key);
+
+/**
+ * @brief Create an Echo value for the ECHO challenge of a context. The value is added as ECHO
+ *        option to the 4.01 (Unauthorized) response by the application.
+ * @param key The key.
+ * @param id_context ID Context of the context.
+ * @param recipient_id Recipient ID of the context, i.e., the KID of the client.
+ * @param echo [in/out] Buffer of at least OSCORE_ECHO_VAL_LEN bytes, the length is set to
+ *        OSCORE_ECHO_VAL_LEN.
+ * @return enum err ok, or error if failed.
+ */
+enum err oscore_echo_create(const struct oscore_echo_key *key,
+			    const struct byte_array *id_context,
+			    const struct byte_array *recipient_id,
+			    struct byte_array *echo);
+
+/**
+ * @brief Verify an Echo value received from a client.
+ * @param key The key.
+ * @param id_context ID Context of the context.
+ * @param recipient_id Recipient ID of the context.
+ * @param echo The Echo value.
+ * @param since Time of the clock when the challenge was sent, values created before are
+ *        rejected.
+ * @return enum err ok, echo_val_mismatch if the value was not created for this context with this
+ *         key, or echo_val_expired if it is older than the lifetime of the key or was created
+ *         before since.
+ */
+enum err oscore_echo_verify(const struct oscore_echo_key *key,
+			    const struct byte_array *id_context,
+			    const struct byte_array *recipient_id,
+			    const struct byte_array *echo, uint32_t since);
+
+#endif
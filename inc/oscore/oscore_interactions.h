@@ -18,82 +18,181 @@
 #include "common/oscore_edhoc_error.h"
 
 /**
- * @brief Number of interactions supported at the same time, per one OSCORE context.
+ * @brief Number of interactions supported at the same time by the storage inside the context. More
+ *        can be used with a pool provided by the user, see oscore_interactions_init_size().
  */
 #ifndef OSCORE_INTERACTIONS_COUNT
 #define OSCORE_INTERACTIONS_COUNT 3
 #endif
 
+/**
+ * @brief Maximum number of interactions of one context, the records are linked by 16 bit indexes.
+ */
+#define OSCORE_INTERACTIONS_MAX_COUNT 0xFFFE
+
+/**
+ * @brief Clock of the interactions, see oscore_interactions_expiry_set(). Returns the current
+ *        time in a unit chosen by the user, e.g., seconds. The value may wrap around.
+ */
+typedef uint32_t (*oscore_interactions_clock_t)(void);
+
 /**
  * @brief Single record of interaction between the server and the client.
  */
 struct oscore_interaction_t {
-	/* Request type, used to distinguish between normal request and resource observations. */
-	enum o_coap_msg request_type;
+	/* Hash of the full URI path (all options concatenated to single string), see
+	   uri_path_hash(). Only the hash is kept, so that the record doesn't depend on
+	   OSCORE_MAX_URI_PATH_LEN. */
+	uint64_t uri_paths_hash;
 
 	/* CoAP token of the subscription request. */
 	uint8_t token[MAX_TOKEN_LEN];
-	uint8_t token_len;
 
-	/* Full URI path (all options concatenated to single string). */
-	uint8_t uri_paths[OSCORE_MAX_URI_PATH_LEN];
-	uint8_t uri_paths_len;
+	/* KID of the subscription request. */
+	uint8_t request_kid[MAX_KID_LEN];
 
 	/* PIV of the subscription request. */
 	uint8_t request_piv[MAX_PIV_LEN];
-	uint8_t request_piv_len;
 
-	/* KID of the subscription request. */
-	uint8_t request_kid[MAX_KID_LEN];
+	uint8_t token_len;
 	uint8_t request_kid_len;
+	uint8_t request_piv_len;
+
+	/* Request type (enum o_coap_msg), used to distinguish between normal request and resource observations. */
+	uint8_t request_type;
 
-	/* True if given record is occupied (used in interactions array). */
+	/* True if given record is occupied (used in interactions table). */
 	bool is_occupied;
+
+	/* Time of the last set or get of the record, see oscore_interactions_clock_t. */
+	uint32_t last_used;
+
+	/* Hash chains, managed by the functions below. The record at index i also holds the first
+	   record of the token bucket i and of the resource bucket i, so that the pool is the only
+	   storage needed. Free records are chained by token_next. */
+	uint16_t token_next;
+	uint16_t resource_next;
+	uint16_t token_head;
+	uint16_t resource_head;
+	/* Buckets the record is linked in. They are stored, since the key fields of a record
+	   returned by oscore_interactions_get_record() may be changed before it is set again. */
+	uint16_t token_bucket;
+	uint16_t resource_bucket;
+	/* Chain of the occupied records from the most to the least recently used one. */
+	uint16_t lru_prev;
+	uint16_t lru_next;
+};
+
+/**
+ * @brief Interactions of one context: a pool of records with hashed lookup by token and by
+ *        (URI path, request type). Up to OSCORE_INTERACTIONS_COUNT records use the storage
+ *        inside the structure, more use a pool provided by the user.
+ */
+struct oscore_interactions {
+	struct oscore_interaction_t records_buf[OSCORE_INTERACTIONS_COUNT];
+	struct oscore_interaction_t *records_ext; /* user provided pool, NULL if records_buf is used */
+	uint32_t count; /* number of records in the pool */
+	uint16_t free_head; /* first free record */
+	uint16_t lru_head; /* most recently used record */
+	uint16_t lru_tail; /* least recently used record */
+	oscore_interactions_clock_t clock; /* NULL if the records never expire */
+	uint32_t idle_timeout; /* 0 if the records never expire */
 };
 
 /**
- * @brief Initialize interactions array.
+ * @brief Initialize interactions table with OSCORE_INTERACTIONS_COUNT records.
  * 
- * @param interactions Interactions array, MUST have exactly OSCORE_INTERACTIONS_COUNT elements.
+ * @param interactions Interactions table.
  * @return enum err ok, or error if failed.
  */
-enum err oscore_interactions_init(struct oscore_interaction_t *interactions);
+enum err oscore_interactions_init(struct oscore_interactions *interactions);
 
 /**
- * @brief Add new record to the interactions array, or replace the old one if it exists (URI paths field is used for comparison).
- * @note To be used while registering to given resource.
- * @param interactions Interactions array, MUST have exactly OSCORE_INTERACTIONS_COUNT elements.
- * @param record Single record to be added or updated.
+ * @brief Initialize interactions table with a given number of records.
+ * 
+ * @param interactions Interactions table.
+ * @param count Number of records, at most OSCORE_INTERACTIONS_MAX_COUNT.
+ * @param records Pool of count records, must stay valid as long as the table is used. Can be
+ *        NULL if count is at most OSCORE_INTERACTIONS_COUNT.
  * @return enum err ok, or error if failed.
  */
-enum err
-oscore_interactions_set_record(struct oscore_interaction_t *interactions,
-			       struct oscore_interaction_t *record);
+enum err oscore_interactions_init_size(struct oscore_interactions *interactions,
+				       uint32_t count,
+				       struct oscore_interaction_t *records);
+
+/**
+ * @brief Enable the expiry of records and the eviction of the least recently used record.
+ * @note Without a clock (the default after initialization), records stay until they are removed
+ *       and oscore_interactions_set_record() fails with oscore_max_interactions when the table is
+ *       full. With a clock, the least recently used record is replaced instead, and records that
+ *       were not used for longer than idle_timeout are dropped when they are found, replaced or
+ *       swept with oscore_interactions_sweep().
+ * @param interactions Interactions table.
+ * @param clock Clock stamping the records, or NULL to disable expiry and eviction.
+ * @param idle_timeout Time in units of the clock after which an unused record expires, or 0 if
+ *        records only leave the table when it is full.
+ * @return enum err ok, or error if failed.
+ */
+enum err oscore_interactions_expiry_set(struct oscore_interactions *interactions,
+					oscore_interactions_clock_t clock,
+					uint32_t idle_timeout);
+
+/**
+ * @brief Remove all expired records, e.g., periodically in a long-running server. Only the
+ *        expired records are visited, beginning with the least recently used one.
+ * @param interactions Interactions table.
+ * @param removed [out] Number of removed records, can be NULL.
+ * @return enum err ok, or error if failed.
+ */
+enum err oscore_interactions_sweep(struct oscore_interactions *interactions,
+				   uint32_t *removed);
+
+/**
+ * @brief Hash identifying a resource in the interaction records. Packets are hashed with
+ *        uri_path_hash() without composing their URI path.
+ * 
+ * @param uri_paths All URI path options concatenated to single string.
+ * @param uri_paths_len Length of the string.
+ * @return The hash.
+ */
+uint64_t oscore_interactions_uri_paths_hash(const uint8_t *uri_paths,
+					    uint32_t uri_paths_len);
+
+/**
+ * @brief Add new record to the interactions table, or replace the old one if it exists (URI paths hash and request type are used for comparison).
+ * @note To be used while registering to given resource. If the table is full and a clock is set,
+ *       the least recently used record is evicted.
+ * @param interactions Interactions table.
+ * @param record Single record to be added or updated. Its hash chain fields are ignored.
+ * @return enum err ok, or error if failed.
+ */
+enum err oscore_interactions_set_record(struct oscore_interactions *interactions,
+					struct oscore_interaction_t *record);
 
 /**
  * @brief Search for the record matching given token and return a pointer to it.
  * @note To be used while encrypting a notification on the server side, and confirming its AAD on the client side.
- * @param interactions Interactions array, MUST have exactly OSCORE_INTERACTIONS_COUNT elements.
+ *       The record becomes the most recently used one. An expired record is removed and not found.
+ * @param interactions Interactions table.
  * @param token Token buffer to match.
  * @param token_len Token buffer size.
  * @param record [out] Pointer to the matching record.
  * @return enum err ok, or error if failed.
  */
-enum err
-oscore_interactions_get_record(struct oscore_interaction_t *interactions,
-			       uint8_t *token, uint8_t token_len,
-			       struct oscore_interaction_t **record);
+enum err oscore_interactions_get_record(struct oscore_interactions *interactions,
+					uint8_t *token, uint8_t token_len,
+					struct oscore_interaction_t **record);
 
 /**
- * @brief Remove a record that matches given URI paths field.
+ * @brief Remove a record that matches given token.
  * @note To be used while de-registering to given resource.
- * @param interactions Interactions array, MUST have exactly OSCORE_INTERACTIONS_COUNT elements.
+ * @param interactions Interactions table.
  * @param token Token buffer to match.
  * @param token_len Token buffer size.
  * @return enum err ok, or error if failed.
  */
 enum err
-oscore_interactions_remove_record(struct oscore_interaction_t *interactions,
+oscore_interactions_remove_record(struct oscore_interactions *interactions,
 				  uint8_t *token, uint8_t token_len);
 
 /**
@@ -101,14 +200,14 @@ oscore_interactions_remove_record(struct oscore_interaction_t *interactions,
  * 
  * @param msg_type Message type of the packet.
  * @param token Token byte array. MUST NOT be NULL, but can be empty.
- * @param interactions Interactions array, MUST have exactly OSCORE_INTERACTIONS_COUNT elements.
+ * @param interactions Interactions table.
  * @param request_piv Output request_piv (to be updated if needed).
  * @param request_kid Output request_kid (to be updated if needed).
  * @return enum err ok, or error if failed.
  */
 enum err oscore_interactions_read_wrapper(
 	enum o_coap_msg msg_type, struct byte_array *token,
-	struct oscore_interaction_t *interactions,
+	struct oscore_interactions *interactions,
 	struct byte_array *request_piv, struct byte_array *request_kid);
 
 /**
@@ -116,15 +215,15 @@ enum err oscore_interactions_read_wrapper(
  * 
  * @param msg_type Message type of the packet.
  * @param token Token byte array. MUST NOT be NULL, but can be empty.
- * @param uri_paths URI Paths byte array. MUST NOT be null, but can be empty.
- * @param interactions Interactions array, MUST have exactly OSCORE_INTERACTIONS_COUNT elements.
+ * @param uri_paths_hash Hash of the URI Paths, see uri_path_hash().
+ * @param interactions Interactions table.
  * @param request_piv Current value of request_piv.
  * @param request_kid Current value of request_kid.
  * @return enum err ok, or error if failed.
  */
 enum err oscore_interactions_update_wrapper(
 	enum o_coap_msg msg_type, struct byte_array *token,
-	struct byte_array *uri_paths, struct oscore_interaction_t *interactions,
+	uint64_t uri_paths_hash, struct oscore_interactions *interactions,
 	struct byte_array *request_piv, struct byte_array *request_kid);
 
 #endif
@@ -0,0 +1,52 @@
+/*
+   Copyright (c) 2026 Fraunhofer AISEC. See the COPYRIGHT
+   file at the top-level directory of this distribution.
+
+   Licensed under the Apache License, Version 2.0 <LICENSE-APACHE or
+   http://www.apache.org/licenses/LICENSE-2.0> or the MIT license
+   <LICENSE-MIT or http://opensource.org/licenses/MIT>, at your
+   option. This file may not be copied, modified, or distributed
+   except according to those terms.
+*/
+
+#ifndef OSCORE_LOCK_H
+#define OSCORE_LOCK_H
+
+#include <stdbool.h>
+
+/**
+ * @brief Lock protecting one security context or one shard of a context store.
+ *
+ * The default implementation is a spinlock built on the atomic builtins of the compiler, so
+ * that no operating system is needed. The critical sections are short (one packet), but on
+ * systems where a thread holding the lock can be preempted by another thread spinning on it
+ * (e.g., with strict priorities), oscore_lock_acquire() and oscore_lock_release() should be
+ * overwritten by the user, e.g., to yield while waiting.
+ *
+ * The lock is part of the structs also without OSCORE_THREAD_SAFE, so that their layout is
+ * the same for the library and for applications built without the flag. It is a plain type,
+ * accessed atomically by the library only, so that the header can be used from C++.
+ */
+struct oscore_lock {
+	bool locked;
+};
+
+/**
+ * @brief Initialize a lock in the released state.
+ * @param l The lock.
+ */
+void oscore_lock_init(struct oscore_lock *l);
+
+/**
+ * @brief Acquire a lock, waiting until it is released by another thread.
+ * @param l The lock.
+ */
+void oscore_lock_acquire(struct oscore_lock *l);
+
+/**
+ * @brief Release a lock acquired with oscore_lock_acquire().
+ * @param l The lock.
+ */
+void oscore_lock_release(struct oscore_lock *l);
+
+#endif
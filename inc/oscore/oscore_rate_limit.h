@@ -0,0 +1,90 @@
+/*
+   Copyright (c) 2026 Fraunhofer AISEC. See the COPYRIGHT
+   file at the top-level directory of this distribution.
+
+   Licensed under the Apache License, Version 2.0 <LICENSE-APACHE or
+   http://www.apache.org/licenses/LICENSE-2.0> or the MIT license
+   <LICENSE-MIT or http://opensource.org/licenses/MIT>, at your
+   option. This file may not be copied, modified, or distributed
+   except according to those terms.
+*/
+
+#ifndef OSCORE_RATE_LIMIT_H
+#define OSCORE_RATE_LIMIT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "oscore/oscore_lock.h"
+
+#include "common/oscore_edhoc_error.h"
+
+/**
+ * @brief Clock of a rate limiter. Returns the current time in a unit chosen by the user, e.g.,
+ *        milliseconds. The value may wrap around.
+ */
+typedef uint32_t (*oscore_rate_limit_clock_t)(void);
+
+/**
+ * @brief Counters of a rate limiter, for monitoring what is being shed.
+ */
+struct oscore_rate_limit_stats {
+	uint32_t failures; /* authentication failures and rejected replays */
+	uint32_t shed; /* packets rejected by the limiter without decryption */
+};
+
+/**
+ * @brief Token bucket limiting the packets that fail, e.g., forged packets with a valid KID,
+ *        which would otherwise cost a decryption each.
+ *
+ * Each failure takes a token, and a token is added every interval up to burst tokens. While the
+ * bucket is empty, packets are rejected before their decryption. With OSCORE_THREAD_SAFE, the
+ * limiter has its own lock, so that one limiter can be shared, e.g., by the threads using a
+ * context store.
+ */
+struct oscore_rate_limit {
+	oscore_rate_limit_clock_t clock; /* NULL if packets are never rejected */
+	uint32_t burst;
+	uint32_t interval;
+	uint32_t tokens;
+	uint32_t last_refill;
+	struct oscore_rate_limit_stats stats;
+	struct oscore_lock lock; /* used with OSCORE_THREAD_SAFE only */
+};
+
+/**
+ * @brief Initialize a limiter with a full bucket.
+ * @param limit The limiter.
+ * @param clock Clock of the limiter, or NULL to only count the failures.
+ * @param burst Number of failures tolerated in a row, at least 1 if a clock is given.
+ * @param interval Time in units of the clock after which one more failure is tolerated, at
+ *        least 1 if a clock is given.
+ * @return enum err ok, or error if failed.
+ */
+enum err oscore_rate_limit_init(struct oscore_rate_limit *limit,
+				oscore_rate_limit_clock_t clock, uint32_t burst,
+				uint32_t interval);
+
+/**
+ * @brief Check if a packet may be processed. A rejected packet is counted as shed.
+ * @param limit The limiter.
+ * @return false if the bucket is empty.
+ */
+bool oscore_rate_limit_allow(struct oscore_rate_limit *limit);
+
+/**
+ * @brief Count a failed packet and take a token.
+ * @param limit The limiter.
+ */
+void oscore_rate_limit_failure(struct oscore_rate_limit *limit);
+
+/**
+ * @brief Read the counters of a limiter.
+ * @param limit The limiter.
+ * @param stats [out] The counters.
+ * @return enum err ok, or error if failed.
+ */
+enum err oscore_rate_limit_stats_get(struct oscore_rate_limit *limit,
+				     struct oscore_rate_limit_stats *stats);
+
+#endif
@@ -0,0 +1,133 @@
+/*
+   Copyright (c) 2026 Fraunhofer AISEC. See the COPYRIGHT
+   file at the top-level directory of this distribution.
+
+   Licensed under the Apache License, Version 2.0 <LICENSE-APACHE or
+   http://www.apache.org/licenses/LICENSE-2.0> or the MIT license
+   <LICENSE-MIT or http://opensource.org/licenses/MIT>, at your
+   option. This file may not be copied, modified, or distributed
+   except according to those terms.
+*/
+
+#ifndef OSCORE_RESPONSE_CACHE_H
+#define OSCORE_RESPONSE_CACHE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "oscore/oscore_coap_defines.h"
+
+#include "common/byte_array.h"
+#include "common/oscore_edhoc_error.h"
+
+/**
+ * @brief Maximum length of a cached OSCORE response. Longer responses are not cached.
+ */
+#ifndef OSCORE_RESPONSE_CACHE_MAX_LEN
+#define OSCORE_RESPONSE_CACHE_MAX_LEN 256
+#endif
+
+/**
+ * @brief Length of the SHA-256 digest of a request datagram, see oscore_response_cache_digest().
+ */
+#define OSCORE_RESPONSE_CACHE_DIGEST_LEN 32
+
+/**
+ * @brief Clock of a response cache. Returns the current time in a unit chosen by the user, e.g.,
+ *        seconds. The value may wrap around.
+ */
+typedef uint32_t (*oscore_response_cache_clock_t)(void);
+
+/**
+ * @brief Protected response to a confirmable request, kept to answer retransmissions of the
+ *        request (RFC 7252 p. 4.5).
+ */
+struct oscore_cached_response {
+	/* Time the response was stored, see oscore_response_cache_clock_t. */
+	uint32_t stored;
+	/* Length of the serialized OSCORE response. */
+	uint32_t len;
+	/* Message ID of the request and of its piggybacked response. */
+	uint16_t mid;
+	/* PIV of the request. */
+	uint8_t request_piv[MAX_PIV_LEN];
+	uint8_t request_piv_len;
+	/* Digest of the request. The key is not authenticated before the lookup, only a byte-identical
+	   retransmission of the request gets the response. */
+	uint8_t request_digest[OSCORE_RESPONSE_CACHE_DIGEST_LEN];
+	/* True if the entry holds a response. */
+	bool is_occupied;
+	uint8_t buf[OSCORE_RESPONSE_CACHE_MAX_LEN];
+};
+
+/**
+ * @brief Responses of one context, keyed by (PIV, Message ID) of their requests. The Recipient ID
+ *        of the key is the one of the context. The entries are provided by the user and searched
+ *        linearly, so the cache is meant to be small.
+ */
+struct oscore_response_cache {
+	struct oscore_cached_response *entries; /* NULL if responses are not cached */
+	uint32_t count;
+	oscore_response_cache_clock_t clock;
+	uint32_t lifetime;
+};
+
+/**
+ * @brief Initialize an empty cache.
+ * @param cache The cache.
+ * @param entries Storage for count entries, must stay valid as long as the cache is used, or NULL
+ *        to disable caching.
+ * @param count Number of entries.
+ * @param clock Clock stamping the entries, required if entries are given.
+ * @param lifetime Time in units of the clock after which a response is dropped, at least 1 if
+ *        entries are given. E.g., EXCHANGE_LIFETIME of RFC 7252, 247 seconds by default.
+ * @return enum err ok, or error if failed.
+ */
+enum err oscore_response_cache_init(struct oscore_response_cache *cache,
+				    struct oscore_cached_response *entries,
+				    uint32_t count,
+				    oscore_response_cache_clock_t clock,
+				    uint32_t lifetime);
+
+/**
+ * @brief Store the protected response to a request. An entry with the same key, a free or expired
+ *        entry, or else the oldest entry is used.
+ * @note Responses longer than OSCORE_RESPONSE_CACHE_MAX_LEN are not stored.
+ * @param cache The cache.
+ * @param request_piv PIV of the request.
+ * @param mid Message ID of the request.
+ * @param request_digest Digest of the request, see oscore_response_cache_digest().
+ * @param response Serialized OSCORE response.
+ * @return enum err ok, or error if failed.
+ */
+enum err oscore_response_cache_put(struct oscore_response_cache *cache,
+				   const struct byte_array *request_piv,
+				   uint16_t mid,
+				   const struct byte_array *request_digest,
+				   const struct byte_array *response);
+
+/**
+ * @brief Find the response to a request. An entry with the same key but another digest is kept, 
+ *        the request is then no retransmission and goes through the replay protection.
+ * @param cache The cache.
+ * @param request_piv PIV of the request.
+ * @param mid Message ID of the request.
+ * @param request_digest Digest of the request, see oscore_response_cache_digest().
+ * @return The entry, or NULL if there is no such response or it expired.
+ */
+const struct oscore_cached_response *
+oscore_response_cache_get(struct oscore_response_cache *cache,
+			  const struct byte_array *request_piv, uint16_t mid,
+			  const struct byte_array *request_digest);
+
+/**
+ * @brief Compute the digest of a serialized request, which identifies its retransmissions.
+ * @param request The OSCORE request as received.
+ * @param digest Buffer of at least OSCORE_RESPONSE_CACHE_DIGEST_LEN bytes on input, the digest on 
+ *        output.
+ * @return enum err ok, or error if failed.
+ */
+enum err oscore_response_cache_digest(const struct byte_array *request,
+				      struct byte_array *digest);
+
+#endif
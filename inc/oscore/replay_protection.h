@@ -13,10 +13,25 @@
 #define OSCORE_SERVER_REPLAY_WINDOW_SIZE 32
 #endif
 
-/* Replay window structure, used internally. */
+/* Largest window size that can be selected for a recipient context at runtime. */
+#ifndef OSCORE_SERVER_REPLAY_WINDOW_MAX_SIZE
+#define OSCORE_SERVER_REPLAY_WINDOW_MAX_SIZE 1024
+#endif
+
+/* Number of 64 bit words needed to store a window of a given size. */
+#define REPLAY_WINDOW_WORDS(size) (((size) + 63) / 64)
+
+/* Replay window structure, used internally.
+   Sliding window as described in RFC 4303 Appendix A: the highest received sequence number
+   and one bit for each sequence number of the window below it. The bits are kept in a ring
+   indexed by the sequence number, so sliding the window doesn't move any data.
+   Windows of up to OSCORE_SERVER_REPLAY_WINDOW_SIZE entries use the storage inside the
+   structure, larger ones use a buffer provided by the user. */
 struct server_replay_window_t {
-	uint64_t window[OSCORE_SERVER_REPLAY_WINDOW_SIZE];
-	bool seq_num_zero_received; /* helper flag used for validation of sequence number 0 */
+	uint64_t bitmap_buf[REPLAY_WINDOW_WORDS(OSCORE_SERVER_REPLAY_WINDOW_SIZE)];
+	uint64_t *bitmap_ext; /* user provided storage, NULL if bitmap_buf is used */
+	uint64_t highest; /* highest received sequence number */
+	uint32_t size; /* number of sequence numbers covered by the window */
 };
 
 /**
@@ -27,12 +42,26 @@ struct server_replay_window_t {
  */
 enum err server_replay_window_init(struct server_replay_window_t *replay_window);
 
+/**
+ * @brief Initialize given replay window with a window size selected at runtime.
+ *
+ * @param replay_window [out] a pointer to replay window structure
+ * @param size [in] window size, from 1 to OSCORE_SERVER_REPLAY_WINDOW_MAX_SIZE
+ * @param bitmap [in] storage of REPLAY_WINDOW_WORDS(size) words, which must stay valid
+ *                    as long as the window is used. NULL to use the storage inside the
+ *                    structure, which is sufficient for up to OSCORE_SERVER_REPLAY_WINDOW_SIZE.
+ * @return err
+ */
+enum err server_replay_window_init_size(struct server_replay_window_t *replay_window,
+					uint32_t size, uint64_t *bitmap);
+
 /**
  * @brief Re-initialize given replay window based on current sequence number.
  *
  * This could be used by the user to restore the session.
  * After restoring, replay protection will reject any packet with sequence number
  * that is not greater than the one provided in the argument.
+ * The window size and storage selected at initialization are kept.
  *
  * @param current_sequence_number [in] last sequence number that was received before the session was stored
  * @param replay_window [out] a pointer to replay window structure
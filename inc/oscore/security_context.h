@@ -16,8 +16,14 @@
 #include "oscore_coap.h"
 #include "oscore/replay_protection.h"
 #include "oscore/oscore_interactions.h"
+#include "oscore/nvm.h"
+#include "oscore/oscore_lock.h"
+#include "oscore/oscore_rate_limit.h"
+#include "oscore/oscore_response_cache.h"
+#include "oscore/oscore_echo.h"
 
 #include "common/byte_array.h"
+#include "common/crypto_wrapper.h"
 #include "common/oscore_edhoc_error.h"
 
 /* Upper limit of SSN that is allowed by AEAD algorithm (AES-CCM-16-64-128) is 2^23-1, according to RFC 9053 p. 4.2.1.
@@ -40,6 +46,7 @@ enum echo_state {
 	ECHO_REBOOT, /* default value after reboot */
 	ECHO_VERIFY, /* verification in progress */
 	ECHO_SYNCHRONIZED, /* synchronized, normal operation */
+	ECHO_RESTORED, /* replay window restored from NVM, older requests get the challenge */
 };
 
 /**
@@ -56,13 +63,33 @@ struct common_context {
 	uint8_t common_iv_buf[COMMON_IV_LEN];
 };
 
+/* Sender Sequence Number. With OSCORE_THREAD_SAFE the library accesses it 
+   atomically, see ssn_atomic_load(), so that blocks of SSNs can be reserved 
+   without the lock of the context. It is a plain type, so that the layout 
+   does not depend on the flag and the header can be used from C++. */
+typedef uint64_t oscore_ssn_t;
+
 /* Sender Context used for encrypting outbound messages */
 struct sender_context {
 	struct byte_array sender_id;
 	uint8_t sender_id_buf[7];
 	struct byte_array sender_key;
 	uint8_t sender_key_buf[SENDER_KEY_LEN_];
-	uint64_t ssn;
+	struct aead_key sender_key_handle; /*bound once at context init*/
+	oscore_ssn_t ssn;
+	/*the following fields are used with OSCORE_NVM_SUPPORT only, they are 
+	always present so that the layout does not depend on the flag*/
+	oscore_ssn_t ssn_in_nvm; /*last SSN written in NVM*/
+	oscore_ssn_t ssn_nvm_bound; /*SSNs below are covered by the value in NVM*/
+	oscore_ssn_t ssn_nvm_request_at; /*a write-behind is requested above*/
+	oscore_ssn_t ssn_nvm_requested; /*SSN when the last write-behind was requested*/
+	oscore_ssn_t ssn_nvm_pending; /*bound of a deferred write, see oscore_ssn_durable()*/
+	oscore_ssn_write_request_t ssn_write_request; /*NULL for synchronous writes*/
+	uint32_t ssn_interval; /*SSNs reserved by the next write*/
+	oscore_ssn_clock_t ssn_clock; /*NULL for a fixed interval*/
+	uint32_t ssn_write_period;
+	uint32_t ssn_last_write; /*time of the last write*/
+	struct oscore_lock nvm_lock; /*held while the SSN is written in NVM*/
 };
 
 /* Recipient Context used to decrypt inbound messages */
@@ -70,10 +97,16 @@ struct recipient_context {
 	struct byte_array recipient_id;
 	struct byte_array recipient_key;
 	uint8_t recipient_key_buf[RECIPIENT_KEY_LEN_];
+	struct aead_key recipient_key_handle; /*bound once at context init*/
 	uint8_t recipient_id_buf[RECIPIENT_ID_BUFF_LEN];
 	struct server_replay_window_t replay_window;
 	uint64_t notification_num;
 	bool notification_num_initialized; /* this is only used to skip the first notification check after the reboot */
+	struct oscore_rate_limit failure_limit; /*failed decryptions and replays*/
+	/*used with OSCORE_NVM_SUPPORT only, always present so that the layout 
+	does not depend on the flag*/
+	uint64_t replay_bound; /*requests from here on need a new bound in NVM*/
+	uint32_t replay_bound_interval; /*0 if no bound is stored*/
 };
 
 /*request-response context contains parameters that need to persists between
@@ -82,10 +115,15 @@ struct req_resp_context {
 	struct byte_array nonce;
 	uint8_t nonce_buf[NONCE_LEN];
 
-	struct oscore_interaction_t interactions[OSCORE_INTERACTIONS_COUNT];
+	struct oscore_interactions interactions;
+
+	struct oscore_response_cache responses; /*for retransmitted requests*/
+	uint8_t request_digest[OSCORE_RESPONSE_CACHE_DIGEST_LEN]; /*of the last accepted request*/
 
 	struct byte_array echo_opt_val;
 	uint8_t echo_opt_val_buf[ECHO_OPT_VALUE_LEN];
+	const struct oscore_echo_key *echo_key; /*NULL if echo_opt_val is used*/
+	uint32_t echo_challenge_time; /*clock of echo_key when the challenge was sent*/
 
 	enum echo_state echo_state_machine;
 };
@@ -96,6 +134,7 @@ struct context {
 	struct common_context cc;
 	struct sender_context sc;
 	struct recipient_context rc;
+	struct oscore_lock lock; /*held while a packet is processed, with OSCORE_THREAD_SAFE only*/
 };
 
 /**
@@ -132,4 +171,35 @@ enum err update_request_piv_request_kid(struct context *c,
  * @return enum err 
  */
 enum err check_context_freshness(struct context *c);
+
+/**
+ * @brief Reads an SSN field of a sender context, atomically with 
+ *        OSCORE_THREAD_SAFE, since other threads may change it without the 
+ *        lock of the context.
+ * @param ssn The field.
+ * @return The value.
+ */
+uint64_t ssn_atomic_load(const oscore_ssn_t *ssn);
+
+/**
+ * @brief Writes an SSN field of a sender context, atomically with 
+ *        OSCORE_THREAD_SAFE.
+ * @param ssn The field.
+ * @param value The new value.
+ */
+void ssn_atomic_store(oscore_ssn_t *ssn, uint64_t value);
+
+/**
+ * @brief Gives the calling thread exclusive access to a security context, 
+ *        i.e., to its SSN, replay window and interactions. Does nothing 
+ *        if OSCORE_THREAD_SAFE is not defined.
+ * @param c security context.
+ */
+void context_lock(struct context *c);
+
+/**
+ * @brief Releases a context locked with context_lock().
+ * @param c security context.
+ */
+void context_unlock(struct context *c);
 #endif
@@ -29,5 +29,6 @@ enum AEAD_algorithm {
 #define RECIPIENT_ID_BUFF_LEN 8
 #define SENDER_KEY_LEN_ MASTER_SECRET_LEN_
 #define RECIPIENT_KEY_LEN_ MASTER_SECRET_LEN_
+#define PRK_LEN 32 /*output of HKDF SHA256 extract*/
 
 #endif
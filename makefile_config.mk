@@ -48,6 +48,20 @@ CBOR_ENGINE += -DZCBOR
 # Uncomment to enable Non-volatile memory (NVM) support for storing security context between device reboots
 OSCORE_NVM_SUPPORT += -DOSCORE_NVM_SUPPORT
 
+# Uncomment to build a store for the SSNs of many contexts in a memory-mapped
+# file (POSIX systems only), see inc/oscore/nvm_file.h. The NVM hooks must 
+# still be overwritten by the user to use it.
+#OSCORE_NVM_SUPPORT += -DOSCORE_NVM_FILE
+
+################################################################################
+# Multithreading
+################################################################################
+# Uncomment to use OSCORE contexts and context stores from several threads at 
+# the same time. Each context gets a lock which is held while a packet is 
+# processed. Note that the crypto engine must be thread safe as well, e.g., 
+# mbedtls must be built with MBEDTLS_THREADING_C.
+#FEATURES += -DOSCORE_THREAD_SAFE
+
 ################################################################################
 # RAM optimization
 ################################################################################
@@ -158,4 +172,11 @@ FEATURES += -DI_OPTIONS_BUFF_MAX_LEN=100
 
 #CRYPTO_ENGINE += -DTINYCRYPT
 CRYPTO_ENGINE += -DCOMPACT25519
-CRYPTO_ENGINE += -DMBEDTLS
\ No newline at end of file
+CRYPTO_ENGINE += -DMBEDTLS
+
+# AES-CCM (OSCORE and EDHOC suites 0-3) with the AES instructions of the CPU 
+# (AES-NI on x86/x86_64, Cryptography Extensions on ARMv8). The CPU support is 
+# checked at runtime, when the instructions are not available TINYCRYPT or 
+# MBEDTLS is used as a fallback. Therefore AES_HW must be combined with one of 
+# them.
+#CRYPTO_ENGINE += -DAES_HW
\ No newline at end of file
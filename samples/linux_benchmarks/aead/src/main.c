@@ -0,0 +1,150 @@
+/*
+   Copyright (c) 2026 Fraunhofer AISEC. See the COPYRIGHT
+   file at the top-level directory of this distribution.
+
+   Licensed under the Apache License, Version 2.0 <LICENSE-APACHE or
+   http://www.apache.org/licenses/LICENSE-2.0> or the MIT license
+   <LICENSE-MIT or http://opensource.org/licenses/MIT>, at your
+   option. This file may not be copied, modified, or distributed
+   except according to those terms.
+*/
+
+/*
+ * Measures the cost of AES-CCM-16-64-128 encryption and decryption through 
+ * the crypto wrapper for typical CoAP payload sizes. With AES_HW the AES 
+ * instructions of the CPU are compared against the fallback engine.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#include "common/crypto_wrapper.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define UNIT "cycles/byte"
+static uint64_t now(void)
+{
+	return __rdtsc();
+}
+#else
+#define UNIT "ns/byte"
+static uint64_t now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+#endif
+
+#define TAG_LEN 8
+#define MAX_PAYLOAD_LEN 1024
+#define BYTES_PER_RUN (8u * 1024u * 1024u)
+
+static uint8_t key_buf[16] = { 0xf0, 0x91, 0x0e, 0xd7, 0x29, 0x5e, 0x6a, 0xd4,
+			       0xb5, 0x4f, 0xc7, 0x93, 0x15, 0x43, 0x02, 0xff };
+static uint8_t nonce_buf[13] = { 0x46, 0x22, 0xd4, 0xdd, 0x6d, 0x94, 0x41,
+				 0x68, 0xee, 0xfb, 0x54, 0x98, 0x68 };
+/*size of a typical OSCORE AAD (Encrypt0 structure)*/
+static uint8_t aad_buf[20];
+static uint8_t plaintext_buf[MAX_PAYLOAD_LEN];
+static uint8_t ciphertext_buf[MAX_PAYLOAD_LEN + TAG_LEN];
+static uint8_t decrypted_buf[MAX_PAYLOAD_LEN];
+
+static int run(const char *name, uint32_t payload_len)
+{
+	struct byte_array key = BYTE_ARRAY_INIT(key_buf, sizeof(key_buf));
+	struct byte_array nonce = BYTE_ARRAY_INIT(nonce_buf, sizeof(nonce_buf));
+	struct byte_array aad = BYTE_ARRAY_INIT(aad_buf, sizeof(aad_buf));
+	struct byte_array pt = BYTE_ARRAY_INIT(plaintext_buf, payload_len);
+	struct byte_array ct = BYTE_ARRAY_INIT(ciphertext_buf, payload_len);
+	struct byte_array ct_tag =
+		BYTE_ARRAY_INIT(ciphertext_buf, payload_len + TAG_LEN);
+	struct byte_array tag =
+		BYTE_ARRAY_INIT(ciphertext_buf + payload_len, TAG_LEN);
+	struct byte_array dec = BYTE_ARRAY_INIT(decrypted_buf, payload_len);
+	struct aead_key bound_key;
+	uint32_t iterations = BYTES_PER_RUN / payload_len;
+
+	if (ok != aead_key_init(&key, TAG_LEN, &bound_key)) {
+		printf("aead_key_init failed\n");
+		return -1;
+	}
+
+	uint64_t start = now();
+	for (uint32_t i = 0; i < iterations; i++) {
+		nonce_buf[12] = (uint8_t)i;
+		ct.len = payload_len;
+		if (ok != aead_with_key(ENCRYPT, &pt, &bound_key, &nonce, &aad,
+					&ct, &tag)) {
+			printf("encryption failed\n");
+			return -1;
+		}
+	}
+	uint64_t enc = now() - start;
+
+	start = now();
+	for (uint32_t i = 0; i < iterations; i++) {
+		if (ok != aead_with_key(DECRYPT, &ct_tag, &bound_key, &nonce,
+					&aad, &dec, &tag)) {
+			printf("decryption failed\n");
+			return -1;
+		}
+	}
+	uint64_t dec_time = now() - start;
+
+	/*one-shot API, the key is bound for every packet*/
+	start = now();
+	for (uint32_t i = 0; i < iterations; i++) {
+		ct.len = payload_len;
+		if (ok != aead(ENCRYPT, &pt, &key, &nonce, &aad, &ct, &tag)) {
+			printf("encryption failed\n");
+			return -1;
+		}
+	}
+	uint64_t one_shot = now() - start;
+
+	aead_key_deinit(&bound_key);
+
+	double bytes = (double)iterations * payload_len;
+	printf("%-10s %6u %14.2f %14.2f %14.2f\n", name, payload_len,
+	       (double)enc / bytes, (double)dec_time / bytes,
+	       (double)one_shot / bytes);
+	return 0;
+}
+
+static int run_all(const char *name)
+{
+	const uint32_t payload_lens[] = { 16, 64, 256, MAX_PAYLOAD_LEN };
+
+	for (uint32_t i = 0; i < sizeof(payload_lens) / sizeof(payload_lens[0]);
+	     i++) {
+		if (0 != run(name, payload_lens[i])) {
+			return -1;
+		}
+	}
+	return 0;
+}
+
+int main(void)
+{
+	memset(plaintext_buf, 0xa5, sizeof(plaintext_buf));
+
+	printf("AES-CCM-16-64-128, values in " UNIT "\n");
+	printf("%-10s %6s %14s %14s %14s\n", "engine", "len", "encrypt",
+	       "decrypt", "encrypt+bind");
+
+#ifdef AES_HW
+	if (aes_hw_available()) {
+		if (0 != run_all("aes_hw")) {
+			return -1;
+		}
+	} else {
+		printf("AES instructions not supported by this CPU\n");
+	}
+	aes_hw_enable(false);
+#endif
+	return run_all("fallback");
+}
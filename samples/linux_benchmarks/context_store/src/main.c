@@ -0,0 +1,265 @@
+/*
+   Copyright (c) 2026 Fraunhofer AISEC. See the COPYRIGHT
+   file at the top-level directory of this distribution.
+
+   Licensed under the Apache License, Version 2.0 <LICENSE-APACHE or
+   http://www.apache.org/licenses/LICENSE-2.0> or the MIT license
+   <LICENSE-MIT or http://opensource.org/licenses/MIT>, at your
+   option. This file may not be copied, modified, or distributed
+   except according to those terms.
+*/
+
+/*
+ * Stress test and scaling benchmark of a sharded context store used by
+ * several threads. Each thread protects requests with client contexts and
+ * unprotects them with oscore2coap_store(). In the "spread" workload every
+ * thread serves its own clients, in the "hot" workload all threads send
+ * and receive with the same client, so that the SSN and the replay window
+ * of one context are contended. The "blocks" workload is the hot one, but the
+ * threads take their SSNs from own blocks with coap2oscore_ssn_block().
+ */
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "oscore.h"
+
+#ifndef OSCORE_THREAD_SAFE
+#error "Enable OSCORE_THREAD_SAFE in makefile_config.mk"
+#endif
+
+#define MAX_THREADS 64
+#define CLIENTS 256
+#define SLOTS_PER_SHARD 512
+#define PACKETS_PER_THREAD 100000u
+#define SSN_BLOCK_SIZE 64
+#define REPLAY_WINDOW_SIZE OSCORE_SERVER_REPLAY_WINDOW_MAX_SIZE
+
+/*GET coap://localhost/tv1 of RFC 8613 Appendix C.4*/
+static const uint8_t COAP_REQ[] = { 0x44, 0x01, 0x5d, 0x1f, 0x00, 0x00,
+				    0x39, 0x74, 0x39, 0x6c, 0x6f, 0x63,
+				    0x61, 0x6c, 0x68, 0x6f, 0x73, 0x74,
+				    0x83, 0x74, 0x76, 0x31 };
+static uint8_t MASTER_SECRET[16] = { 0x01, 0x02, 0x03, 0x04, 0x05, 0x06,
+				     0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c,
+				     0x0d, 0x0e, 0x0f, 0x10 };
+static uint8_t SERVER_ID[] = { 0x00 };
+
+static struct context clients[CLIENTS];
+static struct context servers[CLIENTS];
+static uint8_t client_ids[CLIENTS][2];
+static uint64_t replay_bitmaps[CLIENTS][REPLAY_WINDOW_WORDS(REPLAY_WINDOW_SIZE)];
+
+static struct oscore_context_store store;
+static struct oscore_context_shard shards[MAX_THREADS];
+static struct context *slots[MAX_THREADS * SLOTS_PER_SHARD];
+
+static atomic_uint failures;
+static atomic_uint replayed;
+
+enum workload { SPREAD, HOT, BLOCKS };
+static const char *const workload_names[] = { "spread", "hot", "blocks" };
+
+struct worker {
+	pthread_t thread;
+	uint32_t id;
+	uint32_t threads;
+	enum workload workload;
+};
+
+/*fresh contexts are used, the SSN does not need to survive a reboot*/
+enum err nvm_write_ssn(const struct nvm_key_t *nvm_key, uint64_t ssn)
+{
+	(void)nvm_key;
+	(void)ssn;
+	return ok;
+}
+
+static uint64_t now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static int contexts_init(uint32_t threads)
+{
+	if (ok != oscore_context_store_init(&store, shards, threads, slots,
+					    SLOTS_PER_SHARD)) {
+		return -1;
+	}
+
+	for (uint32_t i = 0; i < CLIENTS; i++) {
+		client_ids[i][0] = (uint8_t)(i >> 8);
+		client_ids[i][1] = (uint8_t)i;
+		struct oscore_init_params client = {
+			.master_secret = BYTE_ARRAY_INIT(MASTER_SECRET,
+							 sizeof(MASTER_SECRET)),
+			.sender_id = BYTE_ARRAY_INIT(client_ids[i],
+						     sizeof(client_ids[i])),
+			.recipient_id =
+				BYTE_ARRAY_INIT(SERVER_ID, sizeof(SERVER_ID)),
+			.aead_alg = OSCORE_AES_CCM_16_64_128,
+			.hkdf = OSCORE_SHA_256,
+			.fresh_master_secret_salt = true,
+		};
+		struct oscore_init_params server = {
+			.master_secret = BYTE_ARRAY_INIT(MASTER_SECRET,
+							 sizeof(MASTER_SECRET)),
+			.sender_id =
+				BYTE_ARRAY_INIT(SERVER_ID, sizeof(SERVER_ID)),
+			.recipient_id = BYTE_ARRAY_INIT(client_ids[i],
+							sizeof(client_ids[i])),
+			.aead_alg = OSCORE_AES_CCM_16_64_128,
+			.hkdf = OSCORE_SHA_256,
+			.fresh_master_secret_salt = true,
+			/*in the hot workload the threads deliver the requests
+			of one client out of order*/
+			.replay_window_size = REPLAY_WINDOW_SIZE,
+			.replay_window_bitmap = replay_bitmaps[i],
+		};
+		if ((ok != oscore_context_init(&client, &clients[i])) ||
+		    (ok != oscore_context_init(&server, &servers[i])) ||
+		    (ok != oscore_context_store_insert(&store, &servers[i]))) {
+			return -1;
+		}
+	}
+	return 0;
+}
+
+static void contexts_deinit(void)
+{
+	for (uint32_t i = 0; i < CLIENTS; i++) {
+		oscore_context_deinit(&clients[i]);
+		oscore_context_deinit(&servers[i]);
+	}
+}
+
+static void *work(void *arg)
+{
+	struct worker *w = arg;
+	uint8_t oscore_buf[64];
+	uint8_t coap_buf[64];
+	uint32_t client = w->id % CLIENTS;
+	struct oscore_ssn_block block = { .size = SSN_BLOCK_SIZE };
+
+	for (uint32_t i = 0; i < PACKETS_PER_THREAD; i++) {
+		if (SPREAD == w->workload) {
+			/*the clients of this thread in turn*/
+			client += w->threads;
+			if (client >= CLIENTS) {
+				client = w->id % CLIENTS;
+			}
+		} else {
+			client = 0;
+		}
+
+		uint32_t oscore_len = sizeof(oscore_buf);
+		uint32_t coap_len = sizeof(coap_buf);
+		struct context *c;
+		enum err r;
+		if (BLOCKS == w->workload) {
+			r = coap2oscore_ssn_block((uint8_t *)COAP_REQ,
+						  sizeof(COAP_REQ), oscore_buf,
+						  &oscore_len, &clients[client],
+						  &block);
+		} else {
+			r = coap2oscore((uint8_t *)COAP_REQ, sizeof(COAP_REQ),
+					oscore_buf, &oscore_len,
+					&clients[client]);
+		}
+		if (ok != r) {
+			atomic_fetch_add(&failures, 1);
+			continue;
+		}
+		r = oscore2coap_store(oscore_buf, oscore_len, coap_buf,
+					       &coap_len, &store, &c);
+		if (oscore_replay_window_protection_error == r) {
+			atomic_fetch_add(&replayed, 1);
+		} else if ((ok != r) || (c != &servers[client]) ||
+			   (coap_len != sizeof(COAP_REQ)) ||
+			   (0 != memcmp(coap_buf, COAP_REQ, coap_len))) {
+			atomic_fetch_add(&failures, 1);
+		}
+	}
+	return NULL;
+}
+
+static int run(uint32_t threads, enum workload workload)
+{
+	struct worker workers[MAX_THREADS];
+
+	if (0 != contexts_init(threads)) {
+		printf("context initialization failed\n");
+		return -1;
+	}
+	atomic_store(&failures, 0);
+	atomic_store(&replayed, 0);
+
+	uint64_t start = now();
+	for (uint32_t i = 0; i < threads; i++) {
+		workers[i].id = i;
+		workers[i].threads = threads;
+		workers[i].workload = workload;
+		pthread_create(&workers[i].thread, NULL, work, &workers[i]);
+	}
+	for (uint32_t i = 0; i < threads; i++) {
+		pthread_join(workers[i].thread, NULL);
+	}
+	uint64_t duration = now() - start;
+
+	/*every request got its own SSN, the unused rest of the last block of 
+	each thread is lost*/
+	uint64_t packets = (uint64_t)threads * PACKETS_PER_THREAD;
+	uint64_t ssn_sum = 0;
+	for (uint32_t i = 0; i < CLIENTS; i++) {
+		ssn_sum += clients[i].sc.ssn;
+	}
+	contexts_deinit();
+	bool ssn_ok = (ssn_sum == packets);
+	if (BLOCKS == workload) {
+		ssn_ok = (ssn_sum >= packets) &&
+			 (ssn_sum < packets + threads * SSN_BLOCK_SIZE);
+	}
+
+	printf("%-8s %8u %14.0f %10u %10u %s\n", workload_names[workload],
+	       threads, (double)packets * 1e9 / (double)duration,
+	       atomic_load(&replayed), atomic_load(&failures),
+	       ssn_ok ? "ok" : "SSN LOST");
+	return ((0 == atomic_load(&failures)) && ssn_ok) ? 0 : -1;
+}
+
+int main(int argc, char **argv)
+{
+	long cores = sysconf(_SC_NPROCESSORS_ONLN);
+	uint32_t max_threads = (cores > MAX_THREADS) ? MAX_THREADS :
+						       (uint32_t)cores;
+	/*more threads than cores can be given to stress the locks*/
+	if (argc > 1) {
+		max_threads = (uint32_t)strtoul(argv[1], NULL, 10);
+		if ((0 == max_threads) || (max_threads > MAX_THREADS)) {
+			printf("usage: %s [threads, at most %u]\n", argv[0],
+			       MAX_THREADS);
+			return -1;
+		}
+	}
+	int result = 0;
+
+	printf("%ld cores, %u requests per thread\n", cores,
+	       PACKETS_PER_THREAD);
+	printf("%-8s %8s %14s %10s %10s %s\n", "workload", "threads",
+	       "requests/s", "replayed", "failures", "SSNs");
+	for (enum workload w = SPREAD; w <= BLOCKS; w++) {
+		for (uint32_t threads = 1; threads <= max_threads;
+		     threads *= 2) {
+			result |= run(threads, w);
+		}
+	}
+	return result;
+}
@@ -0,0 +1,161 @@
+/*
+   Copyright (c) 2026 Fraunhofer AISEC. See the COPYRIGHT
+   file at the top-level directory of this distribution.
+
+   Licensed under the Apache License, Version 2.0 <LICENSE-APACHE or
+   http://www.apache.org/licenses/LICENSE-2.0> or the MIT license
+   <LICENSE-MIT or http://opensource.org/licenses/MIT>, at your
+   option. This file may not be copied, modified, or distributed
+   except according to those terms.
+*/
+
+/*
+ * Measures the cost of finding the security context of a request by its KID
+ * in a server with many contexts: the hash-indexed context table against a
+ * linear search over all contexts.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "oscore/oscore_context_table.h"
+
+#define MAX_CONTEXTS 50000
+#define MAX_ID_LEN 4
+#define LOOKUPS 1000000u
+
+static uint8_t ids[MAX_CONTEXTS][MAX_ID_LEN];
+static uint32_t order[LOOKUPS];
+
+static uint64_t now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/*xorshift, the benchmark needs no cryptographic quality*/
+static uint32_t rnd(void)
+{
+	static uint32_t x = 2463534242u;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	return x;
+}
+
+static struct context *linear_find(struct context *contexts, uint32_t cnt,
+				   struct byte_array *id_context,
+				   struct byte_array *kid)
+{
+	for (uint32_t i = 0; i < cnt; i++) {
+		if (array_equals(&contexts[i].rc.recipient_id, kid) &&
+		    array_equals(&contexts[i].cc.id_context, id_context)) {
+			return &contexts[i];
+		}
+	}
+	return NULL;
+}
+
+static int run(uint32_t cnt)
+{
+	struct context *contexts = calloc(cnt, sizeof(struct context));
+	/*keep the load factor below 3/4*/
+	uint32_t slots_cnt = 4;
+	while (slots_cnt / 4 * 3 < cnt) {
+		slots_cnt *= 2;
+	}
+	struct context **slots = calloc(slots_cnt, sizeof(struct context *));
+	if ((NULL == contexts) || (NULL == slots)) {
+		printf("out of memory\n");
+		return -1;
+	}
+
+	struct oscore_context_table table;
+	if (ok != oscore_context_table_init(&table, slots, slots_cnt)) {
+		printf("oscore_context_table_init failed\n");
+		return -1;
+	}
+
+	/*Recipient IDs of 2 to 4 bytes*/
+	uint64_t start = now();
+	for (uint32_t i = 0; i < cnt; i++) {
+		uint32_t len = 2 + (i % 3);
+		for (uint32_t j = 0; j < len; j++) {
+			ids[i][j] = (uint8_t)(i >> (8 * j));
+		}
+		contexts[i].rc.recipient_id.ptr = ids[i];
+		contexts[i].rc.recipient_id.len = len;
+		if (ok != oscore_context_table_insert(&table, &contexts[i])) {
+			printf("oscore_context_table_insert failed\n");
+			return -1;
+		}
+	}
+	uint64_t insert = now() - start;
+
+	for (uint32_t i = 0; i < LOOKUPS; i++) {
+		order[i] = rnd() % cnt;
+	}
+
+	struct byte_array id_context = EMPTY_ARRAY;
+	struct context *c;
+	start = now();
+	for (uint32_t i = 0; i < LOOKUPS; i++) {
+		struct byte_array *kid = &contexts[order[i]].rc.recipient_id;
+		if ((ok != oscore_context_table_find(&table, &id_context, kid,
+						     &c)) ||
+		    (c != &contexts[order[i]])) {
+			printf("oscore_context_table_find failed\n");
+			return -1;
+		}
+	}
+	uint64_t table_find = now() - start;
+
+	/*the linear search is slow, fewer lookups are enough*/
+	uint32_t linear_lookups = LOOKUPS / 100;
+	start = now();
+	for (uint32_t i = 0; i < linear_lookups; i++) {
+		struct byte_array *kid = &contexts[order[i]].rc.recipient_id;
+		if (linear_find(contexts, cnt, &id_context, kid) !=
+		    &contexts[order[i]]) {
+			printf("linear search failed\n");
+			return -1;
+		}
+	}
+	uint64_t linear = now() - start;
+
+	start = now();
+	for (uint32_t i = 0; i < cnt; i++) {
+		if (ok != oscore_context_table_remove(&table, &contexts[i])) {
+			printf("oscore_context_table_remove failed\n");
+			return -1;
+		}
+	}
+	uint64_t remove = now() - start;
+
+	printf("%8u %8u %12.1f %12.1f %12.1f %12.1f\n", cnt, slots_cnt,
+	       (double)table_find / LOOKUPS, (double)linear / linear_lookups,
+	       (double)insert / cnt, (double)remove / cnt);
+
+	free(slots);
+	free(contexts);
+	return 0;
+}
+
+int main(void)
+{
+	const uint32_t cnts[] = { 1000, 10000, MAX_CONTEXTS };
+
+	printf("values in ns per operation\n");
+	printf("%8s %8s %12s %12s %12s %12s\n", "contexts", "slots", "find",
+	       "linear", "insert", "remove");
+	for (uint32_t i = 0; i < sizeof(cnts) / sizeof(cnts[0]); i++) {
+		if (0 != run(cnts[i])) {
+			return -1;
+		}
+	}
+	return 0;
+}
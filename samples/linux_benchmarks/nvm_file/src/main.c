@@ -0,0 +1,276 @@
+/*
+   Copyright (c) 2026 Fraunhofer AISEC. See the COPYRIGHT
+   file at the top-level directory of this distribution.
+
+   Licensed under the Apache License, Version 2.0 <LICENSE-APACHE or
+   http://www.apache.org/licenses/LICENSE-2.0> or the MIT license
+   <LICENSE-MIT or http://opensource.org/licenses/MIT>, at your
+   option. This file may not be copied, modified, or distributed
+   except according to those terms.
+*/
+
+/*
+ * Measures the SSN store file of a server with 50000 contexts: the SSN writes
+ * per second with one sync after 1 up to 4096 writes, and the time needed to
+ * open and verify the file after a restart. Finally one copy of the record in
+ * every slot is damaged, as a torn write would do, and each context must
+ * still be restored with one of its last two synced SSNs.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "oscore/nvm_file.h"
+
+#ifndef OSCORE_NVM_FILE
+#error "Enable OSCORE_NVM_FILE in makefile_config.mk"
+#endif
+
+#define KEYS 50000
+#define SLOTS 131072
+#define RUN_NS 1000000000u
+/*SSNs reserved by each write*/
+#define SSN_INTERVAL 64
+
+static uint8_t server_id[] = { 0x01 };
+static uint8_t id_context[] = { 0x37, 0xcb, 0xf3, 0x21, 0x00, 0x17, 0xa2, 0xd3 };
+static uint8_t recipient_ids[KEYS][3];
+static struct nvm_key_t keys[KEYS];
+static uint64_t ssns[KEYS];
+
+static uint64_t now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/*xorshift, the benchmark needs no cryptographic quality*/
+static uint32_t rnd(void)
+{
+	static uint32_t x = 2463534242u;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	return x;
+}
+
+/*Recipient IDs of 2 or 3 bytes, every second context has an ID Context*/
+static void keys_init(void)
+{
+	for (uint32_t i = 0; i < KEYS; i++) {
+		recipient_ids[i][0] = (uint8_t)i;
+		recipient_ids[i][1] = (uint8_t)(i >> 8);
+		recipient_ids[i][2] = (uint8_t)(i >> 16);
+		keys[i].sender_id.ptr = server_id;
+		keys[i].sender_id.len = sizeof(server_id);
+		keys[i].recipient_id.ptr = recipient_ids[i];
+		keys[i].recipient_id.len = 2 + (i % 2);
+		if (i % 2) {
+			keys[i].id_context.ptr = id_context;
+			keys[i].id_context.len = sizeof(id_context);
+		}
+	}
+}
+
+static int insert(struct oscore_nvm_file *f)
+{
+	uint64_t start = now();
+	for (uint32_t i = 0; i < KEYS; i++) {
+		if (ok != oscore_nvm_file_write(f, &keys[i], 0,
+						SSN_INTERVAL)) {
+			printf("oscore_nvm_file_write failed\n");
+			return -1;
+		}
+	}
+	if (ok != oscore_nvm_file_sync(f)) {
+		printf("oscore_nvm_file_sync failed\n");
+		return -1;
+	}
+	printf("%u keys inserted in %.1f ms\n\n", KEYS,
+	       (double)(now() - start) / 1e6);
+	return 0;
+}
+
+/**
+ * @brief Writes the SSNs of random contexts for about a second, with a sync
+ *        after every batch of writes.
+ */
+static int writes_run(struct oscore_nvm_file *f, uint32_t batch)
+{
+	uint64_t writes = 0;
+	uint64_t syncs = 0;
+	uint64_t sync_ns = 0;
+	uint64_t start = now();
+	uint64_t duration;
+
+	do {
+		for (uint32_t i = 0; i < batch; i++) {
+			uint32_t k = rnd() % KEYS;
+			ssns[k] += SSN_INTERVAL;
+			if (ok != oscore_nvm_file_write(f, &keys[k], ssns[k],
+							SSN_INTERVAL)) {
+				printf("oscore_nvm_file_write failed\n");
+				return -1;
+			}
+		}
+		uint64_t sync_start = now();
+		if (ok != oscore_nvm_file_sync(f)) {
+			printf("oscore_nvm_file_sync failed\n");
+			return -1;
+		}
+		sync_ns += now() - sync_start;
+		writes += batch;
+		syncs++;
+		duration = now() - start;
+	} while (duration < RUN_NS);
+
+	printf("%8u %14.0f %12.0f %12.1f\n", batch,
+	       (double)writes * 1e9 / (double)duration,
+	       (double)syncs * 1e9 / (double)duration,
+	       (double)sync_ns / (double)syncs / 1e3);
+	return 0;
+}
+
+/**
+ * @brief Reopens the file and checks the SSN of every context.
+ * @param fallbacks [out] Number of contexts restored with their second
+ *        newest SSN, or NULL if all must have the newest one.
+ */
+static int recovery_run(struct oscore_nvm_file *f, const char *path,
+			uint32_t *fallbacks)
+{
+	uint64_t start = now();
+	if (ok != oscore_nvm_file_open(f, path, SLOTS)) {
+		printf("oscore_nvm_file_open failed\n");
+		return -1;
+	}
+	uint64_t open_ns = now() - start;
+
+	for (uint32_t i = 0; i < KEYS; i++) {
+		uint64_t ssn;
+		uint32_t interval;
+		if (ok != oscore_nvm_file_read(f, &keys[i], &ssn, &interval)) {
+			printf("SSN of context %u lost\n", i);
+			return -1;
+		}
+		if ((NULL != fallbacks) &&
+		    (ssn == ssns[i] - SSN_INTERVAL)) {
+			(*fallbacks)++;
+		} else if (ssn != ssns[i]) {
+			printf("wrong SSN of context %u\n", i);
+			return -1;
+		}
+	}
+	printf("recovery of %u keys: %.1f ms\n", f->keys_cnt,
+	       (double)open_ns / 1e6);
+	return 0;
+}
+
+/**
+ * @brief Writes two SSNs for every context and damages one of the two copies
+ *        of each slot.
+ */
+static int damage(struct oscore_nvm_file *f, const char *path)
+{
+	for (uint32_t n = 0; n < 2; n++) {
+		for (uint32_t i = 0; i < KEYS; i++) {
+			ssns[i] += SSN_INTERVAL;
+			if (ok != oscore_nvm_file_write(f, &keys[i], ssns[i],
+							SSN_INTERVAL)) {
+				printf("oscore_nvm_file_write failed\n");
+				return -1;
+			}
+		}
+		if (ok != oscore_nvm_file_sync(f)) {
+			printf("oscore_nvm_file_sync failed\n");
+			return -1;
+		}
+	}
+	if (ok != oscore_nvm_file_close(f)) {
+		printf("oscore_nvm_file_close failed\n");
+		return -1;
+	}
+
+	int fd = open(path, O_RDWR);
+	if (fd < 0) {
+		printf("open failed\n");
+		return -1;
+	}
+	for (uint32_t i = 0; i < SLOTS; i++) {
+		uint8_t garbage[8];
+		for (uint32_t j = 0; j < sizeof(garbage); j++) {
+			garbage[j] = (uint8_t)rnd();
+		}
+		/*the SSN field of one of the copies*/
+		off_t offset = OSCORE_NVM_FILE_HEADER_LEN +
+			       ((off_t)i * 2 + (rnd() % 2)) *
+				       OSCORE_NVM_FILE_RECORD_LEN +
+			       8;
+		if ((ssize_t)sizeof(garbage) !=
+		    pwrite(fd, garbage, sizeof(garbage), offset)) {
+			printf("pwrite failed\n");
+			close(fd);
+			return -1;
+		}
+	}
+	close(fd);
+	return 0;
+}
+
+static int run(const char *path)
+{
+	struct oscore_nvm_file f;
+
+	if (ok != oscore_nvm_file_open(&f, path, SLOTS)) {
+		printf("oscore_nvm_file_open failed\n");
+		return -1;
+	}
+	if (0 != insert(&f)) {
+		return -1;
+	}
+
+	printf("%8s %14s %12s %12s\n", "batch", "writes/s", "syncs/s",
+	       "us/sync");
+	for (uint32_t batch = 1; batch <= 4096; batch *= 16) {
+		if (0 != writes_run(&f, batch)) {
+			return -1;
+		}
+	}
+	printf("\n");
+
+	if ((ok != oscore_nvm_file_close(&f)) ||
+	    (0 != recovery_run(&f, path, NULL))) {
+		return -1;
+	}
+
+	uint32_t fallbacks = 0;
+	if ((0 != damage(&f, path)) ||
+	    (0 != recovery_run(&f, path, &fallbacks))) {
+		return -1;
+	}
+	printf("one copy of each slot damaged: %u contexts restored with the "
+	       "older SSN, none lost\n",
+	       fallbacks);
+	return (ok == oscore_nvm_file_close(&f)) ? 0 : -1;
+}
+
+int main(int argc, char **argv)
+{
+	/*the file system decides on the cost of the syncs, e.g., tmpfs has
+	none*/
+	const char *path = (argc > 1) ? argv[1] : "nvm_file_benchmark.bin";
+
+	keys_init();
+	unlink(path);
+	int result = run(path);
+	unlink(path);
+	return result;
+}
@@ -0,0 +1,520 @@
+/*
+   Copyright (c) 2026 Fraunhofer AISEC. See the COPYRIGHT
+   file at the top-level directory of this distribution.
+
+   Licensed under the Apache License, Version 2.0 <LICENSE-APACHE or
+   http://www.apache.org/licenses/LICENSE-2.0> or the MIT license
+   <LICENSE-MIT or http://opensource.org/licenses/MIT>, at your
+   option. This file may not be copied, modified, or distributed
+   except according to those terms.
+*/
+#ifdef AES_HW
+
+#include <string.h>
+
+#include "common/aes_hw_ccm.h"
+#include "common/oscore_edhoc_error.h"
+
+#define AES_BLOCK_LEN 16
+#define AES128_ROUNDS 10
+
+#if defined(__x86_64__) || defined(__i386__)
+/******************************************************************************/
+/* x86 AES-NI                                                                 */
+/******************************************************************************/
+#define AES_HW_SUPPORTED_ARCH
+#include <immintrin.h>
+
+#define AES_HW_TARGET __attribute__((target("aes,sse2")))
+
+typedef __m128i block_t;
+
+static inline AES_HW_TARGET block_t block_load(const uint8_t *p)
+{
+	return _mm_loadu_si128((const __m128i *)(const void *)p);
+}
+
+static inline AES_HW_TARGET void block_store(uint8_t *p, block_t b)
+{
+	_mm_storeu_si128((__m128i *)(void *)p, b);
+}
+
+static inline AES_HW_TARGET block_t block_xor(block_t a, block_t b)
+{
+	return _mm_xor_si128(a, b);
+}
+
+static inline AES_HW_TARGET block_t aes_enc1(const block_t *rk, block_t a)
+{
+	a = _mm_xor_si128(a, rk[0]);
+	for (uint32_t r = 1; r < AES128_ROUNDS; r++) {
+		a = _mm_aesenc_si128(a, rk[r]);
+	}
+	return _mm_aesenclast_si128(a, rk[AES128_ROUNDS]);
+}
+
+/*two independent blocks, the rounds are interleaved to hide the latency of
+the AES instructions*/
+static inline AES_HW_TARGET void aes_enc2(const block_t *rk, block_t *a,
+					  block_t *b)
+{
+	block_t x = _mm_xor_si128(*a, rk[0]);
+	block_t y = _mm_xor_si128(*b, rk[0]);
+	for (uint32_t r = 1; r < AES128_ROUNDS; r++) {
+		x = _mm_aesenc_si128(x, rk[r]);
+		y = _mm_aesenc_si128(y, rk[r]);
+	}
+	*a = _mm_aesenclast_si128(x, rk[AES128_ROUNDS]);
+	*b = _mm_aesenclast_si128(y, rk[AES128_ROUNDS]);
+}
+
+#define KEY_EXP_STEP(k, rcon)                                                  \
+	key_exp_step(k, _mm_aeskeygenassist_si128(k, rcon))
+
+static inline AES_HW_TARGET block_t key_exp_step(block_t k, block_t assist)
+{
+	assist = _mm_shuffle_epi32(assist, 0xff);
+	k = _mm_xor_si128(k, _mm_slli_si128(k, 4));
+	k = _mm_xor_si128(k, _mm_slli_si128(k, 4));
+	k = _mm_xor_si128(k, _mm_slli_si128(k, 4));
+	return _mm_xor_si128(k, assist);
+}
+
+static AES_HW_TARGET void key_expand(const uint8_t *key, uint8_t *round_keys)
+{
+	block_t k[AES128_ROUNDS + 1];
+	k[0] = block_load(key);
+	k[1] = KEY_EXP_STEP(k[0], 0x01);
+	k[2] = KEY_EXP_STEP(k[1], 0x02);
+	k[3] = KEY_EXP_STEP(k[2], 0x04);
+	k[4] = KEY_EXP_STEP(k[3], 0x08);
+	k[5] = KEY_EXP_STEP(k[4], 0x10);
+	k[6] = KEY_EXP_STEP(k[5], 0x20);
+	k[7] = KEY_EXP_STEP(k[6], 0x40);
+	k[8] = KEY_EXP_STEP(k[7], 0x80);
+	k[9] = KEY_EXP_STEP(k[8], 0x1b);
+	k[10] = KEY_EXP_STEP(k[9], 0x36);
+	for (uint32_t i = 0; i <= AES128_ROUNDS; i++) {
+		block_store(round_keys + i * AES_BLOCK_LEN, k[i]);
+	}
+}
+
+static bool cpu_has_aes(void)
+{
+#if defined(__GNUC__)
+	return __builtin_cpu_supports("aes") && __builtin_cpu_supports("sse2");
+#else
+	return false;
+#endif
+}
+
+#elif defined(__aarch64__)
+/******************************************************************************/
+/* ARMv8 Cryptography Extensions                                              */
+/******************************************************************************/
+#define AES_HW_SUPPORTED_ARCH
+#include <arm_neon.h>
+#if defined(__linux__)
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
+
+#if defined(__clang__)
+#define AES_HW_TARGET __attribute__((target("aes")))
+#else
+#define AES_HW_TARGET __attribute__((target("+crypto")))
+#endif
+
+typedef uint8x16_t block_t;
+
+static inline AES_HW_TARGET block_t block_load(const uint8_t *p)
+{
+	return vld1q_u8(p);
+}
+
+static inline AES_HW_TARGET void block_store(uint8_t *p, block_t b)
+{
+	vst1q_u8(p, b);
+}
+
+static inline AES_HW_TARGET block_t block_xor(block_t a, block_t b)
+{
+	return veorq_u8(a, b);
+}
+
+static inline AES_HW_TARGET block_t aes_enc1(const block_t *rk, block_t a)
+{
+	for (uint32_t r = 0; r < AES128_ROUNDS - 1; r++) {
+		a = vaesmcq_u8(vaeseq_u8(a, rk[r]));
+	}
+	a = vaeseq_u8(a, rk[AES128_ROUNDS - 1]);
+	return veorq_u8(a, rk[AES128_ROUNDS]);
+}
+
+/*two independent blocks, the rounds are interleaved to hide the latency of
+the AES instructions*/
+static inline AES_HW_TARGET void aes_enc2(const block_t *rk, block_t *a,
+					  block_t *b)
+{
+	block_t x = *a;
+	block_t y = *b;
+	for (uint32_t r = 0; r < AES128_ROUNDS - 1; r++) {
+		x = vaesmcq_u8(vaeseq_u8(x, rk[r]));
+		y = vaesmcq_u8(vaeseq_u8(y, rk[r]));
+	}
+	x = vaeseq_u8(x, rk[AES128_ROUNDS - 1]);
+	y = vaeseq_u8(y, rk[AES128_ROUNDS - 1]);
+	*a = veorq_u8(x, rk[AES128_ROUNDS]);
+	*b = veorq_u8(y, rk[AES128_ROUNDS]);
+}
+
+/*SubWord() with AESE and a zero round key. All four columns hold the same
+word, so ShiftRows has no effect.*/
+static inline AES_HW_TARGET uint32_t sub_word(uint32_t w)
+{
+	uint8x16_t s = vreinterpretq_u8_u32(vdupq_n_u32(w));
+	s = vaeseq_u8(s, vdupq_n_u8(0));
+	return vgetq_lane_u32(vreinterpretq_u32_u8(s), 0);
+}
+
+static AES_HW_TARGET void key_expand(const uint8_t *key, uint8_t *round_keys)
+{
+	static const uint8_t rcon[AES128_ROUNDS] = { 0x01, 0x02, 0x04, 0x08,
+						     0x10, 0x20, 0x40, 0x80,
+						     0x1b, 0x36 };
+	uint32_t w[(AES128_ROUNDS + 1) * 4];
+
+	memcpy(w, key, AES_BLOCK_LEN);
+	for (uint32_t i = 4; i < (AES128_ROUNDS + 1) * 4; i++) {
+		uint32_t t = w[i - 1];
+		if (i % 4 == 0) {
+			/*words are little endian, RotWord is a rotation by 8*/
+			t = sub_word(t);
+			t = ((t >> 8) | (t << 24)) ^ rcon[i / 4 - 1];
+		}
+		w[i] = w[i - 4] ^ t;
+	}
+	memcpy(round_keys, w, sizeof(w));
+	memset(w, 0, sizeof(w));
+}
+
+static bool cpu_has_aes(void)
+{
+#if defined(__linux__) && defined(HWCAP_AES)
+	return 0 != (getauxval(AT_HWCAP) & HWCAP_AES);
+#elif defined(__ARM_FEATURE_CRYPTO) || defined(__ARM_FEATURE_AES)
+	return true;
+#else
+	return false;
+#endif
+}
+
+#endif
+
+static bool aes_hw_enabled = true;
+
+void aes_hw_enable(bool enable)
+{
+	aes_hw_enabled = enable;
+}
+
+#ifndef AES_HW_SUPPORTED_ARCH
+/******************************************************************************/
+/* Other architectures: the crypto wrapper always uses the fallback engine    */
+/******************************************************************************/
+bool aes_hw_available(void)
+{
+	return false;
+}
+
+enum err aes_hw_key_expand(const struct byte_array *key,
+			   uint8_t round_keys[AES_HW_ROUND_KEYS_LEN])
+{
+	return not_supported_feature;
+}
+
+enum err aes_hw_ccm_encrypt(const uint8_t *round_keys,
+			    const struct byte_array *in,
+			    const struct byte_array *nonce,
+			    const struct byte_array *aad,
+			    struct byte_array *out, struct byte_array *tag)
+{
+	return not_supported_feature;
+}
+
+enum err aes_hw_ccm_decrypt(const uint8_t *round_keys,
+			    const struct byte_array *in,
+			    const struct byte_array *nonce,
+			    const struct byte_array *aad,
+			    struct byte_array *out, uint32_t tag_len)
+{
+	return not_supported_feature;
+}
+
+#else
+
+bool aes_hw_available(void)
+{
+	/*0: not checked yet, 1: supported, 2: not supported*/
+	static uint8_t cpu_support = 0;
+
+	if (0 == cpu_support) {
+		cpu_support = cpu_has_aes() ? 1 : 2;
+	}
+	return aes_hw_enabled && (1 == cpu_support);
+}
+
+enum err aes_hw_key_expand(const struct byte_array *key,
+			   uint8_t round_keys[AES_HW_ROUND_KEYS_LEN])
+{
+	if (NULL == key || NULL == key->ptr || AES_BLOCK_LEN != key->len) {
+		return wrong_parameter;
+	}
+	if (!aes_hw_available()) {
+		return not_supported_feature;
+	}
+	key_expand(key->ptr, round_keys);
+	return ok;
+}
+
+/**
+ * @brief	Checks the CCM parameters and returns the size of the length
+ *		field L, see RFC3610 Section 2.
+ */
+static enum err ccm_check_params(uint32_t nonce_len, uint32_t tag_len,
+				 uint32_t msg_len, uint32_t *l)
+{
+	if (nonce_len < 7 || nonce_len > 13 || tag_len < 4 || tag_len > 16 ||
+	    (tag_len & 1)) {
+		return wrong_parameter;
+	}
+	*l = 15 - nonce_len;
+	/*the message length must fit into L bytes*/
+	if (*l < 4 && (msg_len >> (8 * *l)) != 0) {
+		return wrong_parameter;
+	}
+	return ok;
+}
+
+/**
+ * @brief	Writes the (big endian) counter/length value into the last
+ *		l bytes of a block.
+ */
+static inline void ccm_set_tail(uint8_t *block, uint32_t l, uint32_t value)
+{
+	for (uint32_t i = 0; i < l; i++) {
+		block[AES_BLOCK_LEN - 1 - i] =
+			(i < 4) ? (uint8_t)(value >> (8 * i)) : 0;
+	}
+}
+
+/**
+ * @brief	Computes the first CBC-MAC block B_0 interleaved with the
+ *		encryption of the counter block A_0, and authenticates the
+ *		additional data.
+ *
+ * @param[out] mac	The CBC-MAC state after processing B_0 and the aad.
+ * @param[out] s0	The encrypted counter block A_0.
+ * @param[out] ctr	Counter block A_0 to be used for the following blocks.
+ */
+static AES_HW_TARGET void ccm_mac_init(const block_t *rk,
+				       const struct byte_array *nonce,
+				       const struct byte_array *aad,
+				       uint32_t tag_len, uint32_t msg_len,
+				       uint32_t l, block_t *mac, block_t *s0,
+				       uint8_t *ctr)
+{
+	uint8_t b[AES_BLOCK_LEN];
+
+	memset(b, 0, sizeof(b));
+	b[0] = (uint8_t)(((aad->len > 0) ? 0x40 : 0) |
+			 (((tag_len - 2) / 2) << 3) | (l - 1));
+	memcpy(b + 1, nonce->ptr, nonce->len);
+	ccm_set_tail(b, l, msg_len);
+
+	memset(ctr, 0, AES_BLOCK_LEN);
+	ctr[0] = (uint8_t)(l - 1);
+	memcpy(ctr + 1, nonce->ptr, nonce->len);
+
+	*mac = block_load(b);
+	*s0 = block_load(ctr);
+	aes_enc2(rk, mac, s0);
+
+	if (0 == aad->len) {
+		return;
+	}
+
+	/*the first aad block starts with the encoded length of the aad*/
+	uint32_t hdr_len;
+	memset(b, 0, sizeof(b));
+	if (aad->len < 0xFF00) {
+		b[0] = (uint8_t)(aad->len >> 8);
+		b[1] = (uint8_t)aad->len;
+		hdr_len = 2;
+	} else {
+		b[0] = 0xFF;
+		b[1] = 0xFE;
+		b[2] = (uint8_t)(aad->len >> 24);
+		b[3] = (uint8_t)(aad->len >> 16);
+		b[4] = (uint8_t)(aad->len >> 8);
+		b[5] = (uint8_t)aad->len;
+		hdr_len = 6;
+	}
+
+	uint32_t pos = AES_BLOCK_LEN - hdr_len;
+	if (pos > aad->len) {
+		pos = aad->len;
+	}
+	memcpy(b + hdr_len, aad->ptr, pos);
+	*mac = aes_enc1(rk, block_xor(*mac, block_load(b)));
+
+	for (; aad->len - pos >= AES_BLOCK_LEN; pos += AES_BLOCK_LEN) {
+		*mac = aes_enc1(rk, block_xor(*mac, block_load(aad->ptr + pos)));
+	}
+	if (pos < aad->len) {
+		memset(b, 0, sizeof(b));
+		memcpy(b, aad->ptr + pos, aad->len - pos);
+		*mac = aes_enc1(rk, block_xor(*mac, block_load(b)));
+	}
+}
+
+static inline AES_HW_TARGET void load_round_keys(const uint8_t *round_keys,
+						 block_t *rk)
+{
+	for (uint32_t i = 0; i <= AES128_ROUNDS; i++) {
+		rk[i] = block_load(round_keys + i * AES_BLOCK_LEN);
+	}
+}
+
+AES_HW_TARGET enum err aes_hw_ccm_encrypt(const uint8_t *round_keys,
+					  const struct byte_array *in,
+					  const struct byte_array *nonce,
+					  const struct byte_array *aad,
+					  struct byte_array *out,
+					  struct byte_array *tag)
+{
+	uint32_t l;
+	TRY(ccm_check_params(nonce->len, tag->len, in->len, &l));
+	if (out->len < in->len) {
+		return buffer_to_small;
+	}
+
+	block_t rk[AES128_ROUNDS + 1];
+	block_t mac, s0;
+	uint8_t ctr[AES_BLOCK_LEN];
+	uint8_t b[AES_BLOCK_LEN];
+	load_round_keys(round_keys, rk);
+	ccm_mac_init(rk, nonce, aad, tag->len, in->len, l, &mac, &s0, ctr);
+
+	/*the CBC-MAC of block i and the key stream of block i are independent
+	and computed at the same time*/
+	uint32_t i = 1;
+	for (uint32_t pos = 0; pos < in->len; pos += AES_BLOCK_LEN, i++) {
+		uint32_t n = in->len - pos;
+		block_t p;
+		if (n >= AES_BLOCK_LEN) {
+			n = AES_BLOCK_LEN;
+			p = block_load(in->ptr + pos);
+		} else {
+			memset(b, 0, sizeof(b));
+			memcpy(b, in->ptr + pos, n);
+			p = block_load(b);
+		}
+
+		ccm_set_tail(ctr, l, i);
+		block_t ks = block_load(ctr);
+		block_t m = block_xor(mac, p);
+		aes_enc2(rk, &m, &ks);
+		mac = m;
+
+		if (AES_BLOCK_LEN == n) {
+			block_store(out->ptr + pos, block_xor(p, ks));
+		} else {
+			block_store(b, block_xor(p, ks));
+			memcpy(out->ptr + pos, b, n);
+		}
+	}
+
+	/*the tag is appended to the ciphertext and copied to the tag buffer*/
+	block_store(b, block_xor(mac, s0));
+	memcpy(out->ptr + in->len, b, tag->len);
+	if (tag->ptr != out->ptr + in->len) {
+		memcpy(tag->ptr, b, tag->len);
+	}
+	return ok;
+}
+
+AES_HW_TARGET enum err aes_hw_ccm_decrypt(const uint8_t *round_keys,
+					  const struct byte_array *in,
+					  const struct byte_array *nonce,
+					  const struct byte_array *aad,
+					  struct byte_array *out,
+					  uint32_t tag_len)
+{
+	if (in->len < tag_len) {
+		return wrong_parameter;
+	}
+	uint32_t len = in->len - tag_len;
+	uint32_t l;
+	TRY(ccm_check_params(nonce->len, tag_len, len, &l));
+	if (out->len < len) {
+		return buffer_to_small;
+	}
+
+	block_t rk[AES128_ROUNDS + 1];
+	block_t mac, s0, ks;
+	uint8_t ctr[AES_BLOCK_LEN];
+	uint8_t b[AES_BLOCK_LEN];
+	load_round_keys(round_keys, rk);
+	ccm_mac_init(rk, nonce, aad, tag_len, len, l, &mac, &s0, ctr);
+
+	if (len > 0) {
+		ccm_set_tail(ctr, l, 1);
+		ks = aes_enc1(rk, block_load(ctr));
+	}
+
+	/*the CBC-MAC of block i depends on the plaintext of block i, therefore
+	it is computed at the same time as the key stream of block i+1*/
+	uint32_t i = 1;
+	for (uint32_t pos = 0; pos < len; pos += AES_BLOCK_LEN, i++) {
+		uint32_t n = len - pos;
+		block_t p;
+		if (n >= AES_BLOCK_LEN) {
+			n = AES_BLOCK_LEN;
+			p = block_xor(block_load(in->ptr + pos), ks);
+			block_store(out->ptr + pos, p);
+		} else {
+			memset(b, 0, sizeof(b));
+			memcpy(b, in->ptr + pos, n);
+			block_store(b, block_xor(block_load(b), ks));
+			memset(b + n, 0, AES_BLOCK_LEN - n);
+			memcpy(out->ptr + pos, b, n);
+			p = block_load(b);
+		}
+
+		block_t m = block_xor(mac, p);
+		if (pos + AES_BLOCK_LEN < len) {
+			ccm_set_tail(ctr, l, i + 1);
+			ks = block_load(ctr);
+			aes_enc2(rk, &m, &ks);
+		} else {
+			m = aes_enc1(rk, m);
+		}
+		mac = m;
+	}
+
+	/*constant time tag comparison*/
+	block_store(b, block_xor(mac, s0));
+	uint8_t diff = 0;
+	for (uint32_t j = 0; j < tag_len; j++) {
+		diff |= (uint8_t)(b[j] ^ in->ptr[len + j]);
+	}
+	if (0 != diff) {
+		memset(out->ptr, 0, len);
+		return unexpected_result_from_ext_lib;
+	}
+	return ok;
+}
+
+#endif /* AES_HW_SUPPORTED_ARCH */
+#endif /* AES_HW */
@@ -8,6 +8,11 @@
    option. This file may not be copied, modified, or distributed
    except according to those terms.
 */
+#ifdef MBEDTLS
+/*must precede the first mbedtls header, crypto_wrapper.h includes psa*/
+#define MBEDTLS_ALLOW_PRIVATE_ACCESS
+#endif
+
 #include <string.h>
 
 #include "edhoc.h"
@@ -21,6 +26,9 @@
 #include "edhoc/suites.h"
 #include "edhoc/buffer_sizes.h"
 
+/*block size of SHA-256, the size of the HMAC ipad/opad*/
+#define HMAC_BLOCK_SIZE 64
+
 #ifdef EDHOC_MOCK_CRYPTO_WRAPPER
 struct edhoc_mock_cb edhoc_crypto_mock_cb;
 #endif // EDHOC_MOCK_CRYPTO_WRAPPER
@@ -33,8 +41,6 @@ make sure MBEDTLS_PSA_CRYPTO_CONFIG is defined in include/mbedtls/mbedtls_config
 
 modify setting in include/psa/crypto_config.h 
 */
-#define MBEDTLS_ALLOW_PRIVATE_ACCESS
-
 #include <psa/crypto.h>
 
 #include "mbedtls/ecp.h"
@@ -61,6 +67,16 @@ modify setting in include/psa/crypto_config.h
 #include <tinycrypt/hmac.h>
 #include <tinycrypt/ecc_dsa.h>
 #include <tinycrypt/ecc_dh.h>
+
+_Static_assert(sizeof(struct tc_aes_key_sched_struct) <=
+		       sizeof(((struct aead_key *)NULL)->sched),
+	       "the TinyCrypt key schedule doesn't fit into struct aead_key");
+#endif
+
+#ifdef AES_HW
+_Static_assert(AES_HW_ROUND_KEYS_LEN <=
+		       sizeof(((struct aead_key *)NULL)->sched),
+	       "the AES_HW round keys don't fit into struct aead_key");
 #endif
 
 #ifdef MBEDTLS
@@ -77,6 +93,40 @@ modify setting in include/psa/crypto_config.h
 		}                                                              \
 	} while (0)
 
+/**
+ * @brief Initializes the PSA crypto subsystem once per process. Subsequent 
+ *        calls return immediately. Concurrent first calls, e.g., from 
+ *        oscore_context_init() in several threads, are serialized, so that 
+ *        psa_crypto_init() never runs twice at the same time.
+ * 
+ * @return PSA_SUCCESS or the error returned by psa_crypto_init()
+ */
+static psa_status_t psa_init_once(void)
+{
+	static bool psa_initialized = false;
+	static bool psa_init_busy = false;
+
+	if (__atomic_load_n(&psa_initialized, __ATOMIC_ACQUIRE)) {
+		return PSA_SUCCESS;
+	}
+
+	while (__atomic_exchange_n(&psa_init_busy, true, __ATOMIC_ACQUIRE)) {
+		while (__atomic_load_n(&psa_init_busy, __ATOMIC_RELAXED)) {
+		}
+	}
+	psa_status_t status = PSA_SUCCESS;
+	/*another thread may have finished while this one was waiting*/
+	if (!__atomic_load_n(&psa_initialized, __ATOMIC_RELAXED)) {
+		status = psa_crypto_init();
+		if (PSA_SUCCESS == status) {
+			__atomic_store_n(&psa_initialized, true,
+					 __ATOMIC_RELEASE);
+		}
+	}
+	__atomic_store_n(&psa_init_busy, false, __ATOMIC_RELEASE);
+	return status;
+}
+
 /**
  * @brief Decompresses an elliptic curve point. 
  * 
@@ -266,15 +316,94 @@ enum err WEAK aead(enum aes_operation op, const struct byte_array *in,
 		   const struct byte_array *key, struct byte_array *nonce,
 		   const struct byte_array *aad, struct byte_array *out,
 		   struct byte_array *tag)
+{
+	struct aead_key bound_key;
+	TRY(aead_key_init(key, tag->len, &bound_key));
+	enum err r = aead_with_key(op, in, &bound_key, nonce, aad, out, tag);
+	TRY(aead_key_deinit(&bound_key));
+	return r;
+}
+
+enum err WEAK aead_key_init(const struct byte_array *key, uint32_t tag_len,
+			    struct aead_key *out)
+{
+	if (NULL == key || NULL == out) {
+		return wrong_parameter;
+	}
+
+	out->key = *key;
+	out->tag_len = tag_len;
+	out->handle = 0;
+	out->hw = false;
+
+#ifdef AES_HW
+	/*use the AES instructions of the CPU if available, otherwise fall back
+	to the engine below*/
+	if (16 == key->len && aes_hw_available()) {
+		TRY(aes_hw_key_expand(key, (uint8_t *)(void *)out->sched));
+		out->hw = true;
+		return ok;
+	}
+#endif
+
+#if defined(TINYCRYPT)
+	/*the key schedule is expanded only once for the lifetime of the key*/
+	TRY_EXPECT(tc_aes128_set_encrypt_key((TCAesKeySched_t)(void *)out->sched,
+					     key->ptr),
+		   1);
+#elif defined(MBEDTLS)
+	psa_key_id_t key_id = PSA_KEY_HANDLE_INIT;
+
+	TRY_EXPECT_PSA(psa_init_once(), PSA_SUCCESS, key_id,
+		       unexpected_result_from_ext_lib);
+
+	psa_key_attributes_t attr = PSA_KEY_ATTRIBUTES_INIT;
+	psa_set_key_usage_flags(&attr,
+				PSA_KEY_USAGE_DECRYPT | PSA_KEY_USAGE_ENCRYPT);
+	psa_set_key_algorithm(&attr, PSA_ALG_AEAD_WITH_SHORTENED_TAG(
+					     PSA_ALG_CCM, tag_len));
+	psa_set_key_type(&attr, PSA_KEY_TYPE_AES);
+	psa_set_key_bits(&attr, ((size_t)key->len << 3));
+	psa_set_key_lifetime(&attr, PSA_KEY_LIFETIME_VOLATILE);
+	TRY_EXPECT_PSA(psa_import_key(&attr, key->ptr, key->len, &key_id),
+		       PSA_SUCCESS, key_id, unexpected_result_from_ext_lib);
+	out->handle = (uint32_t)key_id;
+#endif
+	return ok;
+}
+
+enum err WEAK aead_key_deinit(struct aead_key *key)
+{
+	if (NULL == key) {
+		return wrong_parameter;
+	}
+
+	memset(key->sched, 0, sizeof(key->sched));
+	key->hw = false;
+#if defined(MBEDTLS)
+	if (0 != key->handle) {
+		TRY_EXPECT(psa_destroy_key((psa_key_id_t)key->handle),
+			   PSA_SUCCESS);
+	}
+#endif
+	key->handle = 0;
+	return ok;
+}
+
+enum err WEAK aead_with_key(enum aes_operation op, const struct byte_array *in,
+			    const struct aead_key *key,
+			    struct byte_array *nonce,
+			    const struct byte_array *aad,
+			    struct byte_array *out, struct byte_array *tag)
 {
 #ifdef EDHOC_MOCK_CRYPTO_WRAPPER
 	for (uint32_t i = 0; i < edhoc_crypto_mock_cb.aead_in_out_count; i++) {
 		struct edhoc_mock_aead_in_out *predefined_in_out =
 			edhoc_crypto_mock_cb.aead_in_out + i;
 		if (aead_mock_args_match_predefined(
-			    predefined_in_out, key->ptr, key->len, nonce->ptr,
-			    nonce->len, aad->ptr, aad->len, tag->ptr,
-			    tag->len)) {
+			    predefined_in_out, key->key.ptr, key->key.len,
+			    nonce->ptr, nonce->len, aad->ptr, aad->len,
+			    tag->ptr, tag->len)) {
 			memcpy(out->ptr, predefined_in_out->out.ptr,
 			       predefined_in_out->out.len);
 			return ok;
@@ -283,11 +412,24 @@ enum err WEAK aead(enum aes_operation op, const struct byte_array *in,
 	// if no mocked data has been found - continue with normal aead
 #endif
 
+#ifdef AES_HW
+	if (key->hw) {
+		if (op == DECRYPT) {
+			return aes_hw_ccm_decrypt(
+				(const uint8_t *)(const void *)key->sched, in,
+				nonce, aad, out, tag->len);
+		}
+		return aes_hw_ccm_encrypt(
+			(const uint8_t *)(const void *)key->sched, in, nonce,
+			aad, out, tag);
+	}
+#endif
+
 #if defined(TINYCRYPT)
+	/*tc_ccm_config() only stores the pointer to the precomputed schedule*/
 	struct tc_ccm_mode_struct c;
-	struct tc_aes_key_sched_struct sched;
-	TRY_EXPECT(tc_aes128_set_encrypt_key(&sched, key->ptr), 1);
-	TRY_EXPECT(tc_ccm_config(&c, &sched, nonce->ptr, nonce->len, tag->len),
+	TRY_EXPECT(tc_ccm_config(&c, (TCAesKeySched_t)(void *)key->sched,
+				 nonce->ptr, nonce->len, tag->len),
 		   1);
 
 	if (op == DECRYPT) {
@@ -304,31 +446,23 @@ enum err WEAK aead(enum aes_operation op, const struct byte_array *in,
 		memcpy(tag->ptr, out->ptr + out->len, tag->len);
 	}
 #elif defined(MBEDTLS)
-	psa_key_id_t key_id = PSA_KEY_HANDLE_INIT;
-
-	TRY_EXPECT_PSA(psa_crypto_init(), PSA_SUCCESS, key_id,
-		       unexpected_result_from_ext_lib);
+	if (0 == key->handle || tag->len != key->tag_len) {
+		return wrong_parameter;
+	}
 
+	/*the key is owned by the caller, do not destroy it on failure*/
+	psa_key_id_t key_id = (psa_key_id_t)key->handle;
 	psa_algorithm_t alg = PSA_ALG_AEAD_WITH_SHORTENED_TAG(
 		PSA_ALG_CCM, (uint32_t)tag->len);
 
-	psa_key_attributes_t attr = PSA_KEY_ATTRIBUTES_INIT;
-	psa_set_key_usage_flags(&attr,
-				PSA_KEY_USAGE_DECRYPT | PSA_KEY_USAGE_ENCRYPT);
-	psa_set_key_algorithm(&attr, alg);
-	psa_set_key_type(&attr, PSA_KEY_TYPE_AES);
-	psa_set_key_bits(&attr, ((size_t)key->len << 3));
-	psa_set_key_lifetime(&attr, PSA_KEY_LIFETIME_VOLATILE);
-	TRY_EXPECT_PSA(psa_import_key(&attr, key->ptr, key->len, &key_id),
-		       PSA_SUCCESS, key_id, unexpected_result_from_ext_lib);
-
 	if (op == DECRYPT) {
 		size_t out_len_re = 0;
 		TRY_EXPECT_PSA(
 			psa_aead_decrypt(key_id, alg, nonce->ptr, nonce->len,
 					 aad->ptr, aad->len, in->ptr, in->len,
 					 out->ptr, out->len, &out_len_re),
-			PSA_SUCCESS, key_id, unexpected_result_from_ext_lib);
+			PSA_SUCCESS, PSA_KEY_HANDLE_INIT,
+			unexpected_result_from_ext_lib);
 	} else {
 		size_t out_len_re;
 		TRY_EXPECT_PSA(
@@ -336,11 +470,10 @@ enum err WEAK aead(enum aes_operation op, const struct byte_array *in,
 					 aad->ptr, aad->len, in->ptr, in->len,
 					 out->ptr, (size_t)(in->len + tag->len),
 					 &out_len_re),
-			PSA_SUCCESS, key_id, unexpected_result_from_ext_lib);
+			PSA_SUCCESS, PSA_KEY_HANDLE_INIT,
+			unexpected_result_from_ext_lib);
 		memcpy(tag->ptr, out->ptr + out_len_re - tag->len, tag->len);
 	}
-	TRY_EXPECT(psa_destroy_key(key_id), PSA_SUCCESS);
-
 #endif
 	return ok;
 }
@@ -412,7 +545,7 @@ enum err WEAK sign(enum sign_alg alg, const struct byte_array *sk,
 		psa_alg = PSA_ALG_ECDSA(PSA_ALG_SHA_256);
 		bits = PSA_BYTES_TO_BITS((size_t)sk->len);
 
-		TRY_EXPECT_PSA(psa_crypto_init(), PSA_SUCCESS, key_id,
+		TRY_EXPECT_PSA(psa_init_once(), PSA_SUCCESS, key_id,
 			       unexpected_result_from_ext_lib);
 
 		psa_key_attributes_t attributes = PSA_KEY_ATTRIBUTES_INIT;
@@ -473,7 +606,7 @@ enum err WEAK verify(enum sign_alg alg, const struct byte_array *pk,
 		psa_alg = PSA_ALG_ECDSA(PSA_ALG_SHA_256);
 		bits = PSA_BYTES_TO_BITS(P_256_PRIV_KEY_SIZE);
 
-		TRY_EXPECT_PSA(psa_crypto_init(), PSA_SUCCESS, key_id,
+		TRY_EXPECT_PSA(psa_init_once(), PSA_SUCCESS, key_id,
 			       unexpected_result_from_ext_lib);
 
 		psa_key_attributes_t attributes = PSA_KEY_ATTRIBUTES_INIT;
@@ -551,7 +684,7 @@ enum err WEAK hkdf_extract(enum hash_alg alg, const struct byte_array *salt,
 	psa_key_attributes_t attr = PSA_KEY_ATTRIBUTES_INIT;
 	psa_key_id_t key_id = PSA_KEY_HANDLE_INIT;
 
-	TRY_EXPECT_PSA(psa_crypto_init(), PSA_SUCCESS, key_id,
+	TRY_EXPECT_PSA(psa_init_once(), PSA_SUCCESS, key_id,
 		       unexpected_result_from_ext_lib);
 
 	psa_set_key_lifetime(&attr, PSA_KEY_LIFETIME_VOLATILE);
@@ -586,90 +719,211 @@ enum err WEAK hkdf_expand(enum hash_alg alg, const struct byte_array *prk,
 	if (alg != SHA_256) {
 		return crypto_operation_not_implemented;
 	}
+#if defined(TINYCRYPT) || defined(MBEDTLS)
+	struct hkdf_ctx ctx;
+	TRY(hkdf_ctx_init(alg, prk, &ctx));
+	enum err r = hkdf_ctx_expand(&ctx, info, out);
+	TRY(hkdf_ctx_deinit(&ctx));
+	return r;
+#else
 	/* "N = ceil(L/HashLen)" */
 	uint32_t iterations = (out->len + 31) / 32;
 	/* "L length of output keying material in octets (<= 255*HashLen)"*/
 	if (iterations > 255) {
 		return hkdf_failed;
 	}
+	return ok;
+#endif
+}
 
-#ifdef TINYCRYPT
-	uint8_t t[32] = { 0 };
-	struct tc_hmac_state_struct h;
-	for (uint8_t i = 1; i <= iterations; i++) {
-		memset(&h, 0x00, sizeof(h));
-		TRY_EXPECT(tc_hmac_set_key(&h, prk->ptr, prk->len), 1);
-		tc_hmac_init(&h);
-		if (i > 1) {
-			TRY_EXPECT(tc_hmac_update(&h, t, 32), 1);
-		}
-		TRY_EXPECT(tc_hmac_update(&h, info->ptr, info->len), 1);
-		TRY_EXPECT(tc_hmac_update(&h, &i, 1), 1);
-		TRY_EXPECT(tc_hmac_final(t, TC_SHA256_DIGEST_SIZE, &h), 1);
-		if (out->len < i * 32) {
-			memcpy(&out->ptr[(i - 1) * 32], t, out->len % 32);
-		} else {
-			memcpy(&out->ptr[(i - 1) * 32], t, 32);
-		}
+enum err WEAK hkdf_sha_256(struct byte_array *master_secret,
+			   struct byte_array *master_salt,
+			   struct byte_array *info, struct byte_array *out)
+{
+	BYTE_ARRAY_NEW(prk, HASH_SIZE, HASH_SIZE);
+	TRY(hkdf_extract(SHA_256, master_salt, master_secret, prk.ptr));
+	TRY(hkdf_expand(SHA_256, &prk, info, out));
+	return ok;
+}
+
+enum err WEAK hkdf_ctx_init(enum hash_alg alg, const struct byte_array *prk,
+			    struct hkdf_ctx *ctx)
+{
+	if (NULL == prk || NULL == ctx) {
+		return wrong_parameter;
+	}
+	/*all currently prosed suites use hmac-sha256*/
+	if (alg != SHA_256) {
+		return crypto_operation_not_implemented;
+	}
+	ctx->alg = alg;
+	ctx->prk = *prk;
+
+#if defined(TINYCRYPT) || defined(MBEDTLS)
+	/*"K0 = K padded with zeros, or H(K) if K is longer than the block"*/
+	uint8_t pad[HMAC_BLOCK_SIZE];
+	memset(pad, 0, sizeof(pad));
+	if (prk->len > HMAC_BLOCK_SIZE) {
+		struct byte_array k0 = BYTE_ARRAY_INIT(pad, HASH_SIZE);
+		TRY(hash(alg, prk, &k0));
+	} else if (prk->len) {
+		memcpy(pad, prk->ptr, prk->len);
+	}
+	for (uint32_t i = 0; i < HMAC_BLOCK_SIZE; i++) {
+		pad[i] ^= 0x36;
 	}
 #endif
-#ifdef MBEDTLS
-	psa_status_t status;
-	psa_key_attributes_t attr = PSA_KEY_ATTRIBUTES_INIT;
-	psa_key_id_t key_id = PSA_KEY_HANDLE_INIT;
-	PRINTF("key_id: %d\n", key_id);
-
-	TRY_EXPECT_PSA(psa_crypto_init(), PSA_SUCCESS, key_id,
-		       unexpected_result_from_ext_lib);
-	psa_set_key_lifetime(&attr, PSA_KEY_LIFETIME_VOLATILE);
-	psa_set_key_usage_flags(&attr, PSA_KEY_USAGE_SIGN_HASH);
-	psa_set_key_algorithm(&attr, PSA_ALG_HMAC(PSA_ALG_SHA_256));
-	psa_set_key_type(&attr, PSA_KEY_TYPE_HMAC);
 
-	PRINT_ARRAY("PRK:", prk->ptr, prk->len);
-	TRY_EXPECT_PSA(psa_import_key(&attr, prk->ptr, prk->len, &key_id),
-		       PSA_SUCCESS, key_id, unexpected_result_from_ext_lib);
+#if defined(TINYCRYPT)
+	TRY_EXPECT(tc_sha256_init(&ctx->inner), 1);
+	TRY_EXPECT(tc_sha256_update(&ctx->inner, pad, HMAC_BLOCK_SIZE), 1);
+	for (uint32_t i = 0; i < HMAC_BLOCK_SIZE; i++) {
+		pad[i] ^= 0x36 ^ 0x5c;
+	}
+	TRY_EXPECT(tc_sha256_init(&ctx->outer), 1);
+	TRY_EXPECT(tc_sha256_update(&ctx->outer, pad, HMAC_BLOCK_SIZE), 1);
+	memset(pad, 0, sizeof(pad));
+#elif defined(MBEDTLS)
+	ctx->inner = psa_hash_operation_init();
+	ctx->outer = psa_hash_operation_init();
+	psa_status_t status = psa_init_once();
+	if (PSA_SUCCESS == status) {
+		status = psa_hash_setup(&ctx->inner, PSA_ALG_SHA_256);
+	}
+	if (PSA_SUCCESS == status) {
+		status = psa_hash_update(&ctx->inner, pad, HMAC_BLOCK_SIZE);
+	}
+	for (uint32_t i = 0; i < HMAC_BLOCK_SIZE; i++) {
+		pad[i] ^= 0x36 ^ 0x5c;
+	}
+	if (PSA_SUCCESS == status) {
+		status = psa_hash_setup(&ctx->outer, PSA_ALG_SHA_256);
+	}
+	if (PSA_SUCCESS == status) {
+		status = psa_hash_update(&ctx->outer, pad, HMAC_BLOCK_SIZE);
+	}
+	memset(pad, 0, sizeof(pad));
+	if (PSA_SUCCESS != status) {
+		psa_hash_abort(&ctx->inner);
+		psa_hash_abort(&ctx->outer);
+		handle_external_runtime_error(status, __FILE__, __LINE__);
+		return unexpected_result_from_ext_lib;
+	}
+#endif
+	return ok;
+}
 
-	size_t combo_len = (32 + (size_t)info->len + 1);
+#if defined(TINYCRYPT) || defined(MBEDTLS)
+/**
+ * @brief			Computes HMAC(PRK, parts[0] | ... | parts[n-1])
+ *				starting from the hash states of a context.
+ * 
+ * @param[in] ctx		The keyed context.
+ * @param[in] parts		The message split in parts.
+ * @param parts_cnt		Number of parts.
+ * @param[out] out		The result, HASH_SIZE bytes.
+ * @return 			Ok or error code.
+ */
+static enum err hmac_with_ctx(const struct hkdf_ctx *ctx,
+			      const struct const_byte_array *parts,
+			      uint32_t parts_cnt, uint8_t *out)
+{
+	uint8_t inner_hash[HASH_SIZE];
+#if defined(TINYCRYPT)
+	struct tc_sha256_state_struct s = ctx->inner;
+	for (uint32_t i = 0; i < parts_cnt; i++) {
+		/*tinycrypt rejects empty updates*/
+		if (parts[i].len) {
+			TRY_EXPECT(tc_sha256_update(&s, parts[i].ptr,
+						    parts[i].len),
+				   1);
+		}
+	}
+	TRY_EXPECT(tc_sha256_final(inner_hash, &s), 1);
+	s = ctx->outer;
+	TRY_EXPECT(tc_sha256_update(&s, inner_hash, HASH_SIZE), 1);
+	TRY_EXPECT(tc_sha256_final(out, &s), 1);
+#elif defined(MBEDTLS)
+	psa_hash_operation_t s = PSA_HASH_OPERATION_INIT;
+	size_t len;
+	psa_status_t status = psa_hash_clone(&ctx->inner, &s);
+	for (uint32_t i = 0; i < parts_cnt && PSA_SUCCESS == status; i++) {
+		status = psa_hash_update(&s, parts[i].ptr, parts[i].len);
+	}
+	if (PSA_SUCCESS == status) {
+		status = psa_hash_finish(&s, inner_hash, HASH_SIZE, &len);
+	}
+	if (PSA_SUCCESS == status) {
+		status = psa_hash_clone(&ctx->outer, &s);
+	}
+	if (PSA_SUCCESS == status) {
+		status = psa_hash_update(&s, inner_hash, HASH_SIZE);
+	}
+	if (PSA_SUCCESS == status) {
+		status = psa_hash_finish(&s, out, HASH_SIZE, &len);
+	}
+	if (PSA_SUCCESS != status) {
+		psa_hash_abort(&s);
+		handle_external_runtime_error(status, __FILE__, __LINE__);
+		return unexpected_result_from_ext_lib;
+	}
+#endif
+	return ok;
+}
+#endif
 
-	TRY_EXPECT_PSA(check_buffer_size(INFO_MAX_SIZE + 32 + 1,
-					 (uint32_t)combo_len),
-		       ok, key_id, unexpected_result_from_ext_lib);
+enum err WEAK hkdf_ctx_expand(const struct hkdf_ctx *ctx,
+			      const struct byte_array *info,
+			      struct byte_array *out)
+{
+	/* "N = ceil(L/HashLen)" */
+	uint32_t iterations = (out->len + HASH_SIZE - 1) / HASH_SIZE;
+	/* "L length of output keying material in octets (<= 255*HashLen)"*/
+	if (iterations > 255) {
+		return hkdf_failed;
+	}
 
-	uint8_t combo[INFO_MAX_SIZE + 32 + 1];
-	uint8_t tmp_out[32];
-	memset(tmp_out, 0, 32);
-	memcpy(combo + 32, info->ptr, info->len);
-	size_t offset = 32;
+#if defined(TINYCRYPT) || defined(MBEDTLS)
+	/* "T(i) = HMAC-Hash(PRK, T(i-1) | info | i)", T(0) is empty */
+	uint8_t t[HASH_SIZE];
+	/*the counter byte wraps to 0 after 255, so the loop counts in 32 bit*/
+	uint8_t counter;
+	struct const_byte_array parts[3] = {
+		{ .len = 0, .ptr = t },
+		{ .len = info->len, .ptr = info->ptr },
+		{ .len = 1, .ptr = &counter },
+	};
 	for (uint32_t i = 1; i <= iterations; i++) {
-		memcpy(combo, tmp_out, 32);
-		combo[combo_len - 1] = (uint8_t)i;
-		size_t tmp_out_len;
-		status = psa_mac_compute(key_id, PSA_ALG_HMAC(PSA_ALG_SHA_256),
-					 combo + offset, combo_len - offset,
-					 tmp_out, 32, &tmp_out_len);
-		TRY_EXPECT_PSA(status, PSA_SUCCESS, key_id,
-			       unexpected_result_from_ext_lib);
-		offset = 0;
-		uint8_t *dest = out->ptr + ((i - 1) << 5);
-		if (out->len < (uint32_t)(i << 5)) {
-			memcpy(dest, tmp_out, out->len & 31);
-		} else {
-			memcpy(dest, tmp_out, 32);
+		counter = (uint8_t)i;
+		TRY(hmac_with_ctx(ctx, parts, 3, t));
+		parts[0].len = HASH_SIZE;
+
+		uint32_t offset = (uint32_t)(i - 1) * HASH_SIZE;
+		uint32_t len = out->len - offset;
+		if (len > HASH_SIZE) {
+			len = HASH_SIZE;
 		}
+		memcpy(out->ptr + offset, t, len);
 	}
-	TRY_EXPECT(psa_destroy_key(key_id), PSA_SUCCESS);
-#endif
+	memset(t, 0, sizeof(t));
 	return ok;
+#else
+	return hkdf_expand(ctx->alg, &ctx->prk, info, out);
+#endif
 }
 
-enum err WEAK hkdf_sha_256(struct byte_array *master_secret,
-			   struct byte_array *master_salt,
-			   struct byte_array *info, struct byte_array *out)
+enum err WEAK hkdf_ctx_deinit(struct hkdf_ctx *ctx)
 {
-	BYTE_ARRAY_NEW(prk, HASH_SIZE, HASH_SIZE);
-	TRY(hkdf_extract(SHA_256, master_salt, master_secret, prk.ptr));
-	TRY(hkdf_expand(SHA_256, &prk, info, out));
+	if (NULL == ctx) {
+		return wrong_parameter;
+	}
+#if defined(TINYCRYPT)
+	memset(&ctx->inner, 0, sizeof(ctx->inner));
+	memset(&ctx->outer, 0, sizeof(ctx->outer));
+#elif defined(MBEDTLS)
+	psa_hash_abort(&ctx->inner);
+	psa_hash_abort(&ctx->outer);
+#endif
 	return ok;
 }
 
@@ -711,7 +965,7 @@ enum err WEAK shared_secret_derive(enum ecdh_alg alg,
 		psa_alg = PSA_ALG_ECDH;
 		bits = PSA_BYTES_TO_BITS(sk->len);
 
-		TRY_EXPECT_PSA(psa_crypto_init(), PSA_SUCCESS, key_id,
+		TRY_EXPECT_PSA(psa_init_once(), PSA_SUCCESS, key_id,
 			       unexpected_result_from_ext_lib);
 
 		psa_key_attributes_t attr = PSA_KEY_ATTRIBUTES_INIT;
@@ -831,7 +1085,7 @@ enum err WEAK ephemeral_dh_key_gen(enum ecdh_alg alg, uint32_t seed,
 		if (P_256_PUB_KEY_X_CORD_SIZE > pk->len) {
 			return buffer_to_small;
 		}
-		TRY_EXPECT_PSA(psa_crypto_init(), PSA_SUCCESS, key_id,
+		TRY_EXPECT_PSA(psa_init_once(), PSA_SUCCESS, key_id,
 			       unexpected_result_from_ext_lib);
 
 		psa_set_key_usage_flags(&attributes,
@@ -8,6 +8,10 @@
    option. This file may not be copied, modified, or distributed
    except according to those terms.
 */
+#ifdef MBEDTLS
+/*must precede the first mbedtls header, crypto_wrapper.h includes psa*/
+#define MBEDTLS_ALLOW_PRIVATE_ACCESS
+#endif
 
 #include <stdbool.h>
 #include <stdint.h>
@@ -23,8 +27,6 @@
 #include "cbor/edhoc_decode_cert.h"
 
 #ifdef MBEDTLS
-#define MBEDTLS_ALLOW_PRIVATE_ACCESS
-
 #include <psa/crypto.h>
 #include <mbedtls/asn1.h>
 #include <mbedtls/error.h>
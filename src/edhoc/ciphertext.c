@@ -74,47 +74,75 @@ static enum err ciphertext_encrypt_decrypt(
 
 /**
  * @brief 			Computes the key stream for ciphertext 2 and 
- * 				the key and IV for ciphertext 3 and 4. 
+ * 				the key and IV for ciphertext 3 and 4 from 
+ * 				a keyed HKDF context. 
  * 
  * @param ctxt 			CIPHERTEXT2, CIPHERTEXT3 or CIPHERTEXT4.
- * @param edhoc_hash 		The EDHOC hash algorithm.
- * @param prk 			Pseudorandom key.
+ * @param prk 			HKDF context keyed with the pseudorandom key.
  * @param th 			Transcript hash.
  * @param[out] key 		The generated key/key stream.
  * @param[out] iv 		The generated iv.
  * @return 			Ok or error code. 
  */
-static enum err key_gen(enum ciphertext ctxt, enum hash_alg edhoc_hash,
-			struct byte_array *prk, struct byte_array *th,
-			struct byte_array *key, struct byte_array *iv)
+static enum err key_gen_with_ctx(enum ciphertext ctxt,
+				 const struct hkdf_ctx *prk,
+				 struct byte_array *th, struct byte_array *key,
+				 struct byte_array *iv)
 {
 	switch (ctxt) {
 	case CIPHERTEXT2:
-		TRY(edhoc_kdf(edhoc_hash, prk, KEYSTREAM_2, th, key));
+		TRY(edhoc_kdf_with_ctx(prk, KEYSTREAM_2, th, key));
 		PRINT_ARRAY("KEYSTREAM_2", key->ptr, key->len);
 		break;
 
 	case CIPHERTEXT3:
-		TRY(edhoc_kdf(edhoc_hash, prk, K_3, th, key));
+		TRY(edhoc_kdf_with_ctx(prk, K_3, th, key));
 
 		PRINT_ARRAY("K_3", key->ptr, key->len);
 
-		TRY(edhoc_kdf(edhoc_hash, prk, IV_3, th, iv));
+		TRY(edhoc_kdf_with_ctx(prk, IV_3, th, iv));
 		PRINT_ARRAY("IV_3", iv->ptr, iv->len);
 		break;
 
 	case CIPHERTEXT4:
-		PRINT_ARRAY("PRK_4e3m", prk->ptr, prk->len);
 		PRINT_ARRAY("TH_4", th->ptr, th->len);
-		TRY(edhoc_kdf(edhoc_hash, prk, K_4, th, key));
+		TRY(edhoc_kdf_with_ctx(prk, K_4, th, key));
 		PRINT_ARRAY("K_4", key->ptr, key->len);
-		TRY(edhoc_kdf(edhoc_hash, prk, IV_4, th, iv));
+		TRY(edhoc_kdf_with_ctx(prk, IV_4, th, iv));
 		PRINT_ARRAY("IV_4", iv->ptr, iv->len);
 		break;
 	}
 	return ok;
 }
 
+/**
+ * @brief 			Computes the key stream for ciphertext 2 and 
+ * 				the key and IV for ciphertext 3 and 4. The 
+ * 				PRK is keyed once for both the key and the IV.
+ * 
+ * @param ctxt 			CIPHERTEXT2, CIPHERTEXT3 or CIPHERTEXT4.
+ * @param edhoc_hash 		The EDHOC hash algorithm.
+ * @param prk 			Pseudorandom key.
+ * @param th 			Transcript hash.
+ * @param[out] key 		The generated key/key stream.
+ * @param[out] iv 		The generated iv.
+ * @return 			Ok or error code. 
+ */
+static enum err key_gen(enum ciphertext ctxt, enum hash_alg edhoc_hash,
+			struct byte_array *prk, struct byte_array *th,
+			struct byte_array *key, struct byte_array *iv)
+{
+	if (ctxt == CIPHERTEXT4) {
+		PRINT_ARRAY("PRK_4e3m", prk->ptr, prk->len);
+	}
+
+	struct hkdf_ctx prk_ctx;
+	TRY(hkdf_ctx_init(edhoc_hash, prk, &prk_ctx));
+	enum err r = key_gen_with_ctx(ctxt, &prk_ctx, th, key, iv);
+	TRY(hkdf_ctx_deinit(&prk_ctx));
+	return r;
+}
+
 enum err ciphertext_decrypt_split(enum ciphertext ctxt, struct suite *suite,
 				  struct byte_array *id_cred,
 				  struct byte_array *sig_or_mac,
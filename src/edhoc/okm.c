@@ -32,3 +32,15 @@ enum err edhoc_kdf(enum hash_alg hash_alg, const struct byte_array *prk,
 	PRINT_ARRAY("info", info.ptr, info.len);
 	return hkdf_expand(hash_alg, prk, &info, okm);
 }
+
+enum err edhoc_kdf_with_ctx(const struct hkdf_ctx *prk, uint8_t label,
+			    struct byte_array *context,
+			    struct byte_array *okm)
+{
+	BYTE_ARRAY_NEW(info, INFO_MAX_SIZE, context->len + ENCODING_OVERHEAD);
+
+	TRY(create_hkdf_info(label, context, okm->len, &info));
+
+	PRINT_ARRAY("info", info.ptr, info.len);
+	return hkdf_ctx_expand(prk, &info, okm);
+}
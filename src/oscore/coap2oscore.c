@@ -185,11 +185,29 @@ STATIC enum err inner_outer_option_split(struct o_coap_packet *in_o_coap,
 	return r;
 }
 
+/**
+ * @brief Total length of payload segments
+ * @param payload: payload segments
+ * @param payload_cnt: number of segments
+ * @return length in bytes
+ */
+static inline uint32_t segments_len(const struct byte_array *payload,
+				    uint32_t payload_cnt)
+{
+	uint32_t len = 0;
+	for (uint32_t i = 0; i < payload_cnt; i++) {
+		len += payload[i].len;
+	}
+	return len;
+}
+
 /**
  * @brief Build up plaintext which should be encrypted and protected
  * @param in_o_coap: input CoAP packet that will be analyzed
  * @param E_options: E-options, which should be protected
  * @param E_options_cnt: count number of E-options
+ * @param payload: payload segments, gathered into the plaintext
+ * @param payload_cnt: number of payload segments
  * @param plaintext: output plaintext, which will be encrypted
  * @return err
  *
@@ -197,6 +215,8 @@ STATIC enum err inner_outer_option_split(struct o_coap_packet *in_o_coap,
 static inline enum err plaintext_setup(struct o_coap_packet *in_o_coap,
 				       struct o_coap_option *E_options,
 				       uint8_t E_options_cnt,
+				       const struct byte_array *payload,
+				       uint32_t payload_cnt,
 				       struct byte_array *plaintext)
 {
 	uint8_t *temp_plaintext_ptr = plaintext->ptr;
@@ -204,35 +224,27 @@ static inline enum err plaintext_setup(struct o_coap_packet *in_o_coap,
 	/* Add code to plaintext */
 	*temp_plaintext_ptr = in_o_coap->header.code;
 
-	/* Calculate the maximal length of all options, i.e. all options 
-	have two bytes extra delta and length */
-	uint16_t e_opt_serial_len = 0;
-	for (uint8_t i = 0; i < E_options_cnt; i++) {
-		e_opt_serial_len = (uint16_t)(e_opt_serial_len + 1 + 2 + 2 +
-					      E_options[i].len);
-	}
-	/* Setup buffer */
-	BYTE_ARRAY_NEW(e_opt_serial, E_OPTIONS_BUFF_MAX_LEN, E_OPTIONS_BUFF_MAX_LEN);
-
-	/* Convert all E-options structure to byte string, and copy it to 
+	/* Convert all E-options structure to byte string directly in the 
 	output*/
+	struct byte_array e_opt_serial =
+		BYTE_ARRAY_INIT(temp_plaintext_ptr + 1, plaintext->len - 1);
 	TRY(options_serialize(E_options, E_options_cnt, &e_opt_serial));
-
-	uint32_t dest_size = (plaintext->len - (uint32_t)(temp_plaintext_ptr +
-							  1 - plaintext->ptr));
-	TRY(_memcpy_s(++temp_plaintext_ptr, dest_size, e_opt_serial.ptr,
-		      e_opt_serial.len));
-	temp_plaintext_ptr += e_opt_serial.len;
+	temp_plaintext_ptr += 1 + e_opt_serial.len;
 
 	/* Add payload to plaintext*/
-	if (in_o_coap->payload.len != 0) {
+	if (segments_len(payload, payload_cnt) != 0) {
 		/* An extra byte 0xFF before payload*/
-		*temp_plaintext_ptr = 0xff;
-
-		dest_size = (plaintext->len - (uint32_t)(temp_plaintext_ptr +
-							 1 - plaintext->ptr));
-		TRY(_memcpy_s(++temp_plaintext_ptr, dest_size,
-			      in_o_coap->payload.ptr, in_o_coap->payload.len));
+		*temp_plaintext_ptr++ = 0xff;
+
+		for (uint32_t i = 0; i < payload_cnt; i++) {
+			uint32_t dest_size =
+				(plaintext->len -
+				 (uint32_t)(temp_plaintext_ptr -
+					    plaintext->ptr));
+			TRY(_memcpy_s(temp_plaintext_ptr, dest_size,
+				      payload[i].ptr, payload[i].len));
+			temp_plaintext_ptr += payload[i].len;
+		}
 	}
 	PRINT_ARRAY("Plain text", plaintext->ptr, plaintext->len);
 	return ok;
@@ -440,29 +452,253 @@ STATIC enum err oscore_pkg_generate(struct o_coap_packet *in_o_coap,
 }
 
 /**
- * @brief Increment Sender Sequence Number and call the function to periodically write it to NVM.
+ * @brief Takes cnt consecutive Sender Sequence Numbers of a context. With 
+ *        OSCORE_THREAD_SAFE this is one atomic operation, so that SSNs can 
+ *        be taken without the lock of the context, see 
+ *        oscore_ssn_block_reserve().
  * 
  * @param c Security context.
- * @return enum err 
+ * @param cnt Number of SSNs.
+ * @return The first of the SSNs.
  */
-static enum err generate_new_ssn(struct context *c)
+static uint64_t ssn_fetch_add(struct context *c, uint64_t cnt)
 {
-	if (NULL == c) {
-		return wrong_parameter;
-	}
+#ifdef OSCORE_THREAD_SAFE
+	return __atomic_fetch_add(&c->sc.ssn, cnt, __ATOMIC_SEQ_CST);
+#else
+	return (c->sc.ssn += cnt) - cnt;
+#endif
+}
 
-	c->sc.ssn++;
+/**
+ * @brief Gives back the unused SSNs at the end of a reserved range, unless 
+ *        further SSNs were taken in the meantime.
+ * 
+ * @param c Security context.
+ * @param reserved_end End of the reserved range.
+ * @param used_end End of the used part of the range.
+ */
+static void ssn_give_back(struct context *c, uint64_t reserved_end,
+			  uint64_t used_end)
+{
+#ifdef OSCORE_THREAD_SAFE
+	__atomic_compare_exchange_n(&c->sc.ssn, &reserved_end, used_end, false,
+				    __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+#else
+	if (c->sc.ssn == reserved_end) {
+		c->sc.ssn = used_end;
+	}
+#endif
+}
 
 #ifdef OSCORE_NVM_SUPPORT
+/**
+ * @brief Serializes the writes of the SSN of a context in NVM, so that the 
+ *        value in NVM never goes back. It may be taken with the context 
+ *        locked, but not the other way round. Does nothing if 
+ *        OSCORE_THREAD_SAFE is not defined.
+ */
+static void nvm_lock(struct context *c)
+{
+#ifdef OSCORE_THREAD_SAFE
+	oscore_lock_acquire(&c->sc.nvm_lock);
+#else
+	(void)c;
+#endif
+}
+
+/**
+ * @brief Releases the lock taken with nvm_lock().
+ */
+static void nvm_unlock(struct context *c)
+{
+#ifdef OSCORE_THREAD_SAFE
+	oscore_lock_release(&c->sc.nvm_lock);
+#else
+	(void)c;
+#endif
+}
+
+/**
+ * @brief Adapts the SSN interval of a context to its message rate, so that 
+ *        the SSN is written about once per write period. nvm_lock() must be 
+ *        held.
+ * 
+ * @param c Security context.
+ * @param now Output time of the write, if the context has a clock.
+ * @return The interval for the next write.
+ */
+static uint32_t ssn_interval_adapt(struct context *c, uint32_t *now)
+{
+	uint32_t interval = c->sc.ssn_interval;
+	if (NULL == c->sc.ssn_clock) {
+		return interval;
+	}
+
+	*now = c->sc.ssn_clock();
+	/* the difference is correct also if the clock wrapped around */
+	uint32_t elapsed = (uint32_t)(*now - c->sc.ssn_last_write);
+	if ((elapsed < c->sc.ssn_write_period / 2) &&
+	    (interval <= OSCORE_SSN_INTERVAL_MAX / 2)) {
+		interval *= 2;
+	} else if ((elapsed / 2 > c->sc.ssn_write_period) &&
+		   (interval >= 2 * OSCORE_SSN_INTERVAL_MIN)) {
+		interval /= 2;
+	}
+	return interval;
+}
+
+/**
+ * @brief Writes an SSN in NVM with the interval of the context. nvm_lock() 
+ *        must be held.
+ * 
+ * @param c Security context.
+ * @param ssn SSN to be written, not below the SSNs used so far.
+ * @param deferrable true if the hook may defer the sync of the NVM, see 
+ *        oscore_ssn_durable(). The SSNs are then not covered on return.
+ * @return enum err 
+ */
+static enum err ssn_write(struct context *c, uint64_t ssn, bool deferrable)
+{
+	uint32_t now = 0;
+	uint32_t interval = ssn_interval_adapt(c, &now);
+
+	/* The covered SSNs never shrink when the interval does: SSNs below 
+	   the previous bound may be in use while the value is written. */
+	uint64_t bound = ssn + interval;
+	if (bound < ssn_atomic_load(&c->sc.ssn_nvm_bound)) {
+		bound = ssn_atomic_load(&c->sc.ssn_nvm_bound);
+	}
+	if (bound < ssn_atomic_load(&c->sc.ssn_nvm_pending)) {
+		bound = ssn_atomic_load(&c->sc.ssn_nvm_pending);
+	}
+
 	struct nvm_key_t nvm_key = { .sender_id = c->sc.sender_id,
 				     .recipient_id = c->rc.recipient_id,
 				     .id_context = c->cc.id_context };
+	enum err r =
+		nvm_write_ssn_interval(&nvm_key, ssn, (uint32_t)(bound - ssn));
+	bool deferred = deferrable && (oscore_nvm_write_deferred == r);
+	if (!deferred) {
+		TRY(r);
+	}
+	ssn_atomic_store(&c->sc.ssn_in_nvm, ssn);
+	c->sc.ssn_interval = interval;
+	c->sc.ssn_last_write = now;
+	if (deferred) {
+		/* the old bound stays until the value is known to be durable */
+		ssn_atomic_store(&c->sc.ssn_nvm_pending, bound);
+		return ok;
+	}
+	ssn_atomic_store(&c->sc.ssn_nvm_request_at, ssn + (bound - ssn) / 2);
+	ssn_atomic_store(&c->sc.ssn_nvm_bound, bound);
+	return ok;
+}
+
+/**
+ * @brief Checks if ssn_persist() has to be called before SSNs below end 
+ *        are used. Can be called without the lock of the context.
+ * 
+ * @param c Security context.
+ * @param end End of the SSNs to be used.
+ * @return true if the SSN must be written or a write-behind requested.
+ */
+static bool ssn_persist_due(struct context *c, uint64_t end)
+{
+	if (NULL != c->sc.ssn_write_request) {
+		/* the write-behind is requested after half of the interval */
+		return end > ssn_atomic_load(&c->sc.ssn_nvm_request_at);
+	}
+	return end > ssn_atomic_load(&c->sc.ssn_nvm_bound);
+}
+
+/**
+ * @brief Stores the SSN in NVM (if needed) before SSNs below end are used. 
+ *        The context must be locked. All SSNs below the value in NVM plus 
+ *        the interval stored with it are covered after a reboot, see 
+ *        ssn_init(). The value written is the current SSN of the context, which also 
+ *        covers the blocks reserved by other threads in the meantime. It 
+ *        never goes back, so that it stays an upper bound of all SSNs handed 
+ *        out so far. With a write-behind hook, the write is only requested,
+ *        unless all SSNs covered by the value in NVM are used up.
+ * 
+ * @param c Security context.
+ * @param end End of the SSNs to be used.
+ * @return enum err 
+ */
+static enum err ssn_persist(struct context *c, uint64_t end)
+{
+	/* While the device is still in the ECHO synchronization mode (after device reboot or other context reinitialization)
+	   SSN has to be written immediately, in case of uncontrolled reboot before first cyclic write happens. */
 	bool echo_sync_in_progress =
 		(ECHO_SYNCHRONIZED != c->rrc.echo_state_machine);
-	return ssn_store_in_nvm(&nvm_key, c->sc.ssn, echo_sync_in_progress);
+	bool write_behind = (NULL != c->sc.ssn_write_request);
+	bool covered = (end <= ssn_atomic_load(&c->sc.ssn_nvm_bound));
+
+	if (write_behind && covered) {
+		/* Only one write-behind is requested at a time. */
+		if ((echo_sync_in_progress || ssn_persist_due(c, end)) &&
+		    (ssn_atomic_load(&c->sc.ssn_nvm_requested) <=
+		     ssn_atomic_load(&c->sc.ssn_in_nvm))) {
+			ssn_atomic_store(&c->sc.ssn_nvm_requested, end);
+			c->sc.ssn_write_request(c);
+		}
+		return ok;
+	}
+	if (!write_behind && !echo_sync_in_progress && covered) {
+		return ok;
+	}
+
+	/* Wait for a write-behind in progress, which may cover end already. */
+	nvm_lock(c);
+	enum err r = ok;
+	if (!write_behind || (end > ssn_atomic_load(&c->sc.ssn_nvm_bound))) {
+		uint64_t ssn = ssn_atomic_load(&c->sc.ssn);
+		if (ssn < end) {
+			ssn = end;
+		}
+		if (ssn < ssn_atomic_load(&c->sc.ssn_in_nvm)) {
+			ssn = ssn_atomic_load(&c->sc.ssn_in_nvm);
+		}
+		r = ssn_write(c, ssn, false);
+	}
+	nvm_unlock(c);
+	return r;
+}
+#endif
+
+/**
+ * @brief Takes the next Sender Sequence Number and converts it to a PIV.
+ * 
+ * @param c Security context.
+ * @param range Reserved SSN range, or NULL to take the SSN of the context.
+ * @param piv Output PIV.
+ * @return enum err 
+ */
+static enum err take_ssn(struct context *c, struct oscore_ssn_block *range,
+			 struct byte_array *piv)
+{
+	if (NULL == range) {
+		/* Blocks reserved without the lock may have used up the SSNs 
+		   since the freshness check. */
+		uint64_t ssn = ssn_fetch_add(c, 1);
+		if (ssn >= OSCORE_SSN_OVERFLOW_VALUE) {
+			return oscore_ssn_overflow;
+		}
+		TRY(ssn2piv(ssn, piv));
+#ifdef OSCORE_NVM_SUPPORT
+		return ssn_persist(c, ssn + 1);
 #else
-	return ok;
+		return ok;
 #endif
+	}
+
+	if (range->next >= range->end) {
+		return oscore_ssn_overflow;
+	}
+	TRY(ssn2piv(range->next, piv));
+	range->next++;
+	return ok;
 }
 
 /**
@@ -484,104 +720,251 @@ static bool needs_new_piv(enum o_coap_msg msg_type, enum echo_state echo_state)
 }
 
 /**
- * @brief Wrapper function with common operations for encrypting the payload.
- *        These operations are shared in all possible scenarios.
- *        For more info, see RFC8616 8.1 and 8.3.
+ * @brief Values of the context used for encrypting one packet. They are 
+ *        copied out of the context, so that the encryption itself can run 
+ *        without holding the lock of the context.
+ */
+struct encrypt_params {
+	enum o_coap_msg msg_type;
+	struct byte_array token;
+	bool use_new_piv;
+	struct byte_array piv;
+	struct byte_array kid;
+	struct byte_array kid_context;
+	struct byte_array nonce;
+	struct byte_array request_piv;
+	struct byte_array request_kid;
+	uint8_t piv_buf[MAX_PIV_LEN];
+	uint8_t nonce_buf[NONCE_LEN];
+	uint8_t request_piv_buf[MAX_PIV_LEN];
+	uint8_t request_kid_buf[MAX_KID_LEN];
+};
+
+/**
+ * @brief Takes a fresh PIV (if needed) and reads the nonce and the request 
+ *        fields for the AAD from the context. The context must be locked.
  * 
- * @param plaintext Input plaintext to be encrypted.
- * @param ciphertext Output encrypted payload for the OSCORE packet.
  * @param c Security context.
- * @param input_coap Input coap packet.
- * @param oscore_option Output OSCORE option.
+ * @param e_options E-options of the input packet.
+ * @param e_options_cnt Number of E-options.
+ * @param range Reserved SSN range, or NULL to take the SSN of the context.
+ * @param p In: message type and token, out: the remaining values.
  * @return enum err 
  */
-static enum err encrypt_wrapper(struct byte_array *plaintext,
-				struct byte_array *ciphertext,
-				struct context *c,
-				struct o_coap_packet *input_coap,
-				struct oscore_option *oscore_option)
+static enum err encrypt_params_get(struct context *c,
+				   struct o_coap_option *e_options,
+				   uint8_t e_options_cnt,
+				   struct oscore_ssn_block *range,
+				   struct encrypt_params *p)
 {
-	BYTE_ARRAY_NEW(new_piv, MAX_PIV_LEN, MAX_PIV_LEN);
-	BYTE_ARRAY_NEW(new_nonce, NONCE_LEN, NONCE_LEN);
-	struct byte_array piv = BYTE_ARRAY_INIT(NULL, 0);
-	struct byte_array kid = BYTE_ARRAY_INIT(NULL, 0);
-	struct byte_array kid_context = BYTE_ARRAY_INIT(NULL, 0);
-	struct byte_array nonce;
-
-	/* Read necessary fields from the input packet. */
-	enum o_coap_msg msg_type;
-	TRY(coap_get_message_type(input_coap, &msg_type));
-	struct byte_array token =
-		BYTE_ARRAY_INIT(input_coap->token, input_coap->header.TKL);
+	p->piv = (struct byte_array)BYTE_ARRAY_INIT(p->piv_buf,
+						    sizeof(p->piv_buf));
+	p->nonce = (struct byte_array)BYTE_ARRAY_INIT(p->nonce_buf,
+						      sizeof(p->nonce_buf));
+	p->kid = (struct byte_array)BYTE_ARRAY_INIT(NULL, 0);
+	p->kid_context = (struct byte_array)BYTE_ARRAY_INIT(NULL, 0);
+
+	if ((ECHO_VERIFY == c->rrc.echo_state_machine) &&
+	    (NULL == c->rrc.echo_key)) {
+		/* A server prepares a response with ECHO challenge after the reboot. 
+		   Echo values created with an echo_key are verified without a copy. */
+		TRY(cache_echo_val(&c->rrc.echo_opt_val, e_options,
+				   e_options_cnt));
+	}
 
 	/* Generate new PIV/nonce if needed. */
-	bool use_new_piv = needs_new_piv(msg_type, c->rrc.echo_state_machine);
-	if (use_new_piv) {
-		TRY(ssn2piv(c->sc.ssn, &new_piv));
-		TRY(generate_new_ssn(c));
-		TRY(create_nonce(&c->sc.sender_id, &new_piv, &c->cc.common_iv,
-				 &new_nonce));
-
-		nonce = new_nonce;
-		piv = new_piv;
-		kid = c->sc.sender_id;
-		kid_context = c->cc.id_context;
+	p->use_new_piv =
+		needs_new_piv(p->msg_type, c->rrc.echo_state_machine);
+	if (p->use_new_piv) {
+		TRY(take_ssn(c, range, &p->piv));
+		TRY(create_nonce(&c->sc.sender_id, &p->piv, &c->cc.common_iv,
+				 &p->nonce));
+		p->kid = c->sc.sender_id;
+		p->kid_context = c->cc.id_context;
 	} else {
-		nonce = c->rrc.nonce;
+		p->piv.len = 0;
+		TRY(byte_array_cpy(&p->nonce, &c->rrc.nonce,
+				   sizeof(p->nonce_buf)));
 	}
 
-	/* Generate OSCORE option based on selected values. */
-	TRY(oscore_option_generate(&piv, &kid, &kid_context, oscore_option));
-
 	/* AAD shares the same format for both requests and responses, 
 	   yet request_kid and request_piv fields are only used by responses.
 	   For more details, see 5.4. */
-	BYTE_ARRAY_NEW(aad, MAX_AAD_LEN, MAX_AAD_LEN);
-	struct byte_array request_piv = piv;
-	struct byte_array request_kid = kid;
-	TRY(oscore_interactions_read_wrapper(msg_type, &token,
-					     c->rrc.interactions, &request_piv,
+	struct byte_array request_piv = p->piv;
+	struct byte_array request_kid = p->kid;
+	TRY(oscore_interactions_read_wrapper(p->msg_type, &p->token,
+					     &c->rrc.interactions, &request_piv,
 					     &request_kid));
-	TRY(create_aad(NULL, 0, c->cc.aead_alg, &request_kid, &request_piv,
-		       &aad));
-
-	/* Encrypt the plaintext */
-	TRY(oscore_cose_encrypt(plaintext, ciphertext, &nonce, &aad,
-				&c->sc.sender_key));
+	p->request_piv = (struct byte_array)BYTE_ARRAY_INIT(
+		p->request_piv_buf, sizeof(p->request_piv_buf));
+	p->request_kid = (struct byte_array)BYTE_ARRAY_INIT(
+		p->request_kid_buf, sizeof(p->request_kid_buf));
+	TRY(byte_array_cpy(&p->request_piv, &request_piv,
+			   sizeof(p->request_piv_buf)));
+	return byte_array_cpy(&p->request_kid, &request_kid,
+			      sizeof(p->request_kid_buf));
+}
 
+/**
+ * @brief Stores the state of an encrypted packet in the context. The context 
+ *        must be locked.
+ * 
+ * @param c Security context.
+ * @param p Values used for the encryption.
+ * @param uri_paths_hash Hash of the URI paths of the packet.
+ * @return enum err 
+ */
+static enum err encrypt_params_put(struct context *c,
+				   struct encrypt_params *p,
+				   uint64_t uri_paths_hash)
+{
 	/* Update nonce only after successful encryption (for handling future responses). */
-	if (use_new_piv) {
-		TRY(byte_array_cpy(&c->rrc.nonce, &nonce, NONCE_LEN));
+	if (p->use_new_piv) {
+		TRY(byte_array_cpy(&c->rrc.nonce, &p->nonce, NONCE_LEN));
 	}
 
 	/* Handle OSCORE interactions after successful encryption. */
-	BYTE_ARRAY_NEW(uri_paths, OSCORE_MAX_URI_PATH_LEN,
-		       OSCORE_MAX_URI_PATH_LEN);
-	TRY(uri_path_create(input_coap->options, input_coap->options_cnt,
-			    uri_paths.ptr, &(uri_paths.len)));
-	TRY(oscore_interactions_update_wrapper(msg_type, &token, &uri_paths,
-					       c->rrc.interactions,
-					       &request_piv, &request_kid));
+	return oscore_interactions_update_wrapper(p->msg_type, &p->token,
+						  uri_paths_hash,
+						  &c->rrc.interactions,
+						  &p->request_piv,
+						  &p->request_kid);
+}
 
-	return ok;
+/**
+ * @brief Keeps a protected piggybacked response, so that retransmissions of 
+ *        its request are answered with it, see struct oscore_response_cache.
+ *        The context must be locked.
+ * 
+ * @param c Security context.
+ * @param o_coap_pkt The CoAP response.
+ * @param p Values used for the encryption.
+ * @param buf_oscore The serialized OSCORE response.
+ * @param buf_oscore_len Length of the OSCORE response.
+ * @return enum err 
+ */
+static enum err response_cache_put(struct context *c,
+				   struct o_coap_packet *o_coap_pkt,
+				   struct encrypt_params *p, uint8_t *buf_oscore,
+				   uint32_t buf_oscore_len)
+{
+	/* Only a piggybacked response has the Message ID of its request. */
+	if ((COAP_MSG_RESPONSE != p->msg_type) ||
+	    (TYPE_ACK != o_coap_pkt->header.type)) {
+		return ok;
+	}
+	struct byte_array response = BYTE_ARRAY_INIT(buf_oscore, buf_oscore_len);
+	struct byte_array request_digest = BYTE_ARRAY_INIT(
+		c->rrc.request_digest, sizeof(c->rrc.request_digest));
+	return oscore_response_cache_put(&c->rrc.responses, &p->request_piv,
+					 o_coap_pkt->header.MID,
+					 &request_digest, &response);
 }
 
 /**
- *@brief 	Converts a CoAP packet to OSCORE packet
- *@note		For messaging layer packets (simple ACK with no payload, code 0.00),
- *			encryption is dismissed and raw input buffer is copied, 
- *			as specified at section 4.2 in RFC8613.
+ * @brief Reads the context and generates the OSCORE option of a packet, the 
+ *        first part of encrypt_wrapper().
+ * 
+ * @param c Security context.
+ * @param input_coap Input coap packet.
+ * @param e_options E-options of the input packet.
+ * @param e_options_cnt Number of E-options.
+ * @param range Reserved SSN range, or NULL to take the SSN of the context.
+ * @param lock If true, the context is locked while it is read. If false, 
+ *        the caller holds the lock.
+ * @param p Output values for the encryption.
+ * @param oscore_option Output OSCORE option.
+ * @return enum err 
+ */
+static enum err encrypt_begin(struct context *c,
+			      struct o_coap_packet *input_coap,
+			      struct o_coap_option *e_options,
+			      uint8_t e_options_cnt,
+			      struct oscore_ssn_block *range, bool lock,
+			      struct encrypt_params *p,
+			      struct oscore_option *oscore_option)
+{
+	/* Read necessary fields from the input packet. */
+	TRY(coap_get_message_type(input_coap, &p->msg_type));
+	p->token = (struct byte_array)BYTE_ARRAY_INIT(input_coap->token,
+						      input_coap->header.TKL);
+
+	if (lock) {
+		context_lock(c);
+	}
+	enum err r = encrypt_params_get(c, e_options, e_options_cnt, range, p);
+	if (lock) {
+		context_unlock(c);
+	}
+	TRY(r);
+
+	/* Generate OSCORE option based on selected values. */
+	return oscore_option_generate(&p->piv, &p->kid, &p->kid_context,
+				      oscore_option);
+}
+
+/**
+ * @brief Wrapper function with common operations for encrypting the payload.
+ *        These operations are shared in all possible scenarios.
+ *        For more info, see RFC8616 8.1 and 8.3.
+ * @note  The plaintext may be encrypted in place, i.e., the ciphertext may 
+ *        start at the same address.
+ * 
+ * @param plaintext Input plaintext to be encrypted.
+ * @param ciphertext Output encrypted payload for the OSCORE packet.
+ * @param c Security context.
+ * @param input_coap Input coap packet.
+ * @param p Values returned by encrypt_begin().
+ * @param lock If true, the context is locked only while it is updated, but 
+ *        not during the encryption. If false, the caller holds the lock.
+ * @return enum err 
+ */
+static enum err encrypt_wrapper(struct byte_array *plaintext,
+				struct byte_array *ciphertext,
+				struct context *c,
+				struct o_coap_packet *input_coap,
+				struct encrypt_params *p, bool lock)
+{
+	BYTE_ARRAY_NEW(aad, MAX_AAD_LEN, MAX_AAD_LEN);
+	TRY(create_aad(NULL, 0, c->cc.aead_alg, &p->request_kid,
+		       &p->request_piv, &aad));
+
+	/* Encrypt the plaintext */
+	TRY(oscore_cose_encrypt(plaintext, ciphertext, &p->nonce, &aad,
+				&c->sc.sender_key_handle));
+
+	uint64_t uri_paths_hash;
+	TRY(uri_path_hash(input_coap->options, input_coap->options_cnt,
+			  &uri_paths_hash));
+
+	if (lock) {
+		context_lock(c);
+	}
+	enum err r = encrypt_params_put(c, p, uri_paths_hash);
+	if (lock) {
+		context_unlock(c);
+	}
+	return r;
+}
+
+/**
+ *@brief 	Converts a CoAP packet to OSCORE packet. The freshness of the 
+ *		context must be checked by the caller.
  *@param	buf_o_coap a buffer containing a CoAP packet
  *@param	buf_o_coap_len length of the CoAP buffer
  *@param	buf_oscore a buffer where the OSCORE packet will be written
  *@param	buf_oscore_len length of the OSCORE packet
  *@param	c a struct containing the OSCORE context
+ *@param	range reserved SSN range, or NULL to take the SSN of the context
+ *@param	lock true to lock the context only while it is accessed, false 
+ *		if the caller holds the lock
  *
  *@return	err
  */
-enum err coap2oscore(uint8_t *buf_o_coap, uint32_t buf_o_coap_len,
-		     uint8_t *buf_oscore, uint32_t *buf_oscore_len,
-		     struct context *c)
+static enum err protect(uint8_t *buf_o_coap, uint32_t buf_o_coap_len,
+			uint8_t *buf_oscore, uint32_t *buf_oscore_len,
+			struct context *c, struct oscore_ssn_block *range,
+			bool lock)
 {
 	struct o_coap_packet o_coap_pkt;
 	struct byte_array buf;
@@ -593,9 +976,6 @@ enum err coap2oscore(uint8_t *buf_o_coap, uint32_t buf_o_coap_len,
 	buf.len = buf_o_coap_len;
 	buf.ptr = buf_o_coap;
 
-	/* Make sure that given context is fresh enough to process the message. */
-	TRY(check_context_freshness(c));
-
 	/* Parse the coap buf into a CoAP struct */
 	memset(&o_coap_pkt, 0, sizeof(o_coap_pkt));
 	TRY(coap_deserialize(&buf, &o_coap_pkt));
@@ -634,22 +1014,20 @@ enum err coap2oscore(uint8_t *buf_o_coap, uint32_t buf_o_coap_len,
 	BYTE_ARRAY_NEW(plaintext, MAX_PLAINTEXT_LEN, plaintext_len);
 
 	/* Combine code, E-options and payload of CoAP to plaintext */
-	TRY(plaintext_setup(&o_coap_pkt, e_options, e_options_cnt, &plaintext));
+	TRY(plaintext_setup(&o_coap_pkt, e_options, e_options_cnt,
+			    &o_coap_pkt.payload, 1, &plaintext));
 
 	/* Generate ciphertext array */
 	BYTE_ARRAY_NEW(ciphertext, MAX_CIPHERTEXT_LEN,
 		       plaintext.len + AUTH_TAG_LEN);
 
-	if (ECHO_VERIFY == c->rrc.echo_state_machine) {
-		/* A server prepares a response with ECHO challenge after the reboot. */
-		TRY(cache_echo_val(&c->rrc.echo_opt_val, e_options,
-				   e_options_cnt));
-	}
-
 	/* Encrypt data using either a freshly generated nonce (if needed), or the one cached from the corresponding request. */
+	struct encrypt_params p;
 	struct oscore_option oscore_option;
-	TRY(encrypt_wrapper(&plaintext, &ciphertext, c, &o_coap_pkt,
-			    &oscore_option));
+	TRY(encrypt_begin(c, &o_coap_pkt, e_options, e_options_cnt, range, lock,
+			  &p, &oscore_option));
+	TRY(encrypt_wrapper(&plaintext, &ciphertext, c, &o_coap_pkt, &p,
+			    lock));
 
 	/*create an OSCORE packet*/
 	struct o_coap_packet oscore_pkt;
@@ -657,5 +1035,483 @@ enum err coap2oscore(uint8_t *buf_o_coap, uint32_t buf_o_coap_len,
 				u_options_cnt, &ciphertext, &oscore_option));
 
 	/*convert the oscore pkg to byte string*/
-	return coap_serialize(&oscore_pkt, buf_oscore, buf_oscore_len);
+	TRY(coap_serialize(&oscore_pkt, buf_oscore, buf_oscore_len));
+
+	if (lock) {
+		context_lock(c);
+	}
+	enum err r = response_cache_put(c, &o_coap_pkt, &p, buf_oscore,
+					*buf_oscore_len);
+	if (lock) {
+		context_unlock(c);
+	}
+	return r;
+}
+
+/**
+ *@brief 	Converts a CoAP packet to OSCORE packet
+ *@note		For messaging layer packets (simple ACK with no payload, code 0.00),
+ *			encryption is dismissed and raw input buffer is copied, 
+ *			as specified at section 4.2 in RFC8613.
+ *@param	buf_o_coap a buffer containing a CoAP packet
+ *@param	buf_o_coap_len length of the CoAP buffer
+ *@param	buf_oscore a buffer where the OSCORE packet will be written
+ *@param	buf_oscore_len length of the OSCORE packet
+ *@param	c a struct containing the OSCORE context
+ *
+ *@return	err
+ */
+enum err coap2oscore(uint8_t *buf_o_coap, uint32_t buf_o_coap_len,
+		     uint8_t *buf_oscore, uint32_t *buf_oscore_len,
+		     struct context *c)
+{
+	if (NULL == c) {
+		return wrong_parameter;
+	}
+
+	context_lock(c);
+	/* Make sure that given context is fresh enough to process the message. */
+	enum err r = check_context_freshness(c);
+	if (ok == r) {
+		r = protect(buf_o_coap, buf_o_coap_len, buf_oscore,
+			    buf_oscore_len, c, NULL, false);
+	}
+	context_unlock(c);
+	return r;
+}
+
+/**
+ * @brief Predicts the length of the OSCORE option of the next packet 
+ *        protected with the SSN of a context. The context must be locked.
+ * 
+ * @param c Security context.
+ * @param input_coap Input coap packet.
+ * @param len Output length of the OSCORE option value.
+ * @return enum err 
+ */
+static enum err oscore_option_len_predict(struct context *c,
+					  struct o_coap_packet *input_coap,
+					  uint8_t *len)
+{
+	enum o_coap_msg msg_type;
+	TRY(coap_get_message_type(input_coap, &msg_type));
+
+	*len = 0;
+	if (needs_new_piv(msg_type, c->rrc.echo_state_machine)) {
+		BYTE_ARRAY_NEW(piv, MAX_PIV_LEN, MAX_PIV_LEN);
+		TRY(ssn2piv(ssn_atomic_load(&c->sc.ssn), &piv));
+		*len = (uint8_t)get_oscore_opt_val_len(
+			piv.len, c->sc.sender_id.len, c->cc.id_context.len);
+	}
+	return ok;
+}
+
+/**
+ * @brief Checks that the header and the ciphertext of an OSCORE packet fit 
+ *        into the output segments.
+ * 
+ * @param oscore_pkt The OSCORE packet, its payload length is the length of 
+ *        the ciphertext.
+ * @param header Header segment, its length is the size of the buffer. On 
+ *        failure it is set to the required length.
+ * @param ciphertext Ciphertext segment, like header. If its buffer is NULL, 
+ *        the ciphertext is placed behind the header in the header buffer.
+ * @return enum err ok or buffer_to_small.
+ */
+static enum err segments_fit(struct o_coap_packet *oscore_pkt,
+			     struct byte_array *header,
+			     struct byte_array *ciphertext)
+{
+	uint32_t ciphertext_len = oscore_pkt->payload.len;
+	uint32_t header_len = coap_serialized_len(oscore_pkt) - ciphertext_len;
+	bool fit;
+
+	if (NULL == ciphertext->ptr) {
+		fit = (header->len >= header_len + ciphertext_len);
+	} else {
+		fit = (header->len >= header_len) &&
+		      (ciphertext->len >= ciphertext_len);
+	}
+	if (!fit) {
+		header->len = header_len;
+		ciphertext->len = ciphertext_len;
+		return buffer_to_small;
+	}
+	return ok;
+}
+
+/**
+ *@brief 	Converts a parsed CoAP packet to an OSCORE packet without 
+ *		intermediate buffers. The header, the token, the options and 
+ *		the payload marker are written to the header segment, then the
+ *		plaintext is gathered at the position of the ciphertext and 
+ *		encrypted in place. The required sizes are reported before an 
+ *		SSN is taken. The context must be locked and its freshness 
+ *		checked by the caller.
+ *@param	o_coap_pkt parsed CoAP packet, its payload is not used
+ *@param	payload payload segments
+ *@param	payload_cnt number of payload segments
+ *@param	header header segment, size of the buffer on input, length of 
+ *		the header on output
+ *@param	ciphertext ciphertext segment, like header. If its buffer is 
+ *		NULL, the ciphertext is written behind the header.
+ *@param	c a struct containing the OSCORE context
+ *
+ *@return	err
+ */
+static enum err protect_segments(struct o_coap_packet *o_coap_pkt,
+				 const struct byte_array *payload,
+				 uint32_t payload_cnt,
+				 struct byte_array *header,
+				 struct byte_array *ciphertext,
+				 struct context *c)
+{
+	/* Divide CoAP options into E-option and U-option */
+	struct o_coap_option e_options[MAX_OPTION_COUNT];
+	uint8_t e_options_cnt = 0;
+	uint16_t e_options_len = 0;
+	struct o_coap_option u_options[MAX_OPTION_COUNT];
+	uint8_t u_options_cnt = 0;
+	TRY(inner_outer_option_split(o_coap_pkt, e_options, &e_options_cnt,
+				     &e_options_len, u_options,
+				     &u_options_cnt));
+
+	/* Plaintext: 1 byte code + E-options + 1 byte 0xFF + payload */
+	uint32_t payload_len = segments_len(payload, payload_cnt);
+	uint32_t plaintext_len =
+		1 + options_serialized_len(e_options, e_options_cnt);
+	if (payload_len) {
+		plaintext_len += 1 + payload_len;
+	}
+
+	/* Report the required size before an SSN is taken. */
+	struct oscore_option oscore_option = { .option_number = OSCORE };
+	struct byte_array ct =
+		BYTE_ARRAY_INIT(NULL, plaintext_len + AUTH_TAG_LEN);
+	struct o_coap_packet oscore_pkt;
+	TRY(oscore_option_len_predict(c, o_coap_pkt, &oscore_option.len));
+	TRY(oscore_pkg_generate(o_coap_pkt, &oscore_pkt, u_options,
+				u_options_cnt, &ct, &oscore_option));
+	TRY(segments_fit(&oscore_pkt, header, ciphertext));
+
+	struct encrypt_params p;
+	TRY(encrypt_begin(c, o_coap_pkt, e_options, e_options_cnt, NULL, false,
+			  &p, &oscore_option));
+
+	/* Lay out the OSCORE packet, the ciphertext is its payload. The PIV 
+	   may be longer than predicted if SSN blocks were reserved meanwhile. */
+	TRY(oscore_pkg_generate(o_coap_pkt, &oscore_pkt, u_options,
+				u_options_cnt, &ct, &oscore_option));
+	TRY(segments_fit(&oscore_pkt, header, ciphertext));
+	uint32_t header_len = header->len;
+	TRY(coap_header_serialize(&oscore_pkt, header->ptr, &header_len));
+
+	/* Write the plaintext at the position of the ciphertext and encrypt 
+	   it in place. */
+	bool contiguous = (NULL == ciphertext->ptr);
+	ct.ptr = contiguous ? header->ptr + header_len : ciphertext->ptr;
+	struct byte_array plaintext = BYTE_ARRAY_INIT(ct.ptr, plaintext_len);
+	TRY(plaintext_setup(o_coap_pkt, e_options, e_options_cnt, payload,
+			    payload_cnt, &plaintext));
+	TRY(encrypt_wrapper(&plaintext, &ct, c, o_coap_pkt, &p, false));
+	if (contiguous) {
+		TRY(response_cache_put(c, o_coap_pkt, &p, header->ptr,
+				       header_len + ct.len));
+	}
+
+	header->len = header_len;
+	ciphertext->len = ct.len;
+	PRINT_ARRAY("OSCORE header", header->ptr, header->len);
+	PRINT_ARRAY("OSCORE ciphertext", ct.ptr, ct.len);
+	return ok;
+}
+
+/**
+ * @brief Parses a CoAP packet for protect_segments() and handles messaging 
+ *        layer packets, which are not protected.
+ * 
+ * @param buf_o_coap a buffer containing a CoAP packet
+ * @param buf_o_coap_len length of the CoAP buffer
+ * @param o_coap_pkt output parsed packet
+ * @param header output header segment, the packet is copied into it if it 
+ *        is a messaging layer packet
+ * @param dismissed true if the packet is a messaging layer packet
+ * @return enum err 
+ */
+static enum err coap_parse(uint8_t *buf_o_coap, uint32_t buf_o_coap_len,
+			   struct o_coap_packet *o_coap_pkt,
+			   struct byte_array *header, bool *dismissed)
+{
+	struct byte_array buf = BYTE_ARRAY_INIT(buf_o_coap, buf_o_coap_len);
+
+	/* Parse the coap buf into a CoAP struct */
+	memset(o_coap_pkt, 0, sizeof(*o_coap_pkt));
+	TRY(coap_deserialize(&buf, o_coap_pkt));
+
+	/* Dismiss OSCORE encryption if messaging layer detected (simple ACK, code=0.00) */
+	*dismissed = (TYPE_ACK == o_coap_pkt->header.type) &&
+		     (CODE_EMPTY == o_coap_pkt->header.code);
+	if (*dismissed) {
+		uint32_t header_size = header->len;
+		header->len = buf_o_coap_len;
+		return _memcpy_s(header->ptr, header_size, buf_o_coap,
+				 buf_o_coap_len);
+	}
+	return ok;
+}
+
+enum err coap2oscore_packet(struct o_coap_packet *coap, uint8_t *buf_oscore,
+			    uint32_t *buf_oscore_len, struct context *c)
+{
+	if ((NULL == coap) || (NULL == buf_oscore) ||
+	    (NULL == buf_oscore_len) || (NULL == c)) {
+		return wrong_parameter;
+	}
+
+	/* Dismiss OSCORE encryption if messaging layer detected (simple ACK, code=0.00) */
+	if ((TYPE_ACK == coap->header.type) &&
+	    (CODE_EMPTY == coap->header.code)) {
+		uint32_t len = coap_serialized_len(coap);
+		if (*buf_oscore_len < len) {
+			*buf_oscore_len = len;
+			return buffer_to_small;
+		}
+		return coap_serialize(coap, buf_oscore, buf_oscore_len);
+	}
+
+	struct byte_array header = BYTE_ARRAY_INIT(buf_oscore, *buf_oscore_len);
+	struct byte_array ciphertext = BYTE_ARRAY_INIT(NULL, 0);
+
+	context_lock(c);
+	enum err r = check_context_freshness(c);
+	if (ok == r) {
+		r = protect_segments(coap, &coap->payload, 1, &header,
+				     &ciphertext, c);
+	}
+	context_unlock(c);
+
+	if ((ok == r) || (buffer_to_small == r)) {
+		*buf_oscore_len = header.len + ciphertext.len;
+	}
+	return r;
+}
+
+enum err coap2oscore_in_place(uint8_t *buf_o_coap, uint32_t buf_o_coap_len,
+			      uint8_t *buf_oscore, uint32_t *buf_oscore_len,
+			      struct context *c)
+{
+	if (NULL == buf_o_coap) {
+		return wrong_parameter;
+	}
+
+	struct o_coap_packet o_coap_pkt;
+	struct byte_array buf = BYTE_ARRAY_INIT(buf_o_coap, buf_o_coap_len);
+	memset(&o_coap_pkt, 0, sizeof(o_coap_pkt));
+	TRY(coap_deserialize(&buf, &o_coap_pkt));
+
+	return coap2oscore_packet(&o_coap_pkt, buf_oscore, buf_oscore_len, c);
+}
+
+enum err coap2oscore_iov(uint8_t *buf_o_coap, uint32_t buf_o_coap_len,
+			 const struct byte_array *payload, uint32_t payload_cnt,
+			 struct byte_array *oscore_header,
+			 struct byte_array *oscore_payload, struct context *c)
+{
+	if ((NULL == buf_o_coap) || ((NULL == payload) && (0 != payload_cnt)) ||
+	    (NULL == oscore_header) || (NULL == oscore_header->ptr) ||
+	    (NULL == oscore_payload) || (NULL == oscore_payload->ptr) ||
+	    (NULL == c)) {
+		return wrong_parameter;
+	}
+
+	struct o_coap_packet o_coap_pkt;
+	bool dismissed;
+	TRY(coap_parse(buf_o_coap, buf_o_coap_len, &o_coap_pkt, oscore_header,
+		       &dismissed));
+	if (dismissed) {
+		oscore_payload->len = 0;
+		return ok;
+	}
+	/* The payload is given by the segments only. */
+	if (0 != o_coap_pkt.payload.len) {
+		return wrong_parameter;
+	}
+
+	context_lock(c);
+	enum err r = check_context_freshness(c);
+	if (ok == r) {
+		r = protect_segments(&o_coap_pkt, payload, payload_cnt,
+				     oscore_header, oscore_payload, c);
+	}
+	context_unlock(c);
+	return r;
+}
+
+/**
+ * @brief Protects a batch of packets, see coap2oscore_batch(). The context 
+ *        must be locked by the caller.
+ * 
+ * @param pkts Packets of the batch.
+ * @param pkts_cnt Number of packets.
+ * @param c Security context.
+ * @return enum err The first error of any packet.
+ */
+static enum err protect_batch(struct oscore_batch_pkt *pkts, uint32_t pkts_cnt,
+			      struct context *c)
+{
+	/* Make sure that given context is fresh enough to process the messages. */
+	TRY(check_context_freshness(c));
+
+	/* Reserve one SSN per packet in one step. This is an upper bound, 
+	   responses encrypted with the request nonce do not use their SSN. */
+	struct oscore_ssn_block range;
+	range.next = ssn_fetch_add(c, pkts_cnt);
+	range.end = range.next + pkts_cnt;
+	range.size = pkts_cnt;
+	if (range.end > OSCORE_SSN_OVERFLOW_VALUE) {
+		range.end = OSCORE_SSN_OVERFLOW_VALUE;
+	}
+	uint64_t first = range.next;
+
+#ifdef OSCORE_NVM_SUPPORT
+	/* One NVM write (if any) covers the whole range. */
+	enum err r = ssn_persist(c, range.end);
+	if (ok != r) {
+		ssn_give_back(c, first + pkts_cnt, first);
+		for (uint32_t i = 0; i < pkts_cnt; i++) {
+			pkts[i].result = r;
+		}
+		return r;
+	}
+#endif
+
+	enum err first_error = ok;
+	for (uint32_t i = 0; i < pkts_cnt; i++) {
+		pkts[i].result = protect(pkts[i].buf_in, pkts[i].buf_in_len,
+					 pkts[i].buf_out, &pkts[i].buf_out_len,
+					 c, &range, false);
+		if ((ok != pkts[i].result) && (ok == first_error)) {
+			first_error = pkts[i].result;
+		}
+	}
+
+	/* Give back the SSNs that were not used. The value in NVM (if any) 
+	   stays an upper bound of the used SSNs. */
+	ssn_give_back(c, first + pkts_cnt, range.next);
+	return first_error;
+}
+
+enum err coap2oscore_batch(struct oscore_batch_pkt *pkts, uint32_t pkts_cnt,
+			   struct context *c)
+{
+	if ((NULL == pkts) || (NULL == c)) {
+		return wrong_parameter;
+	}
+
+	context_lock(c);
+	enum err r = protect_batch(pkts, pkts_cnt, c);
+	context_unlock(c);
+	return r;
+}
+
+enum err oscore_ssn_block_reserve(struct context *c, uint32_t size,
+				  struct oscore_ssn_block *block)
+{
+	if ((NULL == c) || (NULL == block) || (0 == size)) {
+		return wrong_parameter;
+	}
+
+	/* No lock is needed, concurrent callers get disjoint blocks. */
+	uint64_t next = ssn_fetch_add(c, size);
+	if (next >= OSCORE_SSN_OVERFLOW_VALUE) {
+		PRINT_MSG(
+			"Sender Sequence Number reached its limit. New security context must be established.\n");
+		return oscore_ssn_overflow;
+	}
+	uint64_t end = next + size;
+	if (end > OSCORE_SSN_OVERFLOW_VALUE) {
+		end = OSCORE_SSN_OVERFLOW_VALUE;
+	}
+
+#ifdef OSCORE_NVM_SUPPORT
+	/* Only the block that passes the value in NVM takes the lock. The NVM 
+	   write covers the whole block before any of its SSNs is used. */
+	if (ssn_persist_due(c, end)) {
+		context_lock(c);
+		enum err r = ssn_persist(c, end);
+		if (ok != r) {
+			ssn_give_back(c, next + size, next);
+		}
+		context_unlock(c);
+		TRY(r);
+	}
+#endif
+
+	block->next = next;
+	block->end = end;
+	block->size = size;
+	return ok;
+}
+
+enum err oscore_ssn_flush(struct context *c)
+{
+	if (NULL == c) {
+		return wrong_parameter;
+	}
+
+#ifdef OSCORE_NVM_SUPPORT
+	/* The lock of the context is not taken, the SSN and the values in NVM
+	   are atomic with OSCORE_THREAD_SAFE. */
+	nvm_lock(c);
+	enum err r = ok;
+	uint64_t requested = ssn_atomic_load(&c->sc.ssn_nvm_requested);
+	if (requested > ssn_atomic_load(&c->sc.ssn_in_nvm)) {
+		/* also the SSNs taken since the request are covered */
+		uint64_t ssn = ssn_atomic_load(&c->sc.ssn);
+		if (ssn < requested) {
+			ssn = requested;
+		}
+		r = ssn_write(c, ssn, true);
+	}
+	nvm_unlock(c);
+	return r;
+#else
+	return ok;
+#endif
+}
+
+enum err oscore_ssn_durable(struct context *c)
+{
+	if (NULL == c) {
+		return wrong_parameter;
+	}
+
+#ifdef OSCORE_NVM_SUPPORT
+	nvm_lock(c);
+	uint64_t pending = ssn_atomic_load(&c->sc.ssn_nvm_pending);
+	if (pending > ssn_atomic_load(&c->sc.ssn_nvm_bound)) {
+		uint64_t ssn = ssn_atomic_load(&c->sc.ssn_in_nvm);
+		ssn_atomic_store(&c->sc.ssn_nvm_request_at,
+				 ssn + (pending - ssn) / 2);
+		ssn_atomic_store(&c->sc.ssn_nvm_bound, pending);
+	}
+	nvm_unlock(c);
+#endif
+	return ok;
+}
+
+enum err coap2oscore_ssn_block(uint8_t *buf_o_coap, uint32_t buf_o_coap_len,
+			       uint8_t *buf_oscore, uint32_t *buf_oscore_len,
+			       struct context *c,
+			       struct oscore_ssn_block *block)
+{
+	if ((NULL == c) || (NULL == block)) {
+		return wrong_parameter;
+	}
+
+	if (block->next >= block->end) {
+		TRY(oscore_ssn_block_reserve(c, block->size, block));
+	}
+	return protect(buf_o_coap, buf_o_coap_len, buf_oscore, buf_oscore_len,
+		       c, block, true);
 }
@@ -34,17 +34,39 @@ enum err WEAK nvm_read_ssn(const struct nvm_key_t *nvm_key, uint64_t *ssn)
 	return not_implemented;
 }
 
-enum err ssn_store_in_nvm(const struct nvm_key_t *nvm_key, uint64_t ssn,
-			  bool echo_sync_in_progress)
+enum err WEAK nvm_write_ssn_interval(const struct nvm_key_t *nvm_key,
+				     uint64_t ssn, uint32_t interval)
 {
-	bool cyclic_write = (0 == ssn % K_SSN_NVM_STORE_INTERVAL);
+	/* ssn_init() adds K_SSN_NVM_STORE_INTERVAL to the stored value */
+	uint64_t bound = ssn + interval;
+	return nvm_write_ssn(nvm_key, (bound > K_SSN_NVM_STORE_INTERVAL) ?
+					      bound - K_SSN_NVM_STORE_INTERVAL :
+					      0);
+}
 
-	/* While the device is still in the ECHO synchronization mode (after device reboot or other context reinitialization)
-	   SSN has to be written immediately, in case of uncontrolled reboot before first cyclic write happens. */
-	if (cyclic_write || echo_sync_in_progress) {
-		TRY(nvm_write_ssn(nvm_key, ssn));
+enum err WEAK nvm_read_ssn_interval(const struct nvm_key_t *nvm_key,
+				    uint64_t *ssn, uint32_t *interval)
+{
+	if (NULL != interval) {
+		*interval = K_SSN_NVM_STORE_INTERVAL;
 	}
-	return ok;
+	return nvm_read_ssn(nvm_key, ssn);
+}
+
+enum err WEAK nvm_write_replay_bound(const struct nvm_key_t *nvm_key,
+				     uint64_t bound)
+{
+	PRINT_MSG(
+		"The nvm_write_replay_bound() function MUST be overwritten by user!!!\n");
+	return not_implemented;
+}
+
+enum err WEAK nvm_read_replay_bound(const struct nvm_key_t *nvm_key,
+				    uint64_t *bound)
+{
+	PRINT_MSG(
+		"The nvm_read_replay_bound() function MUST be overwritten by user!!!\n");
+	return not_implemented;
 }
 #endif
 
@@ -62,8 +84,9 @@ enum err ssn_init(const struct nvm_key_t *nvm_key, uint64_t *ssn,
 		       *ssn);
 	} else {
 		#ifdef OSCORE_NVM_SUPPORT
-			TRY(nvm_read_ssn(nvm_key, ssn));
-			*ssn += K_SSN_NVM_STORE_INTERVAL + F_NVM_MAX_WRITE_FAILURE;
+			uint32_t interval;
+			TRY(nvm_read_ssn_interval(nvm_key, ssn, &interval));
+			*ssn += interval + F_NVM_MAX_WRITE_FAILURE;
 			PRINTF("SSN initialized from NMV. SSN = %" PRIu64 "\n", *ssn);
 		#else
 			PRINT_MSG("OSCORE_NVM_SUPPORT flag must be defined for handling non-fresh (stored) contexts.");
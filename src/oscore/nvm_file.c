@@ -0,0 +1,541 @@
+/*
+   Copyright (c) 2026 Fraunhofer AISEC. See the COPYRIGHT
+   file at the top-level directory of this distribution.
+
+   Licensed under the Apache License, Version 2.0 <LICENSE-APACHE or
+   http://www.apache.org/licenses/LICENSE-2.0> or the MIT license
+   <LICENSE-MIT or http://opensource.org/licenses/MIT>, at your
+   option. This file may not be copied, modified, or distributed
+   except according to those terms.
+*/
+#if defined(OSCORE_NVM_SUPPORT) && defined(OSCORE_NVM_FILE)
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <fcntl.h>
+#include <stdbool.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "oscore/nvm_file.h"
+#include "oscore/oscore_coap_defines.h"
+
+#include "common/oscore_edhoc_error.h"
+#include "common/print_util.h"
+
+#define NVM_FILE_MAGIC "OSCORENV"
+#define NVM_FILE_VERSION 1
+
+struct file_header {
+	char magic[8];
+	uint32_t version;
+	uint32_t slots_cnt;
+	uint32_t record_len;
+	uint32_t max_kid_len;
+	uint32_t max_kid_context_len;
+	uint8_t reserved[OSCORE_NVM_FILE_HEADER_LEN - 28];
+};
+
+/*One copy of the record of a key. The copy is valid if its epoch is not 0
+and the checksum matches, i.e., it was written completely.*/
+struct record {
+	uint64_t epoch;
+	uint64_t ssn;
+	uint32_t interval;
+	uint8_t sender_id_len;
+	uint8_t recipient_id_len;
+	uint8_t id_context_len;
+	uint8_t reserved0;
+	uint8_t sender_id[MAX_KID_LEN];
+	uint8_t recipient_id[MAX_KID_LEN];
+	uint8_t id_context[MAX_KID_CONTEXT_LEN];
+	uint8_t reserved[OSCORE_NVM_FILE_RECORD_LEN - 28 - 2 * MAX_KID_LEN -
+			 MAX_KID_CONTEXT_LEN];
+	uint32_t checksum;
+};
+
+_Static_assert(sizeof(struct file_header) == OSCORE_NVM_FILE_HEADER_LEN,
+	       "wrong header length");
+_Static_assert(sizeof(struct record) == OSCORE_NVM_FILE_RECORD_LEN,
+	       "wrong record length");
+
+/**
+ * @brief Gives the calling thread exclusive access to a store. Does
+ *        nothing if OSCORE_THREAD_SAFE is not defined.
+ */
+static void file_lock(struct oscore_nvm_file *f)
+{
+#ifdef OSCORE_THREAD_SAFE
+	oscore_lock_acquire(&f->lock);
+#else
+	(void)f;
+#endif
+}
+
+/**
+ * @brief Releases a store locked with file_lock().
+ */
+static void file_unlock(struct oscore_nvm_file *f)
+{
+#ifdef OSCORE_THREAD_SAFE
+	oscore_lock_release(&f->lock);
+#else
+	(void)f;
+#endif
+}
+
+/**
+ * @brief Serializes the syncs of a store, see file_lock().
+ */
+static void sync_lock(struct oscore_nvm_file *f)
+{
+#ifdef OSCORE_THREAD_SAFE
+	oscore_lock_acquire(&f->sync_lock);
+#else
+	(void)f;
+#endif
+}
+
+/**
+ * @brief Releases a store locked with sync_lock().
+ */
+static void sync_unlock(struct oscore_nvm_file *f)
+{
+#ifdef OSCORE_THREAD_SAFE
+	oscore_lock_release(&f->sync_lock);
+#else
+	(void)f;
+#endif
+}
+
+/**
+ * @brief Waits until the running sync of a store is done. Does nothing if
+ *        OSCORE_THREAD_SAFE is not defined, since then no sync can run
+ *        concurrently.
+ */
+static void sync_wait(struct oscore_nvm_file *f)
+{
+#ifdef OSCORE_THREAD_SAFE
+	oscore_lock_acquire(&f->sync_lock);
+	oscore_lock_release(&f->sync_lock);
+#else
+	(void)f;
+#endif
+}
+
+/**
+ * @brief CRC-32 (IEEE 802.3) of a record without its checksum field.
+ */
+static uint32_t record_checksum(const struct record *r)
+{
+	static const uint32_t table[16] = {
+		0x00000000, 0x1db71064, 0x3b6e20c8, 0x26d930ac,
+		0x76dc4190, 0x6b6b51f4, 0x4db26158, 0x5005713c,
+		0xedb88320, 0xf00f9344, 0xd6d6a3e8, 0xcb61b38c,
+		0x9b64c2b0, 0x86d3d2d4, 0xa00ae278, 0xbdbdf21c,
+	};
+	const uint8_t *p = (const uint8_t *)r;
+	uint32_t crc = 0xffffffff;
+
+	for (uint32_t i = 0; i < offsetof(struct record, checksum); i++) {
+		crc = (crc >> 4) ^ table[(crc ^ p[i]) & 0x0f];
+		crc = (crc >> 4) ^ table[(crc ^ (uint32_t)(p[i] >> 4)) & 0x0f];
+	}
+	return ~crc;
+}
+
+static bool record_valid(const struct record *r)
+{
+	return (0 != r->epoch) && (r->sender_id_len <= MAX_KID_LEN) &&
+	       (r->recipient_id_len <= MAX_KID_LEN) &&
+	       (r->id_context_len <= MAX_KID_CONTEXT_LEN) &&
+	       (record_checksum(r) == r->checksum);
+}
+
+/*the IDs may be empty with a NULL pointer*/
+static bool field_equals(const uint8_t *buf, uint8_t len,
+			 const struct byte_array *a)
+{
+	return (len == a->len) && ((0 == len) || (0 == memcmp(buf, a->ptr, len)));
+}
+
+static void field_set(uint8_t *buf, uint8_t *len, const struct byte_array *a)
+{
+	*len = (uint8_t)a->len;
+	if (0 != a->len) {
+		memcpy(buf, a->ptr, a->len);
+	}
+}
+
+static bool record_has_key(const struct record *r,
+			   const struct nvm_key_t *nvm_key)
+{
+	return field_equals(r->recipient_id, r->recipient_id_len,
+			    &nvm_key->recipient_id) &&
+	       field_equals(r->id_context, r->id_context_len,
+			    &nvm_key->id_context) &&
+	       field_equals(r->sender_id, r->sender_id_len,
+			    &nvm_key->sender_id);
+}
+
+/**
+ * @brief Returns the two copies of the record of a slot.
+ */
+static struct record *slot_get(const struct oscore_nvm_file *f, uint32_t slot)
+{
+	return (struct record *)(void *)(f->map + OSCORE_NVM_FILE_HEADER_LEN +
+					 (size_t)slot * 2 *
+						 OSCORE_NVM_FILE_RECORD_LEN);
+}
+
+/**
+ * @brief Finds the newest valid copy of a slot.
+ * @param copies The two copies of the slot.
+ * @param newest [out] Index of the newest valid copy.
+ * @return false if no copy is valid, i.e., the slot is free.
+ */
+static bool newest_copy(const struct record *copies, uint32_t *newest)
+{
+	bool valid0 = record_valid(&copies[0]);
+	bool valid1 = record_valid(&copies[1]);
+
+	if (valid0 && valid1) {
+		*newest = (copies[1].epoch > copies[0].epoch) ? 1 : 0;
+	} else if (valid0 || valid1) {
+		*newest = valid1 ? 1 : 0;
+	} else {
+		return false;
+	}
+	return true;
+}
+
+static uint32_t key_hash(const struct nvm_key_t *nvm_key)
+{
+	/*FNV-1a over all fields, each preceded by its length*/
+	const struct byte_array *fields[] = { &nvm_key->sender_id,
+					      &nvm_key->recipient_id,
+					      &nvm_key->id_context };
+	uint32_t h = 2166136261u;
+
+	for (uint32_t i = 0; i < sizeof(fields) / sizeof(fields[0]); i++) {
+		h = (h ^ (uint8_t)fields[i]->len) * 16777619u;
+		for (uint32_t j = 0; j < fields[i]->len; j++) {
+			h = (h ^ fields[i]->ptr[j]) * 16777619u;
+		}
+	}
+	return h;
+}
+
+/**
+ * @brief Finds the slot of a key. Free slots don't end the search, since the
+ *        first write of a key in front of it may have been lost in a crash.
+ * @param f The store.
+ * @param nvm_key The key.
+ * @param slot [out] Slot holding the key, or the first free slot of the
+ *        window if the key is not stored.
+ * @param newest [out] Index of the newest copy if the key is stored.
+ * @return ok, oscore_nvm_key_not_found if the key is not stored (*slot is
+ *         free), or oscore_max_contexts if it is not stored and the window
+ *         has no free slot.
+ */
+static enum err slot_find(const struct oscore_nvm_file *f,
+			  const struct nvm_key_t *nvm_key, uint32_t *slot,
+			  uint32_t *newest)
+{
+	uint32_t mask = f->slots_cnt - 1;
+	uint32_t i = key_hash(nvm_key) & mask;
+	uint32_t probes = (f->slots_cnt < OSCORE_NVM_FILE_MAX_PROBE) ?
+				  f->slots_cnt :
+				  OSCORE_NVM_FILE_MAX_PROBE;
+	bool free_found = false;
+
+	for (uint32_t n = 0; n < probes; n++, i = (i + 1) & mask) {
+		const struct record *copies = slot_get(f, i);
+		uint32_t copy;
+		/*the key is compared before the checksum is verified, the copies
+		of other keys are verified only until a free slot is found*/
+		if ((record_has_key(&copies[0], nvm_key) ||
+		     record_has_key(&copies[1], nvm_key)) &&
+		    newest_copy(copies, &copy) &&
+		    record_has_key(&copies[copy], nvm_key)) {
+			*slot = i;
+			*newest = copy;
+			return ok;
+		}
+		if (!free_found && !newest_copy(copies, &copy)) {
+			free_found = true;
+			*slot = i;
+		}
+	}
+	return free_found ? oscore_nvm_key_not_found : oscore_max_contexts;
+}
+
+static bool key_valid(const struct nvm_key_t *nvm_key)
+{
+	return (NULL != nvm_key) && (nvm_key->sender_id.len <= MAX_KID_LEN) &&
+	       (nvm_key->recipient_id.len <= MAX_KID_LEN) &&
+	       (nvm_key->id_context.len <= MAX_KID_CONTEXT_LEN);
+}
+
+/**
+ * @brief Writes the header of a new file.
+ */
+static enum err header_write(struct oscore_nvm_file *f)
+{
+	struct file_header h;
+
+	memset(&h, 0, sizeof(h));
+	memcpy(h.magic, NVM_FILE_MAGIC, sizeof(h.magic));
+	h.version = NVM_FILE_VERSION;
+	h.slots_cnt = f->slots_cnt;
+	h.record_len = OSCORE_NVM_FILE_RECORD_LEN;
+	h.max_kid_len = MAX_KID_LEN;
+	h.max_kid_context_len = MAX_KID_CONTEXT_LEN;
+	memcpy(f->map, &h, sizeof(h));
+	if (0 != msync(f->map, f->map_len, MS_SYNC)) {
+		return oscore_nvm_io_error;
+	}
+	return ok;
+}
+
+/**
+ * @brief Checks if a copy is being written to the disk by the running sync.
+ *        The store must be locked.
+ */
+static bool copy_syncing(const struct oscore_nvm_file *f,
+			 const struct record *copy)
+{
+	return (copy->epoch >= f->durable_epoch) &&
+	       (copy->epoch <= f->syncing_epoch);
+}
+
+/**
+ * @brief Checks the header of an existing file and finds the newest epoch.
+ */
+static enum err recover(struct oscore_nvm_file *f)
+{
+	struct file_header h;
+
+	memcpy(&h, f->map, sizeof(h));
+	if ((0 != memcmp(h.magic, NVM_FILE_MAGIC, sizeof(h.magic))) ||
+	    (NVM_FILE_VERSION != h.version) || (f->slots_cnt != h.slots_cnt) ||
+	    (OSCORE_NVM_FILE_RECORD_LEN != h.record_len) ||
+	    (MAX_KID_LEN != h.max_kid_len) ||
+	    (MAX_KID_CONTEXT_LEN != h.max_kid_context_len)) {
+		PRINT_MSG("The NVM file has another format or size\n");
+		return oscore_nvm_io_error;
+	}
+
+	uint64_t max_epoch = 0;
+	for (uint32_t i = 0; i < f->slots_cnt; i++) {
+		const struct record *copies = slot_get(f, i);
+		uint32_t copy;
+		if (newest_copy(copies, &copy)) {
+			f->keys_cnt++;
+			if (copies[copy].epoch > max_epoch) {
+				max_epoch = copies[copy].epoch;
+			}
+		}
+	}
+
+	/*records written before a crash of the process may still be in the
+	page cache only, they become durable before they are relied on*/
+	if (0 != fsync(f->fd)) {
+		return oscore_nvm_io_error;
+	}
+	f->epoch = max_epoch + 1;
+	f->durable_epoch = f->epoch;
+	return ok;
+}
+
+/**
+ * @brief Maps the file, which is created with free slots if it is empty.
+ * @param f The store, with an open file.
+ * @param created [out] True if the file was empty.
+ */
+static enum err file_map(struct oscore_nvm_file *f, bool *created)
+{
+	struct stat st;
+
+	if (0 != fstat(f->fd, &st)) {
+		return oscore_nvm_io_error;
+	}
+	*created = (0 == st.st_size);
+	if (*created) {
+		/*the new slots read as zeros, i.e., free*/
+		if (0 != ftruncate(f->fd, (off_t)f->map_len)) {
+			return oscore_nvm_io_error;
+		}
+	} else if ((size_t)st.st_size != f->map_len) {
+		PRINT_MSG("The NVM file has another format or size\n");
+		return oscore_nvm_io_error;
+	}
+
+	void *map = mmap(NULL, f->map_len, PROT_READ | PROT_WRITE, MAP_SHARED,
+			 f->fd, 0);
+	if (MAP_FAILED == map) {
+		return oscore_nvm_io_error;
+	}
+	f->map = map;
+	return ok;
+}
+
+enum err oscore_nvm_file_open(struct oscore_nvm_file *f, const char *path,
+			      uint32_t slots_cnt)
+{
+	if ((NULL == f) || (NULL == path) || (0 == slots_cnt) ||
+	    (0 != (slots_cnt & (slots_cnt - 1)))) {
+		return wrong_parameter;
+	}
+
+	memset(f, 0, sizeof(*f));
+	f->slots_cnt = slots_cnt;
+	f->map_len = OSCORE_NVM_FILE_HEADER_LEN +
+		     (size_t)slots_cnt * 2 * OSCORE_NVM_FILE_RECORD_LEN;
+	oscore_lock_init(&f->lock);
+	oscore_lock_init(&f->sync_lock);
+
+	f->fd = open(path, O_RDWR | O_CREAT, 0600);
+	if (f->fd < 0) {
+		return oscore_nvm_io_error;
+	}
+
+	bool created;
+	enum err r = file_map(f, &created);
+	if (ok != r) {
+		close(f->fd);
+		return r;
+	}
+
+	if (created) {
+		r = header_write(f);
+		f->epoch = 1;
+		f->durable_epoch = 1;
+	} else {
+		r = recover(f);
+	}
+	if (ok != r) {
+		munmap(f->map, f->map_len);
+		close(f->fd);
+	}
+	return r;
+}
+
+enum err oscore_nvm_file_close(struct oscore_nvm_file *f)
+{
+	if (NULL == f) {
+		return wrong_parameter;
+	}
+
+	enum err r = oscore_nvm_file_sync(f);
+	munmap(f->map, f->map_len);
+	close(f->fd);
+	return r;
+}
+
+enum err oscore_nvm_file_write(struct oscore_nvm_file *f,
+			       const struct nvm_key_t *nvm_key, uint64_t ssn,
+			       uint32_t interval)
+{
+	if ((NULL == f) || !key_valid(nvm_key)) {
+		return wrong_parameter;
+	}
+
+	struct record rec;
+	memset(&rec, 0, sizeof(rec));
+	rec.ssn = ssn;
+	rec.interval = interval;
+	field_set(rec.sender_id, &rec.sender_id_len, &nvm_key->sender_id);
+	field_set(rec.recipient_id, &rec.recipient_id_len,
+		  &nvm_key->recipient_id);
+	field_set(rec.id_context, &rec.id_context_len, &nvm_key->id_context);
+
+	file_lock(f);
+	uint32_t slot;
+	uint32_t copy = 0;
+	enum err r = slot_find(f, nvm_key, &slot, &copy);
+	while ((ok == r) && copy_syncing(f, &slot_get(f, slot)[copy])) {
+		/*the newest copy is being written to the disk, and the other one
+		is the only copy known to be on it, so none of them can be 
+		overwritten before the sync is done*/
+		file_unlock(f);
+		sync_wait(f);
+		file_lock(f);
+		r = slot_find(f, nvm_key, &slot, &copy);
+	}
+	if (oscore_nvm_key_not_found == r) {
+		/*a new key, both copies are free*/
+		f->keys_cnt++;
+	} else if (ok == r) {
+		struct record *copies = slot_get(f, slot);
+		/*the newest copy is overwritten only as long as it is not on
+		the disk, since then the other copy is*/
+		if (copies[copy].epoch < f->durable_epoch) {
+			copy ^= 1;
+		}
+	} else {
+		file_unlock(f);
+		return r;
+	}
+
+	rec.epoch = f->epoch;
+	rec.checksum = record_checksum(&rec);
+	memcpy(&slot_get(f, slot)[copy], &rec, sizeof(rec));
+	file_unlock(f);
+	return ok;
+}
+
+enum err oscore_nvm_file_read(struct oscore_nvm_file *f,
+			      const struct nvm_key_t *nvm_key, uint64_t *ssn,
+			      uint32_t *interval)
+{
+	if ((NULL == f) || !key_valid(nvm_key) || (NULL == ssn) ||
+	    (NULL == interval)) {
+		return wrong_parameter;
+	}
+
+	file_lock(f);
+	uint32_t slot;
+	uint32_t copy;
+	enum err r = slot_find(f, nvm_key, &slot, &copy);
+	if (ok == r) {
+		const struct record *rec = &slot_get(f, slot)[copy];
+		*ssn = rec->ssn;
+		*interval = rec->interval;
+	} else {
+		r = oscore_nvm_key_not_found;
+	}
+	file_unlock(f);
+	return r;
+}
+
+enum err oscore_nvm_file_sync(struct oscore_nvm_file *f)
+{
+	if (NULL == f) {
+		return wrong_parameter;
+	}
+
+	/*records written from now on belong to the next epoch, they are not
+	on the disk after this sync*/
+	sync_lock(f);
+	file_lock(f);
+	uint64_t synced = f->epoch++;
+	f->syncing_epoch = synced;
+	file_unlock(f);
+
+	bool failed = (0 != msync(f->map, f->map_len, MS_SYNC));
+
+	/*after a failure the records of the epoch may be overwritten again, 
+	the copies before them are still on the disk*/
+	file_lock(f);
+	f->syncing_epoch = 0;
+	if (!failed && (f->durable_epoch <= synced)) {
+		f->durable_epoch = synced + 1;
+	}
+	file_unlock(f);
+	sync_unlock(f);
+	return failed ? oscore_nvm_io_error : ok;
+}
+#endif
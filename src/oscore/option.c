@@ -113,8 +113,8 @@ enum err oscore_decrypted_payload_parser(struct byte_array *in_payload,
 	return ok;
 }
 
-enum err echo_val_is_fresh(struct byte_array *cache_val,
-			   struct byte_array *decrypted_payload)
+enum err echo_val_get(struct byte_array *decrypted_payload,
+		      struct byte_array *echo_val)
 {
 	uint8_t code = 0;
 	struct byte_array unprotected_o_coap_payload;
@@ -129,19 +129,29 @@ enum err echo_val_is_fresh(struct byte_array *cache_val,
 
 	for (uint8_t i = 0; i < E_options_cnt; i++) {
 		if (E_options[i].option_number == ECHO) {
-			if (cache_val->len == E_options[i].len &&
-			    0 == memcmp(E_options[i].value, cache_val->ptr, cache_val->len) ) {
-				PRINT_MSG("ECHO option check -- OK\n");
-				return ok;
-			} else {
-				return echo_val_mismatch;
-			}
+			echo_val->ptr = E_options[i].value;
+			echo_val->len = E_options[i].len;
+			return ok;
 		}
 	}
 
 	return no_echo_option;
 }
 
+enum err echo_val_is_fresh(struct byte_array *cache_val,
+			   struct byte_array *decrypted_payload)
+{
+	struct byte_array echo_val;
+	TRY(echo_val_get(decrypted_payload, &echo_val));
+
+	if (cache_val->len == echo_val.len &&
+	    0 == memcmp(echo_val.ptr, cache_val->ptr, cache_val->len)) {
+		PRINT_MSG("ECHO option check -- OK\n");
+		return ok;
+	}
+	return echo_val_mismatch;
+}
+
 
 enum err uri_path_create(struct o_coap_option *options, uint32_t options_size,
 			 uint8_t *uri_path, uint32_t *uri_path_size)
@@ -184,4 +194,49 @@ enum err uri_path_create(struct o_coap_option *options, uint32_t options_size,
 
 	*uri_path_size = current_size;
 	return ok;
+}
+
+uint64_t uri_path_hash_update(uint64_t hash, const uint8_t *data, uint32_t len)
+{
+	for (uint32_t i = 0; i < len; i++) {
+		hash = (hash ^ data[i]) * 1099511628211ull;
+	}
+	return hash;
+}
+
+enum err uri_path_hash(struct o_coap_option *options, uint32_t options_size,
+		       uint64_t *hash)
+{
+	if ((NULL == options) || (NULL == hash)) {
+		return wrong_parameter;
+	}
+
+	/* the same bytes as in uri_path_create(), the segments joined by '/' */
+	const uint8_t delimiter = '/';
+	uint64_t h = URI_PATH_HASH_INIT;
+	bool empty = true;
+
+	for (uint32_t index = 0; index < options_size; index++) {
+		struct o_coap_option *option = &options[index];
+		if (URI_PATH != option->option_number) {
+			continue;
+		}
+		if ((0 != option->len) && (NULL == option->value)) {
+			return oscore_wrong_uri_path;
+		}
+
+		if (!empty) {
+			h = uri_path_hash_update(h, &delimiter, 1);
+		}
+		h = uri_path_hash_update(h, option->value, option->len);
+		empty = false;
+	}
+
+	/* a single '/' if the path is empty */
+	if (empty) {
+		h = uri_path_hash_update(h, &delimiter, 1);
+	}
+
+	*hash = h;
+	return ok;
 }
\ No newline at end of file
@@ -94,6 +94,9 @@ STATIC enum err oscore_option_parser(const struct o_coap_option *opt,
 					return oscore_inpkt_invalid_piv;
 					break;
 				default:
+					if (temp_kid_len < out->n) {
+						return not_valid_input_packet;
+					}
 					out->piv.ptr = val_ptr;
 					out->piv.len = out->n;
 					val_ptr += out->n;
@@ -107,6 +110,12 @@ STATIC enum err oscore_option_parser(const struct o_coap_option *opt,
 					out->kid_context.len = 0;
 					out->kid_context.ptr = NULL;
 				} else {
+					/* the length byte and the KID context must be in the option */
+					if ((temp_kid_len < 1) ||
+					    ((uint16_t)(temp_kid_len - 1) <
+					     *val_ptr)) {
+						return not_valid_input_packet;
+					}
 					out->kid_context.len = *val_ptr;
 					out->kid_context.ptr = ++val_ptr;
 					val_ptr += out->kid_context.len;
@@ -274,7 +283,7 @@ decrypt_wrapper(struct byte_array *ciphertext, struct byte_array *plaintext,
 		request_kid = new_nonce_oscore_option->kid;
 	}
 	TRY(oscore_interactions_read_wrapper(msg_type_oscore, &token,
-					     c->rrc.interactions, &request_piv,
+					     &c->rrc.interactions, &request_piv,
 					     &request_kid));
 	/* Message type read from encrypted packet can be invalid due to external OBSERVE option change,
 	   but it is sufficient enough for the interactions read wrapper to work properly,
@@ -297,9 +306,13 @@ decrypt_wrapper(struct byte_array *ciphertext, struct byte_array *plaintext,
 	TRY(create_aad(NULL, 0, c->cc.aead_alg, &request_kid, &request_piv,
 		       &aad));
 
-	/* Decrypt the ciphertext */
-	TRY(oscore_cose_decrypt(ciphertext, plaintext, &nonce, &aad,
-				&c->rc.recipient_key));
+	/* Decrypt the ciphertext, failures are limited by prefilter() */
+	enum err r = oscore_cose_decrypt(ciphertext, plaintext, &nonce, &aad,
+					 &c->rc.recipient_key_handle);
+	if (ok != r) {
+		oscore_rate_limit_failure(&c->rc.failure_limit);
+		return r;
+	}
 
 	/* Update nonce only after successful decryption (for handling future responses) */
 	if (NULL != new_nonce_oscore_option) {
@@ -313,98 +326,408 @@ decrypt_wrapper(struct byte_array *ciphertext, struct byte_array *plaintext,
 	   Decrypted packet is used for URI Paths and message type, as original values are modified while encrypting. */
 	enum o_coap_msg msg_type;
 	TRY(coap_get_message_type(output_coap, &msg_type));
-	BYTE_ARRAY_NEW(uri_paths, OSCORE_MAX_URI_PATH_LEN,
-		       OSCORE_MAX_URI_PATH_LEN);
-	TRY(uri_path_create(output_coap->options, output_coap->options_cnt,
-			    uri_paths.ptr, &(uri_paths.len)));
-	TRY(oscore_interactions_update_wrapper(msg_type, &token, &uri_paths,
-					       c->rrc.interactions,
+	uint64_t uri_paths_hash;
+	TRY(uri_path_hash(output_coap->options, output_coap->options_cnt,
+			  &uri_paths_hash));
+	TRY(oscore_interactions_update_wrapper(msg_type, &token, uri_paths_hash,
+					       &c->rrc.interactions,
 					       &request_piv, &request_kid));
 
 	return ok;
 }
 
-enum err oscore2coap(uint8_t *buf_in, uint32_t buf_in_len, uint8_t *buf_out,
-		     uint32_t *buf_out_len, struct context *c)
+/**
+ * @brief Parses only the header, the token and the options of an incoming 
+ *        packet up to the OSCORE option, see oscore_peek().
+ * 
+ * @param buf_in Input packet.
+ * @param buf_in_len Length of the input packet.
+ * @param oscore_packet Output packet without the options after the OSCORE 
+ *        option and without payload.
+ * @param oscore_option Output parsed OSCORE option.
+ * @return enum err not_oscore_pkt if the packet has no OSCORE option.
+ */
+static enum err peek(uint8_t *buf_in, uint32_t buf_in_len,
+		     struct o_coap_packet *oscore_packet,
+		     struct compressed_oscore_option *oscore_option)
 {
-	struct o_coap_packet oscore_packet;
-	struct compressed_oscore_option oscore_option;
-	struct byte_array buf;
+	struct byte_array buf = BYTE_ARRAY_INIT(buf_in, buf_in_len);
 
-	PRINT_MSG("\n\n\noscore2coap***************************************\n");
-	PRINT_ARRAY("Input OSCORE packet", buf_in, buf_in_len);
+	TRY(coap_header_deserialize(&buf, OSCORE, oscore_packet));
+	return oscore_option_parser(oscore_packet->options,
+				    oscore_packet->options_cnt, oscore_option);
+}
 
-	buf.ptr = buf_in;
-	buf.len = buf_in_len;
+/**
+ * @brief Checks if a packet is replayed, before it is decrypted (see RFC 
+ *        8613 p. 7.4). Requests are checked against the replay window 
+ *        (in normal operation only), notifications against the last 
+ *        notification number.
+ * 
+ * @param oscore_packet Parsed input packet.
+ * @param oscore_option Parsed OSCORE option of the packet.
+ * @param c Security context.
+ * @return enum err ok if the packet is not replayed.
+ */
+static enum err replay_check(struct o_coap_packet *oscore_packet,
+			     struct compressed_oscore_option *oscore_option,
+			     struct context *c)
+{
+	if (is_request(oscore_packet)) {
+		if (ECHO_SYNCHRONIZED == c->rrc.echo_state_machine) {
+			uint64_t ssn;
+			TRY(piv2ssn(&oscore_option->piv, &ssn));
+			if (!server_is_sequence_number_valid(
+				    ssn, &c->rc.replay_window)) {
+				PRINT_MSG("Replayed message detected!\n");
+				return oscore_replay_window_protection_error;
+			}
+		}
+	} else if (is_observe(oscore_packet->options,
+			      oscore_packet->options_cnt) &&
+		   (0 != oscore_option->piv.len)) {
+		TRY(replay_protection_check_notification(
+			c->rc.notification_num,
+			c->rc.notification_num_initialized,
+			&oscore_option->piv));
+	}
+	return ok;
+}
 
-	/* Make sure that given context is fresh enough to process the message. */
-	TRY(check_context_freshness(c));
+/**
+ * @brief Rejects requests for another Recipient ID, replayed packets and 
+ *        packets exceeding the failure limit of the context, based on the 
+ *        fields read by peek() only. The context must be locked.
+ * 
+ * @param oscore_packet Peeked input packet.
+ * @param oscore_option Parsed OSCORE option of the packet.
+ * @param c Security context.
+ * @return enum err ok if the packet can be decrypted with the context.
+ */
+static enum err prefilter(struct o_coap_packet *oscore_packet,
+			  struct compressed_oscore_option *oscore_option,
+			  struct context *c)
+{
+	/*Check that the recipient context c->rc has a Recipient ID that
+	matches the received with the oscore option KID (Sender ID). If this is
+	not true return an error which indicates the caller application to try
+	another context. This is useful when the caller app doesn't know in 
+	advance to which context an incoming packet belongs.*/
+	if (is_request(oscore_packet) &&
+	    !array_equals(&c->rc.recipient_id, &oscore_option->kid)) {
+		return oscore_kid_recipient_id_mismatch;
+	}
 
-	/*Parse the incoming message (buf_in) into a CoAP struct*/
-	memset(&oscore_packet, 0, sizeof(oscore_packet));
-	TRY(coap_deserialize(&buf, &oscore_packet));
+	if (!oscore_rate_limit_allow(&c->rc.failure_limit)) {
+		PRINT_MSG("Packet dropped, too many failures!\n");
+		return oscore_rate_limited;
+	}
 
-	/* Check if the packet is OSCORE packet and if so parse the OSCORE option */
-	TRY(oscore_option_parser(oscore_packet.options,
-				 oscore_packet.options_cnt, &oscore_option));
+	/* Check if the packet is replayed - in case of normal operation (replay window already synchronized). */
+	enum err r = replay_check(oscore_packet, oscore_option, c);
+	if (ok != r) {
+		oscore_rate_limit_failure(&c->rc.failure_limit);
+	}
+	return r;
+}
 
-	/* Encrypted packet payload */
-	struct byte_array *ciphertext = &oscore_packet.payload;
+/**
+ * @brief Runs prefilter() with a context which is not locked yet, after 
+ *        checking its freshness.
+ * 
+ * @param oscore_packet Peeked input packet.
+ * @param oscore_option Parsed OSCORE option of the packet.
+ * @param c Security context.
+ * @return enum err ok if the packet can be decrypted with the context.
+ */
+static enum err context_prefilter(struct o_coap_packet *oscore_packet,
+				  struct compressed_oscore_option *oscore_option,
+				  struct context *c)
+{
+	context_lock(c);
+	enum err r = check_context_freshness(c);
+	if (ok == r) {
+		r = prefilter(oscore_packet, oscore_option, c);
+	}
+	context_unlock(c);
+	return r;
+}
 
-	/* Setup buffer for the plaintext. The plaintext is shorter than the 
-	ciphertext because of the authentication tag*/
-	uint32_t plaintext_bytes_len = ciphertext->len - AUTH_TAG_LEN;
-	BYTE_ARRAY_NEW(plaintext, MAX_PLAINTEXT_LEN, plaintext_bytes_len);
-	/* TODO plaintext can be moved inside decrypt_wrapper to simplify the code.
-	   To do so, refactor of echo_val_is_fresh is needed, to operate on o_coap_packet. */
+/**
+ * @brief Computes the digest of a confirmable request, which identifies its
+ *        retransmissions, if the context caches responses. The context must
+ *        be locked.
+ * 
+ * @param buf_in Input packet.
+ * @param buf_in_len Length of the input packet.
+ * @param oscore_packet Peeked input packet.
+ * @param c Security context.
+ * @param digest Buffer of OSCORE_RESPONSE_CACHE_DIGEST_LEN bytes on input, 
+ *        the digest on output. Its length is 0 if no digest is needed.
+ * @return enum err 
+ */
+static enum err request_digest_get(uint8_t *buf_in, uint32_t buf_in_len,
+				   struct o_coap_packet *oscore_packet,
+				   struct context *c, struct byte_array *digest)
+{
+	if (!is_request(oscore_packet) ||
+	    (TYPE_CON != oscore_packet->header.type) ||
+	    (NULL == c->rrc.responses.entries)) {
+		digest->len = 0;
+		return ok;
+	}
+	struct byte_array request = BYTE_ARRAY_INIT(buf_in, buf_in_len);
+	return oscore_response_cache_digest(&request, digest);
+}
 
-	/* Helper structure for decrypted coap packet */
-	struct o_coap_packet output_coap;
+/**
+ * @brief Keeps the digest of an accepted request for the response cache, 
+ *        see response_cache_put() in coap2oscore.c. The context must be 
+ *        locked.
+ * 
+ * @param oscore_packet The accepted packet.
+ * @param c Security context.
+ * @param digest Digest from request_digest_get().
+ */
+static void request_digest_keep(struct o_coap_packet *oscore_packet,
+				struct context *c,
+				const struct byte_array *digest)
+{
+	if (!is_request(oscore_packet)) {
+		return;
+	}
+	memset(c->rrc.request_digest, 0, sizeof(c->rrc.request_digest));
+	if (0 != digest->len) {
+		memcpy(c->rrc.request_digest, digest->ptr,
+		       sizeof(c->rrc.request_digest));
+	}
+}
+
+/**
+ * @brief Answers a retransmitted confirmable request with the cached 
+ *        response to it, see struct oscore_response_cache. Only a 
+ *        byte-identical retransmission is answered, since the packet is not
+ *        authenticated yet. The context must be locked.
+ * 
+ * @param oscore_packet Peeked input packet.
+ * @param oscore_option Parsed OSCORE option of the packet.
+ * @param digest Digest of the packet from request_digest_get().
+ * @param c Security context.
+ * @param buf_out Output cached OSCORE response.
+ * @param buf_out_len Size of buf_out on input, length of the response on 
+ *        output.
+ * @return enum err oscore_duplicate_request if buf_out holds the cached 
+ *         response, ok if the packet is no retransmission.
+ */
+static enum err duplicate_get(struct o_coap_packet *oscore_packet,
+			      struct compressed_oscore_option *oscore_option,
+			      const struct byte_array *digest,
+			      struct context *c, uint8_t *buf_out,
+			      uint32_t *buf_out_len)
+{
+	if ((0 == digest->len) ||
+	    !array_equals(&c->rc.recipient_id, &oscore_option->kid)) {
+		return ok;
+	}
+
+	const struct oscore_cached_response *response =
+		oscore_response_cache_get(&c->rrc.responses,
+					  &oscore_option->piv,
+					  oscore_packet->header.MID, digest);
+	if (NULL == response) {
+		return ok;
+	}
+	PRINT_MSG("Retransmitted request, the cached response is returned\n");
+	uint32_t buf_out_size = *buf_out_len;
+	*buf_out_len = response->len;
+	TRY(_memcpy_s(buf_out, buf_out_size, response->buf, response->len));
+	return oscore_duplicate_request;
+}
+
+/**
+ * @brief Parses the rest of a peeked packet after it passed prefilter(), so
+ *        that packets which would be rejected anyway are not parsed 
+ *        completely. The context must be locked.
+ * 
+ * @param buf_in Input packet.
+ * @param buf_in_len Length of the input packet.
+ * @param oscore_packet Peeked input packet on input, the parsed packet on 
+ *        output.
+ * @param oscore_option Parsed OSCORE option of the packet.
+ * @param c Security context.
+ * @param digest Output digest of the packet, see request_digest_get(). It is
+ *        computed before the packet can be decrypted in place.
+ * @param buf_out Output for the cached response to a retransmitted request,
+ *        see duplicate_get(), or NULL to treat retransmissions as replays.
+ * @param buf_out_len Size of buf_out, see duplicate_get().
+ * @return enum err 
+ */
+static enum err parse_filtered(uint8_t *buf_in, uint32_t buf_in_len,
+			       struct o_coap_packet *oscore_packet,
+			       struct compressed_oscore_option *oscore_option,
+			       struct context *c, struct byte_array *digest,
+			       uint8_t *buf_out, uint32_t *buf_out_len)
+{
+	TRY(request_digest_get(buf_in, buf_in_len, oscore_packet, c, digest));
+	if (NULL != buf_out) {
+		TRY(duplicate_get(oscore_packet, oscore_option, digest, c,
+				  buf_out, buf_out_len));
+	}
+	TRY(prefilter(oscore_packet, oscore_option, c));
+	struct byte_array buf = BYTE_ARRAY_INIT(buf_in, buf_in_len);
+	return coap_deserialize_rest(&buf, oscore_packet);
+}
+
+/**
+ * @brief Checks if a packet belongs to a given context. Requests are 
+ *        matched by the KID (and the KID context, if present), responses 
+ *        by the token of the corresponding request. This is the rule of all
+ *        lookups, see oscore2coap_table() in oscore.h.
+ * 
+ * @param oscore_packet Parsed input packet.
+ * @param oscore_option Parsed OSCORE option of the packet.
+ * @param c Security context.
+ * @return true if the packet belongs to the context.
+ */
+static bool context_matches(struct o_coap_packet *oscore_packet,
+			    struct compressed_oscore_option *oscore_option,
+			    struct context *c)
+{
+	if (is_request(oscore_packet)) {
+		return array_equals(&c->rc.recipient_id, &oscore_option->kid) &&
+		       ((0 == oscore_option->kid_context.len) ||
+			array_equals(&c->cc.id_context,
+				     &oscore_option->kid_context));
+	}
+
+	/*the interactions change with every request, the IDs above don't*/
+	struct oscore_interaction_t *record;
+	context_lock(c);
+	bool matches = (ok == oscore_interactions_get_record(
+				      &c->rrc.interactions, oscore_packet->token,
+				      oscore_packet->header.TKL, &record));
+	context_unlock(c);
+	return matches;
+}
+
+/**
+ * @brief Stores a new replay bound in NVM before a request with the given 
+ *        SSN is accepted, so that no request accepted before a reboot is 
+ *        accepted again without the ECHO challenge afterwards. Nothing is 
+ *        written while the SSN is below the stored bound.
+ * 
+ * @param c Security context.
+ * @param ssn SSN of the request.
+ * @return enum err 
+ */
+static enum err replay_bound_persist(struct context *c, uint64_t ssn)
+{
+#ifdef OSCORE_NVM_SUPPORT
+	if ((0 == c->rc.replay_bound_interval) || (ssn < c->rc.replay_bound)) {
+		return ok;
+	}
+
+	struct nvm_key_t nvm_key = { .sender_id = c->sc.sender_id,
+				     .recipient_id = c->rc.recipient_id,
+				     .id_context = c->cc.id_context };
+	uint64_t bound = ssn + c->rc.replay_bound_interval;
+	TRY(nvm_write_replay_bound(&nvm_key, bound));
+	c->rc.replay_bound = bound;
+#else
+	(void)c;
+	(void)ssn;
+#endif
+	return ok;
+}
+
+/**
+ * @brief Checks the ECHO option of a request that answers the ECHO 
+ *        challenge, against the Echo value cached by coap2oscore() or with 
+ *        the echo_key of the context. Stateless Echo values must be created
+ *        after the challenge.
+ * 
+ * @param c Security context.
+ * @param plaintext Decrypted request.
+ * @return enum err ok if the Echo value is fresh.
+ */
+static enum err echo_verify(struct context *c, struct byte_array *plaintext)
+{
+	if (NULL == c->rrc.echo_key) {
+		return echo_val_is_fresh(&c->rrc.echo_opt_val, plaintext);
+	}
+
+	struct byte_array echo_val;
+	TRY(echo_val_get(plaintext, &echo_val));
+	return oscore_echo_verify(c->rrc.echo_key, &c->cc.id_context,
+				  &c->rc.recipient_id, &echo_val,
+				  c->rrc.echo_challenge_time);
+}
+
+/**
+ * @brief Decrypts a parsed OSCORE packet and updates the replay protection 
+ *        and the ECHO state of the context. The packet must have passed 
+ *        prefilter(). The context must be locked and its freshness checked 
+ *        by the caller.
+ * 
+ * @param oscore_packet Parsed input packet, its payload is the ciphertext.
+ * @param oscore_option Parsed OSCORE option of the packet.
+ * @param plaintext Output buffer for the plaintext, may start at the same 
+ *        address as the ciphertext.
+ * @param c Security context.
+ * @param output_coap Output CoAP packet, points into the input packet and 
+ *        the plaintext.
+ * @return enum err 
+ */
+static enum err unprotect_packet(struct o_coap_packet *oscore_packet,
+				 struct compressed_oscore_option *oscore_option,
+				 struct byte_array *plaintext,
+				 struct context *c,
+				 struct o_coap_packet *output_coap)
+{
+	/* Encrypted packet payload */
+	struct byte_array *ciphertext = &oscore_packet->payload;
 
 	/*In requests the OSCORE packet contains at least a KID = sender ID 
         and eventually sender sequence number*/
-	if (is_request(&oscore_packet)) {
-		/*Check that the recipient context c->rc has a  Recipient ID that
-			 matches the received with the oscore option KID (Sender ID).
-			 If this is not true return an error which indicates the caller
-			 application to tray another context. This is useful when the caller
-			 app doesn't know in advance to which context an incoming packet 
-             belongs.*/
-		if (!array_equals(&c->rc.recipient_id, &oscore_option.kid)) {
-			return oscore_kid_recipient_id_mismatch;
-		}
+	if (is_request(oscore_packet)) {
+		/* Decrypt packet using new nonce based on the packet */
+		TRY(decrypt_wrapper(ciphertext, plaintext, c, oscore_option,
+				    oscore_packet, output_coap));
 
-		/* Check if the packet is replayed - in case of normal operation (replay window already synchronized).
-		   It must be performed before decrypting the packet (see RFC 8613 p. 7.4). */
-		if (ECHO_SYNCHRONIZED == c->rrc.echo_state_machine) {
+		if (ECHO_RESTORED == c->rrc.echo_state_machine) {
+			/* Requests above the replay window restored from NVM were never accepted 
+			   before. Older ones may be replayed, they get the ECHO challenge. */
 			uint64_t ssn;
-			piv2ssn(&oscore_option.piv, &ssn);
-			if (!server_is_sequence_number_valid(
-				    ssn, &c->rc.replay_window)) {
-				PRINT_MSG("Replayed message detected!\n");
-				return oscore_replay_window_protection_error;
-			}
+			TRY(piv2ssn(&oscore_option->piv, &ssn));
+			c->rrc.echo_state_machine =
+				server_is_sequence_number_valid(
+					ssn, &c->rc.replay_window) ?
+					ECHO_SYNCHRONIZED :
+					ECHO_REBOOT;
 		}
 
-		/* Decrypt packet using new nonce based on the packet */
-		TRY(decrypt_wrapper(ciphertext, &plaintext, c, &oscore_option,
-				    &oscore_packet, &output_coap));
-
 		if (ECHO_REBOOT == c->rrc.echo_state_machine) {
 			/* Abort the execution if this is the the first request after reboot.
 			   Let the application layer know that it should prepare a special response with ECHO option
-			   and prepare for verifying ECHO of the next request. */
+			   and prepare for verifying ECHO of the next request. 
+			   Also a valid stateless Echo value is not accepted here: a request 
+			   recorded before the reboot may carry one, and it would be accepted 
+			   again within the lifetime of the value. */
 			PRINT_MSG("Abort -- first request after reboot!\n");
+			if (NULL != c->rrc.echo_key) {
+				c->rrc.echo_challenge_time =
+					c->rrc.echo_key->clock();
+			}
 			c->rrc.echo_state_machine = ECHO_VERIFY;
 			return first_request_after_reboot;
 		} else if (ECHO_VERIFY == c->rrc.echo_state_machine) {
 			/* Next request should already have proper ECHO option for proving freshness.
 			   If so, perform replay window reinitialization and start normal operation.
 			   If not, repeat the whole process until normal operation can be started. */
-			if (ok == echo_val_is_fresh(&c->rrc.echo_opt_val,
-						    &plaintext)) {
+			if (ok == echo_verify(c, plaintext)) {
 				uint64_t ssn;
-				piv2ssn(&oscore_option.piv, &ssn);
+				piv2ssn(&oscore_option->piv, &ssn);
+				TRY(replay_bound_persist(c, ssn));
 				TRY(server_replay_window_reinit(
 					ssn, &c->rc.replay_window));
 				c->rrc.echo_state_machine = ECHO_SYNCHRONIZED;
@@ -417,55 +740,670 @@ enum err oscore2coap(uint8_t *buf_in, uint32_t buf_in_len, uint8_t *buf_out,
 			/* Normal operation - update replay window. */
 			TRY_EXPECT(c->rrc.echo_state_machine,
 				   ECHO_SYNCHRONIZED);
-			server_replay_window_update(*oscore_option.piv.ptr,
-						    &c->rc.replay_window);
+			uint64_t ssn;
+			TRY(piv2ssn(&oscore_option->piv, &ssn));
+			TRY(replay_bound_persist(c, ssn));
+			server_replay_window_update(ssn, &c->rc.replay_window);
 		}
 	} else {
 		/* received any kind of response */
-		if (is_observe(oscore_packet.options,
-			       oscore_packet.options_cnt)) {
-			if (oscore_option.piv.len != 0) {
+		if (is_observe(oscore_packet->options,
+			       oscore_packet->options_cnt)) {
+			if (oscore_option->piv.len != 0) {
 				/*Notification with PIV received*/
 				PRINT_MSG(
 					"Observe notification with PIV received\n");
 
-				TRY(replay_protection_check_notification(
-					c->rc.notification_num,
-					c->rc.notification_num_initialized,
-					&oscore_option.piv));
-
 				/* Decrypt packet using new nonce based on the packet */
-				TRY(decrypt_wrapper(ciphertext, &plaintext, c,
-						    &oscore_option,
-						    &oscore_packet,
-						    &output_coap));
+				TRY(decrypt_wrapper(ciphertext, plaintext, c,
+						    oscore_option,
+						    oscore_packet,
+						    output_coap));
 
 				/*update replay protection value in context*/
 				TRY(notification_number_update(
 					&c->rc.notification_num,
 					&c->rc.notification_num_initialized,
-					&oscore_option.piv));
+					&oscore_option->piv));
 			} else {
 				/*Notification without PIV received -- Currently not supported*/
 				return not_supported_feature; //LCOV_EXCL_LINE
 			}
 		} else {
 			/*regular response received*/
-			if (oscore_option.piv.len != 0) {
+			if (oscore_option->piv.len != 0) {
 				/*response with PIV*/
-				TRY(decrypt_wrapper(ciphertext, &plaintext, c,
-						    &oscore_option,
-						    &oscore_packet,
-						    &output_coap));
+				TRY(decrypt_wrapper(ciphertext, plaintext, c,
+						    oscore_option,
+						    oscore_packet,
+						    output_coap));
 			} else {
 				/*response without PIV*/
-				TRY(decrypt_wrapper(ciphertext, &plaintext, c,
-						    NULL, &oscore_packet,
-						    &output_coap));
+				TRY(decrypt_wrapper(ciphertext, plaintext, c,
+						    NULL, oscore_packet,
+						    output_coap));
 			}
 		}
 	}
 
+	return ok;
+}
+
+/**
+ * @brief Converts a peeked OSCORE packet to CoAP, see peek(). The context 
+ *        must be locked and its freshness checked by the caller.
+ * 
+ * @param buf_in Input OSCORE packet.
+ * @param buf_in_len Length of the input packet.
+ * @param oscore_packet Peeked input packet, parsed completely on return.
+ * @param oscore_option Parsed OSCORE option of the packet.
+ * @param buf_out Output CoAP packet.
+ * @param buf_out_len Size of buf_out on input, length of the CoAP packet on 
+ *        output.
+ * @param c Security context.
+ * @return enum err 
+ */
+static enum err unprotect_peeked(uint8_t *buf_in, uint32_t buf_in_len,
+				 struct o_coap_packet *oscore_packet,
+				 struct compressed_oscore_option *oscore_option,
+				 uint8_t *buf_out, uint32_t *buf_out_len,
+				 struct context *c)
+{
+	PRINT_MSG("\n\n\noscore2coap***************************************\n");
+	PRINT_ARRAY("Input OSCORE packet", buf_in, buf_in_len);
+
+	BYTE_ARRAY_NEW(digest, OSCORE_RESPONSE_CACHE_DIGEST_LEN,
+		       OSCORE_RESPONSE_CACHE_DIGEST_LEN);
+	TRY(parse_filtered(buf_in, buf_in_len, oscore_packet, oscore_option, c,
+			   &digest, buf_out, buf_out_len));
+
+	/* Setup buffer for the plaintext. The plaintext is shorter than the 
+	ciphertext because of the authentication tag*/
+	uint32_t plaintext_bytes_len =
+		oscore_packet->payload.len - AUTH_TAG_LEN;
+	BYTE_ARRAY_NEW(plaintext, MAX_PLAINTEXT_LEN, plaintext_bytes_len);
+
+	/* Helper structure for decrypted coap packet */
+	struct o_coap_packet output_coap;
+	TRY(unprotect_packet(oscore_packet, oscore_option, &plaintext, c,
+			     &output_coap));
+	request_digest_keep(oscore_packet, c, &digest);
+
 	/*Convert to byte string*/
 	return coap_serialize(&output_coap, buf_out, buf_out_len);
 }
+
+/**
+ * @brief Converts an OSCORE packet to CoAP. The context must be locked and 
+ *        its freshness checked by the caller.
+ * 
+ * @param buf_in Input OSCORE packet.
+ * @param buf_in_len Length of the input packet.
+ * @param buf_out Output CoAP packet.
+ * @param buf_out_len Size of buf_out on input, length of the CoAP packet on 
+ *        output.
+ * @param c Security context.
+ * @return enum err 
+ */
+static enum err unprotect(uint8_t *buf_in, uint32_t buf_in_len,
+			  uint8_t *buf_out, uint32_t *buf_out_len,
+			  struct context *c)
+{
+	struct o_coap_packet oscore_packet;
+	struct compressed_oscore_option oscore_option;
+	TRY(peek(buf_in, buf_in_len, &oscore_packet, &oscore_option));
+	return unprotect_peeked(buf_in, buf_in_len, &oscore_packet,
+				&oscore_option, buf_out, buf_out_len, c);
+}
+
+/**
+ * @brief Decrypts an OSCORE packet into a CoAP packet structure without 
+ *        serializing it. The context must be locked and its freshness 
+ *        checked by the caller.
+ * 
+ * @param buf_in Input OSCORE packet.
+ * @param buf_in_len Length of the input packet.
+ * @param plaintext Buffer and size for the plaintext on input, the plaintext
+ *        on output. If its buffer is NULL, the plaintext is decrypted over 
+ *        the ciphertext in buf_in. If the buffer is too small, its length 
+ *        is set to the required size.
+ * @param output_coap Output CoAP packet, points into buf_in and plaintext.
+ * @param c Security context.
+ * @return enum err 
+ */
+static enum err unprotect_to_packet(uint8_t *buf_in, uint32_t buf_in_len,
+				    struct byte_array *plaintext,
+				    struct o_coap_packet *output_coap,
+				    struct context *c)
+{
+	struct o_coap_packet oscore_packet;
+	struct compressed_oscore_option oscore_option;
+
+	PRINT_ARRAY("Input OSCORE packet", buf_in, buf_in_len);
+
+	TRY(peek(buf_in, buf_in_len, &oscore_packet, &oscore_option));
+	BYTE_ARRAY_NEW(digest, OSCORE_RESPONSE_CACHE_DIGEST_LEN,
+		       OSCORE_RESPONSE_CACHE_DIGEST_LEN);
+	TRY(parse_filtered(buf_in, buf_in_len, &oscore_packet, &oscore_option,
+			   c, &digest, NULL, NULL));
+
+	/* The plaintext is shorter than the ciphertext because of the 
+	authentication tag*/
+	if (oscore_packet.payload.len < AUTH_TAG_LEN) {
+		return not_oscore_pkt;
+	}
+	uint32_t plaintext_len = oscore_packet.payload.len - AUTH_TAG_LEN;
+	if (NULL == plaintext->ptr) {
+		plaintext->ptr = oscore_packet.payload.ptr;
+	} else if (plaintext->len < plaintext_len) {
+		plaintext->len = plaintext_len;
+		return buffer_to_small;
+	}
+	plaintext->len = plaintext_len;
+
+	TRY(unprotect_packet(&oscore_packet, &oscore_option, plaintext, c,
+			     output_coap));
+	request_digest_keep(&oscore_packet, c, &digest);
+	return ok;
+}
+
+/**
+ * @brief Converts an OSCORE packet to CoAP within its own buffer, see 
+ *        oscore2coap_in_place(). The context must be locked and its 
+ *        freshness checked by the caller.
+ * 
+ * @param buf Input OSCORE packet, overwritten with the CoAP packet.
+ * @param buf_len Length of the input packet.
+ * @param coap Start of the CoAP packet in buf.
+ * @param coap_len Length of the CoAP packet.
+ * @param c Security context.
+ * @return enum err 
+ */
+static enum err unprotect_in_place(uint8_t *buf, uint32_t buf_len,
+				   uint8_t **coap, uint32_t *coap_len,
+				   struct context *c)
+{
+	PRINT_MSG("\n\n\noscore2coap in place******************************\n");
+
+	/* The plaintext is decrypted over the ciphertext, the tag at the end is
+	no longer needed after the verification*/
+	struct byte_array plaintext = BYTE_ARRAY_INIT(NULL, 0);
+	struct o_coap_packet output_coap;
+	TRY(unprotect_to_packet(buf, buf_len, &plaintext, &output_coap, c));
+
+	/* The payload stays where it was decrypted, the header, the token and 
+	the options are written directly in front of it. Their values point into
+	the region which is overwritten, so they are serialized to a small 
+	staging buffer first.*/
+	uint8_t *end = (0 != output_coap.payload.len) ?
+			       output_coap.payload.ptr :
+			       plaintext.ptr + plaintext.len;
+	uint8_t header[4 + MAX_TOKEN_LEN + E_OPTIONS_BUFF_MAX_LEN +
+		       I_OPTIONS_BUFF_MAX_LEN + 1];
+	uint32_t header_len = sizeof(header);
+	TRY(coap_header_serialize(&output_coap, header, &header_len));
+	if (header_len > (uint32_t)(end - buf)) {
+		return buffer_to_small;
+	}
+
+	*coap = end - header_len;
+	memmove(*coap, header, header_len);
+	*coap_len = header_len + output_coap.payload.len;
+	PRINT_ARRAY("Output CoAP packet", *coap, *coap_len);
+	return ok;
+}
+
+/**
+ * @brief Converts an OSCORE packet to a CoAP packet in two segments, see 
+ *        oscore2coap_iov(). The context must be locked and its freshness 
+ *        checked by the caller.
+ * 
+ * @param buf_in Input OSCORE packet.
+ * @param buf_in_len Length of the input packet.
+ * @param coap_header Header segment, size of the buffer on input, length of
+ *        the header on output.
+ * @param coap_payload Payload segment, like coap_header.
+ * @param c Security context.
+ * @return enum err 
+ */
+static enum err unprotect_segments(uint8_t *buf_in, uint32_t buf_in_len,
+				   struct byte_array *coap_header,
+				   struct byte_array *coap_payload,
+				   struct context *c)
+{
+	PRINT_MSG("\n\n\noscore2coap iov***********************************\n");
+
+	/* The whole plaintext is decrypted into the payload segment, the 
+	payload is moved to its start at the end*/
+	struct byte_array plaintext = *coap_payload;
+	struct o_coap_packet output_coap;
+	enum err r =
+		unprotect_to_packet(buf_in, buf_in_len, &plaintext, &output_coap, c);
+	if (buffer_to_small == r) {
+		coap_payload->len = plaintext.len;
+	}
+	TRY(r);
+
+	/* The options point into the plaintext, so they are serialized before
+	the payload is moved*/
+	uint32_t header_len = coap_header->len;
+	TRY(coap_header_serialize(&output_coap, coap_header->ptr, &header_len));
+	memmove(coap_payload->ptr, output_coap.payload.ptr,
+		output_coap.payload.len);
+
+	coap_header->len = header_len;
+	coap_payload->len = output_coap.payload.len;
+	PRINT_ARRAY("Output CoAP header", coap_header->ptr, coap_header->len);
+	PRINT_ARRAY("Output CoAP payload", coap_payload->ptr,
+		    coap_payload->len);
+	return ok;
+}
+
+/**
+ * @brief Runs unprotect_peeked() with a context which is not locked yet, 
+ *        after checking its freshness, for a packet peeked while its context
+ *        was looked up.
+ * 
+ * @param buf_in Input OSCORE packet.
+ * @param buf_in_len Length of the input packet.
+ * @param oscore_packet Peeked input packet.
+ * @param oscore_option Parsed OSCORE option of the packet.
+ * @param buf_out Output CoAP packet.
+ * @param buf_out_len Size of buf_out on input, length of the CoAP packet on 
+ *        output.
+ * @param c Security context.
+ * @return enum err 
+ */
+static enum err context_unprotect(uint8_t *buf_in, uint32_t buf_in_len,
+				  struct o_coap_packet *oscore_packet,
+				  struct compressed_oscore_option *oscore_option,
+				  uint8_t *buf_out, uint32_t *buf_out_len,
+				  struct context *c)
+{
+	context_lock(c);
+	enum err r = check_context_freshness(c);
+	if (ok == r) {
+		r = unprotect_peeked(buf_in, buf_in_len, oscore_packet,
+				     oscore_option, buf_out, buf_out_len, c);
+	}
+	context_unlock(c);
+	return r;
+}
+
+enum err oscore2coap(uint8_t *buf_in, uint32_t buf_in_len, uint8_t *buf_out,
+		     uint32_t *buf_out_len, struct context *c)
+{
+	if (NULL == c) {
+		return wrong_parameter;
+	}
+
+	context_lock(c);
+	/* Make sure that given context is fresh enough to process the message. */
+	enum err r = check_context_freshness(c);
+	if (ok == r) {
+		r = unprotect(buf_in, buf_in_len, buf_out, buf_out_len, c);
+	}
+	context_unlock(c);
+	return r;
+}
+
+enum err oscore2coap_in_place(uint8_t *buf, uint32_t buf_len, uint8_t **coap,
+			      uint32_t *coap_len, struct context *c)
+{
+	if ((NULL == buf) || (NULL == coap) || (NULL == coap_len) ||
+	    (NULL == c)) {
+		return wrong_parameter;
+	}
+
+	context_lock(c);
+	enum err r = check_context_freshness(c);
+	if (ok == r) {
+		r = unprotect_in_place(buf, buf_len, coap, coap_len, c);
+	}
+	context_unlock(c);
+	return r;
+}
+
+enum err oscore2coap_iov(uint8_t *buf_in, uint32_t buf_in_len,
+			 struct byte_array *coap_header,
+			 struct byte_array *coap_payload, struct context *c)
+{
+	if ((NULL == buf_in) || (NULL == coap_header) ||
+	    (NULL == coap_header->ptr) || (NULL == coap_payload) ||
+	    (NULL == coap_payload->ptr) || (NULL == c)) {
+		return wrong_parameter;
+	}
+
+	context_lock(c);
+	enum err r = check_context_freshness(c);
+	if (ok == r) {
+		r = unprotect_segments(buf_in, buf_in_len, coap_header,
+				       coap_payload, c);
+	}
+	context_unlock(c);
+	return r;
+}
+
+enum err oscore2coap_packet(uint8_t *buf_in, uint32_t buf_in_len,
+			    struct byte_array *plaintext,
+			    struct o_coap_packet *coap, struct context *c)
+{
+	if ((NULL == buf_in) || (NULL == coap) || (NULL == c)) {
+		return wrong_parameter;
+	}
+
+	struct byte_array in_place = BYTE_ARRAY_INIT(NULL, 0);
+	if (NULL == plaintext) {
+		plaintext = &in_place;
+	}
+
+	context_lock(c);
+	enum err r = check_context_freshness(c);
+	if (ok == r) {
+		r = unprotect_to_packet(buf_in, buf_in_len, plaintext, coap, c);
+	}
+	context_unlock(c);
+	return r;
+}
+
+enum err oscore_peek(uint8_t *buf_in, uint32_t buf_in_len,
+		     struct o_coap_packet *packet,
+		     struct compressed_oscore_option *oscore_option)
+{
+	if ((NULL == buf_in) || (NULL == packet) || (NULL == oscore_option)) {
+		return wrong_parameter;
+	}
+	return peek(buf_in, buf_in_len, packet, oscore_option);
+}
+
+enum err oscore_prefilter(uint8_t *buf_in, uint32_t buf_in_len,
+			  struct context *c)
+{
+	if ((NULL == buf_in) || (NULL == c)) {
+		return wrong_parameter;
+	}
+
+	struct o_coap_packet oscore_packet;
+	struct compressed_oscore_option oscore_option;
+	TRY(peek(buf_in, buf_in_len, &oscore_packet, &oscore_option));
+	return context_prefilter(&oscore_packet, &oscore_option, c);
+}
+
+/**
+ * @brief Checks the limiter of packets matching no context, see 
+ *        oscore_context_table_rate_limit_set().
+ * 
+ * @param limit The limiter, or NULL.
+ * @return true if the packet may be looked up.
+ */
+static bool unknown_allow(struct oscore_rate_limit *limit)
+{
+	return (NULL == limit) || oscore_rate_limit_allow(limit);
+}
+
+/**
+ * @brief Counts a packet which matched no context.
+ * 
+ * @param limit The limiter, or NULL.
+ * @param r Error of the lookup.
+ * @return enum err r, or oscore_rate_limited if the limiter is exhausted.
+ */
+static enum err unknown_limit(struct oscore_rate_limit *limit, enum err r)
+{
+	if (NULL == limit) {
+		return r;
+	}
+	if (!oscore_rate_limit_allow(limit)) {
+		return oscore_rate_limited;
+	}
+	oscore_rate_limit_failure(limit);
+	return r;
+}
+
+/**
+ * @brief Finds the context of a peeked packet in a table of contexts.
+ * 
+ * @param oscore_packet Peeked input packet.
+ * @param oscore_option Parsed OSCORE option of the packet.
+ * @param table The table.
+ * @param c Output context.
+ * @return enum err 
+ */
+static enum err table_lookup(struct o_coap_packet *oscore_packet,
+			     struct compressed_oscore_option *oscore_option,
+			     struct oscore_context_table *table,
+			     struct context **c)
+{
+	bool request = is_request(oscore_packet);
+	if (request) {
+		enum err r = oscore_context_table_find(
+			table, &oscore_option->kid_context, &oscore_option->kid,
+			c);
+		if ((ok == r) || (0 != oscore_option->kid_context.len)) {
+			return (ok == r) ? ok :
+					   unknown_limit(table->unknown_limit, r);
+		}
+	}
+
+	/*responses carry no KID, they are matched by their token. Requests
+	without a KID context which match no context without an ID Context
+	are matched by their KID*/
+	if (!unknown_allow(table->unknown_limit)) {
+		return oscore_rate_limited;
+	}
+	uint32_t iterator = 0;
+	struct context *entry;
+	while (NULL != (entry = oscore_context_table_next(table, &iterator))) {
+		if (context_matches(oscore_packet, oscore_option, entry)) {
+			*c = entry;
+			return ok;
+		}
+	}
+	return unknown_limit(table->unknown_limit,
+			     request ? oscore_kid_recipient_id_mismatch :
+				       oscore_interaction_not_found);
+}
+
+enum err oscore_prefilter_table(uint8_t *buf_in, uint32_t buf_in_len,
+				struct oscore_context_table *table,
+				struct context **c)
+{
+	if ((NULL == buf_in) || (NULL == table) || (NULL == c)) {
+		return wrong_parameter;
+	}
+	*c = NULL;
+
+	struct o_coap_packet oscore_packet;
+	struct compressed_oscore_option oscore_option;
+	TRY(peek(buf_in, buf_in_len, &oscore_packet, &oscore_option));
+	TRY(table_lookup(&oscore_packet, &oscore_option, table, c));
+	return context_prefilter(&oscore_packet, &oscore_option, *c);
+}
+
+enum err oscore2coap_table(uint8_t *buf_in, uint32_t buf_in_len,
+			   uint8_t *buf_out, uint32_t *buf_out_len,
+			   struct oscore_context_table *table,
+			   struct context **c)
+{
+	if ((NULL == table) || (NULL == c)) {
+		return wrong_parameter;
+	}
+	*c = NULL;
+
+	struct o_coap_packet oscore_packet;
+	struct compressed_oscore_option oscore_option;
+	TRY(peek(buf_in, buf_in_len, &oscore_packet, &oscore_option));
+	TRY(table_lookup(&oscore_packet, &oscore_option, table, c));
+
+	return context_unprotect(buf_in, buf_in_len, &oscore_packet,
+				 &oscore_option, buf_out, buf_out_len, *c);
+}
+
+/**
+ * @brief A peeked packet, passed to packet_matches().
+ */
+struct parsed_packet {
+	struct o_coap_packet *oscore_packet;
+	struct compressed_oscore_option *oscore_option;
+};
+
+static bool packet_matches(struct context *c, void *arg)
+{
+	struct parsed_packet *p = arg;
+	return context_matches(p->oscore_packet, p->oscore_option, c);
+}
+
+/**
+ * @brief Finds the context of a peeked packet in a context store.
+ * 
+ * @param oscore_packet Peeked input packet.
+ * @param oscore_option Parsed OSCORE option of the packet.
+ * @param store The store.
+ * @param c Output context.
+ * @return enum err 
+ */
+static enum err store_lookup(struct o_coap_packet *oscore_packet,
+			     struct compressed_oscore_option *oscore_option,
+			     struct oscore_context_store *store,
+			     struct context **c)
+{
+	bool request = is_request(oscore_packet);
+	if (request) {
+		enum err r = oscore_context_store_find(
+			store, &oscore_option->kid_context, &oscore_option->kid,
+			c);
+		if ((ok == r) || (0 != oscore_option->kid_context.len)) {
+			return (ok == r) ? ok :
+					   unknown_limit(store->unknown_limit, r);
+		}
+	}
+
+	/*see table_lookup()*/
+	if (!unknown_allow(store->unknown_limit)) {
+		return oscore_rate_limited;
+	}
+	struct parsed_packet p = { .oscore_packet = oscore_packet,
+				   .oscore_option = oscore_option };
+	*c = oscore_context_store_search(store, packet_matches, &p);
+	if (NULL == *c) {
+		return unknown_limit(store->unknown_limit,
+				     request ? oscore_kid_recipient_id_mismatch :
+					       oscore_interaction_not_found);
+	}
+	return ok;
+}
+
+enum err oscore_prefilter_store(uint8_t *buf_in, uint32_t buf_in_len,
+				struct oscore_context_store *store,
+				struct context **c)
+{
+	if ((NULL == buf_in) || (NULL == store) || (NULL == c)) {
+		return wrong_parameter;
+	}
+	*c = NULL;
+
+	struct o_coap_packet oscore_packet;
+	struct compressed_oscore_option oscore_option;
+	TRY(peek(buf_in, buf_in_len, &oscore_packet, &oscore_option));
+	TRY(store_lookup(&oscore_packet, &oscore_option, store, c));
+	return context_prefilter(&oscore_packet, &oscore_option, *c);
+}
+
+enum err oscore2coap_store(uint8_t *buf_in, uint32_t buf_in_len,
+			   uint8_t *buf_out, uint32_t *buf_out_len,
+			   struct oscore_context_store *store,
+			   struct context **c)
+{
+	if ((NULL == store) || (NULL == c)) {
+		return wrong_parameter;
+	}
+	*c = NULL;
+
+	struct o_coap_packet oscore_packet;
+	struct compressed_oscore_option oscore_option;
+	TRY(peek(buf_in, buf_in_len, &oscore_packet, &oscore_option));
+	TRY(store_lookup(&oscore_packet, &oscore_option, store, c));
+
+	return context_unprotect(buf_in, buf_in_len, &oscore_packet,
+				 &oscore_option, buf_out, buf_out_len, *c);
+}
+
+/**
+ * @brief Finds the context of a packet and checks if the packet is 
+ *        replayed, without decrypting it. The packet is peeked into 
+ *        pkt->oscore_packet and pkt->oscore_option, which are reused for the
+ *        decryption.
+ * 
+ * @param pkt Packet of the batch, pkt->c is set to the matching context.
+ * @param contexts Contexts to search.
+ * @param contexts_cnt Number of contexts.
+ * @param hint Context of the previous packet of the batch, tried first 
+ *        since the packets of a batch often come from the same peer, or 
+ *        NULL.
+ * @return enum err 
+ */
+static enum err route(struct oscore_batch_pkt *pkt, struct context **contexts,
+		      uint32_t contexts_cnt, struct context *hint)
+{
+	TRY(peek(pkt->buf_in, pkt->buf_in_len, &pkt->oscore_packet,
+		 &pkt->oscore_option));
+
+	if ((NULL != hint) && context_matches(&pkt->oscore_packet,
+					      &pkt->oscore_option, hint)) {
+		pkt->c = hint;
+	}
+	for (uint32_t i = 0; (NULL == pkt->c) && (i < contexts_cnt); i++) {
+		if ((NULL != contexts[i]) && (hint != contexts[i]) &&
+		    context_matches(&pkt->oscore_packet, &pkt->oscore_option,
+				    contexts[i])) {
+			pkt->c = contexts[i];
+		}
+	}
+
+	if (NULL == pkt->c) {
+		return is_request(&pkt->oscore_packet) ?
+			       oscore_kid_recipient_id_mismatch :
+			       oscore_interaction_not_found;
+	}
+
+	return context_prefilter(&pkt->oscore_packet, &pkt->oscore_option,
+				 pkt->c);
+}
+
+enum err oscore2coap_batch(struct oscore_batch_pkt *pkts, uint32_t pkts_cnt,
+			   struct context **contexts, uint32_t contexts_cnt)
+{
+	if ((NULL == pkts) || (NULL == contexts)) {
+		return wrong_parameter;
+	}
+
+	/* Route all packets and reject replayed ones before any decryption. */
+	struct context *hint = NULL;
+	for (uint32_t i = 0; i < pkts_cnt; i++) {
+		pkts[i].c = NULL;
+		pkts[i].result = route(&pkts[i], contexts, contexts_cnt, hint);
+		if (NULL != pkts[i].c) {
+			hint = pkts[i].c;
+		}
+	}
+
+	/* Decrypt the remaining packets. The replay check is repeated, since 
+	   the batch itself can contain the same packet twice. The packets are
+	   not peeked again. */
+	enum err first_error = ok;
+	for (uint32_t i = 0; i < pkts_cnt; i++) {
+		if (ok == pkts[i].result) {
+			context_lock(pkts[i].c);
+			pkts[i].result = unprotect_peeked(
+				pkts[i].buf_in, pkts[i].buf_in_len,
+				&pkts[i].oscore_packet, &pkts[i].oscore_option,
+				pkts[i].buf_out, &pkts[i].buf_out_len,
+				pkts[i].c);
+			context_unlock(pkts[i].c);
+		}
+		if ((ok != pkts[i].result) && (ok == first_error)) {
+			first_error = pkts[i].result;
+		}
+	}
+	return first_error;
+}
@@ -222,7 +222,16 @@ enum err options_deserialize(struct byte_array *in_data,
 	return ok;
 }
 
-enum err coap_deserialize(struct byte_array *in, struct o_coap_packet *out)
+/**
+ * @brief   Reads the fixed header and the token of a packet
+ * @param   in: input message packet
+ * @param   out: output packet, its header and token are set
+ * @param   offset: output offset of the options in the input
+ * @return  err
+ */
+static enum err header_token_deserialize(struct byte_array *in,
+					 struct o_coap_packet *out,
+					 uint32_t *offset)
 {
 	uint8_t *tmp_p = in->ptr;
 	uint32_t payload_len = in->len;
@@ -258,11 +267,18 @@ enum err coap_deserialize(struct byte_array *in, struct o_coap_packet *out)
 		/* ERROR: CoAP token length maximal 8 bytes */
 		return oscore_inpkt_invalid_tkl;
 	}
-	/* Update pointer and length */
-	tmp_p += out->header.TKL;
-	payload_len -= out->header.TKL;
 
-	struct byte_array remaining_bytes = BYTE_ARRAY_INIT(tmp_p, payload_len);
+	*offset = HEADER_LEN + out->header.TKL;
+	return ok;
+}
+
+enum err coap_deserialize(struct byte_array *in, struct o_coap_packet *out)
+{
+	uint32_t offset;
+	TRY(header_token_deserialize(in, out, &offset));
+
+	struct byte_array remaining_bytes =
+		BYTE_ARRAY_INIT(in->ptr + offset, in->len - offset);
 	TRY(options_deserialize(&remaining_bytes,
 				(struct o_coap_option *)&out->options,
 				&out->options_cnt, &out->payload));
@@ -270,6 +286,195 @@ enum err coap_deserialize(struct byte_array *in, struct o_coap_packet *out)
 	return ok;
 }
 
+/**
+ * @brief   Reads the extended option delta or length following an option 
+ *          header byte (RFC 7252 p. 3.1)
+ * @param   p: in: position of the extended bytes, out: position after them
+ * @param   end: end of the input
+ * @param   value: in: 4 bit value from the option header byte, out: value
+ * @param   reserved: error returned for the reserved value 15
+ * @return  err
+ */
+static enum err option_extended_read(uint8_t **p, const uint8_t *end,
+				     uint16_t *value, enum err reserved)
+{
+	uint32_t v = *value;
+	if (13 == v) {
+		if (end - *p < 1) {
+			return not_valid_input_packet;
+		}
+		v = (uint32_t)(*p)[0] + 13;
+		*p += 1;
+	} else if (14 == v) {
+		if (end - *p < 2) {
+			return not_valid_input_packet;
+		}
+		v = ((uint32_t)(*p)[0] << 8 | (*p)[1]) + 269;
+		*p += 2;
+	} else if (15 == v) {
+		return reserved;
+	}
+
+	if (v > UINT16_MAX) {
+		return reserved;
+	}
+	*value = (uint16_t)v;
+	return ok;
+}
+
+/**
+ * @brief   Reads options until the payload marker, the end of the input or 
+ *          the first option with a number of at least last_option_number
+ * @param   p: in: position of the first option, out: position after the 
+ *          options read
+ * @param   end: end of the input
+ * @param   option_number: number of the option before p, 0 if none
+ * @param   last_option_number: number of the last option needed
+ * @param   out: output packet, the options are appended
+ * @return  err
+ */
+static enum err options_read(uint8_t **p, const uint8_t *end,
+			     uint32_t option_number,
+			     uint32_t last_option_number,
+			     struct o_coap_packet *out)
+{
+	while ((*p < end) && (OPTION_PAYLOAD_MARKER != **p)) {
+		uint16_t delta = (uint16_t)(**p >> 4);
+		uint16_t len = (uint16_t)(**p & 0x0F);
+		(*p)++;
+		TRY(option_extended_read(p, end, &delta,
+					 oscore_inpkt_invalid_option_delta));
+		TRY(option_extended_read(p, end, &len,
+					 oscore_inpkt_invalid_optionlen));
+		option_number += delta;
+		if ((len > end - *p) || (option_number > UINT16_MAX)) {
+			return not_valid_input_packet;
+		}
+		if (MAX_OPTION_COUNT <= out->options_cnt) {
+			return too_many_options;
+		}
+
+		struct o_coap_option *opt = &out->options[out->options_cnt++];
+		opt->delta = delta;
+		opt->len = len;
+		opt->option_number = (uint16_t)option_number;
+		opt->value = (0 != len) ? *p : NULL;
+		*p += len;
+
+		/* the options are ordered, the rest is not needed */
+		if (option_number >= last_option_number) {
+			break;
+		}
+	}
+	return ok;
+}
+
+enum err coap_header_deserialize(struct byte_array *in,
+				 uint16_t last_option_number,
+				 struct o_coap_packet *out)
+{
+	uint32_t offset;
+	TRY(header_token_deserialize(in, out, &offset));
+	out->payload.ptr = NULL;
+	out->payload.len = 0;
+
+	uint8_t *p = in->ptr + offset;
+	return options_read(&p, in->ptr + in->len, 0, last_option_number, out);
+}
+
+enum err coap_deserialize_rest(struct byte_array *in,
+			       struct o_coap_packet *out)
+{
+	/*the options read so far are encoded with the shortest deltas and 
+	lengths, the only encoding accepted by option_extended_read()*/
+	uint8_t *p = in->ptr + HEADER_LEN + out->header.TKL +
+		     options_serialized_len(out->options, out->options_cnt);
+	const uint8_t *end = in->ptr + in->len;
+	uint32_t option_number =
+		(0 != out->options_cnt) ?
+			out->options[out->options_cnt - 1].option_number :
+			0;
+	TRY(options_read(&p, end, option_number, UINT32_MAX, out));
+
+	out->payload.ptr = NULL;
+	out->payload.len = 0;
+	if (p < end) {
+		/* a payload marker must be followed by a payload */
+		if ((end - p) < 2) {
+			return not_valid_input_packet;
+		}
+		out->payload.ptr = p + 1;
+		out->payload.len = (uint32_t)(end - p - 1);
+	}
+	return ok;
+}
+
+uint32_t options_serialized_len(struct o_coap_option *options,
+				uint8_t options_cnt)
+{
+	uint32_t len = 0;
+	for (uint8_t i = 0; i < options_cnt; i++) {
+		len += (uint32_t)1 + opt_extra_bytes(options[i].delta) +
+		       opt_extra_bytes(options[i].len) + options[i].len;
+	}
+	return len;
+}
+
+uint32_t coap_serialized_len(struct o_coap_packet *in)
+{
+	uint32_t len = (uint32_t)4 + in->header.TKL +
+		       options_serialized_len(in->options, in->options_cnt);
+	if (in->payload.len) {
+		len += 1 + in->payload.len;
+	}
+	return len;
+}
+
+enum err coap_header_serialize(struct o_coap_packet *in,
+			       uint8_t *out_byte_string,
+			       uint32_t *out_byte_string_len)
+{
+	/* The exact length is known in advance, so that everything can be 
+	   written directly into the output. */
+	uint32_t len = coap_serialized_len(in) - in->payload.len;
+	if (*out_byte_string_len < len) {
+		return buffer_to_small;
+	}
+	uint8_t *temp_out_ptr = out_byte_string;
+
+	/* First byte in header (version + type + token length) */
+	*temp_out_ptr = (uint8_t)((in->header.ver << HEADER_VERSION_OFFSET) |
+				  (in->header.type << HEADER_TYPE_OFFSET) |
+				  (in->header.TKL));
+	/* Following 3 bytes in header (1 byte code + 2 bytes message ID)*/
+	*(temp_out_ptr + 1) = in->header.code;
+	uint16_t temp_MID = in->header.MID;
+	*(temp_out_ptr + 2) = (uint8_t)((temp_MID & 0xFF00) >> 8);
+	*(temp_out_ptr + 3) = (uint8_t)(temp_MID & 0x00FF);
+
+	temp_out_ptr += 4;
+	/* Copy token */
+	if (in->header.TKL > 0) {
+		TRY(_memcpy_s(temp_out_ptr, in->header.TKL, in->token,
+			      in->header.TKL));
+		temp_out_ptr += in->header.TKL;
+	}
+
+	/* Convert all options into byte string */
+	struct byte_array options = BYTE_ARRAY_INIT(
+		temp_out_ptr,
+		len - (uint32_t)(temp_out_ptr - out_byte_string));
+	TRY(options_serialize(in->options, in->options_cnt, &options));
+	temp_out_ptr += options.len;
+
+	/* Payload marker, the payload follows */
+	if (in->payload.len != 0) {
+		*temp_out_ptr = OPTION_PAYLOAD_MARKER;
+	}
+	*out_byte_string_len = len;
+	return ok;
+}
+
 enum err coap_serialize(struct o_coap_packet *in, uint8_t *out_byte_string,
 			uint32_t *out_byte_string_len)
 {
@@ -0,0 +1,157 @@
+/*
+   Copyright (c) 2026 Fraunhofer AISEC. See the COPYRIGHT
+   file at the top-level directory of this distribution.
+
+   Licensed under the Apache License, Version 2.0 <LICENSE-APACHE or
+   http://www.apache.org/licenses/LICENSE-2.0> or the MIT license
+   <LICENSE-MIT or http://opensource.org/licenses/MIT>, at your
+   option. This file may not be copied, modified, or distributed
+   except according to those terms.
+*/
+
+#include "oscore/oscore_context_store.h"
+
+#include "common/byte_array.h"
+#include "common/oscore_edhoc_error.h"
+
+/**
+ * @brief Selects the shard of a key. The high bits of the hash are used, 
+ *        since the low bits select the slot inside the shard.
+ * @param store The store.
+ * @param id_context ID Context.
+ * @param recipient_id Recipient ID.
+ * @return The shard.
+ */
+static struct oscore_context_shard *
+shard_of(struct oscore_context_store *store,
+	 const struct byte_array *id_context,
+	 const struct byte_array *recipient_id)
+{
+	uint64_t h = oscore_context_table_hash(id_context, recipient_id);
+	return &store->shards[(h * store->shards_cnt) >> 32];
+}
+
+static void shard_lock(struct oscore_context_shard *shard)
+{
+#ifdef OSCORE_THREAD_SAFE
+	oscore_lock_acquire(&shard->lock);
+#else
+	(void)shard;
+#endif
+}
+
+static void shard_unlock(struct oscore_context_shard *shard)
+{
+#ifdef OSCORE_THREAD_SAFE
+	oscore_lock_release(&shard->lock);
+#else
+	(void)shard;
+#endif
+}
+
+enum err oscore_context_store_init(struct oscore_context_store *store,
+				   struct oscore_context_shard *shards,
+				   uint32_t shards_cnt, struct context **slots,
+				   uint32_t slots_per_shard)
+{
+	if ((NULL == store) || (NULL == shards) || (NULL == slots) ||
+	    (0 == shards_cnt)) {
+		return wrong_parameter;
+	}
+
+	for (uint32_t i = 0; i < shards_cnt; i++) {
+		TRY(oscore_context_table_init(&shards[i].table,
+					      &slots[i * slots_per_shard],
+					      slots_per_shard));
+		oscore_lock_init(&shards[i].lock);
+	}
+	store->shards = shards;
+	store->shards_cnt = shards_cnt;
+	store->unknown_limit = NULL;
+	return ok;
+}
+
+enum err oscore_context_store_rate_limit_set(struct oscore_context_store *store,
+					     struct oscore_rate_limit *limit)
+{
+	if (NULL == store) {
+		return wrong_parameter;
+	}
+	store->unknown_limit = limit;
+	return ok;
+}
+
+enum err oscore_context_store_insert(struct oscore_context_store *store,
+				     struct context *c)
+{
+	if ((NULL == store) || (NULL == c)) {
+		return wrong_parameter;
+	}
+
+	struct oscore_context_shard *shard =
+		shard_of(store, &c->cc.id_context, &c->rc.recipient_id);
+	shard_lock(shard);
+	enum err r = oscore_context_table_insert(&shard->table, c);
+	shard_unlock(shard);
+	return r;
+}
+
+enum err oscore_context_store_remove(struct oscore_context_store *store,
+				     struct context *c)
+{
+	if ((NULL == store) || (NULL == c)) {
+		return wrong_parameter;
+	}
+
+	struct oscore_context_shard *shard =
+		shard_of(store, &c->cc.id_context, &c->rc.recipient_id);
+	shard_lock(shard);
+	enum err r = oscore_context_table_remove(&shard->table, c);
+	shard_unlock(shard);
+	return r;
+}
+
+enum err oscore_context_store_find(struct oscore_context_store *store,
+				   const struct byte_array *id_context,
+				   const struct byte_array *recipient_id,
+				   struct context **c)
+{
+	if ((NULL == store) || (NULL == id_context) ||
+	    (NULL == recipient_id) || (NULL == c)) {
+		return wrong_parameter;
+	}
+
+	struct oscore_context_shard *shard =
+		shard_of(store, id_context, recipient_id);
+	shard_lock(shard);
+	enum err r = oscore_context_table_find(&shard->table, id_context,
+					       recipient_id, c);
+	shard_unlock(shard);
+	return r;
+}
+
+struct context *
+oscore_context_store_search(struct oscore_context_store *store,
+			    bool (*match)(struct context *c, void *arg),
+			    void *arg)
+{
+	if ((NULL == store) || (NULL == match)) {
+		return NULL;
+	}
+
+	for (uint32_t i = 0; i < store->shards_cnt; i++) {
+		struct oscore_context_shard *shard = &store->shards[i];
+		uint32_t iterator = 0;
+		struct context *c;
+		shard_lock(shard);
+		while (NULL != (c = oscore_context_table_next(&shard->table,
+							      &iterator))) {
+			if (match(c, arg)) {
+				shard_unlock(shard);
+				return c;
+			}
+		}
+		shard_unlock(shard);
+	}
+	return NULL;
+}
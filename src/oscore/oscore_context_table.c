@@ -0,0 +1,200 @@
+/*
+   Copyright (c) 2026 Fraunhofer AISEC. See the COPYRIGHT
+   file at the top-level directory of this distribution.
+
+   Licensed under the Apache License, Version 2.0 <LICENSE-APACHE or
+   http://www.apache.org/licenses/LICENSE-2.0> or the MIT license
+   <LICENSE-MIT or http://opensource.org/licenses/MIT>, at your
+   option. This file may not be copied, modified, or distributed
+   except according to those terms.
+*/
+
+#include <string.h>
+
+#include "oscore/oscore_context_table.h"
+
+#include "common/byte_array.h"
+#include "common/oscore_edhoc_error.h"
+
+uint32_t oscore_context_table_hash(const struct byte_array *id_context,
+				   const struct byte_array *recipient_id)
+{
+	/*FNV-1a, the length of the ID Context is hashed too, so that bytes 
+	can't be moved from one field to the other without changing the hash*/
+	uint32_t h = 2166136261u;
+
+	h = (h ^ (uint8_t)id_context->len) * 16777619u;
+	for (uint32_t i = 0; i < id_context->len; i++) {
+		h = (h ^ id_context->ptr[i]) * 16777619u;
+	}
+	for (uint32_t i = 0; i < recipient_id->len; i++) {
+		h = (h ^ recipient_id->ptr[i]) * 16777619u;
+	}
+	return h;
+}
+
+/**
+ * @brief Checks if a context has the given key.
+ * @param c The context.
+ * @param id_context ID Context.
+ * @param recipient_id Recipient ID.
+ * @return true if both fields match.
+ */
+static bool key_equals(const struct context *c,
+		       const struct byte_array *id_context,
+		       const struct byte_array *recipient_id)
+{
+	return array_equals(&c->rc.recipient_id, recipient_id) &&
+	       array_equals(&c->cc.id_context, id_context);
+}
+
+/**
+ * @brief Finds the slot of a key.
+ * @param table The table.
+ * @param id_context ID Context.
+ * @param recipient_id Recipient ID.
+ * @param index [out] Index of the slot holding the key, or of the empty slot
+ *        where the key would be inserted.
+ * @return true if the key is in the table.
+ */
+static bool slot_find(const struct oscore_context_table *table,
+		      const struct byte_array *id_context,
+		      const struct byte_array *recipient_id, uint32_t *index)
+{
+	uint32_t mask = table->slots_cnt - 1;
+	uint32_t i = oscore_context_table_hash(id_context, recipient_id) & mask;
+
+	/*the table is never full, so an empty slot ends every probe sequence*/
+	while (NULL != table->slots[i]) {
+		if (key_equals(table->slots[i], id_context, recipient_id)) {
+			*index = i;
+			return true;
+		}
+		i = (i + 1) & mask;
+	}
+	*index = i;
+	return false;
+}
+
+enum err oscore_context_table_init(struct oscore_context_table *table,
+				   struct context **slots, uint32_t slots_cnt)
+{
+	if ((NULL == table) || (NULL == slots)) {
+		return wrong_parameter;
+	}
+	/*a power of two with room for at least one context*/
+	if ((slots_cnt < 4) || (0 != (slots_cnt & (slots_cnt - 1)))) {
+		return wrong_parameter;
+	}
+
+	memset(slots, 0, slots_cnt * sizeof(slots[0]));
+	table->slots = slots;
+	table->slots_cnt = slots_cnt;
+	table->contexts_cnt = 0;
+	table->unknown_limit = NULL;
+	return ok;
+}
+
+enum err oscore_context_table_rate_limit_set(struct oscore_context_table *table,
+					     struct oscore_rate_limit *limit)
+{
+	if (NULL == table) {
+		return wrong_parameter;
+	}
+	table->unknown_limit = limit;
+	return ok;
+}
+
+enum err oscore_context_table_insert(struct oscore_context_table *table,
+				     struct context *c)
+{
+	if ((NULL == table) || (NULL == c)) {
+		return wrong_parameter;
+	}
+
+	uint32_t index;
+	if (slot_find(table, &c->cc.id_context, &c->rc.recipient_id, &index)) {
+		return oscore_context_duplicated;
+	}
+
+	/*keep the load factor at 3/4*/
+	if ((table->contexts_cnt + 1) > (table->slots_cnt / 4) * 3) {
+		return oscore_max_contexts;
+	}
+
+	table->slots[index] = c;
+	table->contexts_cnt++;
+	return ok;
+}
+
+enum err oscore_context_table_remove(struct oscore_context_table *table,
+				     struct context *c)
+{
+	if ((NULL == table) || (NULL == c)) {
+		return wrong_parameter;
+	}
+
+	uint32_t i;
+	if (!slot_find(table, &c->cc.id_context, &c->rc.recipient_id, &i) ||
+	    (table->slots[i] != c)) {
+		return oscore_kid_recipient_id_mismatch;
+	}
+
+	/*backward shift deletion: move following entries of the probe sequence
+	into the gap, so that no entry becomes unreachable*/
+	uint32_t mask = table->slots_cnt - 1;
+	uint32_t gap = i;
+	table->slots[gap] = NULL;
+	for (uint32_t j = (gap + 1) & mask; NULL != table->slots[j];
+	     j = (j + 1) & mask) {
+		struct context *entry = table->slots[j];
+		uint32_t home = oscore_context_table_hash(
+					&entry->cc.id_context,
+					&entry->rc.recipient_id) &
+				mask;
+		/*the entry can be moved if its home slot is not between the
+		gap and its current slot (cyclically)*/
+		if (((j - home) & mask) >= ((j - gap) & mask)) {
+			table->slots[gap] = entry;
+			table->slots[j] = NULL;
+			gap = j;
+		}
+	}
+
+	table->contexts_cnt--;
+	return ok;
+}
+
+enum err oscore_context_table_find(const struct oscore_context_table *table,
+				   const struct byte_array *id_context,
+				   const struct byte_array *recipient_id,
+				   struct context **c)
+{
+	if ((NULL == table) || (NULL == id_context) ||
+	    (NULL == recipient_id) || (NULL == c)) {
+		return wrong_parameter;
+	}
+
+	uint32_t index;
+	if (!slot_find(table, id_context, recipient_id, &index)) {
+		return oscore_kid_recipient_id_mismatch;
+	}
+	*c = table->slots[index];
+	return ok;
+}
+
+struct context *oscore_context_table_next(const struct oscore_context_table *table,
+					  uint32_t *iterator)
+{
+	if ((NULL == table) || (NULL == iterator)) {
+		return NULL;
+	}
+
+	while (*iterator < table->slots_cnt) {
+		struct context *c = table->slots[(*iterator)++];
+		if (NULL != c) {
+			return c;
+		}
+	}
+	return NULL;
+}
@@ -0,0 +1,147 @@
+/*
+   Copyright (c) 2026 Fraunhofer AISEC. See the COPYRIGHT
+   file at the top-level directory of this distribution.
+
+   Licensed under the Apache License, Version 2.0 <LICENSE-APACHE or
+   http://www.apache.org/licenses/LICENSE-2.0> or the MIT license
+   <LICENSE-MIT or http://opensource.org/licenses/MIT>, at your
+   option. This file may not be copied, modified, or distributed
+   except according to those terms.
+*/
+
+#include <string.h>
+
+#include "oscore/oscore_echo.h"
+#include "oscore/oscore_coap.h"
+
+#include "common/byte_array.h"
+#include "common/crypto_wrapper.h"
+#include "common/oscore_edhoc_error.h"
+
+/**
+ * @brief Computes the tag of an Echo value.
+ * @param key The key.
+ * @param time Timestamp of the value, serialized in network byte order.
+ * @param id_context ID Context.
+ * @param recipient_id Recipient ID.
+ * @param tag [out] OSCORE_ECHO_TAG_LEN bytes.
+ * @return enum err
+ */
+static enum err tag_compute(const struct oscore_echo_key *key,
+			    const uint8_t *time,
+			    const struct byte_array *id_context,
+			    const struct byte_array *recipient_id, uint8_t *tag)
+{
+	if ((id_context->len > MAX_KID_CONTEXT_LEN) ||
+	    (recipient_id->len > MAX_KID_LEN)) {
+		return wrong_parameter;
+	}
+
+	/*the length of the ID Context separates the two IDs*/
+	uint8_t info_buf[4 + 1 + MAX_KID_CONTEXT_LEN + MAX_KID_LEN];
+	uint32_t info_len = 0;
+	memcpy(info_buf, time, 4);
+	info_len += 4;
+	info_buf[info_len++] = (uint8_t)id_context->len;
+	if (0 != id_context->len) {
+		memcpy(&info_buf[info_len], id_context->ptr, id_context->len);
+		info_len += id_context->len;
+	}
+	if (0 != recipient_id->len) {
+		memcpy(&info_buf[info_len], recipient_id->ptr,
+		       recipient_id->len);
+		info_len += recipient_id->len;
+	}
+
+	struct byte_array info = BYTE_ARRAY_INIT(info_buf, info_len);
+	struct byte_array out = BYTE_ARRAY_INIT(tag, OSCORE_ECHO_TAG_LEN);
+	return hkdf_ctx_expand(&key->prf, &info, &out);
+}
+
+enum err oscore_echo_key_init(struct oscore_echo_key *key,
+			      const struct byte_array *secret,
+			      oscore_echo_clock_t clock, uint32_t lifetime)
+{
+	if ((NULL == key) || (NULL == secret) || (NULL == secret->ptr) ||
+	    (secret->len < 16) || (secret->len > OSCORE_ECHO_SECRET_MAX_LEN) ||
+	    (NULL == clock) || (0 == lifetime)) {
+		return wrong_parameter;
+	}
+
+	memcpy(key->secret, secret->ptr, secret->len);
+	struct byte_array prk = BYTE_ARRAY_INIT(key->secret, secret->len);
+	TRY(hkdf_ctx_init(SHA_256, &prk, &key->prf));
+	key->clock = clock;
+	key->lifetime = lifetime;
+	return ok;
+}
+
+enum err oscore_echo_key_deinit(struct oscore_echo_key *key)
+{
+	if (NULL == key) {
+		return wrong_parameter;
+	}
+
+	enum err r = hkdf_ctx_deinit(&key->prf);
+	memset(key->secret, 0, sizeof(key->secret));
+	return r;
+}
+
+enum err oscore_echo_create(const struct oscore_echo_key *key,
+			    const struct byte_array *id_context,
+			    const struct byte_array *recipient_id,
+			    struct byte_array *echo)
+{
+	if ((NULL == key) || (NULL == id_context) || (NULL == recipient_id) ||
+	    (NULL == echo) || (NULL == echo->ptr) ||
+	    (echo->len < OSCORE_ECHO_VAL_LEN)) {
+		return wrong_parameter;
+	}
+
+	uint32_t now = key->clock();
+	echo->ptr[0] = (uint8_t)(now >> 24);
+	echo->ptr[1] = (uint8_t)(now >> 16);
+	echo->ptr[2] = (uint8_t)(now >> 8);
+	echo->ptr[3] = (uint8_t)now;
+	TRY(tag_compute(key, echo->ptr, id_context, recipient_id,
+			&echo->ptr[4]));
+	echo->len = OSCORE_ECHO_VAL_LEN;
+	return ok;
+}
+
+enum err oscore_echo_verify(const struct oscore_echo_key *key,
+			    const struct byte_array *id_context,
+			    const struct byte_array *recipient_id,
+			    const struct byte_array *echo, uint32_t since)
+{
+	if ((NULL == key) || (NULL == id_context) || (NULL == recipient_id) ||
+	    (NULL == echo)) {
+		return wrong_parameter;
+	}
+	if ((OSCORE_ECHO_VAL_LEN != echo->len) || (NULL == echo->ptr)) {
+		return echo_val_mismatch;
+	}
+
+	uint8_t tag[OSCORE_ECHO_TAG_LEN];
+	TRY(tag_compute(key, echo->ptr, id_context, recipient_id, tag));
+	/*constant time comparison, the tag must not leak byte by byte*/
+	uint8_t diff = 0;
+	for (uint32_t i = 0; i < OSCORE_ECHO_TAG_LEN; i++) {
+		diff |= (uint8_t)(tag[i] ^ echo->ptr[4 + i]);
+	}
+	if (0 != diff) {
+		return echo_val_mismatch;
+	}
+
+	uint32_t created = ((uint32_t)echo->ptr[0] << 24) |
+			   ((uint32_t)echo->ptr[1] << 16) |
+			   ((uint32_t)echo->ptr[2] << 8) | echo->ptr[3];
+	/*correct also if the clock wrapped around, values from the future
+	get a large age*/
+	uint32_t now = key->clock();
+	uint32_t age = (uint32_t)(now - created);
+	if ((age > key->lifetime) || (age > (uint32_t)(now - since))) {
+		return echo_val_expired;
+	}
+	return ok;
+}
@@ -14,9 +14,13 @@
 #include <string.h>
 
 #include "oscore/oscore_interactions.h"
+#include "oscore/option.h"
 #include "common/byte_array.h"
 #include "common/print_util.h"
 
+/* End of a hash chain, or no record. */
+#define NONE 0xFFFF
+
 #ifdef DEBUG_PRINT
 static const char msg_interaction_not_found[] =
 	"Couldn't find the interaction with given key.\n";
@@ -43,26 +47,32 @@ static void print_interaction_field(const char *name, uint8_t *buffer,
 }
 
 /**
- * @brief Print interactions array.
+ * @brief Print the occupied records of an interactions table.
  * 
- * @param interactions Input interactions array.
+ * @param interactions Input interactions table.
  */
-static void print_interactions(struct oscore_interaction_t *interactions)
+static void print_interactions(struct oscore_interactions *interactions)
 {
-	for (uint8_t index = 0; index < OSCORE_INTERACTIONS_COUNT; index++) {
-		struct oscore_interaction_t *record = &interactions[index];
+	struct oscore_interaction_t *records =
+		(NULL != interactions->records_ext) ?
+			interactions->records_ext :
+			interactions->records_buf;
+	for (uint32_t index = 0; index < interactions->count; index++) {
+		struct oscore_interaction_t *record = &records[index];
+		if (!record->is_occupied) {
+			continue;
+		}
 		PRINTF("record %02u:\n", index);
 		PRINTF("   type     : %d\n", record->request_type);
-		print_interaction_field("uri paths", record->uri_paths,
-					record->uri_paths_len);
+		PRINTF("   last used: %u\n", record->last_used);
+		PRINTF("   uri hash : %016llx\n",
+		       (unsigned long long)record->uri_paths_hash);
 		print_interaction_field("token    ", record->token,
 					record->token_len);
 		print_interaction_field("req_piv  ", record->request_piv,
 					record->request_piv_len);
 		print_interaction_field("req_kid  ", record->request_kid,
 					record->request_kid_len);
-		PRINTF("   occupied : %s\n",
-		       record->is_occupied ? "true" : "false");
 	}
 }
 
@@ -99,131 +109,416 @@ static bool compare_memory(uint8_t *actual, uint32_t actual_size,
 }
 
 /**
- * @brief Searches given interactions array for a first free slot.
- * @param interactions Interactions array, MUST have exactly OSCORE_INTERACTIONS_COUNT elements.
- * @return Index of the first unoccupied slot (or OSCORE_INTERACTIONS_COUNT if the array is full).
+ * @brief Returns the records of an interactions table.
  */
-static uint32_t find_unoccupied_index(struct oscore_interaction_t *interactions)
+static inline struct oscore_interaction_t *
+records_get(struct oscore_interactions *interactions)
 {
-	uint32_t index;
-	for (index = 0; index < OSCORE_INTERACTIONS_COUNT; index++) {
-		if (false == interactions[index].is_occupied) {
-			break;
-		}
+	return (NULL != interactions->records_ext) ? interactions->records_ext :
+						     interactions->records_buf;
+}
+
+/**
+ * @brief Maps a hash to a bucket, any number of buckets is possible.
+ * @param hash Hash value.
+ * @param count Number of buckets.
+ * @return Index of the bucket.
+ */
+static inline uint32_t bucket_get(uint64_t hash, uint32_t count)
+{
+	uint32_t h = (uint32_t)(hash ^ (hash >> 32));
+	return (uint32_t)(((uint64_t)h * count) >> 32);
+}
+
+/**
+ * @brief Bucket of a token.
+ */
+static uint32_t token_bucket(struct oscore_interactions *interactions,
+			     uint8_t *token, uint8_t token_len)
+{
+	/* FNV-1a */
+	uint32_t h = 2166136261u;
+	for (uint8_t i = 0; (NULL != token) && (i < token_len); i++) {
+		h = (h ^ token[i]) * 16777619u;
 	}
-	return index;
+	return bucket_get(h, interactions->count);
+}
+
+/**
+ * @brief Bucket of a resource.
+ */
+static uint32_t resource_bucket(struct oscore_interactions *interactions,
+				uint64_t uri_paths_hash, uint8_t request_type)
+{
+	return bucket_get(uri_paths_hash + request_type, interactions->count);
+}
+
+/**
+ * @brief Removes a record from the chain of its token bucket.
+ */
+static void token_unlink(struct oscore_interactions *interactions,
+			 uint16_t index)
+{
+	struct oscore_interaction_t *records = records_get(interactions);
+	uint16_t *link = &records[records[index].token_bucket].token_head;
+	while (*link != index) {
+		link = &records[*link].token_next;
+	}
+	*link = records[index].token_next;
+}
+
+/**
+ * @brief Adds a record to the chain of its token bucket.
+ */
+static void token_link(struct oscore_interactions *interactions,
+		       uint16_t index)
+{
+	struct oscore_interaction_t *records = records_get(interactions);
+	records[index].token_bucket = (uint16_t)token_bucket(
+		interactions, records[index].token, records[index].token_len);
+	uint16_t *head = &records[records[index].token_bucket].token_head;
+	records[index].token_next = *head;
+	*head = index;
+}
+
+/**
+ * @brief Removes a record from the chain of its resource bucket.
+ */
+static void resource_unlink(struct oscore_interactions *interactions,
+			    uint16_t index)
+{
+	struct oscore_interaction_t *records = records_get(interactions);
+	uint16_t *link = &records[records[index].resource_bucket].resource_head;
+	while (*link != index) {
+		link = &records[*link].resource_next;
+	}
+	*link = records[index].resource_next;
+}
+
+/**
+ * @brief Adds a record to the chain of its resource bucket.
+ */
+static void resource_link(struct oscore_interactions *interactions,
+			  uint16_t index)
+{
+	struct oscore_interaction_t *records = records_get(interactions);
+	records[index].resource_bucket = (uint16_t)resource_bucket(
+		interactions, records[index].uri_paths_hash,
+		records[index].request_type);
+	uint16_t *head = &records[records[index].resource_bucket].resource_head;
+	records[index].resource_next = *head;
+	*head = index;
+}
+
+/**
+ * @brief Removes a record from the LRU chain.
+ */
+static void lru_unlink(struct oscore_interactions *interactions, uint16_t index)
+{
+	struct oscore_interaction_t *records = records_get(interactions);
+	struct oscore_interaction_t *record = &records[index];
+	if (NONE != record->lru_prev) {
+		records[record->lru_prev].lru_next = record->lru_next;
+	} else {
+		interactions->lru_head = record->lru_next;
+	}
+	if (NONE != record->lru_next) {
+		records[record->lru_next].lru_prev = record->lru_prev;
+	} else {
+		interactions->lru_tail = record->lru_prev;
+	}
+}
+
+/**
+ * @brief Adds a record to the LRU chain as the most recently used one.
+ */
+static void lru_push(struct oscore_interactions *interactions, uint16_t index)
+{
+	struct oscore_interaction_t *records = records_get(interactions);
+	records[index].lru_prev = NONE;
+	records[index].lru_next = interactions->lru_head;
+	if (NONE != interactions->lru_head) {
+		records[interactions->lru_head].lru_prev = index;
+	} else {
+		interactions->lru_tail = index;
+	}
+	interactions->lru_head = index;
+}
+
+/**
+ * @brief Returns the current time of the clock, or 0 without clock.
+ */
+static uint32_t clock_now(struct oscore_interactions *interactions)
+{
+	return (NULL != interactions->clock) ? interactions->clock() : 0;
+}
+
+/**
+ * @brief Checks if a record was not used for longer than the idle timeout.
+ * @param interactions Interactions table.
+ * @param index Index of an occupied record.
+ * @param now Current time.
+ * @return True if the record expired.
+ */
+static bool is_expired(struct oscore_interactions *interactions,
+		       uint16_t index, uint32_t now)
+{
+	/* the difference is correct also if the clock wrapped around */
+	return (NULL != interactions->clock) &&
+	       (0 != interactions->idle_timeout) &&
+	       ((uint32_t)(now - records_get(interactions)[index].last_used) >
+		interactions->idle_timeout);
+}
+
+/**
+ * @brief Removes an occupied record from all chains and returns it to the free list.
+ */
+static void record_release(struct oscore_interactions *interactions,
+			   uint16_t index)
+{
+	token_unlink(interactions, index);
+	resource_unlink(interactions, index);
+	lru_unlink(interactions, index);
+
+	/* clear the record, but keep the heads of its buckets */
+	struct oscore_interaction_t *entry = &records_get(interactions)[index];
+	uint16_t token_head = entry->token_head;
+	uint16_t resource_head = entry->resource_head;
+	memset(entry, 0, sizeof(*entry));
+	entry->token_head = token_head;
+	entry->resource_head = resource_head;
+	entry->resource_next = NONE;
+	entry->lru_prev = NONE;
+	entry->lru_next = NONE;
+	entry->token_next = interactions->free_head;
+	interactions->free_head = index;
 }
 
 /**
- * @brief Searches given interactions array for a record that matches given resource and request type.
- * @param interactions Interactions array, MUST have exactly OSCORE_INTERACTIONS_COUNT elements.
- * @param uri_paths Resource path buffer to match.
- * @param uri_paths_len Resource path buffer size.
+ * @brief Searches given interactions table for a record that matches given resource and request type.
+ * @param interactions Interactions table.
+ * @param uri_paths_hash Hash of the resource path to match.
  * @param request_type Request type to match.
- * @return Index of the record (of OSCORE_INTERACTIONS_COUNT if not found).
+ * @return Index of the record (or NONE if not found).
  */
-static uint32_t
-find_record_index_by_resource(struct oscore_interaction_t *interactions,
-			      uint8_t *uri_paths, uint8_t uri_paths_len,
-			      enum o_coap_msg request_type)
+static uint16_t
+find_record_index_by_resource(struct oscore_interactions *interactions,
+			      uint64_t uri_paths_hash, uint8_t request_type)
 {
-	uint32_t index;
-	for (index = 0; index < OSCORE_INTERACTIONS_COUNT; index++) {
-		bool is_occupied = interactions[index].is_occupied;
-		bool request_type_ok =
-			(interactions[index].request_type == request_type);
-		bool uri_path_ok =
-			compare_memory(uri_paths, uri_paths_len,
-				       interactions[index].uri_paths,
-				       interactions[index].uri_paths_len);
-		if (is_occupied && request_type_ok && uri_path_ok) {
+	struct oscore_interaction_t *records = records_get(interactions);
+	uint16_t index =
+		records[resource_bucket(interactions, uri_paths_hash,
+					request_type)]
+			.resource_head;
+	while (NONE != index) {
+		if ((records[index].uri_paths_hash == uri_paths_hash) &&
+		    (records[index].request_type == request_type)) {
 			break;
 		}
+		index = records[index].resource_next;
 	}
 	return index;
 }
 
 /**
- * @brief Searches given interactions array for a record that matches given token.
- * @param interactions Interactions array, MUST have exactly OSCORE_INTERACTIONS_COUNT elements.
+ * @brief Searches given interactions table for a record that matches given token.
+ * @param interactions Interactions table.
  * @param token Token buffer to match.
  * @param token_len Token buffer size.
- * @return Index of the record (if found), or OSCORE_INTERACTIONS_COUNT (if not found).
+ * @return Index of the record (if found), or NONE (if not found).
  */
-static uint32_t
-find_record_index_by_token(struct oscore_interaction_t *interactions,
+static uint16_t
+find_record_index_by_token(struct oscore_interactions *interactions,
 			   uint8_t *token, uint8_t token_len)
 {
-	uint32_t index;
-	for (index = 0; index < OSCORE_INTERACTIONS_COUNT; index++) {
-		bool is_occupied = interactions[index].is_occupied;
-		bool token_ok = compare_memory(token, token_len,
-					       interactions[index].token,
-					       interactions[index].token_len);
-		if (is_occupied && token_ok) {
+	struct oscore_interaction_t *records = records_get(interactions);
+	uint16_t index =
+		records[token_bucket(interactions, token, token_len)].token_head;
+	while (NONE != index) {
+		if (compare_memory(token, token_len, records[index].token,
+				   records[index].token_len)) {
 			break;
 		}
+		index = records[index].token_next;
 	}
 	return index;
 }
 
-enum err oscore_interactions_init(struct oscore_interaction_t *interactions)
+uint64_t oscore_interactions_uri_paths_hash(const uint8_t *uri_paths,
+					    uint32_t uri_paths_len)
+{
+	/* 64 bit, so that collisions of different resources are negligible */
+	return uri_path_hash_update(URI_PATH_HASH_INIT, uri_paths,
+				    uri_paths_len);
+}
+
+enum err oscore_interactions_init_size(struct oscore_interactions *interactions,
+				       uint32_t count,
+				       struct oscore_interaction_t *records)
+{
+	if ((NULL == interactions) || (0 == count) ||
+	    (OSCORE_INTERACTIONS_MAX_COUNT < count)) {
+		return wrong_parameter;
+	}
+	if ((NULL == records) && (OSCORE_INTERACTIONS_COUNT < count)) {
+		return wrong_parameter;
+	}
+
+	memset(interactions, 0, sizeof(*interactions));
+	interactions->records_ext = records;
+	interactions->count = count;
+	records = records_get(interactions);
+	memset(records, 0, count * sizeof(*records));
+
+	/* all buckets empty, all records in the free list */
+	for (uint32_t i = 0; i < count; i++) {
+		records[i].token_head = NONE;
+		records[i].resource_head = NONE;
+		records[i].resource_next = NONE;
+		records[i].lru_prev = NONE;
+		records[i].lru_next = NONE;
+		records[i].token_next = (uint16_t)((i + 1 < count) ? i + 1 :
+								   NONE);
+	}
+	interactions->free_head = 0;
+	interactions->lru_head = NONE;
+	interactions->lru_tail = NONE;
+	return ok;
+}
+
+enum err oscore_interactions_expiry_set(struct oscore_interactions *interactions,
+					oscore_interactions_clock_t clock,
+					uint32_t idle_timeout)
+{
+	if (NULL == interactions) {
+		return wrong_parameter;
+	}
+	interactions->clock = clock;
+	interactions->idle_timeout = idle_timeout;
+
+	/* stamp the records added without clock, so that they don't expire at once */
+	uint32_t now = clock_now(interactions);
+	for (uint16_t index = interactions->lru_head; NONE != index;
+	     index = records_get(interactions)[index].lru_next) {
+		records_get(interactions)[index].last_used = now;
+	}
+	return ok;
+}
+
+enum err oscore_interactions_sweep(struct oscore_interactions *interactions,
+				   uint32_t *removed)
 {
 	if (NULL == interactions) {
 		return wrong_parameter;
 	}
 
-	memset(interactions, 0,
-	       sizeof(struct oscore_interaction_t) * OSCORE_INTERACTIONS_COUNT);
+	/* the LRU chain is ordered by the time of use, so the expired records are at its end */
+	uint32_t now = clock_now(interactions);
+	uint32_t cnt = 0;
+	while ((NONE != interactions->lru_tail) &&
+	       is_expired(interactions, interactions->lru_tail, now)) {
+		record_release(interactions, interactions->lru_tail);
+		cnt++;
+	}
+
+	if (NULL != removed) {
+		*removed = cnt;
+	}
 	return ok;
 }
 
-enum err
-oscore_interactions_set_record(struct oscore_interaction_t *interactions,
-			       struct oscore_interaction_t *record)
+enum err oscore_interactions_init(struct oscore_interactions *interactions)
+{
+	return oscore_interactions_init_size(interactions,
+					     OSCORE_INTERACTIONS_COUNT, NULL);
+}
+
+enum err oscore_interactions_set_record(struct oscore_interactions *interactions,
+					struct oscore_interaction_t *record)
 {
 	if ((NULL == interactions) || (NULL == record) ||
 	    (record->token_len > MAX_TOKEN_LEN) ||
-	    (record->uri_paths_len > OSCORE_MAX_URI_PATH_LEN) ||
 	    (record->request_piv_len > MAX_PIV_LEN) ||
 	    (record->request_kid_len > MAX_KID_LEN)) {
 		return wrong_parameter;
 	}
+	struct oscore_interaction_t *records = records_get(interactions);
+
+	// The record may be the entry itself when get_record output is used as the record. Its key
+	// fields may have been changed already, its chains are found by the stored buckets.
+	uint16_t index_in_place = NONE;
+	if ((record >= records) && (record < &records[interactions->count]) &&
+	    record->is_occupied) {
+		index_in_place = (uint16_t)(record - records);
+	}
 
 	// Find the entry at which the record will be stored.
-	uint32_t index_by_uri =
-		find_record_index_by_resource(interactions, record->uri_paths,
-					      record->uri_paths_len,
-					      record->request_type);
-	if (index_by_uri >= OSCORE_INTERACTIONS_COUNT) {
-		index_by_uri = find_unoccupied_index(interactions);
-		if (index_by_uri >= OSCORE_INTERACTIONS_COUNT) {
-			return oscore_max_interactions;
-		}
-	}
+	uint16_t index_by_uri = find_record_index_by_resource(
+		interactions, record->uri_paths_hash, record->request_type);
 
 	// Prevent from using the same token twice, as it would be impossible to find the proper record with get_record.
-	uint32_t index_by_token = find_record_index_by_token(
+	uint16_t index_by_token = find_record_index_by_token(
 		interactions, record->token, record->token_len);
-	if ((index_by_token < OSCORE_INTERACTIONS_COUNT) &&
-	    (index_by_token != index_by_uri)) {
+	if ((NONE != index_by_token) && (index_by_token != index_by_uri) &&
+	    (index_by_token != index_in_place)) {
 		PRINTF(msg_token_already_used, index_by_token);
 		return oscore_interaction_duplicated_token;
 	}
 
-	record->is_occupied = true;
+	uint32_t now = clock_now(interactions);
+	if (NONE != index_in_place) {
+		/* the record replaces another one of the same resource */
+		if ((NONE != index_by_uri) && (index_by_uri != index_in_place)) {
+			record_release(interactions, index_by_uri);
+		}
+		index_by_uri = index_in_place;
+		token_unlink(interactions, index_by_uri);
+		resource_unlink(interactions, index_by_uri);
+		lru_unlink(interactions, index_by_uri);
+	} else if (NONE == index_by_uri) {
+		if (NONE == interactions->free_head) {
+			if (NULL == interactions->clock) {
+				return oscore_max_interactions;
+			}
+			/* evict the least recently used record, it is the expired one if any */
+			PRINTF("evict record %u\n", interactions->lru_tail);
+			record_release(interactions, interactions->lru_tail);
+		}
+		index_by_uri = interactions->free_head;
+		interactions->free_head = records[index_by_uri].token_next;
+	} else {
+		token_unlink(interactions, index_by_uri);
+		resource_unlink(interactions, index_by_uri);
+		lru_unlink(interactions, index_by_uri);
+	}
+
+	struct oscore_interaction_t *entry = &records[index_by_uri];
+	if (entry != record) {
+		entry->uri_paths_hash = record->uri_paths_hash;
+		entry->request_type = record->request_type;
+		entry->token_len = record->token_len;
+		entry->request_piv_len = record->request_piv_len;
+		entry->request_kid_len = record->request_kid_len;
+		memcpy(entry->token, record->token, sizeof(entry->token));
+		memcpy(entry->request_piv, record->request_piv,
+		       sizeof(entry->request_piv));
+		memcpy(entry->request_kid, record->request_kid,
+		       sizeof(entry->request_kid));
+	}
+	entry->is_occupied = true;
+	entry->last_used = now;
+	token_link(interactions, index_by_uri);
+	resource_link(interactions, index_by_uri);
+	lru_push(interactions, index_by_uri);
 
-	// Memmove is used to avoid overlapping issues when get_record output is used as the record.
-	memmove(&interactions[index_by_uri], record, sizeof(*record));
 	PRINT_MSG("set record:\n");
 	PRINT_INTERACTIONS(interactions);
 	return ok;
 }
 
-enum err
-oscore_interactions_get_record(struct oscore_interaction_t *interactions,
-			       uint8_t *token, uint8_t token_len,
-			       struct oscore_interaction_t **record)
+enum err oscore_interactions_get_record(struct oscore_interactions *interactions,
+					uint8_t *token, uint8_t token_len,
+					struct oscore_interaction_t **record)
 {
 	if ((NULL == interactions) || (NULL == record) ||
 	    (token_len > MAX_TOKEN_LEN)) {
@@ -234,20 +529,30 @@ oscore_interactions_get_record(struct oscore_interaction_t *interactions,
 	PRINT_MSG("get record:\n");
 	PRINT_INTERACTIONS(interactions);
 
-	uint32_t index =
+	uint16_t index =
 		find_record_index_by_token(interactions, token, token_len);
-	if (index >= OSCORE_INTERACTIONS_COUNT) {
+	if (NONE == index) {
 		PRINT_MSG(msg_interaction_not_found);
 		PRINT_ARRAY("token", token, token_len);
 		return oscore_interaction_not_found;
 	}
 
-	*record = &interactions[index];
+	uint32_t now = clock_now(interactions);
+	if (is_expired(interactions, index, now)) {
+		PRINTF("record %u expired\n", index);
+		record_release(interactions, index);
+		return oscore_interaction_not_found;
+	}
+	records_get(interactions)[index].last_used = now;
+	lru_unlink(interactions, index);
+	lru_push(interactions, index);
+
+	*record = &records_get(interactions)[index];
 	return ok;
 }
 
 enum err
-oscore_interactions_remove_record(struct oscore_interaction_t *interactions,
+oscore_interactions_remove_record(struct oscore_interactions *interactions,
 				  uint8_t *token, uint8_t token_len)
 {
 	if ((NULL == interactions) || (token_len > MAX_TOKEN_LEN)) {
@@ -257,15 +562,16 @@ oscore_interactions_remove_record(struct oscore_interaction_t *interactions,
 	PRINT_MSG("remove record (before):\n");
 	PRINT_INTERACTIONS(interactions);
 
-	uint32_t index =
+	uint16_t index =
 		find_record_index_by_token(interactions, token, token_len);
-	if (index >= OSCORE_INTERACTIONS_COUNT) {
+	if (NONE == index) {
 		PRINT_MSG(msg_interaction_not_found);
 		PRINT_ARRAY("token", token, token_len);
 		return oscore_interaction_not_found;
 	}
 
-	memset(&interactions[index], 0, sizeof(struct oscore_interaction_t));
+	record_release(interactions, index);
+
 	PRINT_MSG("remove record (after):\n");
 	PRINT_INTERACTIONS(interactions);
 	return ok;
@@ -273,7 +579,7 @@ oscore_interactions_remove_record(struct oscore_interaction_t *interactions,
 
 enum err oscore_interactions_read_wrapper(
 	enum o_coap_msg msg_type, struct byte_array *token,
-	struct oscore_interaction_t *interactions,
+	struct oscore_interactions *interactions,
 	struct byte_array *request_piv, struct byte_array *request_kid)
 {
 	if ((NULL == token) || (NULL == interactions) ||
@@ -299,10 +605,10 @@ enum err oscore_interactions_read_wrapper(
 
 enum err oscore_interactions_update_wrapper(
 	enum o_coap_msg msg_type, struct byte_array *token,
-	struct byte_array *uri_paths, struct oscore_interaction_t *interactions,
+	uint64_t uri_paths_hash, struct oscore_interactions *interactions,
 	struct byte_array *request_piv, struct byte_array *request_kid)
 {
-	if ((NULL == token) || (NULL == uri_paths) || (NULL == interactions) ||
+	if ((NULL == token) || (NULL == interactions) ||
 	    (NULL == request_piv) || (NULL == request_kid)) {
 		return wrong_parameter;
 	}
@@ -317,11 +623,11 @@ enum err oscore_interactions_update_wrapper(
 		/* Server receives / client sends any request (including registration and cancellation) - add the record to the interactions array.
 		   Request_piv and request_kid not updated - current values of PIV and KID (Sender ID) are used. */
 		struct oscore_interaction_t record = {
+			.uri_paths_hash = uri_paths_hash,
 			.request_piv_len = (uint8_t)request_piv->len,
 			.request_kid_len = (uint8_t)request_kid->len,
 			.token_len = (uint8_t)token->len,
-			.uri_paths_len = (uint8_t)uri_paths->len,
-			.request_type = msg_type
+			.request_type = (uint8_t)msg_type
 		};
 		TRY(_memcpy_s(record.request_piv, MAX_PIV_LEN, request_piv->ptr,
 			      request_piv->len));
@@ -329,8 +635,6 @@ enum err oscore_interactions_update_wrapper(
 			      request_kid->len));
 		TRY(_memcpy_s(record.token, MAX_TOKEN_LEN, token->ptr,
 			      token->len));
-		TRY(_memcpy_s(record.uri_paths, OSCORE_MAX_URI_PATH_LEN,
-			      uri_paths->ptr, uri_paths->len));
 		TRY(oscore_interactions_set_record(interactions, &record));
 	} else if (COAP_MSG_RESPONSE == msg_type) {
 		/* Server sends / client receives a regular response - remove the record. */
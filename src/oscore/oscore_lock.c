@@ -0,0 +1,34 @@
+/*
+   Copyright (c) 2026 Fraunhofer AISEC. See the COPYRIGHT
+   file at the top-level directory of this distribution.
+
+   Licensed under the Apache License, Version 2.0 <LICENSE-APACHE or
+   http://www.apache.org/licenses/LICENSE-2.0> or the MIT license
+   <LICENSE-MIT or http://opensource.org/licenses/MIT>, at your
+   option. This file may not be copied, modified, or distributed
+   except according to those terms.
+*/
+
+#include "edhoc.h"
+
+#include "oscore/oscore_lock.h"
+
+void oscore_lock_init(struct oscore_lock *l)
+{
+	l->locked = false;
+}
+
+void WEAK oscore_lock_acquire(struct oscore_lock *l)
+{
+	while (__atomic_exchange_n(&l->locked, true, __ATOMIC_ACQUIRE)) {
+		/*wait with plain reads, so that the cache line is not written 
+		while the lock is held*/
+		while (__atomic_load_n(&l->locked, __ATOMIC_RELAXED)) {
+		}
+	}
+}
+
+void WEAK oscore_lock_release(struct oscore_lock *l)
+{
+	__atomic_store_n(&l->locked, false, __ATOMIC_RELEASE);
+}
@@ -0,0 +1,129 @@
+/*
+   Copyright (c) 2026 Fraunhofer AISEC. See the COPYRIGHT
+   file at the top-level directory of this distribution.
+
+   Licensed under the Apache License, Version 2.0 <LICENSE-APACHE or
+   http://www.apache.org/licenses/LICENSE-2.0> or the MIT license
+   <LICENSE-MIT or http://opensource.org/licenses/MIT>, at your
+   option. This file may not be copied, modified, or distributed
+   except according to those terms.
+*/
+
+#include <string.h>
+
+#include "oscore/oscore_rate_limit.h"
+
+#include "common/oscore_edhoc_error.h"
+
+/**
+ * @brief Gives the calling thread exclusive access to a limiter. Does 
+ *        nothing if OSCORE_THREAD_SAFE is not defined.
+ */
+static void limit_lock(struct oscore_rate_limit *limit)
+{
+#ifdef OSCORE_THREAD_SAFE
+	oscore_lock_acquire(&limit->lock);
+#else
+	(void)limit;
+#endif
+}
+
+/**
+ * @brief Releases a limiter locked with limit_lock().
+ */
+static void limit_unlock(struct oscore_rate_limit *limit)
+{
+#ifdef OSCORE_THREAD_SAFE
+	oscore_lock_release(&limit->lock);
+#else
+	(void)limit;
+#endif
+}
+
+/**
+ * @brief Adds the tokens of the intervals passed since the last refill.
+ * @param limit The limiter, with a clock.
+ */
+static void refill(struct oscore_rate_limit *limit)
+{
+	uint32_t now = limit->clock();
+	/* the difference is correct also if the clock wrapped around */
+	uint32_t intervals = (uint32_t)(now - limit->last_refill) /
+			     limit->interval;
+	if (0 == intervals) {
+		return;
+	}
+
+	if (intervals >= limit->burst - limit->tokens) {
+		/* a full bucket doesn't collect tokens */
+		limit->tokens = limit->burst;
+		limit->last_refill = now;
+	} else {
+		/* the rest of the current interval is kept */
+		limit->tokens += intervals;
+		limit->last_refill += intervals * limit->interval;
+	}
+}
+
+enum err oscore_rate_limit_init(struct oscore_rate_limit *limit,
+				oscore_rate_limit_clock_t clock, uint32_t burst,
+				uint32_t interval)
+{
+	if ((NULL == limit) ||
+	    ((NULL != clock) && ((0 == burst) || (0 == interval)))) {
+		return wrong_parameter;
+	}
+
+	memset(limit, 0, sizeof(*limit));
+	limit->clock = clock;
+	limit->burst = burst;
+	limit->interval = interval;
+	limit->tokens = burst;
+	if (NULL != clock) {
+		limit->last_refill = clock();
+	}
+	oscore_lock_init(&limit->lock);
+	return ok;
+}
+
+bool oscore_rate_limit_allow(struct oscore_rate_limit *limit)
+{
+	if (NULL == limit->clock) {
+		return true;
+	}
+
+	limit_lock(limit);
+	refill(limit);
+	bool allowed = (0 != limit->tokens);
+	if (!allowed) {
+		limit->stats.shed++;
+	}
+	limit_unlock(limit);
+	return allowed;
+}
+
+void oscore_rate_limit_failure(struct oscore_rate_limit *limit)
+{
+	limit_lock(limit);
+	limit->stats.failures++;
+	if (NULL != limit->clock) {
+		refill(limit);
+		if (0 != limit->tokens) {
+			limit->tokens--;
+		}
+	}
+	limit_unlock(limit);
+}
+
+enum err oscore_rate_limit_stats_get(struct oscore_rate_limit *limit,
+				     struct oscore_rate_limit_stats *stats)
+{
+	if ((NULL == limit) || (NULL == stats)) {
+		return wrong_parameter;
+	}
+
+	limit_lock(limit);
+	*stats = limit->stats;
+	limit_unlock(limit);
+	return ok;
+}
@@ -0,0 +1,151 @@
+/*
+   Copyright (c) 2026 Fraunhofer AISEC. See the COPYRIGHT
+   file at the top-level directory of this distribution.
+
+   Licensed under the Apache License, Version 2.0 <LICENSE-APACHE or
+   http://www.apache.org/licenses/LICENSE-2.0> or the MIT license
+   <LICENSE-MIT or http://opensource.org/licenses/MIT>, at your
+   option. This file may not be copied, modified, or distributed
+   except according to those terms.
+*/
+
+#include <string.h>
+
+#include "oscore/oscore_response_cache.h"
+
+#include "common/crypto_wrapper.h"
+#include "common/oscore_edhoc_error.h"
+
+/**
+ * @brief Checks if an entry holds a response to the given request.
+ * @param entry The entry.
+ * @param request_piv PIV of the request.
+ * @param mid Message ID of the request.
+ * @return true if the key matches.
+ */
+static bool key_equals(const struct oscore_cached_response *entry,
+		       const struct byte_array *request_piv, uint16_t mid)
+{
+	return entry->is_occupied && (entry->mid == mid) &&
+	       (entry->request_piv_len == request_piv->len) &&
+	       (0 == memcmp(entry->request_piv, request_piv->ptr,
+			    request_piv->len));
+}
+
+/**
+ * @brief Time since an entry was stored, correct also if the clock wrapped around.
+ */
+static uint32_t age(const struct oscore_cached_response *entry, uint32_t now)
+{
+	return (uint32_t)(now - entry->stored);
+}
+
+enum err oscore_response_cache_init(struct oscore_response_cache *cache,
+				    struct oscore_cached_response *entries,
+				    uint32_t count,
+				    oscore_response_cache_clock_t clock,
+				    uint32_t lifetime)
+{
+	if ((NULL == cache) ||
+	    ((NULL != entries) &&
+	     ((0 == count) || (NULL == clock) || (0 == lifetime)))) {
+		return wrong_parameter;
+	}
+
+	cache->entries = entries;
+	cache->count = (NULL != entries) ? count : 0;
+	cache->clock = clock;
+	cache->lifetime = lifetime;
+	for (uint32_t i = 0; i < cache->count; i++) {
+		entries[i].is_occupied = false;
+	}
+	return ok;
+}
+
+enum err oscore_response_cache_put(struct oscore_response_cache *cache,
+				   const struct byte_array *request_piv,
+				   uint16_t mid,
+				   const struct byte_array *request_digest,
+				   const struct byte_array *response)
+{
+	if ((NULL == cache) || (NULL == request_piv) ||
+	    (NULL == request_digest) || (NULL == response) ||
+	    (request_piv->len > MAX_PIV_LEN) ||
+	    (OSCORE_RESPONSE_CACHE_DIGEST_LEN != request_digest->len)) {
+		return wrong_parameter;
+	}
+	if ((NULL == cache->entries) ||
+	    (response->len > OSCORE_RESPONSE_CACHE_MAX_LEN)) {
+		return ok;
+	}
+
+	/* the entry of the same request, else a free one, else the oldest one, 
+	   which is also an expired one if there is any */
+	uint32_t now = cache->clock();
+	struct oscore_cached_response *victim = NULL;
+	uint32_t victim_age = 0;
+	for (uint32_t i = 0; i < cache->count; i++) {
+		struct oscore_cached_response *entry = &cache->entries[i];
+		if (key_equals(entry, request_piv, mid)) {
+			victim = entry;
+			break;
+		}
+		uint32_t a = entry->is_occupied ? age(entry, now) :
+						  UINT32_MAX;
+		if ((NULL == victim) || (a > victim_age)) {
+			victim = entry;
+			victim_age = a;
+		}
+	}
+
+	victim->is_occupied = true;
+	victim->stored = now;
+	victim->mid = mid;
+	victim->request_piv_len = (uint8_t)request_piv->len;
+	memcpy(victim->request_piv, request_piv->ptr, request_piv->len);
+	memcpy(victim->request_digest, request_digest->ptr,
+	       OSCORE_RESPONSE_CACHE_DIGEST_LEN);
+	victim->len = response->len;
+	memcpy(victim->buf, response->ptr, response->len);
+	return ok;
+}
+
+const struct oscore_cached_response *
+oscore_response_cache_get(struct oscore_response_cache *cache,
+			  const struct byte_array *request_piv, uint16_t mid,
+			  const struct byte_array *request_digest)
+{
+	if ((NULL == cache) || (NULL == request_piv) ||
+	    (NULL == request_digest) || (NULL == cache->entries) ||
+	    (OSCORE_RESPONSE_CACHE_DIGEST_LEN != request_digest->len)) {
+		return NULL;
+	}
+
+	for (uint32_t i = 0; i < cache->count; i++) {
+		struct oscore_cached_response *entry = &cache->entries[i];
+		if (key_equals(entry, request_piv, mid)) {
+			if (age(entry, cache->clock()) >=
+			    cache->lifetime) {
+				entry->is_occupied = false;
+				return NULL;
+			}
+			if (0 != memcmp(entry->request_digest,
+					request_digest->ptr,
+					OSCORE_RESPONSE_CACHE_DIGEST_LEN)) {
+				return NULL;
+			}
+			return entry;
+		}
+	}
+	return NULL;
+}
+
+enum err oscore_response_cache_digest(const struct byte_array *request,
+				      struct byte_array *digest)
+{
+	if ((NULL == request) || (NULL == digest) ||
+	    (digest->len < OSCORE_RESPONSE_CACHE_DIGEST_LEN)) {
+		return wrong_parameter;
+	}
+	return hash(SHA_256, request, digest);
+}
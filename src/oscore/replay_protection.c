@@ -6,41 +6,127 @@
 #include "common/memcpy_s.h"
 #include "common/byte_array.h"
 
-#define WINDOW_SIZE OSCORE_SERVER_REPLAY_WINDOW_SIZE
+/**
+ * @brief Get the storage of the window bits.
+ *
+ * @param replay_window [in] replay window structure
+ * @return pointer to the first word of the bitmap
+ */
+static inline uint64_t *
+window_bitmap(const struct server_replay_window_t *replay_window)
+{
+	if (NULL != replay_window->bitmap_ext) {
+		return replay_window->bitmap_ext;
+	}
+	return (uint64_t *)replay_window->bitmap_buf;
+}
 
 /**
- * @brief Insert given sequence number in the specified position of replay window.
+ * @brief Get the number of bits in the ring storing the window.
+ *
+ * @param replay_window [in] replay window structure
+ * @return a multiple of 64 not smaller than the window size
+ */
+static inline uint64_t
+window_ring_bits(const struct server_replay_window_t *replay_window)
+{
+	return (uint64_t)REPLAY_WINDOW_WORDS(replay_window->size) * 64;
+}
 
- * @param seq_number [in] sequence number to be inserted
- * @param replay_window [out] replay window array pointer
- * @param position [in] index to place new number (all older elements will be left-shifted)
+/**
+ * @brief Check whether the bit of given sequence number is set. The sequence number must be inside the window.
+ *
+ * @param seq_number [in] sequence number
+ * @param replay_window [in] replay window structure
+ * @return true if the sequence number was already received
  */
-static void server_replay_window_insert(uint64_t seq_number,
-					struct server_replay_window_t *replay_window,
-					size_t position)
+static inline bool window_bit_get(uint64_t seq_number,
+				  const struct server_replay_window_t *replay_window)
 {
-	uint64_t *window = replay_window->window;
+	uint64_t bit = seq_number % window_ring_bits(replay_window);
+	return 0 != (window_bitmap(replay_window)[bit / 64] & (1ULL << (bit % 64)));
+}
 
-	/*shift all old values one position to the left*/
-	size_t shift_length = position * sizeof(window[0]);
-	memmove(window, window + 1, shift_length);
+/**
+ * @brief Set or clear the bit of given sequence number.
+ *
+ * @param seq_number [in] sequence number
+ * @param replay_window [out] replay window structure
+ * @param value [in] new value of the bit
+ */
+static inline void window_bit_set(uint64_t seq_number,
+				  struct server_replay_window_t *replay_window,
+				  bool value)
+{
+	uint64_t bit = seq_number % window_ring_bits(replay_window);
+	uint64_t *word = &window_bitmap(replay_window)[bit / 64];
+	if (value) {
+		*word |= (1ULL << (bit % 64));
+	} else {
+		*word &= ~(1ULL << (bit % 64));
+	}
+}
 
-	/*insert the new sender sequence number at a given position*/
-	window[position] = seq_number;
+/**
+ * @brief Slide the window so that given sequence number becomes the highest one. Bits of all sequence numbers that enter the window are cleared.
+ *
+ * @param seq_number [in] new highest sequence number, greater than the current one
+ * @param replay_window [out] replay window structure
+ */
+static void window_slide(uint64_t seq_number,
+			 struct server_replay_window_t *replay_window)
+{
+	uint64_t ring_bits = window_ring_bits(replay_window);
+	uint64_t *bitmap = window_bitmap(replay_window);
+
+	if (seq_number - replay_window->highest >= ring_bits) {
+		/*the whole ring is reused*/
+		memset(bitmap, 0, (size_t)(ring_bits / 8));
+	} else {
+		/*clear one bit at a time up to a word boundary, then whole words*/
+		uint64_t s = replay_window->highest + 1;
+		while (s <= seq_number) {
+			if ((0 == s % 64) && (seq_number - s >= 63)) {
+				bitmap[(s % ring_bits) / 64] = 0;
+				s += 64;
+			} else {
+				window_bit_set(s, replay_window, false);
+				s++;
+			}
+		}
+	}
+	replay_window->highest = seq_number;
 }
 
-enum err server_replay_window_init(struct server_replay_window_t *replay_window)
+enum err server_replay_window_init_size(struct server_replay_window_t *replay_window,
+					uint32_t size, uint64_t *bitmap)
 {
 	if (NULL == replay_window) {
 		return wrong_parameter;
 	}
+	if ((0 == size) || (OSCORE_SERVER_REPLAY_WINDOW_MAX_SIZE < size)) {
+		return wrong_parameter;
+	}
+	if ((NULL == bitmap) &&
+	    (REPLAY_WINDOW_WORDS(size) >
+	     REPLAY_WINDOW_WORDS(OSCORE_SERVER_REPLAY_WINDOW_SIZE))) {
+		return wrong_parameter;
+	}
 
-	memset(replay_window->window, 0,
-	       WINDOW_SIZE * sizeof(replay_window->window[0]));
-	replay_window->seq_num_zero_received = false;
+	replay_window->bitmap_ext = bitmap;
+	replay_window->size = size;
+	replay_window->highest = 0;
+	memset(window_bitmap(replay_window), 0,
+	       REPLAY_WINDOW_WORDS(size) * sizeof(uint64_t));
 	return ok;
 }
 
+enum err server_replay_window_init(struct server_replay_window_t *replay_window)
+{
+	return server_replay_window_init_size(
+		replay_window, OSCORE_SERVER_REPLAY_WINDOW_SIZE, NULL);
+}
+
 enum err server_replay_window_reinit(uint64_t current_sequence_number,
 				     struct server_replay_window_t *replay_window)
 {
@@ -48,17 +134,10 @@ enum err server_replay_window_reinit(uint64_t current_sequence_number,
 		return wrong_parameter;
 	}
 
-	/*fill the window in a way that only new sequence numbers are accepted*/
-	for (uint8_t j = 0; j < WINDOW_SIZE; j++) {
-		replay_window->window[(WINDOW_SIZE - 1) - j] =
-			current_sequence_number;
-		if (current_sequence_number > 0) {
-			current_sequence_number--;
-		}
-	}
-
-	/* don't accept seqNum=0 anymore */
-	replay_window->seq_num_zero_received = true;
+	/*mark the whole window as received so that only new sequence numbers are accepted*/
+	replay_window->highest = current_sequence_number;
+	memset(window_bitmap(replay_window), 0xFF,
+	       REPLAY_WINDOW_WORDS(replay_window->size) * sizeof(uint64_t));
 
 	return ok;
 }
@@ -70,30 +149,16 @@ bool server_is_sequence_number_valid(uint64_t seq_number,
 		return false;
 	}
 
-	/* replay window uses zeros for unused entries, so in case of sequence number is 0, a little logic is needed */
-	if (0 == seq_number) {
-		if ((!replay_window->seq_num_zero_received) &&
-		    (0 == replay_window->window[0])) {
-			return true;
-		}
-		return false;
-	}
-
-	if (seq_number > replay_window->window[WINDOW_SIZE - 1]) {
+	if (seq_number > replay_window->highest) {
 		return true;
 	}
 
-	if (seq_number < replay_window->window[0]) {
+	/*too old - behind the window*/
+	if (replay_window->highest - seq_number >= replay_window->size) {
 		return false;
 	}
 
-	for (uint8_t i = 0; i < WINDOW_SIZE; i++) {
-		if (seq_number == replay_window->window[i]) {
-			return false;
-		}
-	}
-
-	return true;
+	return !window_bit_get(seq_number, replay_window);
 }
 
 bool server_replay_window_update(uint64_t seq_number,
@@ -106,20 +171,10 @@ bool server_replay_window_update(uint64_t seq_number,
 		return false;
 	}
 
-	if (seq_number == 0) {
-		replay_window->seq_num_zero_received = true;
-		return true;
-	}
-
-	uint16_t index;
-	for (index = 0; index < WINDOW_SIZE - 1; index++) {
-		/* when the loop doesn't find proper index to place the number, it will stop at index = WINDOW_SIZE-1 */
-		if ((replay_window->window[index] < seq_number) &&
-		    (replay_window->window[index + 1] > seq_number)) {
-			break;
-		}
+	if (seq_number > replay_window->highest) {
+		window_slide(seq_number, replay_window);
 	}
-	server_replay_window_insert(seq_number, replay_window, index);
+	window_bit_set(seq_number, replay_window, true);
 	return true;
 }
 
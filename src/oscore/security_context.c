@@ -33,13 +33,16 @@
  * @brief       Common derive procedure used to derive the Common IV and 
  *              Sender / Recipient Keys
  * @param cc    pointer to the common context
+ * @param prk   HKDF context keyed with the PRK extracted from the master 
+ *              secret and master salt
  * @param id    empty array for Common IV, sender / recipient ID for keys
  * @param type  IV for Common IV, KEY for Sender / Recipient Keys
  * @param out   out-array. Must be initialized
  * @return      err
  */
-STATIC enum err derive(struct common_context *cc, struct byte_array *id,
-		       enum derive_type type, struct byte_array *out)
+STATIC enum err derive(struct common_context *cc, const struct hkdf_ctx *prk,
+		       struct byte_array *id, enum derive_type type,
+		       struct byte_array *out)
 {
 	BYTE_ARRAY_NEW(info, MAX_INFO_LEN, MAX_INFO_LEN);
 	TRY(oscore_create_hkdf_info(id, &cc->id_context, cc->aead_alg, type,
@@ -49,8 +52,7 @@ STATIC enum err derive(struct common_context *cc, struct byte_array *id,
 
 	switch (cc->kdf) {
 	case OSCORE_SHA_256:
-		TRY(hkdf_sha_256(&cc->master_secret, &cc->master_salt, &info,
-				 out));
+		TRY(hkdf_ctx_expand(prk, &info, out));
 		break;
 	default:
 		return oscore_unknown_hkdf;
@@ -62,11 +64,13 @@ STATIC enum err derive(struct common_context *cc, struct byte_array *id,
 /**
  * @brief    Derives the Common IV 
  * @param    cc    pointer to the common context
+ * @param    prk   the keyed HKDF context
  * @return   err
  */
-static enum err derive_common_iv(struct common_context *cc)
+static enum err derive_common_iv(struct common_context *cc,
+				 const struct hkdf_ctx *prk)
 {
-	TRY(derive(cc, &EMPTY_ARRAY, IV, &cc->common_iv));
+	TRY(derive(cc, prk, &EMPTY_ARRAY, IV, &cc->common_iv));
 	PRINT_ARRAY("Common IV", cc->common_iv.ptr, cc->common_iv.len);
 	return ok;
 }
@@ -74,13 +78,15 @@ static enum err derive_common_iv(struct common_context *cc)
 /**
  * @brief    Derives the Sender Key 
  * @param    cc    pointer to the common context
+ * @param    prk   the keyed HKDF context
  * @param    sc    pointer to the sender context
  * @return   err
  */
 static enum err derive_sender_key(struct common_context *cc,
+				  const struct hkdf_ctx *prk,
 				  struct sender_context *sc)
 {
-	TRY(derive(cc, &sc->sender_id, KEY, &sc->sender_key));
+	TRY(derive(cc, prk, &sc->sender_id, KEY, &sc->sender_key));
 	PRINT_ARRAY("Sender Key", sc->sender_key.ptr, sc->sender_key.len);
 	return ok;
 }
@@ -88,19 +94,128 @@ static enum err derive_sender_key(struct common_context *cc,
 /**
  * @brief    Derives the Recipient Key 
  * @param    cc    pointer to the common context
+ * @param    prk   the keyed HKDF context
  * @param    sc    pointer to the recipient context
  * @return   err
  */
 static enum err derive_recipient_key(struct common_context *cc,
+				     const struct hkdf_ctx *prk,
 				     struct recipient_context *rc)
 {
-	TRY(derive(cc, &rc->recipient_id, KEY, &rc->recipient_key));
+	TRY(derive(cc, prk, &rc->recipient_id, KEY, &rc->recipient_key));
 
 	PRINT_ARRAY("Recipient Key", rc->recipient_key.ptr,
 		    rc->recipient_key.len);
 	return ok;
 }
 
+/**
+ * @brief    Derives the Common IV and the Recipient and Sender Contexts
+ * @param    params the init parameters
+ * @param    prk    HKDF context keyed with the PRK
+ * @param    c      the context
+ * @return   err
+ */
+static enum err derive_contexts(struct oscore_init_params *params,
+				const struct hkdf_ctx *prk, struct context *c)
+{
+	c->cc.common_iv.len = sizeof(c->cc.common_iv_buf);
+	c->cc.common_iv.ptr = c->cc.common_iv_buf;
+	TRY(derive_common_iv(&c->cc, prk));
+
+	/*derive Recipient Context*********************************************/
+	c->rc.notification_num_initialized = false;
+	TRY(server_replay_window_init_size(
+		&c->rc.replay_window,
+		(0 != params->replay_window_size) ?
+			params->replay_window_size :
+			OSCORE_SERVER_REPLAY_WINDOW_SIZE,
+		params->replay_window_bitmap));
+	c->rc.recipient_id.len = params->recipient_id.len;
+	c->rc.recipient_id.ptr = c->rc.recipient_id_buf;
+	memcpy(c->rc.recipient_id.ptr, params->recipient_id.ptr,
+	       params->recipient_id.len);
+	c->rc.recipient_key.len = sizeof(c->rc.recipient_key_buf);
+	c->rc.recipient_key.ptr = c->rc.recipient_key_buf;
+	TRY(derive_recipient_key(&c->cc, prk, &c->rc));
+
+	/*derive Sender Context************************************************/
+	c->sc.sender_id = params->sender_id;
+	c->sc.sender_key.len = sizeof(c->sc.sender_key_buf);
+	c->sc.sender_key.ptr = c->sc.sender_key_buf;
+	struct nvm_key_t nvm_key = { .sender_id = c->sc.sender_id,
+				     .recipient_id = c->rc.recipient_id,
+				     .id_context = c->cc.id_context };
+
+	uint64_t ssn;
+	TRY(ssn_init(&nvm_key, &ssn, params->fresh_master_secret_salt));
+	c->sc.ssn = ssn;
+#ifdef OSCORE_NVM_SUPPORT
+	if ((NULL != params->ssn_clock) && (0 == params->ssn_write_period)) {
+		return wrong_parameter;
+	}
+	c->sc.ssn_interval = K_SSN_NVM_STORE_INTERVAL;
+	if (NULL != params->ssn_clock) {
+		if (c->sc.ssn_interval < OSCORE_SSN_INTERVAL_MIN) {
+			c->sc.ssn_interval = OSCORE_SSN_INTERVAL_MIN;
+		}
+		if (c->sc.ssn_interval > OSCORE_SSN_INTERVAL_MAX) {
+			c->sc.ssn_interval = OSCORE_SSN_INTERVAL_MAX;
+		}
+	}
+	c->sc.ssn_clock = params->ssn_clock;
+	c->sc.ssn_write_period = params->ssn_write_period;
+	c->sc.ssn_last_write =
+		(NULL != params->ssn_clock) ? params->ssn_clock() : 0;
+	/*a fresh context uses its first interval without writing, a restored 
+	context writes its SSN before the first use*/
+	c->sc.ssn_in_nvm = 0;
+	c->sc.ssn_nvm_bound =
+		params->fresh_master_secret_salt ? c->sc.ssn_interval : 0;
+	c->sc.ssn_nvm_request_at = c->sc.ssn_nvm_bound / 2;
+	c->sc.ssn_nvm_requested = 0;
+	c->sc.ssn_nvm_pending = 0;
+	c->sc.ssn_write_request = params->ssn_write_request;
+	oscore_lock_init(&c->sc.nvm_lock);
+#endif
+	TRY(derive_sender_key(&c->cc, prk, &c->sc));
+	return ok;
+}
+
+#ifdef OSCORE_NVM_SUPPORT
+/**
+ * @brief Restores the replay window of a context which is not fresh from 
+ *        the bound stored in NVM, see nvm_write_replay_bound(). Without a 
+ *        stored bound the context stays in ECHO_REBOOT.
+ * @param params The initialization parameters.
+ * @param c The context.
+ * @return enum err 
+ */
+static enum err replay_bound_restore(struct oscore_init_params *params,
+				     struct context *c)
+{
+	c->rc.replay_bound = 0;
+	c->rc.replay_bound_interval = params->replay_bound_interval;
+	if ((0 == c->rc.replay_bound_interval) ||
+	    params->fresh_master_secret_salt) {
+		return ok;
+	}
+
+	struct nvm_key_t nvm_key = { .sender_id = c->sc.sender_id,
+				     .recipient_id = c->rc.recipient_id,
+				     .id_context = c->cc.id_context };
+	uint64_t bound;
+	if ((ok != nvm_read_replay_bound(&nvm_key, &bound)) || (0 == bound)) {
+		return ok;
+	}
+	/*all requests accepted before had an SSN below the bound*/
+	TRY(server_replay_window_reinit(bound - 1, &c->rc.replay_window));
+	c->rc.replay_bound = bound;
+	c->rrc.echo_state_machine = ECHO_RESTORED;
+	return ok;
+}
+#endif
+
 enum err oscore_context_init(struct oscore_init_params *params,
 			     struct context *c)
 {
@@ -122,47 +237,97 @@ enum err oscore_context_init(struct oscore_init_params *params,
 	c->cc.master_secret = params->master_secret;
 	c->cc.master_salt = params->master_salt;
 	c->cc.id_context = params->id_context;
-	c->cc.common_iv.len = sizeof(c->cc.common_iv_buf);
-	c->cc.common_iv.ptr = c->cc.common_iv_buf;
-	TRY(derive_common_iv(&c->cc));
 
-	/*derive Recipient Context*********************************************/
-	c->rc.notification_num_initialized = false;
-	server_replay_window_init(&c->rc.replay_window);
-	c->rc.recipient_id.len = params->recipient_id.len;
-	c->rc.recipient_id.ptr = c->rc.recipient_id_buf;
-	memcpy(c->rc.recipient_id.ptr, params->recipient_id.ptr,
-	       params->recipient_id.len);
-	c->rc.recipient_key.len = sizeof(c->rc.recipient_key_buf);
-	c->rc.recipient_key.ptr = c->rc.recipient_key_buf;
-	TRY(derive_recipient_key(&c->cc, &c->rc));
-
-	/*derive Sender Context************************************************/
-	c->sc.sender_id = params->sender_id;
-	c->sc.sender_key.len = sizeof(c->sc.sender_key_buf);
-	c->sc.sender_key.ptr = c->sc.sender_key_buf;
-	struct nvm_key_t nvm_key = { .sender_id = c->sc.sender_id,
-				     .recipient_id = c->rc.recipient_id,
-				     .id_context = c->cc.id_context };
+	/*the PRK is extracted once and keyed once, the Common IV and both keys 
+	are expanded from the same HKDF context*/
+	uint8_t prk_buf[PRK_LEN];
+	struct byte_array prk = BYTE_ARRAY_INIT(prk_buf, sizeof(prk_buf));
+	struct hkdf_ctx prk_ctx;
+	TRY(hkdf_extract(SHA_256, &c->cc.master_salt, &c->cc.master_secret,
+			 prk_buf));
+	enum err r = hkdf_ctx_init(SHA_256, &prk, &prk_ctx);
+	if (ok == r) {
+		r = derive_contexts(params, &prk_ctx, c);
+		hkdf_ctx_deinit(&prk_ctx);
+	}
+	memset(prk_buf, 0, sizeof(prk_buf));
+	TRY(r);
 
-	TRY(ssn_init(&nvm_key, &c->sc.ssn, params->fresh_master_secret_salt));
-	TRY(derive_sender_key(&c->cc, &c->sc));
+	TRY(oscore_interactions_init_size(&c->rrc.interactions,
+					  (0 != params->interactions_count) ?
+						  params->interactions_count :
+						  OSCORE_INTERACTIONS_COUNT,
+					  params->interactions));
+	TRY(oscore_interactions_expiry_set(&c->rrc.interactions,
+					   params->interactions_clock,
+					   params->interactions_idle_timeout));
+	TRY(oscore_rate_limit_init(&c->rc.failure_limit,
+				   params->failure_limit_clock,
+				   params->failure_limit_burst,
+				   params->failure_limit_interval));
+	TRY(oscore_response_cache_init(&c->rrc.responses, params->responses,
+				       params->responses_count,
+				       params->responses_clock,
+				       params->responses_lifetime));
 
 	/*set up the request response context**********************************/
-	oscore_interactions_init(c->rrc.interactions);
 	c->rrc.nonce.len = sizeof(c->rrc.nonce_buf);
 	c->rrc.nonce.ptr = c->rrc.nonce_buf;
 	c->rrc.echo_opt_val.len = sizeof(c->rrc.echo_opt_val_buf);
 	c->rrc.echo_opt_val.ptr = c->rrc.echo_opt_val_buf;
+	c->rrc.echo_key = params->echo_key;
+	c->rrc.echo_challenge_time = 0;
+	memset(c->rrc.request_digest, 0, sizeof(c->rrc.request_digest));
 
 	/* no ECHO challenge needed if the context is fresh */
 	c->rrc.echo_state_machine =
 		(params->fresh_master_secret_salt ? ECHO_SYNCHRONIZED :
 						    ECHO_REBOOT);
+#ifdef OSCORE_NVM_SUPPORT
+	TRY(replay_bound_restore(params, c));
+#endif
+
+	/*bind the keys to AEAD key handles used for every message*************/
+	/*this is the last step that can fail, no handle is leaked on errors*/
+	TRY(aead_key_init(&c->rc.recipient_key, AUTH_TAG_LEN,
+			  &c->rc.recipient_key_handle));
+	r = aead_key_init(&c->sc.sender_key, AUTH_TAG_LEN,
+			  &c->sc.sender_key_handle);
+	if (ok != r) {
+		aead_key_deinit(&c->rc.recipient_key_handle);
+		return r;
+	}
+
+	oscore_lock_init(&c->lock);
+	return ok;
+}
+
+enum err oscore_context_deinit(struct context *c)
+{
+	if (NULL == c) {
+		return wrong_parameter;
+	}
 
+	enum err r_sender = aead_key_deinit(&c->sc.sender_key_handle);
+	enum err r_recipient = aead_key_deinit(&c->rc.recipient_key_handle);
+	TRY(r_sender);
+	TRY(r_recipient);
 	return ok;
 }
 
+enum err oscore_context_interactions_sweep(struct context *c,
+					   uint32_t *removed)
+{
+	if (NULL == c) {
+		return wrong_parameter;
+	}
+
+	context_lock(c);
+	enum err r = oscore_interactions_sweep(&c->rrc.interactions, removed);
+	context_unlock(c);
+	return r;
+}
+
 enum err check_context_freshness(struct context *c)
 {
 	if (NULL == c) {
@@ -172,7 +337,7 @@ enum err check_context_freshness(struct context *c)
 	/* "If the Sender Sequence Number exceeds the maximum, the endpoint MUST NOT
 	   process any more messages with the given Sender Context."
 	   For more info, refer to RFC 8613 p. 7.2.1. */
-	if (c->sc.ssn >= OSCORE_SSN_OVERFLOW_VALUE) {
+	if (ssn_atomic_load(&c->sc.ssn) >= OSCORE_SSN_OVERFLOW_VALUE) {
 		PRINT_MSG(
 			"Sender Sequence Number reached its limit. New security context must be established.\n");
 		return oscore_ssn_overflow;
@@ -187,7 +352,7 @@ enum err ssn2piv(uint64_t ssn, struct byte_array *piv)
 		return wrong_parameter;
 	}
 
-	static uint8_t tmp_piv[MAX_PIV_LEN];
+	uint8_t tmp_piv[MAX_PIV_LEN];
 	uint8_t len = 0;
 	while (ssn > 0) {
 		tmp_piv[len] = (uint8_t)(ssn & 0xFF);
@@ -232,3 +397,39 @@ enum err piv2ssn(struct byte_array *piv, uint64_t *ssn)
 	*ssn = result;
 	return ok;
 }
+
+uint64_t ssn_atomic_load(const oscore_ssn_t *ssn)
+{
+#ifdef OSCORE_THREAD_SAFE
+	return __atomic_load_n(ssn, __ATOMIC_SEQ_CST);
+#else
+	return *ssn;
+#endif
+}
+
+void ssn_atomic_store(oscore_ssn_t *ssn, uint64_t value)
+{
+#ifdef OSCORE_THREAD_SAFE
+	__atomic_store_n(ssn, value, __ATOMIC_SEQ_CST);
+#else
+	*ssn = value;
+#endif
+}
+
+void context_lock(struct context *c)
+{
+#ifdef OSCORE_THREAD_SAFE
+	oscore_lock_acquire(&c->lock);
+#else
+	(void)c;
+#endif
+}
+
+void context_unlock(struct context *c)
+{
+#ifdef OSCORE_THREAD_SAFE
+	oscore_lock_release(&c->lock);
+#else
+	(void)c;
+#endif
+}
@@ -1,11 +1,18 @@
 #include "oscore.h"
 
+/*last written SSN and number of writes, checked by the tests*/
+uint64_t nvm_mock_ssn;
+uint32_t nvm_mock_write_cnt;
+/*result of the writes, e.g., oscore_nvm_write_deferred*/
+enum err nvm_mock_write_result = ok;
+
 enum err nvm_write_ssn(const struct nvm_key_t *nvm_key, uint64_t ssn)
 {
 	(void)nvm_key;
-	(void)ssn;
 	PRINT_MSG("NVM write mock\n");
-	return ok;
+	nvm_mock_ssn = ssn;
+	nvm_mock_write_cnt++;
+	return nvm_mock_write_result;
 }
 
 enum err nvm_read_ssn(const struct nvm_key_t *nvm_key, uint64_t *ssn)
@@ -15,3 +22,25 @@ enum err nvm_read_ssn(const struct nvm_key_t *nvm_key, uint64_t *ssn)
 	*ssn = 0;
 	return ok;
 }
+
+/*last written replay bound, 0 if none is stored*/
+uint64_t nvm_mock_replay_bound;
+
+enum err nvm_write_replay_bound(const struct nvm_key_t *nvm_key,
+				uint64_t bound)
+{
+	(void)nvm_key;
+	nvm_mock_replay_bound = bound;
+	return ok;
+}
+
+enum err nvm_read_replay_bound(const struct nvm_key_t *nvm_key,
+			       uint64_t *bound)
+{
+	(void)nvm_key;
+	if (0 == nvm_mock_replay_bound) {
+		return oscore_nvm_key_not_found;
+	}
+	*bound = nvm_mock_replay_bound;
+	return ok;
+}
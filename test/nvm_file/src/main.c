@@ -0,0 +1,237 @@
+/*
+   Copyright (c) 2026 Fraunhofer AISEC. See the COPYRIGHT
+   file at the top-level directory of this distribution.
+
+   Licensed under the Apache License, Version 2.0 <LICENSE-APACHE or
+   http://www.apache.org/licenses/LICENSE-2.0> or the MIT license
+   <LICENSE-MIT or http://opensource.org/licenses/MIT>, at your
+   option. This file may not be copied, modified, or distributed
+   except according to those terms.
+*/
+
+/*
+ * Tests of the SSN store file of inc/oscore/nvm_file.h on a POSIX host. The
+ * store is built into the test with OSCORE_THREAD_SAFE. msync() is replaced
+ * by the test, so that a write of another thread can be run while a sync is
+ * in progress, and the mapping can be captured as the disk may hold it.
+ */
+
+#define _GNU_SOURCE
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "oscore/nvm_file.h"
+
+/*one slot, so that its two copies are at known offsets*/
+#define SLOTS 1
+#define COPY0_OFFSET OSCORE_NVM_FILE_HEADER_LEN
+#define COPY1_OFFSET (OSCORE_NVM_FILE_HEADER_LEN + OSCORE_NVM_FILE_RECORD_LEN)
+#define FILE_LEN (OSCORE_NVM_FILE_HEADER_LEN + 2 * OSCORE_NVM_FILE_RECORD_LEN)
+/*offset of the SSN in a record*/
+#define SSN_OFFSET 8
+
+#define CHECK(cond)                                                            \
+	do {                                                                   \
+		if (!(cond)) {                                                 \
+			printf("%s:%d: check failed: %s\n", __FILE__,          \
+			       __LINE__, #cond);                               \
+			exit(EXIT_FAILURE);                                    \
+		}                                                              \
+	} while (0)
+
+static uint8_t sender_id[] = { 0x01 };
+static uint8_t recipient_id[] = { 0x02, 0x03 };
+static uint8_t id_context[] = { 0x37, 0xcb, 0xf3, 0x21 };
+static const struct nvm_key_t key = {
+	.sender_id = { .ptr = sender_id, .len = sizeof(sender_id) },
+	.recipient_id = { .ptr = recipient_id, .len = sizeof(recipient_id) },
+	.id_context = { .ptr = id_context, .len = sizeof(id_context) },
+};
+
+static char path[] = "/tmp/nvm_file_test_XXXXXX";
+static char snapshot_path[] = "/tmp/nvm_file_test_snapshot_XXXXXX";
+
+/*store whose sync runs the hook of msync()*/
+static struct oscore_nvm_file *hooked;
+static void (*hook)(struct oscore_nvm_file *f);
+
+int msync(void *addr, size_t length, int flags)
+{
+	if ((NULL != hook) && (NULL != hooked) && (hooked->map == addr)) {
+		void (*h)(struct oscore_nvm_file *) = hook;
+		hook = NULL;
+		h(hooked);
+	}
+	return (int)syscall(SYS_msync, addr, length, flags);
+}
+
+static void sleep_ms(long ms)
+{
+	struct timespec ts = { .tv_sec = 0, .tv_nsec = ms * 1000000 };
+	nanosleep(&ts, NULL);
+}
+
+static uint64_t ssn_read(struct oscore_nvm_file *f)
+{
+	uint64_t ssn;
+	uint32_t interval;
+	CHECK(ok == oscore_nvm_file_read(f, &key, &ssn, &interval));
+	return ssn;
+}
+
+static void file_damage(const char *p, long offset)
+{
+	int fd = open(p, O_RDWR);
+	CHECK(fd >= 0);
+	uint8_t b;
+	CHECK(1 == pread(fd, &b, 1, offset));
+	b ^= 0x01;
+	CHECK(1 == pwrite(fd, &b, 1, offset));
+	close(fd);
+}
+
+/**
+ * @brief Values written and synced survive closing and reopening the file,
+ *        a file with another number of slots is rejected.
+ */
+static void reopen_test(void)
+{
+	struct oscore_nvm_file f;
+
+	CHECK(ok == oscore_nvm_file_open(&f, path, SLOTS));
+	uint64_t ssn;
+	uint32_t interval;
+	CHECK(oscore_nvm_key_not_found ==
+	      oscore_nvm_file_read(&f, &key, &ssn, &interval));
+	CHECK(ok == oscore_nvm_file_write(&f, &key, 100, 64));
+	CHECK(100 == ssn_read(&f));
+	CHECK(ok == oscore_nvm_file_sync(&f));
+	CHECK(ok == oscore_nvm_file_write(&f, &key, 200, 64));
+	CHECK(ok == oscore_nvm_file_close(&f));
+
+	CHECK(ok == oscore_nvm_file_open(&f, path, SLOTS));
+	CHECK(1 == f.keys_cnt);
+	CHECK(ok == oscore_nvm_file_read(&f, &key, &ssn, &interval));
+	CHECK((200 == ssn) && (64 == interval));
+	CHECK(ok == oscore_nvm_file_close(&f));
+
+	CHECK(oscore_nvm_io_error == oscore_nvm_file_open(&f, path, 2 * SLOTS));
+}
+
+/**
+ * @brief A damaged copy, as a torn write leaves it, is ignored and the other
+ *        copy is used.
+ */
+static void damaged_copy_test(void)
+{
+	struct oscore_nvm_file f;
+
+	/*the first value of the key is in copy 0, the second one in copy 1,
+	since copy 0 is on the disk when it is written*/
+	CHECK(ok == oscore_nvm_file_open(&f, path, SLOTS));
+	CHECK(ok == oscore_nvm_file_write(&f, &key, 300, 64));
+	CHECK(ok == oscore_nvm_file_sync(&f));
+	CHECK(ok == oscore_nvm_file_write(&f, &key, 400, 64));
+	CHECK(ok == oscore_nvm_file_close(&f));
+
+	file_damage(path, COPY1_OFFSET + SSN_OFFSET);
+	CHECK(ok == oscore_nvm_file_open(&f, path, SLOTS));
+	CHECK(300 == ssn_read(&f));
+	CHECK(ok == oscore_nvm_file_close(&f));
+
+	/*without a valid copy the key is lost, and its slot is free again*/
+	file_damage(path, COPY0_OFFSET + SSN_OFFSET);
+	CHECK(ok == oscore_nvm_file_open(&f, path, SLOTS));
+	CHECK(0 == f.keys_cnt);
+	uint64_t ssn;
+	uint32_t interval;
+	CHECK(oscore_nvm_key_not_found ==
+	      oscore_nvm_file_read(&f, &key, &ssn, &interval));
+	CHECK(ok == oscore_nvm_file_close(&f));
+}
+
+static volatile bool writer_started;
+static uint8_t snapshot[FILE_LEN];
+
+static void *writer(void *arg)
+{
+	struct oscore_nvm_file *f = arg;
+	writer_started = true;
+	CHECK(ok == oscore_nvm_file_write(f, &key, 600, 64));
+	return NULL;
+}
+
+static pthread_t writer_thread;
+
+/*runs in the sync, before the pages are written to the disk*/
+static void concurrent_write(struct oscore_nvm_file *f)
+{
+	CHECK(0 == pthread_create(&writer_thread, NULL, writer, f));
+	while (!writer_started) {
+		sleep_ms(1);
+	}
+	sleep_ms(50);
+	memcpy(snapshot, f->map, sizeof(snapshot));
+}
+
+/**
+ * @brief A write during a sync doesn't change the copy which is being written
+ *        to the disk, so that the disk holds either copy completely.
+ */
+static void concurrent_write_test(void)
+{
+	struct oscore_nvm_file f;
+
+	CHECK(ok == oscore_nvm_file_open(&f, path, SLOTS));
+	CHECK(ok == oscore_nvm_file_write(&f, &key, 500, 64));
+
+	hooked = &f;
+	hook = concurrent_write;
+	CHECK(ok == oscore_nvm_file_sync(&f));
+	CHECK(0 == pthread_join(writer_thread, NULL));
+	hooked = NULL;
+	CHECK(600 == ssn_read(&f));
+	CHECK(ok == oscore_nvm_file_close(&f));
+
+	/*the mapping as the sync found it restores the value it synced*/
+	int fd = open(snapshot_path, O_RDWR | O_TRUNC);
+	CHECK(fd >= 0);
+	CHECK(sizeof(snapshot) == write(fd, snapshot, sizeof(snapshot)));
+	close(fd);
+	CHECK(ok == oscore_nvm_file_open(&f, snapshot_path, SLOTS));
+	CHECK(500 == ssn_read(&f));
+	CHECK(ok == oscore_nvm_file_close(&f));
+
+	CHECK(ok == oscore_nvm_file_open(&f, path, SLOTS));
+	CHECK(600 == ssn_read(&f));
+	CHECK(ok == oscore_nvm_file_close(&f));
+}
+
+int main(void)
+{
+	int fd = mkstemp(path);
+	CHECK(fd >= 0);
+	close(fd);
+	fd = mkstemp(snapshot_path);
+	CHECK(fd >= 0);
+	close(fd);
+
+	reopen_test();
+	damaged_copy_test();
+	concurrent_write_test();
+
+	unlink(path);
+	unlink(snapshot_path);
+	printf("nvm_file tests passed\n");
+	return EXIT_SUCCESS;
+}
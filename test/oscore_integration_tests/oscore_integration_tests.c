@@ -95,6 +95,9 @@ void t1_oscore_client_request_response(void)
 	zassert_equal(r, ok, "Error in coap2oscore!");
 	zassert_mem_equal__(&buf_coap, T1__COAP_RESPONSE, T1__COAP_RESPONSE_LEN,
 			    "coap2oscore failed");
+
+	r = oscore_context_deinit(&c_client);
+	zassert_equal(r, ok, "Error in oscore_context_deinit");
 }
 
 /**
@@ -143,6 +146,9 @@ void t3_oscore_client_request(void)
 
 	zassert_mem_equal__(&buf_oscore, T3__OSCORE_REQ, T3__OSCORE_REQ_LEN,
 			    "coap2oscore failed");
+
+	r = oscore_context_deinit(&c_client);
+	zassert_equal(r, ok, "Error in oscore_context_deinit");
 }
 
 /**
@@ -191,6 +197,9 @@ void t5_oscore_client_request(void)
 
 	zassert_mem_equal__(&buf_oscore, T5__OSCORE_REQ, buf_oscore_len,
 			    "coap2oscore failed");
+
+	r = oscore_context_deinit(&c_client);
+	zassert_equal(r, ok, "Error in oscore_context_deinit");
 }
 
 /**
@@ -254,6 +263,9 @@ void t2_oscore_server_request_response(void)
 
 	zassert_mem_equal__(&buf_oscore, T2__OSCORE_RESP, buf_oscore_len,
 			    "coap2oscore failed");
+
+	r = oscore_context_deinit(&c_server);
+	zassert_equal(r, ok, "Error in oscore_context_deinit");
 }
 
 void t4_oscore_server_key_derivation(void)
@@ -291,6 +303,9 @@ void t4_oscore_server_key_derivation(void)
 	zassert_mem_equal__(c_server.cc.common_iv.ptr, T4__COMMON_IV,
 			    c_server.cc.common_iv.len,
 			    "T4 common IV derivation failed");
+
+	r = oscore_context_deinit(&c_server);
+	zassert_equal(r, ok, "Error in oscore_context_deinit");
 }
 
 /**
@@ -332,6 +347,9 @@ void t6_oscore_server_key_derivation(void)
 	zassert_mem_equal__(c_server.cc.common_iv.ptr, T6__COMMON_IV,
 			    c_server.cc.common_iv.len,
 			    "T6 common IV derivation failed");
+
+	r = oscore_context_deinit(&c_server);
+	zassert_equal(r, ok, "Error in oscore_context_deinit");
 }
 
 /**
@@ -375,6 +393,9 @@ void t8_oscore_server_response_simple_ack(void)
 			    "coap2oscore failed");
 
 	zassert_equal(buf_oscore_len, T8__COAP_ACK_LEN, "coap2oscore failed");
+
+	r = oscore_context_deinit(&context);
+	zassert_equal(r, ok, "Error in oscore_context_deinit");
 }
 
 /**
@@ -577,6 +598,11 @@ void t9_oscore_client_server_observe(void)
 			&ser_conv_coap_pkt_len, &c_client);
 	zassert_equal(r, oscore_replay_notification_protection_error,
 		      "Error in oscore2coap!");
+
+	r = oscore_context_deinit(&c_client);
+	zassert_equal(r, ok, "Error in oscore_context_deinit");
+	r = oscore_context_deinit(&c_server);
+	zassert_equal(r, ok, "Error in oscore_context_deinit");
 }
 
 /**
@@ -1108,6 +1134,11 @@ void t10_oscore_client_server_after_reboot(void)
 
 	zassert_equal(r, oscore_replay_window_protection_error,
 		      "Error in oscore2coap!");
+
+	r = oscore_context_deinit(&cc);
+	zassert_equal(r, ok, "Error in oscore_context_deinit");
+	r = oscore_context_deinit(&cs);
+	zassert_equal(r, ok, "Error in oscore_context_deinit");
 }
 
 /**
@@ -1140,4 +1171,1689 @@ void t11_oscore_ssn_overflow_protection(void)
 	result = oscore2coap((uint8_t *)T1__OSCORE_RESP, T1__OSCORE_RESP_LEN,
 			(uint8_t *)&buf_coap, &buf_coap_len, &security_context);
 	zassert_equal(result, oscore_ssn_overflow, "SSN overflow not detected in oscore2coap");
+
+	result = oscore_context_deinit(&security_context);
+	zassert_equal(result, ok, "Error in oscore_context_deinit");
+}
+
+/**
+ * Test 12:
+ * A burst of notifications protected with coap2oscore_batch() must give the 
+ * same OSCORE packets as protecting them one by one with coap2oscore(). 
+ * A messaging layer ACK in the batch does not consume a SSN.
+ */
+void t12_oscore_batch_notifications(void)
+{
+	enum err r;
+	struct context c_client;
+	struct context c_server;
+	struct context c_server_single;
+	struct oscore_init_params params_client =
+		get_default_params(NORMAL, FRESH);
+	struct oscore_init_params params_server =
+		get_default_params(REVERSED, FRESH);
+	r = oscore_context_init(&params_client, &c_client);
+	zassert_equal(r, ok, "Error in oscore_context_init for client");
+	r = oscore_context_init(&params_server, &c_server);
+	zassert_equal(r, ok, "Error in oscore_context_init for server");
+	r = oscore_context_init(&params_server, &c_server_single);
+	zassert_equal(r, ok, "Error in oscore_context_init for server");
+
+	/*observe registration received by both servers*/
+	uint8_t observe_val[] = { 0x00 };
+	uint8_t uri_path_val[] = { 't', 'e', 'm', 'p' };
+	uint8_t token[] = { 0x4a };
+	struct o_coap_packet coap_pkt_registration = {
+		.header = { .ver = 1,
+			    .type = TYPE_CON,
+			    .TKL = 1,
+			    .code = CODE_REQ_GET,
+			    .MID = 0x0 },
+		.token = token,
+		.options_cnt = 2,
+		.options = { { .delta = 6,
+			       .len = sizeof(observe_val),
+			       .value = observe_val,
+			       .option_number = OBSERVE },
+			     { .delta = 5,
+			       .len = sizeof(uri_path_val),
+			       .value = uri_path_val,
+			       .option_number = URI_PATH } },
+		.payload.len = 0,
+		.payload.ptr = NULL,
+	};
+	uint8_t ser_coap_pkt[40];
+	uint32_t ser_coap_pkt_len = sizeof(ser_coap_pkt);
+	uint8_t ser_oscore_pkt[40];
+	uint32_t ser_oscore_pkt_len = sizeof(ser_oscore_pkt);
+	r = coap_serialize(&coap_pkt_registration, ser_coap_pkt,
+			   &ser_coap_pkt_len);
+	zassert_equal(r, ok, "Error in coap_serialize");
+	r = coap2oscore(ser_coap_pkt, ser_coap_pkt_len, ser_oscore_pkt,
+			&ser_oscore_pkt_len, &c_client);
+	zassert_equal(r, ok, "Error in coap2oscore!");
+
+	uint8_t ser_conv_coap_pkt[40];
+	uint32_t ser_conv_coap_pkt_len = sizeof(ser_conv_coap_pkt);
+	r = oscore2coap(ser_oscore_pkt, ser_oscore_pkt_len, ser_conv_coap_pkt,
+			&ser_conv_coap_pkt_len, &c_server);
+	zassert_equal(r, ok, "Error in oscore2coap!");
+	ser_conv_coap_pkt_len = sizeof(ser_conv_coap_pkt);
+	r = oscore2coap(ser_oscore_pkt, ser_oscore_pkt_len, ser_conv_coap_pkt,
+			&ser_conv_coap_pkt_len, &c_server_single);
+	zassert_equal(r, ok, "Error in oscore2coap!");
+
+	/*three notifications and an empty ACK*/
+	uint8_t notification_val[3][1] = { { 0x01 }, { 0x02 }, { 0x03 } };
+	uint8_t ser_coap_pkts[4][40];
+	uint32_t ser_coap_pkts_len[4];
+	for (uint8_t i = 0; i < 3; i++) {
+		struct o_coap_packet coap_pkt_notification = {
+			.header = { .ver = 1,
+				    .type = TYPE_NON,
+				    .TKL = 1,
+				    .code = CODE_RESP_CONTENT,
+				    .MID = i },
+			.token = token,
+			.options_cnt = 1,
+			.options = { { .delta = 6,
+				       .len = 1,
+				       .value = notification_val[i],
+				       .option_number = OBSERVE } },
+			.payload.len = 0,
+			.payload.ptr = NULL,
+		};
+		uint8_t pos = (uint8_t)((i < 2) ? i : 3);
+		ser_coap_pkts_len[pos] = sizeof(ser_coap_pkts[pos]);
+		r = coap_serialize(&coap_pkt_notification, ser_coap_pkts[pos],
+				   &ser_coap_pkts_len[pos]);
+		zassert_equal(r, ok, "Error in coap_serialize");
+	}
+	const uint8_t COAP_ACK[] = { 0x60, 0x00, 0x00, 0x05 };
+	memcpy(ser_coap_pkts[2], COAP_ACK, sizeof(COAP_ACK));
+	ser_coap_pkts_len[2] = sizeof(COAP_ACK);
+
+	uint8_t batch_out[4][40];
+	struct oscore_batch_pkt pkts[4];
+	for (uint8_t i = 0; i < 4; i++) {
+		pkts[i].buf_in = ser_coap_pkts[i];
+		pkts[i].buf_in_len = ser_coap_pkts_len[i];
+		pkts[i].buf_out = batch_out[i];
+		pkts[i].buf_out_len = sizeof(batch_out[i]);
+	}
+	r = coap2oscore_batch(pkts, 4, &c_server);
+	zassert_equal(r, ok, "Error in coap2oscore_batch!");
+
+	for (uint8_t i = 0; i < 4; i++) {
+		zassert_equal(pkts[i].result, ok,
+			      "Error in coap2oscore_batch for packet %d", i);
+
+		uint8_t single_out[40];
+		uint32_t single_out_len = sizeof(single_out);
+		r = coap2oscore(ser_coap_pkts[i], ser_coap_pkts_len[i],
+				single_out, &single_out_len, &c_server_single);
+		zassert_equal(r, ok, "Error in coap2oscore!");
+		zassert_equal(pkts[i].buf_out_len, single_out_len,
+			      "wrong length of packet %d", i);
+		zassert_mem_equal__(batch_out[i], single_out, single_out_len,
+				    "coap2oscore_batch failed");
+
+		/*the client can decrypt every notification*/
+		if (2 != i) {
+			ser_conv_coap_pkt_len = sizeof(ser_conv_coap_pkt);
+			r = oscore2coap(batch_out[i], pkts[i].buf_out_len,
+					ser_conv_coap_pkt,
+					&ser_conv_coap_pkt_len, &c_client);
+			zassert_equal(r, ok, "Error in oscore2coap!");
+		}
+	}
+
+	/*the ACK did not use a SSN*/
+	zassert_equal(c_server.sc.ssn, c_server_single.sc.ssn,
+		      "wrong SSN after coap2oscore_batch");
+	zassert_equal(c_server.sc.ssn, 3, "wrong SSN after coap2oscore_batch");
+
+	r = oscore_context_deinit(&c_client);
+	zassert_equal(r, ok, "Error in oscore_context_deinit");
+	r = oscore_context_deinit(&c_server);
+	zassert_equal(r, ok, "Error in oscore_context_deinit");
+	r = oscore_context_deinit(&c_server_single);
+	zassert_equal(r, ok, "Error in oscore_context_deinit");
+}
+
+/**
+ * Test 13:
+ * oscore2coap_batch() routes requests of two clients to the matching server 
+ * contexts. A packet repeated within the batch or in a later batch is 
+ * rejected as replayed, a packet with an unknown KID is not routed.
+ */
+void t13_oscore_batch_requests(void)
+{
+	enum err r;
+	uint8_t sender_id2[] = { 0x05 };
+	uint8_t recipient_id2[] = { 0x06 };
+	struct oscore_init_params params_client2 = {
+		.master_secret.ptr = (uint8_t *)T1__MASTER_SECRET,
+		.master_secret.len = T1__MASTER_SECRET_LEN,
+		.sender_id = BYTE_ARRAY_INIT(sender_id2, sizeof(sender_id2)),
+		.recipient_id =
+			BYTE_ARRAY_INIT(recipient_id2, sizeof(recipient_id2)),
+		.master_salt.ptr = (uint8_t *)T1__MASTER_SALT,
+		.master_salt.len = T1__MASTER_SALT_LEN,
+		.id_context.ptr = (uint8_t *)T1__ID_CONTEXT,
+		.id_context.len = T1__ID_CONTEXT_LEN,
+		.aead_alg = OSCORE_AES_CCM_16_64_128,
+		.hkdf = OSCORE_SHA_256,
+		.fresh_master_secret_salt = true,
+	};
+	struct oscore_init_params params_server2 = {
+		.master_secret.ptr = (uint8_t *)T1__MASTER_SECRET,
+		.master_secret.len = T1__MASTER_SECRET_LEN,
+		.sender_id =
+			BYTE_ARRAY_INIT(recipient_id2, sizeof(recipient_id2)),
+		.recipient_id = BYTE_ARRAY_INIT(sender_id2, sizeof(sender_id2)),
+		.master_salt.ptr = (uint8_t *)T1__MASTER_SALT,
+		.master_salt.len = T1__MASTER_SALT_LEN,
+		.id_context.ptr = (uint8_t *)T1__ID_CONTEXT,
+		.id_context.len = T1__ID_CONTEXT_LEN,
+		.aead_alg = OSCORE_AES_CCM_16_64_128,
+		.hkdf = OSCORE_SHA_256,
+		.fresh_master_secret_salt = true,
+	};
+	struct oscore_init_params params_client1 =
+		get_default_params(NORMAL, FRESH);
+	struct oscore_init_params params_server1 =
+		get_default_params(REVERSED, FRESH);
+
+	struct oscore_init_params params_client3 =
+		get_default_params(REVERSED, FRESH);
+
+	struct context c_client1, c_client2, c_client3, c_server1, c_server2;
+	r = oscore_context_init(&params_client1, &c_client1);
+	zassert_equal(r, ok, "Error in oscore_context_init");
+	r = oscore_context_init(&params_client3, &c_client3);
+	zassert_equal(r, ok, "Error in oscore_context_init");
+	r = oscore_context_init(&params_client2, &c_client2);
+	zassert_equal(r, ok, "Error in oscore_context_init");
+	r = oscore_context_init(&params_server1, &c_server1);
+	zassert_equal(r, ok, "Error in oscore_context_init");
+	r = oscore_context_init(&params_server2, &c_server2);
+	zassert_equal(r, ok, "Error in oscore_context_init");
+
+	/*requests of both clients and a request with an unknown KID*/
+	uint8_t oscore_reqs[3][64];
+	uint32_t oscore_reqs_len[3] = { sizeof(oscore_reqs[0]),
+					sizeof(oscore_reqs[1]),
+					sizeof(oscore_reqs[2]) };
+	r = coap2oscore((uint8_t *)T1__COAP_REQ, T1__COAP_REQ_LEN,
+			oscore_reqs[0], &oscore_reqs_len[0], &c_client1);
+	zassert_equal(r, ok, "Error in coap2oscore!");
+	r = coap2oscore((uint8_t *)T1__COAP_REQ, T1__COAP_REQ_LEN,
+			oscore_reqs[1], &oscore_reqs_len[1], &c_client2);
+	zassert_equal(r, ok, "Error in coap2oscore!");
+	/*the server's own Sender ID is not a known KID*/
+	r = coap2oscore((uint8_t *)T1__COAP_REQ, T1__COAP_REQ_LEN,
+			oscore_reqs[2], &oscore_reqs_len[2], &c_client3);
+	zassert_equal(r, ok, "Error in coap2oscore!");
+
+	struct context *contexts[] = { &c_server1, &c_server2 };
+	uint8_t coap_out[4][64];
+	struct oscore_batch_pkt pkts[4] = {
+		{ .buf_in = oscore_reqs[0], .buf_in_len = oscore_reqs_len[0] },
+		{ .buf_in = oscore_reqs[1], .buf_in_len = oscore_reqs_len[1] },
+		{ .buf_in = oscore_reqs[0], .buf_in_len = oscore_reqs_len[0] },
+		{ .buf_in = oscore_reqs[2], .buf_in_len = oscore_reqs_len[2] },
+	};
+	for (uint8_t i = 0; i < 4; i++) {
+		pkts[i].buf_out = coap_out[i];
+		pkts[i].buf_out_len = sizeof(coap_out[i]);
+	}
+
+	r = oscore2coap_batch(pkts, 4, contexts, 2);
+	zassert_equal(r, oscore_replay_window_protection_error,
+		      "Error in oscore2coap_batch!");
+	zassert_equal(pkts[0].result, ok, "wrong result of packet 0");
+	zassert_equal(pkts[0].c, &c_server1, "wrong context of packet 0");
+	zassert_equal(pkts[0].buf_out_len, T1__COAP_REQ_LEN,
+		      "wrong length of packet 0");
+	zassert_mem_equal__(coap_out[0], T1__COAP_REQ, T1__COAP_REQ_LEN,
+			    "oscore2coap_batch failed");
+	zassert_equal(pkts[1].result, ok, "wrong result of packet 1");
+	zassert_equal(pkts[1].c, &c_server2, "wrong context of packet 1");
+	zassert_mem_equal__(coap_out[1], T1__COAP_REQ, T1__COAP_REQ_LEN,
+			    "oscore2coap_batch failed");
+	zassert_equal(pkts[2].result, oscore_replay_window_protection_error,
+		      "replay within the batch not detected");
+	zassert_equal(pkts[3].result, oscore_kid_recipient_id_mismatch,
+		      "unknown KID not detected");
+	zassert_is_null(pkts[3].c, "packet with unknown KID routed");
+
+	/*the replay is rejected before decryption in a later batch*/
+	pkts[1].buf_out_len = sizeof(coap_out[1]);
+	r = oscore2coap_batch(&pkts[1], 1, contexts, 2);
+	zassert_equal(r, oscore_replay_window_protection_error,
+		      "replay in a later batch not detected");
+	zassert_equal(pkts[1].c, &c_server2, "wrong context of packet 1");
+
+	r = oscore_context_deinit(&c_client1);
+	zassert_equal(r, ok, "Error in oscore_context_deinit");
+	r = oscore_context_deinit(&c_client2);
+	zassert_equal(r, ok, "Error in oscore_context_deinit");
+	r = oscore_context_deinit(&c_client3);
+	zassert_equal(r, ok, "Error in oscore_context_deinit");
+	r = oscore_context_deinit(&c_server1);
+	zassert_equal(r, ok, "Error in oscore_context_deinit");
+	r = oscore_context_deinit(&c_server2);
+	zassert_equal(r, ok, "Error in oscore_context_deinit");
+}
+
+void t14_oscore_context_table(void)
+{
+	enum err r;
+	uint8_t sender_id2[] = { 0x05 };
+	uint8_t recipient_id2[] = { 0x06 };
+	struct oscore_init_params params_client2 = {
+		.master_secret.ptr = (uint8_t *)T1__MASTER_SECRET,
+		.master_secret.len = T1__MASTER_SECRET_LEN,
+		.sender_id = BYTE_ARRAY_INIT(sender_id2, sizeof(sender_id2)),
+		.recipient_id =
+			BYTE_ARRAY_INIT(recipient_id2, sizeof(recipient_id2)),
+		.master_salt.ptr = (uint8_t *)T1__MASTER_SALT,
+		.master_salt.len = T1__MASTER_SALT_LEN,
+		.aead_alg = OSCORE_AES_CCM_16_64_128,
+		.hkdf = OSCORE_SHA_256,
+		.fresh_master_secret_salt = true,
+	};
+	struct oscore_init_params params_server2 = {
+		.master_secret.ptr = (uint8_t *)T1__MASTER_SECRET,
+		.master_secret.len = T1__MASTER_SECRET_LEN,
+		.sender_id =
+			BYTE_ARRAY_INIT(recipient_id2, sizeof(recipient_id2)),
+		.recipient_id = BYTE_ARRAY_INIT(sender_id2, sizeof(sender_id2)),
+		.master_salt.ptr = (uint8_t *)T1__MASTER_SALT,
+		.master_salt.len = T1__MASTER_SALT_LEN,
+		.aead_alg = OSCORE_AES_CCM_16_64_128,
+		.hkdf = OSCORE_SHA_256,
+		.fresh_master_secret_salt = true,
+	};
+	struct oscore_init_params params_client1 =
+		get_default_params(NORMAL, FRESH);
+	struct oscore_init_params params_server1 =
+		get_default_params(REVERSED, FRESH);
+	struct oscore_init_params params_client3 =
+		get_default_params(REVERSED, FRESH);
+
+	struct context c_client1, c_client2, c_client3, c_server1, c_server2;
+	r = oscore_context_init(&params_client1, &c_client1);
+	zassert_equal(r, ok, "Error in oscore_context_init");
+	r = oscore_context_init(&params_client2, &c_client2);
+	zassert_equal(r, ok, "Error in oscore_context_init");
+	r = oscore_context_init(&params_client3, &c_client3);
+	zassert_equal(r, ok, "Error in oscore_context_init");
+	r = oscore_context_init(&params_server1, &c_server1);
+	zassert_equal(r, ok, "Error in oscore_context_init");
+	r = oscore_context_init(&params_server2, &c_server2);
+	zassert_equal(r, ok, "Error in oscore_context_init");
+
+	struct context *server_slots[8];
+	struct oscore_context_table server_table;
+	r = oscore_context_table_init(&server_table, server_slots, 8);
+	zassert_equal(r, ok, "Error in oscore_context_table_init");
+	r = oscore_context_table_insert(&server_table, &c_server1);
+	zassert_equal(r, ok, "Error in oscore_context_table_insert");
+	r = oscore_context_table_insert(&server_table, &c_server2);
+	zassert_equal(r, ok, "Error in oscore_context_table_insert");
+
+	struct context *client_slots[4];
+	struct oscore_context_table client_table;
+	r = oscore_context_table_init(&client_table, client_slots, 4);
+	zassert_equal(r, ok, "Error in oscore_context_table_init");
+	r = oscore_context_table_insert(&client_table, &c_client1);
+	zassert_equal(r, ok, "Error in oscore_context_table_insert");
+	r = oscore_context_table_insert(&client_table, &c_client2);
+	zassert_equal(r, ok, "Error in oscore_context_table_insert");
+
+	uint8_t buf_oscore[64];
+	uint32_t buf_oscore_len = sizeof(buf_oscore);
+	uint8_t buf_coap[64];
+	uint32_t buf_coap_len = sizeof(buf_coap);
+	struct context *c;
+
+	/*a request of client 1 is routed to server context 1*/
+	r = coap2oscore((uint8_t *)T1__COAP_REQ, T1__COAP_REQ_LEN, buf_oscore,
+			&buf_oscore_len, &c_client1);
+	zassert_equal(r, ok, "Error in coap2oscore!");
+	r = oscore2coap_table(buf_oscore, buf_oscore_len, buf_coap,
+			      &buf_coap_len, &server_table, &c);
+	zassert_equal(r, ok, "Error in oscore2coap_table! r: %d", r);
+	zassert_equal_ptr(c, &c_server1, "wrong context");
+	zassert_mem_equal__(buf_coap, T1__COAP_REQ, T1__COAP_REQ_LEN,
+			    "oscore2coap_table failed");
+
+	/*the response is routed to client context 1 by its token*/
+	buf_oscore_len = sizeof(buf_oscore);
+	r = coap2oscore((uint8_t *)T1__COAP_RESPONSE, T1__COAP_RESPONSE_LEN,
+			buf_oscore, &buf_oscore_len, &c_server1);
+	zassert_equal(r, ok, "Error in coap2oscore!");
+	buf_coap_len = sizeof(buf_coap);
+	r = oscore2coap_table(buf_oscore, buf_oscore_len, buf_coap,
+			      &buf_coap_len, &client_table, &c);
+	zassert_equal(r, ok, "Error in oscore2coap_table! r: %d", r);
+	zassert_equal_ptr(c, &c_client1, "wrong context");
+	zassert_mem_equal__(buf_coap, T1__COAP_RESPONSE, T1__COAP_RESPONSE_LEN,
+			    "oscore2coap_table failed");
+
+	/*a request of client 2 is routed to server context 2*/
+	buf_oscore_len = sizeof(buf_oscore);
+	r = coap2oscore((uint8_t *)T1__COAP_REQ, T1__COAP_REQ_LEN, buf_oscore,
+			&buf_oscore_len, &c_client2);
+	zassert_equal(r, ok, "Error in coap2oscore!");
+	buf_coap_len = sizeof(buf_coap);
+	r = oscore2coap_table(buf_oscore, buf_oscore_len, buf_coap,
+			      &buf_coap_len, &server_table, &c);
+	zassert_equal(r, ok, "Error in oscore2coap_table! r: %d", r);
+	zassert_equal_ptr(c, &c_server2, "wrong context");
+
+	/*the server's own Sender ID is not a known KID*/
+	buf_oscore_len = sizeof(buf_oscore);
+	r = coap2oscore((uint8_t *)T1__COAP_REQ, T1__COAP_REQ_LEN, buf_oscore,
+			&buf_oscore_len, &c_client3);
+	zassert_equal(r, ok, "Error in coap2oscore!");
+	buf_coap_len = sizeof(buf_coap);
+	r = oscore2coap_table(buf_oscore, buf_oscore_len, buf_coap,
+			      &buf_coap_len, &server_table, &c);
+	zassert_equal(r, oscore_kid_recipient_id_mismatch,
+		      "unknown KID not detected");
+	zassert_is_null(c, "packet with unknown KID routed");
+
+	/*a request without KID context matches a context with an ID Context
+	and its KID as Recipient ID. The KID context is not part of the AAD,
+	so the request of C.6 stays valid without it*/
+	struct oscore_init_params params_server3 = {
+		.master_secret.ptr = (uint8_t *)T6__MASTER_SECRET,
+		.master_secret.len = T6__MASTER_SECRET_LEN,
+		.sender_id.ptr = (uint8_t *)T6__SENDER_ID,
+		.sender_id.len = T6__SENDER_ID_LEN,
+		.recipient_id.ptr = (uint8_t *)T6__RECIPIENT_ID,
+		.recipient_id.len = T6__RECIPIENT_ID_LEN,
+		.master_salt.ptr = (uint8_t *)T6__MASTER_SALT,
+		.master_salt.len = T6__MASTER_SALT_LEN,
+		.id_context.ptr = (uint8_t *)T6__ID_CONTEXT,
+		.id_context.len = T6__ID_CONTEXT_LEN,
+		.aead_alg = OSCORE_AES_CCM_16_64_128,
+		.hkdf = OSCORE_SHA_256,
+		.fresh_master_secret_salt = true,
+	};
+	struct context c_server3;
+	r = oscore_context_init(&params_server3, &c_server3);
+	zassert_equal(r, ok, "Error in oscore_context_init");
+
+	/*header, token and Uri-Host are kept, the OSCORE option is replaced
+	by one with the flags and the PIV only*/
+	uint8_t buf[64];
+	memcpy(buf, T5__OSCORE_REQ, 18);
+	buf[18] = 0x62;
+	buf[19] = 0x09;
+	buf[20] = 0x14;
+	memcpy(&buf[21], &T5__OSCORE_REQ[30], T5__OSCORE_REQ_LEN - 30);
+	uint32_t buf_len = 21 + T5__OSCORE_REQ_LEN - 30;
+
+	struct oscore_context_store store;
+	struct oscore_context_shard shards[2];
+	struct context *store_slots[2 * 4];
+	r = oscore_context_store_init(&store, shards, 2, store_slots, 4);
+	zassert_equal(r, ok, "Error in oscore_context_store_init");
+	r = oscore_context_store_insert(&store, &c_server2);
+	zassert_equal(r, ok, "Error in oscore_context_store_insert");
+	r = oscore_context_store_insert(&store, &c_server3);
+	zassert_equal(r, ok, "Error in oscore_context_store_insert");
+	r = oscore_prefilter_store(buf, buf_len, &store, &c);
+	zassert_equal(r, ok, "Error in oscore_prefilter_store! r: %d", r);
+	zassert_equal_ptr(c, &c_server3, "wrong context");
+
+	struct context *id_context_slots[4];
+	struct oscore_context_table id_context_table;
+	r = oscore_context_table_init(&id_context_table, id_context_slots, 4);
+	zassert_equal(r, ok, "Error in oscore_context_table_init");
+	r = oscore_context_table_insert(&id_context_table, &c_server3);
+	zassert_equal(r, ok, "Error in oscore_context_table_insert");
+	buf_coap_len = sizeof(buf_coap);
+	r = oscore2coap_table(buf, buf_len, buf_coap, &buf_coap_len,
+			      &id_context_table, &c);
+	zassert_equal(r, ok, "Error in oscore2coap_table! r: %d", r);
+	zassert_equal_ptr(c, &c_server3, "wrong context");
+	zassert_mem_equal__(buf_coap, T5__COAP_REQ, T5__COAP_REQ_LEN,
+			    "oscore2coap_table failed");
+
+	/*the exact match is preferred, the request then belongs to the context
+	without an ID Context*/
+	r = oscore_context_table_insert(&server_table, &c_server3);
+	zassert_equal(r, ok, "Error in oscore_context_table_insert");
+	r = oscore_prefilter_table(buf, buf_len, &server_table, &c);
+	zassert_equal_ptr(c, &c_server1, "wrong context");
+
+	r = oscore_context_deinit(&c_server3);
+	zassert_equal(r, ok, "Error in oscore_context_deinit");
+	r = oscore_context_deinit(&c_client1);
+	zassert_equal(r, ok, "Error in oscore_context_deinit");
+	r = oscore_context_deinit(&c_client2);
+	zassert_equal(r, ok, "Error in oscore_context_deinit");
+	r = oscore_context_deinit(&c_client3);
+	zassert_equal(r, ok, "Error in oscore_context_deinit");
+	r = oscore_context_deinit(&c_server1);
+	zassert_equal(r, ok, "Error in oscore_context_deinit");
+	r = oscore_context_deinit(&c_server2);
+	zassert_equal(r, ok, "Error in oscore_context_deinit");
+}
+
+/**
+ * @brief Send requests with SSNs taken from blocks, e.g., of two worker 
+ *        threads sharing one client context. The blocks are disjoint and the 
+ *        server accepts the requests in any order.
+ */
+static void ssn_block_request_send(struct context *c_client,
+				   struct context *c_server,
+				   struct oscore_ssn_block *block)
+{
+	uint8_t buf_oscore[64];
+	uint32_t buf_oscore_len = sizeof(buf_oscore);
+	uint8_t buf_coap[64];
+	uint32_t buf_coap_len = sizeof(buf_coap);
+
+	enum err r = coap2oscore_ssn_block((uint8_t *)T1__COAP_REQ,
+					   T1__COAP_REQ_LEN, buf_oscore,
+					   &buf_oscore_len, c_client, block);
+	zassert_equal(r, ok, "Error in coap2oscore_ssn_block! r: %d", r);
+	r = oscore2coap(buf_oscore, buf_oscore_len, buf_coap, &buf_coap_len,
+			c_server);
+	zassert_equal(r, ok, "Error in oscore2coap! r: %d", r);
+	zassert_mem_equal__(buf_coap, T1__COAP_REQ, T1__COAP_REQ_LEN,
+			    "oscore2coap failed");
+}
+
+void t15_oscore_ssn_blocks(void)
+{
+	enum err r;
+	struct oscore_init_params params_client =
+		get_default_params(NORMAL, FRESH);
+	struct oscore_init_params params_server =
+		get_default_params(REVERSED, FRESH);
+	struct context c_client, c_server;
+	r = oscore_context_init(&params_client, &c_client);
+	zassert_equal(r, ok, "Error in oscore_context_init");
+	r = oscore_context_init(&params_server, &c_server);
+	zassert_equal(r, ok, "Error in oscore_context_init");
+
+	struct oscore_ssn_block block_a, block_b;
+	r = oscore_ssn_block_reserve(&c_client, 0, &block_a);
+	zassert_equal(r, wrong_parameter, "r: %d", r);
+	r = oscore_ssn_block_reserve(&c_client, 4, &block_a);
+	zassert_equal(r, ok, "Error in oscore_ssn_block_reserve");
+	r = oscore_ssn_block_reserve(&c_client, 4, &block_b);
+	zassert_equal(r, ok, "Error in oscore_ssn_block_reserve");
+	zassert_equal(block_a.next, 0, "wrong block");
+	zassert_equal(block_a.end, 4, "wrong block");
+	zassert_equal(block_b.next, 4, "wrong block");
+	zassert_equal(block_b.end, 8, "wrong block");
+	zassert_equal(c_client.sc.ssn, 8, "wrong SSN");
+
+	/*the requests of block b overtake the ones of block a*/
+	ssn_block_request_send(&c_client, &c_server, &block_b);
+	for (uint8_t i = 0; i < 4; i++) {
+		ssn_block_request_send(&c_client, &c_server, &block_a);
+	}
+	zassert_equal(block_a.next, 4, "wrong block");
+
+	/*a used up block is replaced by a new one*/
+	ssn_block_request_send(&c_client, &c_server, &block_a);
+	zassert_equal(block_a.next, 9, "wrong block");
+	zassert_equal(block_a.end, 12, "wrong block");
+
+	/*coap2oscore() continues after the reserved blocks*/
+	ssn_block_request_send(&c_client, &c_server, &block_b);
+	uint8_t buf_oscore[64];
+	uint32_t buf_oscore_len = sizeof(buf_oscore);
+	r = coap2oscore((uint8_t *)T1__COAP_REQ, T1__COAP_REQ_LEN, buf_oscore,
+			&buf_oscore_len, &c_client);
+	zassert_equal(r, ok, "Error in coap2oscore!");
+	zassert_equal(c_client.sc.ssn, 13, "wrong SSN");
+
+	/*the last block is cut at the SSN limit*/
+	c_client.sc.ssn = OSCORE_SSN_OVERFLOW_VALUE - 2;
+	r = oscore_ssn_block_reserve(&c_client, 4, &block_a);
+	zassert_equal(r, ok, "Error in oscore_ssn_block_reserve");
+	zassert_equal(block_a.end, OSCORE_SSN_OVERFLOW_VALUE, "wrong block");
+	r = oscore_ssn_block_reserve(&c_client, 4, &block_b);
+	zassert_equal(r, oscore_ssn_overflow, "r: %d", r);
+
+	r = oscore_context_deinit(&c_client);
+	zassert_equal(r, ok, "Error in oscore_context_deinit");
+	r = oscore_context_deinit(&c_server);
+	zassert_equal(r, ok, "Error in oscore_context_deinit");
+}
+
+void t16_oscore_in_place_request(void)
+{
+	enum err r;
+	struct context c_client, c_server;
+	struct oscore_init_params params_client =
+		get_default_params(NORMAL, RESTORED);
+	r = oscore_context_init(&params_client, &c_client);
+	zassert_equal(r, ok, "Error in oscore_context_init");
+
+	/*the required size is reported without using an SSN*/
+	uint8_t buf_oscore[256];
+	uint32_t buf_oscore_len = 10;
+	r = coap2oscore_in_place((uint8_t *)T1__COAP_REQ, T1__COAP_REQ_LEN,
+				 buf_oscore, &buf_oscore_len, &c_client);
+	zassert_equal(r, buffer_to_small, "r: %d", r);
+	zassert_equal(buf_oscore_len, T1__OSCORE_REQ_LEN, "wrong size %d",
+		      buf_oscore_len);
+	zassert_equal(c_client.sc.ssn, 20, "SSN used");
+
+	/*the same packet as with coap2oscore()*/
+	r = coap2oscore_in_place((uint8_t *)T1__COAP_REQ, T1__COAP_REQ_LEN,
+				 buf_oscore, &buf_oscore_len, &c_client);
+	zassert_equal(r, ok, "Error in coap2oscore_in_place! r: %d", r);
+	zassert_equal(buf_oscore_len, T1__OSCORE_REQ_LEN, "wrong length");
+	zassert_mem_equal__(buf_oscore, T1__OSCORE_REQ, T1__OSCORE_REQ_LEN,
+			    "coap2oscore_in_place failed");
+	r = oscore_context_deinit(&c_client);
+	zassert_equal(r, ok, "Error in oscore_context_deinit");
+
+	/*a request with a payload*/
+	struct oscore_init_params params_fresh_client =
+		get_default_params(NORMAL, FRESH);
+	struct oscore_init_params params_server =
+		get_default_params(REVERSED, FRESH);
+	r = oscore_context_init(&params_fresh_client, &c_client);
+	zassert_equal(r, ok, "Error in oscore_context_init");
+	r = oscore_context_init(&params_server, &c_server);
+	zassert_equal(r, ok, "Error in oscore_context_init");
+
+	uint8_t buf_coap[200];
+	memcpy(buf_coap, T1__COAP_REQ, T1__COAP_REQ_LEN);
+	buf_coap[1] = CODE_REQ_POST;
+	buf_coap[T1__COAP_REQ_LEN] = 0xff;
+	for (uint32_t i = T1__COAP_REQ_LEN + 1; i < sizeof(buf_coap); i++) {
+		buf_coap[i] = (uint8_t)i;
+	}
+	buf_oscore_len = sizeof(buf_oscore);
+	r = coap2oscore_in_place(buf_coap, sizeof(buf_coap), buf_oscore,
+				 &buf_oscore_len, &c_client);
+	zassert_equal(r, ok, "Error in coap2oscore_in_place! r: %d", r);
+
+	uint8_t buf_out[256];
+	uint32_t buf_out_len = sizeof(buf_out);
+	r = oscore2coap(buf_oscore, buf_oscore_len, buf_out, &buf_out_len,
+			&c_server);
+	zassert_equal(r, ok, "Error in oscore2coap! r: %d", r);
+	zassert_equal(buf_out_len, sizeof(buf_coap), "wrong length");
+	zassert_mem_equal__(buf_out, buf_coap, sizeof(buf_coap),
+			    "oscore2coap failed");
+
+	r = oscore_context_deinit(&c_client);
+	zassert_equal(r, ok, "Error in oscore_context_deinit");
+	r = oscore_context_deinit(&c_server);
+	zassert_equal(r, ok, "Error in oscore_context_deinit");
+}
+
+void t17_oscore_in_place_unprotect(void)
+{
+	enum err r;
+	struct context c_client, c_server;
+	struct oscore_init_params params_server = {
+		.master_secret.ptr = (uint8_t *)T2__MASTER_SECRET,
+		.master_secret.len = T2__MASTER_SECRET_LEN,
+		.sender_id.ptr = (uint8_t *)T2__SENDER_ID,
+		.sender_id.len = T2__SENDER_ID_LEN,
+		.recipient_id.ptr = (uint8_t *)T2__RECIPIENT_ID,
+		.recipient_id.len = T2__RECIPIENT_ID_LEN,
+		.master_salt.ptr = (uint8_t *)T2__MASTER_SALT,
+		.master_salt.len = T2__MASTER_SALT_LEN,
+		.id_context.ptr = (uint8_t *)T2__ID_CONTEXT,
+		.id_context.len = T2__ID_CONTEXT_LEN,
+		.aead_alg = OSCORE_AES_CCM_16_64_128,
+		.hkdf = OSCORE_SHA_256,
+		.fresh_master_secret_salt = true,
+	};
+	r = oscore_context_init(&params_server, &c_server);
+	zassert_equal(r, ok, "Error in oscore_context_init");
+
+	/*the request of Appendix C.5 decrypted in its own buffer*/
+	uint8_t buf[256];
+	uint8_t *coap;
+	uint32_t coap_len;
+	memcpy(buf, T2__OSCORE_REQ, T2__OSCORE_REQ_LEN);
+	r = oscore2coap_in_place(buf, T2__OSCORE_REQ_LEN, &coap, &coap_len,
+				 &c_server);
+	zassert_equal(r, ok, "Error in oscore2coap_in_place! r: %d", r);
+	zassert_true((coap >= buf) && (coap + coap_len <= buf + sizeof(buf)),
+		     "CoAP packet not in the buffer");
+	zassert_equal(coap_len, T2__COAP_REQ_LEN, "wrong length %d", coap_len);
+	zassert_mem_equal__(coap, T2__COAP_REQ, T2__COAP_REQ_LEN,
+			    "oscore2coap_in_place failed");
+
+	/*the replayed request is rejected*/
+	memcpy(buf, T2__OSCORE_REQ, T2__OSCORE_REQ_LEN);
+	r = oscore2coap_in_place(buf, T2__OSCORE_REQ_LEN, &coap, &coap_len,
+				 &c_server);
+	zassert_equal(r, oscore_replay_window_protection_error, "r: %d", r);
+	r = oscore_context_deinit(&c_server);
+	zassert_equal(r, ok, "Error in oscore_context_deinit");
+
+	/*a request with a payload*/
+	struct oscore_init_params params_client =
+		get_default_params(NORMAL, FRESH);
+	struct oscore_init_params params_fresh_server =
+		get_default_params(REVERSED, FRESH);
+	r = oscore_context_init(&params_client, &c_client);
+	zassert_equal(r, ok, "Error in oscore_context_init");
+	r = oscore_context_init(&params_fresh_server, &c_server);
+	zassert_equal(r, ok, "Error in oscore_context_init");
+
+	uint8_t buf_coap[200];
+	memcpy(buf_coap, T1__COAP_REQ, T1__COAP_REQ_LEN);
+	buf_coap[1] = CODE_REQ_POST;
+	buf_coap[T1__COAP_REQ_LEN] = 0xff;
+	for (uint32_t i = T1__COAP_REQ_LEN + 1; i < sizeof(buf_coap); i++) {
+		buf_coap[i] = (uint8_t)i;
+	}
+	uint32_t buf_len = sizeof(buf);
+	r = coap2oscore(buf_coap, sizeof(buf_coap), buf, &buf_len, &c_client);
+	zassert_equal(r, ok, "Error in coap2oscore! r: %d", r);
+
+	r = oscore2coap_in_place(buf, buf_len, &coap, &coap_len, &c_server);
+	zassert_equal(r, ok, "Error in oscore2coap_in_place! r: %d", r);
+	zassert_equal(coap_len, sizeof(buf_coap), "wrong length %d", coap_len);
+	zassert_mem_equal__(coap, buf_coap, sizeof(buf_coap),
+			    "oscore2coap_in_place failed");
+
+	/*a manipulated packet is not accepted*/
+	buf_len = sizeof(buf);
+	r = coap2oscore(buf_coap, sizeof(buf_coap), buf, &buf_len, &c_client);
+	zassert_equal(r, ok, "Error in coap2oscore! r: %d", r);
+	buf[buf_len - 1] ^= 1;
+	r = oscore2coap_in_place(buf, buf_len, &coap, &coap_len, &c_server);
+	zassert_not_equal(r, ok, "manipulated packet accepted");
+
+	r = oscore_context_deinit(&c_client);
+	zassert_equal(r, ok, "Error in oscore_context_deinit");
+	r = oscore_context_deinit(&c_server);
+	zassert_equal(r, ok, "Error in oscore_context_deinit");
+}
+
+void t18_oscore_iov(void)
+{
+	enum err r;
+	struct context c_client, c_server;
+	struct oscore_init_params params_client =
+		get_default_params(NORMAL, RESTORED);
+	r = oscore_context_init(&params_client, &c_client);
+	zassert_equal(r, ok, "Error in oscore_context_init");
+
+	/*the required sizes are reported without using an SSN*/
+	uint8_t header_buf[64];
+	uint8_t ciphertext_buf[256];
+	struct byte_array header = BYTE_ARRAY_INIT(header_buf, 10);
+	struct byte_array ciphertext =
+		BYTE_ARRAY_INIT(ciphertext_buf, sizeof(ciphertext_buf));
+	r = coap2oscore_iov((uint8_t *)T1__COAP_REQ, T1__COAP_REQ_LEN, NULL, 0,
+			    &header, &ciphertext, &c_client);
+	zassert_equal(r, buffer_to_small, "r: %d", r);
+	zassert_equal(header.len + ciphertext.len, T1__OSCORE_REQ_LEN,
+		      "wrong size");
+	zassert_equal(c_client.sc.ssn, 20, "SSN used");
+
+	/*the segments make up the same packet as with coap2oscore()*/
+	header.len = sizeof(header_buf);
+	ciphertext.len = sizeof(ciphertext_buf);
+	r = coap2oscore_iov((uint8_t *)T1__COAP_REQ, T1__COAP_REQ_LEN, NULL, 0,
+			    &header, &ciphertext, &c_client);
+	zassert_equal(r, ok, "Error in coap2oscore_iov! r: %d", r);
+	zassert_equal(header.len + ciphertext.len, T1__OSCORE_REQ_LEN,
+		      "wrong length");
+	zassert_mem_equal__(header.ptr, T1__OSCORE_REQ, header.len,
+			    "wrong header");
+	zassert_mem_equal__(ciphertext.ptr, T1__OSCORE_REQ + header.len,
+			    ciphertext.len, "wrong ciphertext");
+	r = oscore_context_deinit(&c_client);
+	zassert_equal(r, ok, "Error in oscore_context_deinit");
+
+	/*a request with a payload in several segments*/
+	struct oscore_init_params params_fresh_client =
+		get_default_params(NORMAL, FRESH);
+	struct oscore_init_params params_server =
+		get_default_params(REVERSED, FRESH);
+	r = oscore_context_init(&params_fresh_client, &c_client);
+	zassert_equal(r, ok, "Error in oscore_context_init");
+	r = oscore_context_init(&params_server, &c_server);
+	zassert_equal(r, ok, "Error in oscore_context_init");
+
+	uint8_t buf_coap[200];
+	memcpy(buf_coap, T1__COAP_REQ, T1__COAP_REQ_LEN);
+	buf_coap[1] = CODE_REQ_POST;
+	buf_coap[T1__COAP_REQ_LEN] = 0xff;
+	for (uint32_t i = T1__COAP_REQ_LEN + 1; i < sizeof(buf_coap); i++) {
+		buf_coap[i] = (uint8_t)i;
+	}
+	uint8_t *data = buf_coap + T1__COAP_REQ_LEN + 1;
+	uint32_t data_len = sizeof(buf_coap) - T1__COAP_REQ_LEN - 1;
+	struct byte_array payload[] = {
+		BYTE_ARRAY_INIT(data, 1),
+		BYTE_ARRAY_INIT(data + 1, 0),
+		BYTE_ARRAY_INIT(data + 1, data_len - 1),
+	};
+
+	header.len = sizeof(header_buf);
+	ciphertext.len = sizeof(ciphertext_buf);
+	r = coap2oscore_iov(buf_coap, T1__COAP_REQ_LEN, payload,
+			    sizeof(payload) / sizeof(payload[0]), &header,
+			    &ciphertext, &c_client);
+	zassert_equal(r, ok, "Error in coap2oscore_iov! r: %d", r);
+
+	uint8_t buf_oscore[300];
+	uint32_t buf_oscore_len = header.len + ciphertext.len;
+	memcpy(buf_oscore, header.ptr, header.len);
+	memcpy(buf_oscore + header.len, ciphertext.ptr, ciphertext.len);
+
+	uint8_t buf_out[256];
+	uint32_t buf_out_len = sizeof(buf_out);
+	r = oscore2coap(buf_oscore, buf_oscore_len, buf_out, &buf_out_len,
+			&c_server);
+	zassert_equal(r, ok, "Error in oscore2coap! r: %d", r);
+	zassert_equal(buf_out_len, sizeof(buf_coap), "wrong length");
+	zassert_mem_equal__(buf_out, buf_coap, sizeof(buf_coap),
+			    "oscore2coap failed");
+
+	/*the same request decrypted into segments*/
+	header.len = sizeof(header_buf);
+	ciphertext.len = sizeof(ciphertext_buf);
+	r = coap2oscore_iov(buf_coap, T1__COAP_REQ_LEN, payload,
+			    sizeof(payload) / sizeof(payload[0]), &header,
+			    &ciphertext, &c_client);
+	zassert_equal(r, ok, "Error in coap2oscore_iov! r: %d", r);
+	buf_oscore_len = header.len + ciphertext.len;
+	memcpy(buf_oscore, header.ptr, header.len);
+	memcpy(buf_oscore + header.len, ciphertext.ptr, ciphertext.len);
+
+	uint8_t coap_header_buf[64];
+	uint8_t coap_payload_buf[256];
+	struct byte_array coap_header =
+		BYTE_ARRAY_INIT(coap_header_buf, sizeof(coap_header_buf));
+	struct byte_array coap_payload = BYTE_ARRAY_INIT(coap_payload_buf, 10);
+	r = oscore2coap_iov(buf_oscore, buf_oscore_len, &coap_header,
+			    &coap_payload, &c_server);
+	zassert_equal(r, buffer_to_small, "r: %d", r);
+	zassert_equal(coap_payload.len, ciphertext.len - 8, "wrong size");
+
+	r = oscore2coap_iov(buf_oscore, buf_oscore_len, &coap_header,
+			    &coap_payload, &c_server);
+	zassert_equal(r, ok, "Error in oscore2coap_iov! r: %d", r);
+	zassert_equal(coap_header.len, T1__COAP_REQ_LEN + 1, "wrong length");
+	zassert_mem_equal__(coap_header.ptr, buf_coap, coap_header.len,
+			    "wrong header");
+	zassert_equal(coap_payload.len, data_len, "wrong length");
+	zassert_mem_equal__(coap_payload.ptr, data, data_len, "wrong payload");
+
+	r = oscore_context_deinit(&c_client);
+	zassert_equal(r, ok, "Error in oscore_context_deinit");
+	r = oscore_context_deinit(&c_server);
+	zassert_equal(r, ok, "Error in oscore_context_deinit");
+}
+
+void t19_oscore_packet_api(void)
+{
+	enum err r;
+	struct context c_server;
+	struct oscore_init_params params_server = {
+		.master_secret.ptr = (uint8_t *)T2__MASTER_SECRET,
+		.master_secret.len = T2__MASTER_SECRET_LEN,
+		.sender_id.ptr = (uint8_t *)T2__SENDER_ID,
+		.sender_id.len = T2__SENDER_ID_LEN,
+		.recipient_id.ptr = (uint8_t *)T2__RECIPIENT_ID,
+		.recipient_id.len = T2__RECIPIENT_ID_LEN,
+		.master_salt.ptr = (uint8_t *)T2__MASTER_SALT,
+		.master_salt.len = T2__MASTER_SALT_LEN,
+		.id_context.ptr = (uint8_t *)T2__ID_CONTEXT,
+		.id_context.len = T2__ID_CONTEXT_LEN,
+		.aead_alg = OSCORE_AES_CCM_16_64_128,
+		.hkdf = OSCORE_SHA_256,
+		.fresh_master_secret_salt = true,
+	};
+	r = oscore_context_init(&params_server, &c_server);
+	zassert_equal(r, ok, "Error in oscore_context_init");
+
+	/*the required plaintext size is reported before decrypting*/
+	struct o_coap_packet coap;
+	uint8_t plaintext_buf[64];
+	struct byte_array plaintext = BYTE_ARRAY_INIT(plaintext_buf, 1);
+	r = oscore2coap_packet((uint8_t *)T2__OSCORE_REQ, T2__OSCORE_REQ_LEN,
+			       &plaintext, &coap, &c_server);
+	zassert_equal(r, buffer_to_small, "r: %d", r);
+	/*code and Uri-Path "tv1"*/
+	zassert_equal(plaintext.len, 5, "wrong size %d", plaintext.len);
+
+	/*the request of Appendix C.5 as a parsed packet*/
+	plaintext.len = sizeof(plaintext_buf);
+	r = oscore2coap_packet((uint8_t *)T2__OSCORE_REQ, T2__OSCORE_REQ_LEN,
+			       &plaintext, &coap, &c_server);
+	zassert_equal(r, ok, "Error in oscore2coap_packet! r: %d", r);
+	zassert_equal(coap.header.code, CODE_REQ_GET, "wrong code");
+	zassert_equal(coap.payload.len, 0, "unexpected payload");
+	zassert_true((coap.options[coap.options_cnt - 1].value >= plaintext_buf) &&
+			     (coap.options[coap.options_cnt - 1].value <
+			      plaintext_buf + plaintext.len),
+		     "E-option not in the plaintext");
+	uint8_t buf_coap[64];
+	uint32_t buf_coap_len = sizeof(buf_coap);
+	r = coap_serialize(&coap, buf_coap, &buf_coap_len);
+	zassert_equal(r, ok, "Error in coap_serialize. r: %d", r);
+	zassert_equal(buf_coap_len, T2__COAP_REQ_LEN, "wrong length");
+	zassert_mem_equal__(buf_coap, T2__COAP_REQ, T2__COAP_REQ_LEN,
+			    "oscore2coap_packet failed");
+
+	/*decrypted in place, the replayed request is rejected*/
+	uint8_t buf[64];
+	memcpy(buf, T2__OSCORE_REQ, T2__OSCORE_REQ_LEN);
+	r = oscore2coap_packet(buf, T2__OSCORE_REQ_LEN, NULL, &coap, &c_server);
+	zassert_equal(r, oscore_replay_window_protection_error, "r: %d", r);
+
+	/*the response of Appendix C.7 from a parsed packet*/
+	struct byte_array coap_resp = BYTE_ARRAY_INIT(
+		(uint8_t *)T2__COAP_RESPONSE, T2__COAP_RESPONSE_LEN);
+	memset(&coap, 0, sizeof(coap));
+	r = coap_deserialize(&coap_resp, &coap);
+	zassert_equal(r, ok, "Error in coap_deserialize. r: %d", r);
+
+	uint8_t buf_oscore[64];
+	uint32_t buf_oscore_len = 4;
+	r = coap2oscore_packet(&coap, buf_oscore, &buf_oscore_len, &c_server);
+	zassert_equal(r, buffer_to_small, "r: %d", r);
+	zassert_equal(buf_oscore_len, T2__OSCORE_RESP_LEN, "wrong size");
+	r = coap2oscore_packet(&coap, buf_oscore, &buf_oscore_len, &c_server);
+	zassert_equal(r, ok, "Error in coap2oscore_packet! r: %d", r);
+	zassert_equal(buf_oscore_len, T2__OSCORE_RESP_LEN, "wrong length");
+	zassert_mem_equal__(buf_oscore, T2__OSCORE_RESP, T2__OSCORE_RESP_LEN,
+			    "coap2oscore_packet failed");
+
+	r = oscore_context_deinit(&c_server);
+	zassert_equal(r, ok, "Error in oscore_context_deinit");
+}
+
+void t20_oscore_prefilter(void)
+{
+	enum err r;
+	struct context c_server;
+	struct oscore_init_params params_server = {
+		.master_secret.ptr = (uint8_t *)T2__MASTER_SECRET,
+		.master_secret.len = T2__MASTER_SECRET_LEN,
+		.sender_id.ptr = (uint8_t *)T2__SENDER_ID,
+		.sender_id.len = T2__SENDER_ID_LEN,
+		.recipient_id.ptr = (uint8_t *)T2__RECIPIENT_ID,
+		.recipient_id.len = T2__RECIPIENT_ID_LEN,
+		.master_salt.ptr = (uint8_t *)T2__MASTER_SALT,
+		.master_salt.len = T2__MASTER_SALT_LEN,
+		.id_context.ptr = (uint8_t *)T2__ID_CONTEXT,
+		.id_context.len = T2__ID_CONTEXT_LEN,
+		.aead_alg = OSCORE_AES_CCM_16_64_128,
+		.hkdf = OSCORE_SHA_256,
+		.fresh_master_secret_salt = true,
+	};
+	r = oscore_context_init(&params_server, &c_server);
+	zassert_equal(r, ok, "Error in oscore_context_init");
+
+	/*the request of Appendix C.5 up to its OSCORE option: header, token, 
+	Uri-Host and the OSCORE option with PIV 0x14 and an empty KID*/
+	const uint32_t header_len = 4 + 4 + 10 + 3;
+	struct o_coap_packet packet;
+	struct compressed_oscore_option oscore_option;
+	r = oscore_peek((uint8_t *)T2__OSCORE_REQ, T2__OSCORE_REQ_LEN, &packet,
+			&oscore_option);
+	zassert_equal(r, ok, "Error in oscore_peek. r: %d", r);
+	zassert_equal(packet.options_cnt, 2, "wrong options");
+	zassert_equal(packet.options[1].option_number, OSCORE, "wrong option");
+	zassert_equal(packet.payload.len, 0, "payload read");
+	zassert_equal(oscore_option.piv.len, 1, "wrong PIV");
+	zassert_equal(oscore_option.piv.ptr[0], 0x14, "wrong PIV");
+	zassert_equal(oscore_option.kid.len, 0, "wrong KID");
+
+	/*the payload is not needed to pass the filter*/
+	r = oscore_prefilter((uint8_t *)T2__OSCORE_REQ, header_len, &c_server);
+	zassert_equal(r, ok, "Error in oscore_prefilter. r: %d", r);
+
+	uint8_t buf_coap[64];
+	uint32_t buf_coap_len = sizeof(buf_coap);
+	r = oscore2coap((uint8_t *)T2__OSCORE_REQ, T2__OSCORE_REQ_LEN, buf_coap,
+			&buf_coap_len, &c_server);
+	zassert_equal(r, ok, "Error in oscore2coap. r: %d", r);
+
+	/*the replayed request is dropped, also if it was damaged after the
+	OSCORE option*/
+	uint8_t buf[64];
+	memcpy(buf, T2__OSCORE_REQ, T2__OSCORE_REQ_LEN);
+	buf[header_len + 1] ^= 0xff;
+	r = oscore_prefilter(buf, T2__OSCORE_REQ_LEN, &c_server);
+	zassert_equal(r, oscore_replay_window_protection_error, "r: %d", r);
+	buf_coap_len = sizeof(buf_coap);
+	r = oscore2coap(buf, T2__OSCORE_REQ_LEN, buf_coap, &buf_coap_len,
+			&c_server);
+	zassert_equal(r, oscore_replay_window_protection_error, "r: %d", r);
+
+	/*a KID 0x14 instead of the PIV*/
+	memcpy(buf, T2__OSCORE_REQ, T2__OSCORE_REQ_LEN);
+	buf[header_len - 2] = 0x08;
+	r = oscore_prefilter(buf, T2__OSCORE_REQ_LEN, &c_server);
+	zassert_equal(r, oscore_kid_recipient_id_mismatch, "r: %d", r);
+
+	/*malformed OSCORE options: truncated, and a KID context longer than 
+	the option*/
+	r = oscore_prefilter((uint8_t *)T2__OSCORE_REQ, header_len - 1,
+			     &c_server);
+	zassert_equal(r, not_valid_input_packet, "r: %d", r);
+	memcpy(buf, T2__OSCORE_REQ, T2__OSCORE_REQ_LEN);
+	buf[header_len - 2] = 0x19;
+	r = oscore_prefilter(buf, T2__OSCORE_REQ_LEN, &c_server);
+	zassert_equal(r, not_valid_input_packet, "r: %d", r);
+
+	/*the context is found in a table*/
+	struct context *slots[4];
+	struct oscore_context_table table;
+	struct context *c;
+	r = oscore_context_table_init(&table, slots, 4);
+	zassert_equal(r, ok, "Error in oscore_context_table_init");
+	r = oscore_context_table_insert(&table, &c_server);
+	zassert_equal(r, ok, "Error in oscore_context_table_insert");
+	r = oscore_prefilter_table((uint8_t *)T2__OSCORE_REQ,
+				   T2__OSCORE_REQ_LEN, &table, &c);
+	zassert_equal(r, oscore_replay_window_protection_error, "r: %d", r);
+	zassert_equal_ptr(c, &c_server, "wrong context");
+
+	r = oscore_context_deinit(&c_server);
+	zassert_equal(r, ok, "Error in oscore_context_deinit");
+}
+
+static uint32_t t21_time;
+
+static uint32_t t21_clock(void)
+{
+	return t21_time;
+}
+
+/**
+ * @brief   Decryption failures and replays are limited per context and 
+ *          requests with unknown KIDs by the limiter of a context table.
+ */
+void t21_oscore_rate_limit(void)
+{
+	enum err r;
+	struct context c_server;
+	struct oscore_init_params params_server = {
+		.master_secret.ptr = (uint8_t *)T2__MASTER_SECRET,
+		.master_secret.len = T2__MASTER_SECRET_LEN,
+		.sender_id.ptr = (uint8_t *)T2__SENDER_ID,
+		.sender_id.len = T2__SENDER_ID_LEN,
+		.recipient_id.ptr = (uint8_t *)T2__RECIPIENT_ID,
+		.recipient_id.len = T2__RECIPIENT_ID_LEN,
+		.master_salt.ptr = (uint8_t *)T2__MASTER_SALT,
+		.master_salt.len = T2__MASTER_SALT_LEN,
+		.id_context.ptr = (uint8_t *)T2__ID_CONTEXT,
+		.id_context.len = T2__ID_CONTEXT_LEN,
+		.aead_alg = OSCORE_AES_CCM_16_64_128,
+		.hkdf = OSCORE_SHA_256,
+		.fresh_master_secret_salt = true,
+		.failure_limit_clock = t21_clock,
+		.failure_limit_burst = 2,
+		.failure_limit_interval = 100,
+	};
+	t21_time = 0xffffff00;
+	r = oscore_context_init(&params_server, &c_server);
+	zassert_equal(r, ok, "Error in oscore_context_init");
+
+	/*two requests with a damaged payload use up the budget*/
+	uint8_t buf[64];
+	uint8_t buf_coap[64];
+	uint32_t buf_coap_len;
+	memcpy(buf, T2__OSCORE_REQ, T2__OSCORE_REQ_LEN);
+	buf[T2__OSCORE_REQ_LEN - 1] ^= 0xff;
+	for (uint32_t i = 0; i < 2; i++) {
+		buf_coap_len = sizeof(buf_coap);
+		r = oscore2coap(buf, T2__OSCORE_REQ_LEN, buf_coap,
+				&buf_coap_len, &c_server);
+		zassert_not_equal(r, ok, "damaged request accepted");
+		zassert_not_equal(r, oscore_rate_limited, "r: %d", r);
+	}
+
+	/*also the valid request is rejected until the next interval*/
+	buf_coap_len = sizeof(buf_coap);
+	r = oscore2coap((uint8_t *)T2__OSCORE_REQ, T2__OSCORE_REQ_LEN, buf_coap,
+			&buf_coap_len, &c_server);
+	zassert_equal(r, oscore_rate_limited, "r: %d", r);
+	r = oscore_prefilter((uint8_t *)T2__OSCORE_REQ, T2__OSCORE_REQ_LEN,
+			     &c_server);
+	zassert_equal(r, oscore_rate_limited, "r: %d", r);
+
+	/*one token after an interval, also if the clock wraps around*/
+	t21_time += 150;
+	buf_coap_len = sizeof(buf_coap);
+	r = oscore2coap((uint8_t *)T2__OSCORE_REQ, T2__OSCORE_REQ_LEN, buf_coap,
+			&buf_coap_len, &c_server);
+	zassert_equal(r, ok, "Error in oscore2coap. r: %d", r);
+
+	/*the replay takes the token*/
+	buf_coap_len = sizeof(buf_coap);
+	r = oscore2coap((uint8_t *)T2__OSCORE_REQ, T2__OSCORE_REQ_LEN, buf_coap,
+			&buf_coap_len, &c_server);
+	zassert_equal(r, oscore_replay_window_protection_error, "r: %d", r);
+	r = oscore_prefilter((uint8_t *)T2__OSCORE_REQ, T2__OSCORE_REQ_LEN,
+			     &c_server);
+	zassert_equal(r, oscore_rate_limited, "r: %d", r);
+
+	/*the half interval left from the last refill counts*/
+	t21_time += 50;
+	r = oscore_prefilter((uint8_t *)T2__OSCORE_REQ, T2__OSCORE_REQ_LEN,
+			     &c_server);
+	zassert_equal(r, oscore_replay_window_protection_error, "r: %d", r);
+
+	struct oscore_rate_limit_stats stats;
+	r = oscore_rate_limit_stats_get(&c_server.rc.failure_limit, &stats);
+	zassert_equal(r, ok, "Error in oscore_rate_limit_stats_get");
+	zassert_equal(stats.failures, 4, "failures: %d", stats.failures);
+	zassert_equal(stats.shed, 3, "shed: %d", stats.shed);
+
+	/*requests with an unknown KID are limited by the table*/
+	struct context *slots[4];
+	struct oscore_context_table table;
+	struct oscore_rate_limit unknown_limit;
+	struct context *c;
+	r = oscore_context_table_init(&table, slots, 4);
+	zassert_equal(r, ok, "Error in oscore_context_table_init");
+	r = oscore_context_table_insert(&table, &c_server);
+	zassert_equal(r, ok, "Error in oscore_context_table_insert");
+	r = oscore_rate_limit_init(&unknown_limit, t21_clock, 1, 100);
+	zassert_equal(r, ok, "Error in oscore_rate_limit_init");
+	r = oscore_context_table_rate_limit_set(&table, &unknown_limit);
+	zassert_equal(r, ok, "Error in oscore_context_table_rate_limit_set");
+
+	/*a KID 0x14 instead of the PIV*/
+	const uint32_t header_len = 4 + 4 + 10 + 3;
+	memcpy(buf, T2__OSCORE_REQ, T2__OSCORE_REQ_LEN);
+	buf[header_len - 2] = 0x08;
+	r = oscore_prefilter_table(buf, T2__OSCORE_REQ_LEN, &table, &c);
+	zassert_equal(r, oscore_kid_recipient_id_mismatch, "r: %d", r);
+	r = oscore_prefilter_table(buf, T2__OSCORE_REQ_LEN, &table, &c);
+	zassert_equal(r, oscore_rate_limited, "r: %d", r);
+
+	/*the known context is not affected*/
+	t21_time += 100;
+	r = oscore_prefilter_table((uint8_t *)T2__OSCORE_REQ,
+				   T2__OSCORE_REQ_LEN, &table, &c);
+	zassert_equal(r, oscore_replay_window_protection_error, "r: %d", r);
+	zassert_equal_ptr(c, &c_server, "wrong context");
+
+	r = oscore_rate_limit_stats_get(&unknown_limit, &stats);
+	zassert_equal(r, ok, "Error in oscore_rate_limit_stats_get");
+	zassert_equal(stats.failures, 1, "failures: %d", stats.failures);
+	zassert_equal(stats.shed, 1, "shed: %d", stats.shed);
+
+	r = oscore_context_deinit(&c_server);
+	zassert_equal(r, ok, "Error in oscore_context_deinit");
+}
+
+static uint32_t t22_time;
+
+static uint32_t t22_clock(void)
+{
+	return t22_time;
+}
+
+/**
+ * @brief   A retransmitted confirmable request is answered with the cached 
+ *          response, see Appendix C.5 and C.7.
+ */
+void t22_oscore_response_cache(void)
+{
+	enum err r;
+	struct context c_server;
+	struct oscore_cached_response responses[2];
+	struct oscore_init_params params_server = {
+		.master_secret.ptr = (uint8_t *)T2__MASTER_SECRET,
+		.master_secret.len = T2__MASTER_SECRET_LEN,
+		.sender_id.ptr = (uint8_t *)T2__SENDER_ID,
+		.sender_id.len = T2__SENDER_ID_LEN,
+		.recipient_id.ptr = (uint8_t *)T2__RECIPIENT_ID,
+		.recipient_id.len = T2__RECIPIENT_ID_LEN,
+		.master_salt.ptr = (uint8_t *)T2__MASTER_SALT,
+		.master_salt.len = T2__MASTER_SALT_LEN,
+		.id_context.ptr = (uint8_t *)T2__ID_CONTEXT,
+		.id_context.len = T2__ID_CONTEXT_LEN,
+		.aead_alg = OSCORE_AES_CCM_16_64_128,
+		.hkdf = OSCORE_SHA_256,
+		.fresh_master_secret_salt = true,
+		.responses = responses,
+		.responses_count = 2,
+		.responses_clock = t22_clock,
+		.responses_lifetime = 100,
+	};
+	t22_time = 0xffffffc0;
+	r = oscore_context_init(&params_server, &c_server);
+	zassert_equal(r, ok, "Error in oscore_context_init");
+
+	uint8_t buf_coap[64];
+	uint32_t buf_coap_len = sizeof(buf_coap);
+	r = oscore2coap((uint8_t *)T2__OSCORE_REQ, T2__OSCORE_REQ_LEN, buf_coap,
+			&buf_coap_len, &c_server);
+	zassert_equal(r, ok, "Error in oscore2coap. r: %d", r);
+
+	uint8_t buf_oscore[64];
+	uint32_t buf_oscore_len = sizeof(buf_oscore);
+	r = coap2oscore((uint8_t *)T2__COAP_RESPONSE, T2__COAP_RESPONSE_LEN,
+			buf_oscore, &buf_oscore_len, &c_server);
+	zassert_equal(r, ok, "Error in coap2oscore. r: %d", r);
+
+	/*the retransmission gets the same response*/
+	t22_time += 99;
+	buf_coap_len = sizeof(buf_coap);
+	r = oscore2coap((uint8_t *)T2__OSCORE_REQ, T2__OSCORE_REQ_LEN, buf_coap,
+			&buf_coap_len, &c_server);
+	zassert_equal(r, oscore_duplicate_request, "r: %d", r);
+	zassert_equal(buf_coap_len, T2__OSCORE_RESP_LEN, "wrong length");
+	zassert_mem_equal__(buf_coap, T2__OSCORE_RESP, T2__OSCORE_RESP_LEN,
+			    "wrong response");
+
+	/*another request with the same PIV and Message ID is no retransmission,
+	it is not authenticated and gets no response*/
+	uint8_t buf[64];
+	memcpy(buf, T2__OSCORE_REQ, T2__OSCORE_REQ_LEN);
+	buf[T2__OSCORE_REQ_LEN - 1] ^= 0x01;
+	buf_coap_len = sizeof(buf_coap);
+	r = oscore2coap(buf, T2__OSCORE_REQ_LEN, buf_coap, &buf_coap_len,
+			&c_server);
+	zassert_equal(r, oscore_replay_window_protection_error, "r: %d", r);
+
+	/*the same PIV with another Message ID or as a non-confirmable 
+	message is a replay*/
+	memcpy(buf, T2__OSCORE_REQ, T2__OSCORE_REQ_LEN);
+	buf[3] ^= 0x01;
+	buf_coap_len = sizeof(buf_coap);
+	r = oscore2coap(buf, T2__OSCORE_REQ_LEN, buf_coap, &buf_coap_len,
+			&c_server);
+	zassert_equal(r, oscore_replay_window_protection_error, "r: %d", r);
+	memcpy(buf, T2__OSCORE_REQ, T2__OSCORE_REQ_LEN);
+	buf[0] = (uint8_t)((buf[0] & 0xcf) | (TYPE_NON << 4));
+	buf_coap_len = sizeof(buf_coap);
+	r = oscore2coap(buf, T2__OSCORE_REQ_LEN, buf_coap, &buf_coap_len,
+			&c_server);
+	zassert_equal(r, oscore_replay_window_protection_error, "r: %d", r);
+
+	/*the response expires*/
+	t22_time += 1;
+	buf_coap_len = sizeof(buf_coap);
+	r = oscore2coap((uint8_t *)T2__OSCORE_REQ, T2__OSCORE_REQ_LEN, buf_coap,
+			&buf_coap_len, &c_server);
+	zassert_equal(r, oscore_replay_window_protection_error, "r: %d", r);
+
+	r = oscore_context_deinit(&c_server);
+	zassert_equal(r, ok, "Error in oscore_context_deinit");
+}
+
+extern uint64_t nvm_mock_ssn;
+extern uint32_t nvm_mock_write_cnt;
+extern enum err nvm_mock_write_result;
+
+static struct context *t23_requested;
+static uint32_t t23_requests;
+
+static void t23_write_request(struct context *c)
+{
+	t23_requested = c;
+	t23_requests++;
+}
+
+static void t23_requests_send(struct context *c, uint32_t cnt)
+{
+	for (uint32_t i = 0; i < cnt; i++) {
+		uint8_t buf_oscore[256];
+		uint32_t buf_oscore_len = sizeof(buf_oscore);
+		enum err r = coap2oscore((uint8_t *)T5__COAP_REQ,
+					 T5__COAP_REQ_LEN, buf_oscore,
+					 &buf_oscore_len, c);
+		zassert_equal(r, ok, "Error in coap2oscore. r: %d", r);
+	}
+}
+
+/**
+ * @brief   The SSN is written in NVM behind the packets by 
+ *          oscore_ssn_flush(), and synchronously only if the flush is late.
+ */
+void t23_oscore_ssn_write_behind(void)
+{
+	enum err r;
+	struct context c_client;
+	struct oscore_init_params params = {
+		.master_secret.ptr = (uint8_t *)T5__MASTER_SECRET,
+		.master_secret.len = T5__MASTER_SECRET_LEN,
+		.sender_id.ptr = (uint8_t *)T5__SENDER_ID,
+		.sender_id.len = T5__SENDER_ID_LEN,
+		.recipient_id.ptr = (uint8_t *)T5__RECIPIENT_ID,
+		.recipient_id.len = T5__RECIPIENT_ID_LEN,
+		.master_salt.ptr = (uint8_t *)T5__MASTER_SALT,
+		.master_salt.len = T5__MASTER_SALT_LEN,
+		.id_context.ptr = (uint8_t *)T5__ID_CONTEXT,
+		.id_context.len = T5__ID_CONTEXT_LEN,
+		.aead_alg = OSCORE_AES_CCM_16_64_128,
+		.hkdf = OSCORE_SHA_256,
+		.fresh_master_secret_salt = true,
+		.ssn_write_request = t23_write_request,
+	};
+	const uint32_t k = K_SSN_NVM_STORE_INTERVAL;
+	r = oscore_context_init(&params, &c_client);
+	zassert_equal(r, ok, "Error in oscore_context_init");
+	t23_requests = 0;
+	uint32_t writes = nvm_mock_write_cnt;
+
+	/*the write-behind is requested once, after half of the window*/
+	t23_requests_send(&c_client, k / 2);
+	zassert_equal(t23_requests, 0, "write requested early");
+	t23_requests_send(&c_client, k - k / 2);
+	zassert_equal(t23_requests, 1, "requests: %d", t23_requests);
+	zassert_equal_ptr(t23_requested, &c_client, "wrong context");
+	zassert_equal(nvm_mock_write_cnt, writes, "synchronous write");
+
+	/*the flush covers all SSNs used so far*/
+	r = oscore_ssn_flush(&c_client);
+	zassert_equal(r, ok, "Error in oscore_ssn_flush. r: %d", r);
+	zassert_equal(nvm_mock_write_cnt, writes + 1, "no write");
+	zassert_equal(nvm_mock_ssn, k, "wrong SSN written");
+	r = oscore_ssn_flush(&c_client);
+	zassert_equal(r, ok, "Error in oscore_ssn_flush. r: %d", r);
+	zassert_equal(nvm_mock_write_cnt, writes + 1, "write not requested");
+
+	/*without a flush, the SSN is written when the window is used up*/
+	t23_requests_send(&c_client, k);
+	zassert_equal(t23_requests, 2, "requests: %d", t23_requests);
+	zassert_equal(nvm_mock_write_cnt, writes + 1, "synchronous write");
+	t23_requests_send(&c_client, 1);
+	zassert_equal(nvm_mock_write_cnt, writes + 2, "no synchronous write");
+	zassert_equal(nvm_mock_ssn, 2 * k + 1, "wrong SSN written");
+	r = oscore_ssn_flush(&c_client);
+	zassert_equal(r, ok, "Error in oscore_ssn_flush. r: %d", r);
+	zassert_equal(nvm_mock_write_cnt, writes + 2, "write not requested");
+
+	/*a deferred write covers the SSNs only after the sync is acknowledged*/
+	uint64_t bound = c_client.sc.ssn_nvm_bound;
+	t23_requests_send(&c_client, (uint32_t)(c_client.sc.ssn_nvm_request_at -
+						c_client.sc.ssn) + 1);
+	zassert_equal(t23_requests, 3, "requests: %d", t23_requests);
+	nvm_mock_write_result = oscore_nvm_write_deferred;
+	r = oscore_ssn_flush(&c_client);
+	nvm_mock_write_result = ok;
+	zassert_equal(r, ok, "Error in oscore_ssn_flush. r: %d", r);
+	zassert_equal(nvm_mock_write_cnt, writes + 3, "no write");
+	zassert_equal(c_client.sc.ssn_nvm_bound, bound, "bound not kept");
+	r = oscore_ssn_durable(&c_client);
+	zassert_equal(r, ok, "Error in oscore_ssn_durable. r: %d", r);
+	zassert_true(c_client.sc.ssn_nvm_bound > bound, "bound not advanced");
+	t23_requests_send(&c_client, (uint32_t)(bound - c_client.sc.ssn) + 1);
+	zassert_equal(nvm_mock_write_cnt, writes + 3, "synchronous write");
+
+	/*a packet is never protected with a value that is not durable*/
+	bound = c_client.sc.ssn_nvm_bound;
+	t23_requests_send(&c_client, (uint32_t)(bound - c_client.sc.ssn));
+	nvm_mock_write_result = oscore_nvm_write_deferred;
+	uint8_t buf_oscore[256];
+	uint32_t buf_oscore_len = sizeof(buf_oscore);
+	r = coap2oscore((uint8_t *)T5__COAP_REQ, T5__COAP_REQ_LEN, buf_oscore,
+			&buf_oscore_len, &c_client);
+	nvm_mock_write_result = ok;
+	zassert_equal(r, oscore_nvm_write_deferred, "r: %d", r);
+	zassert_equal(c_client.sc.ssn_nvm_bound, bound, "bound advanced");
+
+	r = oscore_context_deinit(&c_client);
+	zassert_equal(r, ok, "Error in oscore_context_deinit");
+}
+
+static uint32_t t24_time;
+
+static uint32_t t24_clock(void)
+{
+	return t24_time;
+}
+
+/**
+ * @brief   The SSN interval grows when the SSN is written more often than 
+ *          once per write period and shrinks when it is written less often.
+ */
+void t24_oscore_ssn_adaptive_interval(void)
+{
+	enum err r;
+	struct context c_client;
+	struct oscore_init_params params = {
+		.master_secret.ptr = (uint8_t *)T5__MASTER_SECRET,
+		.master_secret.len = T5__MASTER_SECRET_LEN,
+		.sender_id.ptr = (uint8_t *)T5__SENDER_ID,
+		.sender_id.len = T5__SENDER_ID_LEN,
+		.recipient_id.ptr = (uint8_t *)T5__RECIPIENT_ID,
+		.recipient_id.len = T5__RECIPIENT_ID_LEN,
+		.master_salt.ptr = (uint8_t *)T5__MASTER_SALT,
+		.master_salt.len = T5__MASTER_SALT_LEN,
+		.id_context.ptr = (uint8_t *)T5__ID_CONTEXT,
+		.id_context.len = T5__ID_CONTEXT_LEN,
+		.aead_alg = OSCORE_AES_CCM_16_64_128,
+		.hkdf = OSCORE_SHA_256,
+		.fresh_master_secret_salt = true,
+		.ssn_clock = t24_clock,
+		.ssn_write_period = 100,
+	};
+	const uint32_t k = K_SSN_NVM_STORE_INTERVAL;
+	t24_time = 0xfffffff0;
+	r = oscore_context_init(&params, &c_client);
+	zassert_equal(r, ok, "Error in oscore_context_init");
+	uint32_t writes = nvm_mock_write_cnt;
+
+	/*a fast sender doubles the interval at every write*/
+	t23_requests_send(&c_client, k);
+	zassert_equal(nvm_mock_write_cnt, writes, "early write");
+	t23_requests_send(&c_client, 1);
+	zassert_equal(nvm_mock_write_cnt, writes + 1, "no write");
+	zassert_equal(c_client.sc.ssn_interval, 2 * k, "interval not grown");
+	zassert_equal(c_client.sc.ssn_nvm_bound, k + 1 + 2 * k, "wrong bound");
+	/*the default nvm_write_ssn_interval() stores the bound - K*/
+	zassert_equal(nvm_mock_ssn, c_client.sc.ssn_nvm_bound - k,
+		      "wrong value in NVM");
+
+	t23_requests_send(&c_client, 2 * k + 1);
+	zassert_equal(nvm_mock_write_cnt, writes + 2, "no write");
+	zassert_equal(c_client.sc.ssn_interval, 4 * k, "interval not grown");
+	uint64_t bound = c_client.sc.ssn_nvm_bound;
+	zassert_equal(bound, 3 * k + 2 + 4 * k, "wrong bound");
+
+	/*a slow sender halves it, also if the clock wraps around*/
+	while (c_client.sc.ssn < bound) {
+		t24_time += 10;
+		t23_requests_send(&c_client, 1);
+	}
+	zassert_equal(nvm_mock_write_cnt, writes + 2, "early write");
+	t23_requests_send(&c_client, 1);
+	zassert_equal(nvm_mock_write_cnt, writes + 3, "no write");
+	zassert_equal(c_client.sc.ssn_interval, 2 * k, "interval not shrunk");
+	zassert_equal(c_client.sc.ssn_nvm_bound, bound + 1 + 2 * k,
+		      "wrong bound");
+
+	r = oscore_context_deinit(&c_client);
+	zassert_equal(r, ok, "Error in oscore_context_deinit");
+}
+
+extern uint64_t nvm_mock_replay_bound;
+
+/**
+ * @brief   Parameters of the server of the test vector 1.
+ */
+static struct oscore_init_params
+t1_server_params(bool fresh, uint32_t replay_bound_interval,
+		 const struct oscore_echo_key *echo_key)
+{
+	struct oscore_init_params params = {
+		.master_secret.ptr = (uint8_t *)T1__MASTER_SECRET,
+		.master_secret.len = T1__MASTER_SECRET_LEN,
+		.sender_id.ptr = (uint8_t *)T1__RECIPIENT_ID,
+		.sender_id.len = T1__RECIPIENT_ID_LEN,
+		.recipient_id.ptr = (uint8_t *)T1__SENDER_ID,
+		.recipient_id.len = T1__SENDER_ID_LEN,
+		.master_salt.ptr = (uint8_t *)T1__MASTER_SALT,
+		.master_salt.len = T1__MASTER_SALT_LEN,
+		.id_context.ptr = (uint8_t *)T1__ID_CONTEXT,
+		.id_context.len = T1__ID_CONTEXT_LEN,
+		.aead_alg = OSCORE_AES_CCM_16_64_128,
+		.hkdf = OSCORE_SHA_256,
+		.fresh_master_secret_salt = fresh,
+		.replay_bound_interval = replay_bound_interval,
+		.echo_key = echo_key,
+	};
+	return params;
+}
+
+/**
+ * @brief   Protects a request of the client and unprotects it with the server.
+ * @param   oscore [out] the protected request, for replays
+ * @return  the result of oscore2coap()
+ */
+static enum err t25_request(struct context *cc, struct context *cs,
+			    uint8_t *oscore, uint32_t *oscore_len)
+{
+	uint8_t buf_coap[64];
+	uint32_t buf_coap_len = sizeof(buf_coap);
+
+	*oscore_len = 64;
+	enum err r = coap2oscore((uint8_t *)T1__COAP_REQ, T1__COAP_REQ_LEN,
+				 oscore, oscore_len, cc);
+	zassert_equal(r, ok, "Error in coap2oscore. r: %d", r);
+	return oscore2coap(oscore, *oscore_len, buf_coap, &buf_coap_len, cs);
+}
+
+/**
+ * @brief   The server stores a bound above the SSNs of the accepted requests 
+ *          in NVM. After a reboot, requests above the bound are accepted 
+ *          without the ECHO challenge, older ones get the challenge.
+ */
+void t25_oscore_replay_bound(void)
+{
+	enum err r;
+	struct context cc;
+	struct context cs;
+	struct oscore_init_params params_client =
+		get_default_params(NORMAL, FRESH);
+	struct oscore_init_params params_server = t1_server_params(true, 4, NULL);
+	struct oscore_init_params params_server_restored =
+		t1_server_params(false, 4, NULL);
+	struct oscore_init_params params_server_no_bound =
+		t1_server_params(false, 0, NULL);
+	uint8_t oscore[64];
+	uint32_t oscore_len;
+	uint8_t replay[64];
+	uint32_t replay_len;
+
+	nvm_mock_replay_bound = 0;
+	r = oscore_context_init(&params_client, &cc);
+	zassert_equal(r, ok, "Error in oscore_context_init");
+	r = oscore_context_init(&params_server, &cs);
+	zassert_equal(r, ok, "Error in oscore_context_init");
+
+	/*the bound is written with the first request and with SSN 4*/
+	r = t25_request(&cc, &cs, oscore, &oscore_len);
+	zassert_equal(r, ok, "r: %d", r);
+	zassert_equal(nvm_mock_replay_bound, 4, "wrong bound");
+	for (uint32_t i = 1; i < 8; i++) {
+		r = t25_request(&cc, &cs, oscore, &oscore_len);
+		zassert_equal(r, ok, "r: %d", r);
+		zassert_equal(nvm_mock_replay_bound, (i < 4) ? 4 : 8,
+			      "wrong bound");
+		if (5 == i) {
+			memcpy(replay, oscore, oscore_len);
+			replay_len = oscore_len;
+		}
+	}
+
+	/*after a reboot the request with SSN 8 is accepted at once, the 
+	replayed one is rejected*/
+	r = oscore_context_deinit(&cs);
+	zassert_equal(r, ok, "Error in oscore_context_deinit");
+	r = oscore_context_init(&params_server_restored, &cs);
+	zassert_equal(r, ok, "Error in oscore_context_init");
+	zassert_equal(cs.rrc.echo_state_machine, ECHO_RESTORED, "not restored");
+	r = t25_request(&cc, &cs, oscore, &oscore_len);
+	zassert_equal(r, ok, "r: %d", r);
+	zassert_equal(cs.rrc.echo_state_machine, ECHO_SYNCHRONIZED,
+		      "not synchronized");
+	zassert_equal(nvm_mock_replay_bound, 12, "wrong bound");
+	uint8_t buf_coap[64];
+	uint32_t buf_coap_len = sizeof(buf_coap);
+	r = oscore2coap(replay, replay_len, buf_coap, &buf_coap_len, &cs);
+	zassert_equal(r, oscore_replay_window_protection_error, "r: %d", r);
+
+	/*a request below the bound gets the ECHO challenge*/
+	r = oscore_context_deinit(&cs);
+	zassert_equal(r, ok, "Error in oscore_context_deinit");
+	r = oscore_context_init(&params_server_restored, &cs);
+	zassert_equal(r, ok, "Error in oscore_context_init");
+	buf_coap_len = sizeof(buf_coap);
+	r = oscore2coap(replay, replay_len, buf_coap, &buf_coap_len, &cs);
+	zassert_equal(r, first_request_after_reboot, "r: %d", r);
+	zassert_equal(cs.rrc.echo_state_machine, ECHO_VERIFY, "no challenge");
+
+	/*without the interval no bound is read*/
+	r = oscore_context_deinit(&cs);
+	zassert_equal(r, ok, "Error in oscore_context_deinit");
+	r = oscore_context_init(&params_server_no_bound, &cs);
+	zassert_equal(r, ok, "Error in oscore_context_init");
+	zassert_equal(cs.rrc.echo_state_machine, ECHO_REBOOT, "restored");
+
+	r = oscore_context_deinit(&cs);
+	zassert_equal(r, ok, "Error in oscore_context_deinit");
+	r = oscore_context_deinit(&cc);
+	zassert_equal(r, ok, "Error in oscore_context_deinit");
+}
+
+static uint32_t t26_now;
+
+static uint32_t t26_clock(void)
+{
+	return t26_now;
+}
+
+/**
+ * @brief   Sends a GET request of the client, with an ECHO option if echo 
+ *          is given, to the server.
+ * @return  the result of oscore2coap()
+ */
+static enum err t26_request(struct context *cc, struct context *cs,
+			    const struct byte_array *echo)
+{
+	uint8_t token[] = { 0x4a };
+	struct o_coap_packet coap_pkt_req = {
+		.header = { .ver = 1,
+			    .type = TYPE_CON,
+			    .TKL = 1,
+			    .code = CODE_REQ_GET,
+			    .MID = 0x0 },
+		.token = token,
+		.options_cnt = (NULL != echo) ? 1 : 0,
+		.options = { { .delta = 252,
+			       .len = (NULL != echo) ? echo->len : 0,
+			       .value = (NULL != echo) ? echo->ptr : NULL,
+			       .option_number = ECHO } },
+		.payload.len = 0,
+		.payload.ptr = NULL,
+	};
+	uint8_t buf_coap[64];
+	uint32_t buf_coap_len = sizeof(buf_coap);
+	uint8_t buf_oscore[64];
+	uint32_t buf_oscore_len = sizeof(buf_oscore);
+
+	enum err r = coap_serialize(&coap_pkt_req, buf_coap, &buf_coap_len);
+	zassert_equal(r, ok, "Error in coap_serialize. r: %d", r);
+	r = coap2oscore(buf_coap, buf_coap_len, buf_oscore, &buf_oscore_len,
+			cc);
+	zassert_equal(r, ok, "Error in coap2oscore. r: %d", r);
+	buf_coap_len = sizeof(buf_coap);
+	return oscore2coap(buf_oscore, buf_oscore_len, buf_coap, &buf_coap_len,
+			   cs);
+}
+
+/**
+ * @brief   The ECHO challenge with stateless Echo values: the server 
+ *          creates them with a server secret and verifies them without a 
+ *          copy in the context, so that they can be created by another 
+ *          context or thread than the one that sent the challenge.
+ */
+void t26_oscore_echo_stateless(void)
+{
+	enum err r;
+	struct context cc;
+	struct context cs;
+	struct context cs_other;
+	struct oscore_echo_key key;
+	uint8_t secret_buf[32] = { 0xa5 };
+	struct byte_array secret = BYTE_ARRAY_INIT(secret_buf, 32);
+	struct oscore_init_params params_client =
+		get_default_params(NORMAL, FRESH);
+	struct oscore_init_params params_server =
+		t1_server_params(false, 0, &key);
+	uint8_t echo_buf[OSCORE_ECHO_VAL_LEN];
+	struct byte_array echo = BYTE_ARRAY_INIT(echo_buf, sizeof(echo_buf));
+
+	t26_now = 1000;
+	r = oscore_echo_key_init(&key, &secret, t26_clock, 10);
+	zassert_equal(r, ok, "Error in oscore_echo_key_init. r: %d", r);
+	r = oscore_context_init(&params_client, &cc);
+	zassert_equal(r, ok, "Error in oscore_context_init");
+	r = oscore_context_init(&params_server, &cs);
+	zassert_equal(r, ok, "Error in oscore_context_init");
+	r = oscore_context_init(&params_server, &cs_other);
+	zassert_equal(r, ok, "Error in oscore_context_init");
+
+	/*the first request gets the challenge, the response needs no ECHO 
+	option to be cached*/
+	r = t26_request(&cc, &cs, NULL);
+	zassert_equal(r, first_request_after_reboot, "r: %d", r);
+	r = oscore_echo_create(&key, &cs.cc.id_context, &cs.rc.recipient_id,
+			       &echo);
+	zassert_equal(r, ok, "Error in oscore_echo_create. r: %d", r);
+	uint8_t coap_resp[] = { 0x61, 0x81, 0x00, 0x00, 0x4A };
+	uint8_t buf_oscore[64];
+	uint32_t buf_oscore_len = sizeof(buf_oscore);
+	r = coap2oscore(coap_resp, sizeof(coap_resp), buf_oscore,
+			&buf_oscore_len, &cs);
+	zassert_equal(r, ok, "Error in coap2oscore. r: %d", r);
+
+	/*a request with a wrong Echo value repeats the challenge*/
+	echo_buf[5] ^= 0x01;
+	r = t26_request(&cc, &cs, &echo);
+	zassert_equal(r, echo_validation_failed, "r: %d", r);
+	echo_buf[5] ^= 0x01;
+	r = t26_request(&cc, &cs, &echo);
+	zassert_equal(r, ok, "r: %d", r);
+	zassert_equal(cs.rrc.echo_state_machine, ECHO_SYNCHRONIZED,
+		      "not synchronized");
+
+	/*another context with the same key sends the challenge itself and 
+	rejects values created before, which a replayed request may carry*/
+	t26_now += 5;
+	r = t26_request(&cc, &cs_other, &echo);
+	zassert_equal(r, first_request_after_reboot, "r: %d", r);
+	r = t26_request(&cc, &cs_other, &echo);
+	zassert_equal(r, echo_validation_failed, "r: %d", r);
+
+	/*a value created afterwards is accepted, e.g., from another thread, as 
+	long as it is not expired*/
+	t26_now++;
+	r = oscore_echo_create(&key, &cs_other.cc.id_context,
+			       &cs_other.rc.recipient_id, &echo);
+	zassert_equal(r, ok, "Error in oscore_echo_create. r: %d", r);
+	r = t26_request(&cc, &cs_other, &echo);
+	zassert_equal(r, ok, "r: %d", r);
+	zassert_equal(cs_other.rrc.echo_state_machine, ECHO_SYNCHRONIZED,
+		      "not synchronized");
+
+	r = oscore_context_deinit(&cs_other);
+	zassert_equal(r, ok, "Error in oscore_context_deinit");
+	r = oscore_context_init(&params_server, &cs_other);
+	zassert_equal(r, ok, "Error in oscore_context_init");
+	r = t26_request(&cc, &cs_other, NULL);
+	zassert_equal(r, first_request_after_reboot, "r: %d", r);
+	r = oscore_echo_create(&key, &cs_other.cc.id_context,
+			       &cs_other.rc.recipient_id, &echo);
+	zassert_equal(r, ok, "Error in oscore_echo_create. r: %d", r);
+	t26_now += 11;
+	r = t26_request(&cc, &cs_other, &echo);
+	zassert_equal(r, echo_validation_failed, "r: %d", r);
+
+	r = oscore_context_deinit(&cs_other);
+	zassert_equal(r, ok, "Error in oscore_context_deinit");
+	r = oscore_context_deinit(&cs);
+	zassert_equal(r, ok, "Error in oscore_context_deinit");
+	r = oscore_context_deinit(&cc);
+	zassert_equal(r, ok, "Error in oscore_context_deinit");
+	r = oscore_echo_key_deinit(&key);
+	zassert_equal(r, ok, "Error in oscore_echo_key_deinit. r: %d", r);
 }
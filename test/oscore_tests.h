@@ -22,6 +22,21 @@ void t8_oscore_server_response_simple_ack(void);
 void t9_oscore_client_server_observe(void);
 void t10_oscore_client_server_after_reboot(void);
 void t11_oscore_ssn_overflow_protection(void);
+void t12_oscore_batch_notifications(void);
+void t13_oscore_batch_requests(void);
+void t14_oscore_context_table(void);
+void t15_oscore_ssn_blocks(void);
+void t16_oscore_in_place_request(void);
+void t17_oscore_in_place_unprotect(void);
+void t18_oscore_iov(void);
+void t19_oscore_packet_api(void);
+void t20_oscore_prefilter(void);
+void t21_oscore_rate_limit(void);
+void t22_oscore_response_cache(void);
+void t23_oscore_ssn_write_behind(void);
+void t24_oscore_ssn_adaptive_interval(void);
+void t25_oscore_replay_bound(void);
+void t26_oscore_echo_stateless(void);
 
 /*unit tests*/
 void t100_inner_outer_option_split__no_special_options(void);
@@ -47,12 +62,14 @@ void t401_cache_echo_val(void);
 void t402_echo_val_is_fresh(void);
 void t403_uri_path_create(void);
 void t404_get_observe_value(void);
+void t405_uri_path_hash(void);
 
 void t500_oscore_context_init_corner_cases(void);
 void t501_piv2ssn(void);
 void t502_ssn2piv(void);
 void t503_derive_corner_case(void);
 void t504_context_freshness(void);
+void t505_oscore_context_deinit(void);
 
 void t600_server_replay_init_test(void);
 void t601_server_replay_reinit_test(void);
@@ -61,11 +78,24 @@ void t603_server_replay_check_in_progress_test(void);
 void t604_server_replay_insert_zero_test(void);
 void t605_server_replay_insert_test(void);
 void t606_server_replay_standard_scenario_test(void);
+void t607_server_replay_window_size_test(void);
 
 void t700_interactions_init_test(void);
 void t701_interactions_set_record_test(void);
 void t702_interactions_get_record_test(void);
 void t703_interactions_remove_record_test(void);
 void t704_interactions_usecases_test(void);
+void t705_interactions_pool_test(void);
+void t706_interactions_expiry_test(void);
+
+void t800_aead_rfc8613_vector(void);
+void t801_hkdf_rfc5869_vectors(void);
+
+void t900_context_table_test(void);
+void t901_context_store_test(void);
+
+void t1000_response_cache_test(void);
+
+void t1100_echo_test(void);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,188 @@
+/*
+   Copyright (c) 2026 Fraunhofer AISEC. See the COPYRIGHT
+   file at the top-level directory of this distribution.
+
+   Licensed under the Apache License, Version 2.0 <LICENSE-APACHE or
+   http://www.apache.org/licenses/LICENSE-2.0> or the MIT license
+   <LICENSE-MIT or http://opensource.org/licenses/MIT>, at your
+   option. This file may not be copied, modified, or distributed
+   except according to those terms.
+*/
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+
+#include "oscore/oscore_context_store.h"
+#include "oscore/oscore_context_table.h"
+
+#define SLOTS_CNT 64
+#define CONTEXTS_CNT (SLOTS_CNT / 4 * 3)
+
+static struct context contexts[CONTEXTS_CNT + 1];
+static uint8_t recipient_ids[CONTEXTS_CNT + 1][2];
+static struct context *slots[SLOTS_CNT];
+static uint8_t id_context_buf[] = { 0x37, 0xcb, 0xf3, 0x21 };
+
+/**
+ * @brief Set up the key of context number i. Every second context gets an
+ *        ID Context, so that equal Recipient IDs appear with and without it.
+ */
+static void context_key_init(uint32_t i)
+{
+	memset(&contexts[i], 0, sizeof(contexts[i]));
+	recipient_ids[i][0] = (uint8_t)(i / 2);
+	recipient_ids[i][1] = 0xaa;
+	contexts[i].rc.recipient_id.ptr = recipient_ids[i];
+	contexts[i].rc.recipient_id.len = sizeof(recipient_ids[i]);
+	if (i % 2) {
+		contexts[i].cc.id_context.ptr = id_context_buf;
+		contexts[i].cc.id_context.len = sizeof(id_context_buf);
+	}
+}
+
+static void find_and_check(struct oscore_context_table *table, uint32_t i,
+			   bool present)
+{
+	struct context *c = NULL;
+	enum err r = oscore_context_table_find(table, &contexts[i].cc.id_context,
+					       &contexts[i].rc.recipient_id,
+					       &c);
+	if (present) {
+		zassert_equal(r, ok, "context %d not found. r: %d", i, r);
+		zassert_equal_ptr(c, &contexts[i], "wrong context %d", i);
+	} else {
+		zassert_equal(r, oscore_kid_recipient_id_mismatch,
+			      "context %d found. r: %d", i, r);
+	}
+}
+
+void t900_context_table_test(void)
+{
+	enum err r;
+	struct oscore_context_table table;
+	struct context *c;
+
+	/*wrong parameters*/
+	r = oscore_context_table_init(NULL, slots, SLOTS_CNT);
+	zassert_equal(r, wrong_parameter, "r: %d", r);
+	r = oscore_context_table_init(&table, NULL, SLOTS_CNT);
+	zassert_equal(r, wrong_parameter, "r: %d", r);
+	r = oscore_context_table_init(&table, slots, SLOTS_CNT - 1);
+	zassert_equal(r, wrong_parameter, "r: %d", r);
+	r = oscore_context_table_init(&table, slots, 2);
+	zassert_equal(r, wrong_parameter, "r: %d", r);
+
+	r = oscore_context_table_init(&table, slots, SLOTS_CNT);
+	zassert_equal(r, ok, "Error in oscore_context_table_init. r: %d", r);
+
+	/*fill the table up to its load factor*/
+	for (uint32_t i = 0; i < CONTEXTS_CNT + 1; i++) {
+		context_key_init(i);
+	}
+	for (uint32_t i = 0; i < CONTEXTS_CNT; i++) {
+		r = oscore_context_table_insert(&table, &contexts[i]);
+		zassert_equal(r, ok, "Error in insert of %d. r: %d", i, r);
+	}
+	r = oscore_context_table_insert(&table, &contexts[CONTEXTS_CNT]);
+	zassert_equal(r, oscore_max_contexts, "r: %d", r);
+	r = oscore_context_table_insert(&table, &contexts[0]);
+	zassert_equal(r, oscore_context_duplicated, "r: %d", r);
+
+	for (uint32_t i = 0; i < CONTEXTS_CNT; i++) {
+		find_and_check(&table, i, true);
+	}
+	find_and_check(&table, CONTEXTS_CNT, false);
+
+	/*a known Recipient ID with another ID Context does not match*/
+	struct byte_array other_id_context = BYTE_ARRAY_INIT(id_context_buf, 2);
+	r = oscore_context_table_find(&table, &other_id_context,
+				      &contexts[1].rc.recipient_id, &c);
+	zassert_equal(r, oscore_kid_recipient_id_mismatch, "r: %d", r);
+
+	/*every context is visited exactly once*/
+	uint32_t iterator = 0;
+	uint32_t visited = 0;
+	while (NULL != (c = oscore_context_table_next(&table, &iterator))) {
+		zassert_true((c >= contexts) && (c < &contexts[CONTEXTS_CNT]),
+			     "unknown context");
+		visited++;
+	}
+	zassert_equal(visited, CONTEXTS_CNT, "visited %d", visited);
+
+	/*remove every third context, all others must stay reachable*/
+	for (uint32_t i = 0; i < CONTEXTS_CNT; i += 3) {
+		r = oscore_context_table_remove(&table, &contexts[i]);
+		zassert_equal(r, ok, "Error in remove of %d. r: %d", i, r);
+	}
+	r = oscore_context_table_remove(&table, &contexts[0]);
+	zassert_equal(r, oscore_kid_recipient_id_mismatch, "r: %d", r);
+	for (uint32_t i = 0; i < CONTEXTS_CNT; i++) {
+		find_and_check(&table, i, (i % 3) != 0);
+	}
+
+	/*the freed slots can be used again*/
+	r = oscore_context_table_insert(&table, &contexts[CONTEXTS_CNT]);
+	zassert_equal(r, ok, "Error in oscore_context_table_insert. r: %d", r);
+	find_and_check(&table, CONTEXTS_CNT, true);
+}
+
+#define SHARDS_CNT 4
+#define SLOTS_PER_SHARD 32
+
+static bool is_context(struct context *c, void *arg)
+{
+	return c == arg;
+}
+
+void t901_context_store_test(void)
+{
+	enum err r;
+	struct oscore_context_store store;
+	struct oscore_context_shard shards[SHARDS_CNT];
+	struct context *store_slots[SHARDS_CNT * SLOTS_PER_SHARD];
+	struct context *c;
+
+	r = oscore_context_store_init(&store, shards, 0, store_slots,
+				      SLOTS_PER_SHARD);
+	zassert_equal(r, wrong_parameter, "r: %d", r);
+	r = oscore_context_store_init(&store, shards, SHARDS_CNT, store_slots,
+				      SLOTS_PER_SHARD - 1);
+	zassert_equal(r, wrong_parameter, "r: %d", r);
+	r = oscore_context_store_init(&store, shards, SHARDS_CNT, store_slots,
+				      SLOTS_PER_SHARD);
+	zassert_equal(r, ok, "Error in oscore_context_store_init. r: %d", r);
+
+	for (uint32_t i = 0; i < CONTEXTS_CNT; i++) {
+		context_key_init(i);
+		r = oscore_context_store_insert(&store, &contexts[i]);
+		zassert_equal(r, ok, "Error in insert of %d. r: %d", i, r);
+	}
+	r = oscore_context_store_insert(&store, &contexts[0]);
+	zassert_equal(r, oscore_context_duplicated, "r: %d", r);
+
+	/*the contexts are spread over all shards*/
+	for (uint32_t i = 0; i < SHARDS_CNT; i++) {
+		zassert_true(shards[i].table.contexts_cnt > 0,
+			     "shard %d is empty", i);
+	}
+
+	for (uint32_t i = 0; i < CONTEXTS_CNT; i++) {
+		r = oscore_context_store_find(&store, &contexts[i].cc.id_context,
+					      &contexts[i].rc.recipient_id, &c);
+		zassert_equal(r, ok, "context %d not found. r: %d", i, r);
+		zassert_equal_ptr(c, &contexts[i], "wrong context %d", i);
+	}
+
+	c = oscore_context_store_search(&store, is_context, &contexts[7]);
+	zassert_equal_ptr(c, &contexts[7], "wrong context");
+
+	r = oscore_context_store_remove(&store, &contexts[7]);
+	zassert_equal(r, ok, "Error in oscore_context_store_remove. r: %d", r);
+	r = oscore_context_store_find(&store, &contexts[7].cc.id_context,
+				      &contexts[7].rc.recipient_id, &c);
+	zassert_equal(r, oscore_kid_recipient_id_mismatch, "r: %d", r);
+	c = oscore_context_store_search(&store, is_context, &contexts[7]);
+	zassert_is_null(c, "removed context found");
+}
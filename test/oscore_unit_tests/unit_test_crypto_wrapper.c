@@ -0,0 +1,194 @@
+/*
+   Copyright (c) 2026 Fraunhofer AISEC. See the COPYRIGHT
+   file at the top-level directory of this distribution.
+
+   Licensed under the Apache License, Version 2.0 <LICENSE-APACHE or
+   http://www.apache.org/licenses/LICENSE-2.0> or the MIT license
+   <LICENSE-MIT or http://opensource.org/licenses/MIT>, at your
+   option. This file may not be copied, modified, or distributed
+   except according to those terms.
+*/
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+
+#include "common/crypto_wrapper.h"
+
+/*Request protection of RFC8613 Appendix C.4*/
+static const uint8_t KEY[] = { 0xf0, 0x91, 0x0e, 0xd7, 0x29, 0x5e, 0x6a, 0xd4,
+			       0xb5, 0x4f, 0xc7, 0x93, 0x15, 0x43, 0x02, 0xff };
+static const uint8_t NONCE[] = { 0x46, 0x22, 0xd4, 0xdd, 0x6d, 0x94, 0x41,
+				 0x68, 0xee, 0xfb, 0x54, 0x98, 0x68 };
+static const uint8_t AAD[] = { 0x83, 0x68, 0x45, 0x6e, 0x63, 0x72, 0x79,
+			       0x70, 0x74, 0x30, 0x40, 0x48, 0x85, 0x01,
+			       0x81, 0x0a, 0x40, 0x41, 0x14, 0x40 };
+static const uint8_t PLAINTEXT[] = { 0x01, 0xb3, 0x74, 0x76, 0x31 };
+static const uint8_t CIPHERTEXT[] = { 0x61, 0x2f, 0x10, 0x92, 0xf1,
+				      0x77, 0x6f, 0x1c, 0x16, 0x68,
+				      0xb3, 0x82, 0x5e };
+
+static void aead_rfc8613_vector(void)
+{
+	enum err r;
+	struct aead_key key;
+	uint8_t nonce_buf[sizeof(NONCE)];
+	uint8_t buf[sizeof(CIPHERTEXT)];
+	memcpy(nonce_buf, NONCE, sizeof(NONCE));
+
+	struct byte_array raw_key = BYTE_ARRAY_INIT((uint8_t *)KEY, sizeof(KEY));
+	struct byte_array nonce = BYTE_ARRAY_INIT(nonce_buf, sizeof(nonce_buf));
+	struct byte_array aad = BYTE_ARRAY_INIT((uint8_t *)AAD, sizeof(AAD));
+	struct byte_array plaintext =
+		BYTE_ARRAY_INIT((uint8_t *)PLAINTEXT, sizeof(PLAINTEXT));
+
+	r = aead_key_init(&raw_key, 8, &key);
+	zassert_equal(r, ok, "Error in aead_key_init. r: %d", r);
+
+	/*encryption*/
+	struct byte_array out = BYTE_ARRAY_INIT(buf, sizeof(PLAINTEXT));
+	struct byte_array tag = BYTE_ARRAY_INIT(buf + sizeof(PLAINTEXT), 8);
+	r = aead_with_key(ENCRYPT, &plaintext, &key, &nonce, &aad, &out, &tag);
+	zassert_equal(r, ok, "Error in aead_with_key. r: %d", r);
+	zassert_mem_equal__(buf, CIPHERTEXT, sizeof(CIPHERTEXT),
+			    "wrong ciphertext");
+
+	/*decryption*/
+	uint8_t pt_buf[sizeof(PLAINTEXT)];
+	struct byte_array ciphertext = BYTE_ARRAY_INIT(buf, sizeof(buf));
+	struct byte_array pt = BYTE_ARRAY_INIT(pt_buf, sizeof(pt_buf));
+	r = aead_with_key(DECRYPT, &ciphertext, &key, &nonce, &aad, &pt, &tag);
+	zassert_equal(r, ok, "Error in aead_with_key. r: %d", r);
+	zassert_mem_equal__(pt_buf, PLAINTEXT, sizeof(PLAINTEXT),
+			    "wrong plaintext");
+
+	/*a modified tag must be rejected*/
+	buf[sizeof(buf) - 1] ^= 0x01;
+	r = aead_with_key(DECRYPT, &ciphertext, &key, &nonce, &aad, &pt, &tag);
+	zassert_not_equal(r, ok, "modified tag not detected");
+
+	r = aead_key_deinit(&key);
+	zassert_equal(r, ok, "Error in aead_key_deinit. r: %d", r);
+
+	/*the one-shot API gives the same result*/
+	out.len = sizeof(PLAINTEXT);
+	r = aead(ENCRYPT, &plaintext, &raw_key, &nonce, &aad, &out, &tag);
+	zassert_equal(r, ok, "Error in aead. r: %d", r);
+	zassert_mem_equal__(buf, CIPHERTEXT, sizeof(CIPHERTEXT),
+			    "wrong ciphertext");
+}
+
+void t800_aead_rfc8613_vector(void)
+{
+	aead_rfc8613_vector();
+#ifdef AES_HW
+	/*the same with the fallback engine*/
+	aes_hw_enable(false);
+	aead_rfc8613_vector();
+	aes_hw_enable(true);
+#endif
+}
+
+/*RFC5869 Appendix A.1 (test case 1)*/
+static const uint8_t HKDF1_SALT[] = { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06,
+				      0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c };
+static const uint8_t HKDF1_INFO[] = { 0xf0, 0xf1, 0xf2, 0xf3, 0xf4,
+				      0xf5, 0xf6, 0xf7, 0xf8, 0xf9 };
+static const uint8_t HKDF1_PRK[] = {
+	0x07, 0x77, 0x09, 0x36, 0x2c, 0x2e, 0x32, 0xdf, 0x0d, 0xdc, 0x3f,
+	0x0d, 0xc4, 0x7b, 0xba, 0x63, 0x90, 0xb6, 0xc7, 0x3b, 0xb5, 0x0f,
+	0x9c, 0x31, 0x22, 0xec, 0x84, 0x4a, 0xd7, 0xc2, 0xb3, 0xe5
+};
+static const uint8_t HKDF1_OKM[] = {
+	0x3c, 0xb2, 0x5f, 0x25, 0xfa, 0xac, 0xd5, 0x7a, 0x90, 0x43, 0x4f,
+	0x64, 0xd0, 0x36, 0x2f, 0x2a, 0x2d, 0x2d, 0x0a, 0x90, 0xcf, 0x1a,
+	0x5a, 0x4c, 0x5d, 0xb0, 0x2d, 0x56, 0xec, 0xc4, 0xc5, 0xbf, 0x34,
+	0x00, 0x72, 0x08, 0xd5, 0xb8, 0x87, 0x18, 0x58, 0x65
+};
+/*RFC5869 Appendix A.3 (test case 3), empty salt and info*/
+static const uint8_t HKDF3_PRK[] = {
+	0x19, 0xef, 0x24, 0xa3, 0x2c, 0x71, 0x7b, 0x16, 0x7f, 0x33, 0xa9,
+	0x1d, 0x6f, 0x64, 0x8b, 0xdf, 0x96, 0x59, 0x67, 0x76, 0xaf, 0xdb,
+	0x63, 0x77, 0xac, 0x43, 0x4c, 0x1c, 0x29, 0x3c, 0xcb, 0x04
+};
+static const uint8_t HKDF3_OKM[] = {
+	0x8d, 0xa4, 0xe7, 0x75, 0xa5, 0x63, 0xc1, 0x8f, 0x71, 0x5f, 0x80,
+	0x2a, 0x06, 0x3c, 0x5a, 0x31, 0xb8, 0xa1, 0x1f, 0x5c, 0x5e, 0xe1,
+	0x87, 0x9e, 0xc3, 0x45, 0x4e, 0x5f, 0x3c, 0x73, 0x8d, 0x2d, 0x9d,
+	0x20, 0x13, 0x95, 0xfa, 0xa4, 0xb6, 0x1a, 0x96, 0xc8
+};
+
+void t801_hkdf_rfc5869_vectors(void)
+{
+	enum err r;
+	uint8_t ikm_buf[22];
+	uint8_t prk_buf[32];
+	uint8_t okm_buf[sizeof(HKDF1_OKM)];
+	memset(ikm_buf, 0x0b, sizeof(ikm_buf));
+
+	struct byte_array ikm = BYTE_ARRAY_INIT(ikm_buf, sizeof(ikm_buf));
+	struct byte_array prk = BYTE_ARRAY_INIT(prk_buf, sizeof(prk_buf));
+	struct byte_array okm = BYTE_ARRAY_INIT(okm_buf, sizeof(okm_buf));
+	struct byte_array salt =
+		BYTE_ARRAY_INIT((uint8_t *)HKDF1_SALT, sizeof(HKDF1_SALT));
+	struct byte_array info =
+		BYTE_ARRAY_INIT((uint8_t *)HKDF1_INFO, sizeof(HKDF1_INFO));
+
+	/*test case 1, the output spans two HMAC blocks*/
+	r = hkdf_extract(SHA_256, &salt, &ikm, prk_buf);
+	zassert_equal(r, ok, "Error in hkdf_extract. r: %d", r);
+	zassert_mem_equal__(prk_buf, HKDF1_PRK, sizeof(HKDF1_PRK), "wrong PRK");
+
+	r = hkdf_expand(SHA_256, &prk, &info, &okm);
+	zassert_equal(r, ok, "Error in hkdf_expand. r: %d", r);
+	zassert_mem_equal__(okm_buf, HKDF1_OKM, sizeof(HKDF1_OKM), "wrong OKM");
+
+	/*test case 3*/
+	r = hkdf_extract(SHA_256, &EMPTY_ARRAY, &ikm, prk_buf);
+	zassert_equal(r, ok, "Error in hkdf_extract. r: %d", r);
+	zassert_mem_equal__(prk_buf, HKDF3_PRK, sizeof(HKDF3_PRK), "wrong PRK");
+
+	r = hkdf_expand(SHA_256, &prk, &EMPTY_ARRAY, &okm);
+	zassert_equal(r, ok, "Error in hkdf_expand. r: %d", r);
+	zassert_mem_equal__(okm_buf, HKDF3_OKM, sizeof(HKDF3_OKM), "wrong OKM");
+
+	/*a truncated output is a prefix of the full one*/
+	memset(okm_buf, 0, sizeof(okm_buf));
+	okm.len = 16;
+	r = hkdf_expand(SHA_256, &prk, &EMPTY_ARRAY, &okm);
+	zassert_equal(r, ok, "Error in hkdf_expand. r: %d", r);
+	zassert_mem_equal__(okm_buf, HKDF3_OKM, 16, "wrong OKM");
+
+	/*more than 255 blocks must be rejected*/
+	okm.len = 255 * 32 + 1;
+	r = hkdf_expand(SHA_256, &prk, &EMPTY_ARRAY, &okm);
+	zassert_equal(r, hkdf_failed, "Error in hkdf_expand. r: %d", r);
+
+	/*the longest output, 255 blocks, with a keyed context*/
+	static uint8_t okm_long_buf[255 * 32];
+	struct byte_array okm_long =
+		BYTE_ARRAY_INIT(okm_long_buf, sizeof(okm_long_buf));
+	struct hkdf_ctx ctx;
+	r = hkdf_ctx_init(SHA_256, &prk, &ctx);
+	zassert_equal(r, ok, "Error in hkdf_ctx_init. r: %d", r);
+	r = hkdf_ctx_expand(&ctx, &EMPTY_ARRAY, &okm_long);
+	zassert_equal(r, ok, "Error in hkdf_ctx_expand. r: %d", r);
+	r = hkdf_ctx_deinit(&ctx);
+	zassert_equal(r, ok, "Error in hkdf_ctx_deinit. r: %d", r);
+	zassert_mem_equal__(okm_long_buf, HKDF3_OKM, sizeof(HKDF3_OKM),
+			    "wrong OKM");
+
+	/*"T(255) = HMAC-Hash(PRK, T(254) | info | 0xff)", HMAC with the PRK 
+	as key is hkdf_extract() with the PRK as salt*/
+	uint8_t last_input_buf[32 + 1];
+	uint8_t last_block[32];
+	struct byte_array last_input =
+		BYTE_ARRAY_INIT(last_input_buf, sizeof(last_input_buf));
+	memcpy(last_input_buf, &okm_long_buf[253 * 32], 32);
+	last_input_buf[32] = 0xff;
+	r = hkdf_extract(SHA_256, &prk, &last_input, last_block);
+	zassert_equal(r, ok, "Error in hkdf_extract. r: %d", r);
+	zassert_mem_equal__(&okm_long_buf[254 * 32], last_block,
+			    sizeof(last_block), "wrong last block");
+}
@@ -0,0 +1,125 @@
+/*
+   Copyright (c) 2026 Fraunhofer AISEC. See the COPYRIGHT
+   file at the top-level directory of this distribution.
+
+   Licensed under the Apache License, Version 2.0 <LICENSE-APACHE or
+   http://www.apache.org/licenses/LICENSE-2.0> or the MIT license
+   <LICENSE-MIT or http://opensource.org/licenses/MIT>, at your
+   option. This file may not be copied, modified, or distributed
+   except according to those terms.
+*/
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+
+#include "oscore/oscore_echo.h"
+
+static uint32_t now;
+
+static uint32_t test_clock(void)
+{
+	return now;
+}
+
+void t1100_echo_test(void)
+{
+	enum err r;
+	struct oscore_echo_key key;
+	struct oscore_echo_key other_key;
+	uint8_t secret_buf[32] = { 0x01, 0x02, 0x03 };
+	struct byte_array secret = BYTE_ARRAY_INIT(secret_buf, 32);
+	uint8_t id_context_buf[] = { 0x37, 0xcb, 0xf3, 0x21 };
+	struct byte_array id_context =
+		BYTE_ARRAY_INIT(id_context_buf, sizeof(id_context_buf));
+	struct byte_array no_id_context = BYTE_ARRAY_INIT(NULL, 0);
+	uint8_t kid_buf[] = { 0x01 };
+	struct byte_array kid = BYTE_ARRAY_INIT(kid_buf, sizeof(kid_buf));
+	uint8_t other_kid_buf[] = { 0x02 };
+	struct byte_array other_kid =
+		BYTE_ARRAY_INIT(other_kid_buf, sizeof(other_kid_buf));
+	uint8_t echo_buf[OSCORE_ECHO_VAL_LEN];
+	struct byte_array echo = BYTE_ARRAY_INIT(echo_buf, sizeof(echo_buf));
+
+	/*wrong parameters*/
+	secret.len = 15;
+	r = oscore_echo_key_init(&key, &secret, test_clock, 10);
+	zassert_equal(r, wrong_parameter, "r: %d", r);
+	secret.len = 32;
+	r = oscore_echo_key_init(&key, &secret, NULL, 10);
+	zassert_equal(r, wrong_parameter, "r: %d", r);
+	r = oscore_echo_key_init(&key, &secret, test_clock, 0);
+	zassert_equal(r, wrong_parameter, "r: %d", r);
+
+	now = 0xfffffffe;
+	r = oscore_echo_key_init(&key, &secret, test_clock, 10);
+	zassert_equal(r, ok, "Error in oscore_echo_key_init. r: %d", r);
+	echo.len = OSCORE_ECHO_VAL_LEN - 1;
+	r = oscore_echo_create(&key, &id_context, &kid, &echo);
+	zassert_equal(r, wrong_parameter, "r: %d", r);
+	echo.len = sizeof(echo_buf);
+	uint32_t since = now;
+	r = oscore_echo_create(&key, &id_context, &kid, &echo);
+	zassert_equal(r, ok, "Error in oscore_echo_create. r: %d", r);
+	zassert_equal(echo.len, OSCORE_ECHO_VAL_LEN, "wrong length");
+
+	/*the value is bound to the context and to the key*/
+	r = oscore_echo_verify(&key, &id_context, &kid, &echo, since);
+	zassert_equal(r, ok, "Error in oscore_echo_verify. r: %d", r);
+	r = oscore_echo_verify(&key, &id_context, &other_kid, &echo, since);
+	zassert_equal(r, echo_val_mismatch, "r: %d", r);
+	r = oscore_echo_verify(&key, &no_id_context, &kid, &echo, since);
+	zassert_equal(r, echo_val_mismatch, "r: %d", r);
+	secret_buf[0] ^= 0x80;
+	r = oscore_echo_key_init(&other_key, &secret, test_clock, 10);
+	zassert_equal(r, ok, "Error in oscore_echo_key_init. r: %d", r);
+	r = oscore_echo_verify(&other_key, &id_context, &kid, &echo, since);
+	zassert_equal(r, echo_val_mismatch, "r: %d", r);
+	r = oscore_echo_key_deinit(&other_key);
+	zassert_equal(r, ok, "Error in oscore_echo_key_deinit. r: %d", r);
+
+	/*a changed timestamp or tag, or a truncated value is rejected*/
+	echo_buf[3] ^= 0x01;
+	r = oscore_echo_verify(&key, &id_context, &kid, &echo, since);
+	zassert_equal(r, echo_val_mismatch, "r: %d", r);
+	echo_buf[3] ^= 0x01;
+	echo_buf[OSCORE_ECHO_VAL_LEN - 1] ^= 0x01;
+	r = oscore_echo_verify(&key, &id_context, &kid, &echo, since);
+	zassert_equal(r, echo_val_mismatch, "r: %d", r);
+	echo_buf[OSCORE_ECHO_VAL_LEN - 1] ^= 0x01;
+	echo.len--;
+	r = oscore_echo_verify(&key, &id_context, &kid, &echo, since);
+	zassert_equal(r, echo_val_mismatch, "r: %d", r);
+	echo.len++;
+
+	/*valid for the lifetime, also when the clock wraps around*/
+	now += 10;
+	r = oscore_echo_verify(&key, &id_context, &kid, &echo, since);
+	zassert_equal(r, ok, "Error in oscore_echo_verify. r: %d", r);
+	now++;
+	r = oscore_echo_verify(&key, &id_context, &kid, &echo, since);
+	zassert_equal(r, echo_val_expired, "r: %d", r);
+
+	/*values created before the challenge are rejected*/
+	now -= 5;
+	r = oscore_echo_verify(&key, &id_context, &kid, &echo, since + 1);
+	zassert_equal(r, echo_val_expired, "r: %d", r);
+	now += 5;
+
+	/*values from the future are rejected*/
+	now -= 12;
+	r = oscore_echo_verify(&key, &id_context, &kid, &echo, since);
+	zassert_equal(r, echo_val_expired, "r: %d", r);
+
+	/*contexts without ID Context*/
+	r = oscore_echo_create(&key, &no_id_context, &kid, &echo);
+	zassert_equal(r, ok, "Error in oscore_echo_create. r: %d", r);
+	r = oscore_echo_verify(&key, &no_id_context, &kid, &echo, since);
+	zassert_equal(r, ok, "Error in oscore_echo_verify. r: %d", r);
+	r = oscore_echo_verify(&key, &id_context, &kid, &echo, since);
+	zassert_equal(r, echo_val_mismatch, "r: %d", r);
+
+	r = oscore_echo_key_deinit(&key);
+	zassert_equal(r, ok, "Error in oscore_echo_key_deinit. r: %d", r);
+}
@@ -212,3 +212,58 @@ void t404_get_observe_value(void)
 	/* Test non-existing OBSERVE option. */
 	get_observe_value_and_compare(options_no_observe, GET_ARRAY_SIZE(options_no_observe), &output, false, NULL);
 }
+
+/**
+ * @brief Check that uri_path_hash() matches the hash of the path composed by uri_path_create().
+ */
+static void uri_path_hash_and_compare(struct o_coap_option *options, uint32_t options_size, const char *expected_uri_path)
+{
+	uint64_t hash;
+	enum err r = uri_path_hash(options, options_size, &hash);
+	zassert_equal(r, ok, "Error in uri_path_hash. r: %d", r);
+	zassert_equal(hash, uri_path_hash_update(URI_PATH_HASH_INIT, (uint8_t *)expected_uri_path, strlen(expected_uri_path)), "");
+}
+
+void t405_uri_path_hash(void)
+{
+	struct o_coap_option default_options[] = {
+		{ .option_number = IF_NONE_MATCH },
+		{ .option_number = URI_PATH, .value = "path", .len = 4 },
+		{ .option_number = URI_PATH, .value = "to", .len = 2 },
+		{ .option_number = OSCORE },
+		{ .option_number = URI_PATH, .value = "rsc", .len = 3 },
+	};
+	uint64_t hash;
+
+	/* Test null pointers. */
+	zassert_equal(uri_path_hash(NULL, 1, &hash), wrong_parameter, "");
+	zassert_equal(uri_path_hash(default_options, 1, NULL), wrong_parameter, "");
+
+	uri_path_hash_and_compare(default_options, GET_ARRAY_SIZE(default_options), "path/to/rsc");
+
+	/* Wrong option should fail. */
+	struct o_coap_option wrong_option[] = {
+		{ .option_number = URI_PATH, .value = "path", .len = 4 },
+		{ .option_number = URI_PATH, .value = NULL, .len = 2 },
+	};
+	zassert_equal(uri_path_hash(wrong_option, GET_ARRAY_SIZE(wrong_option), &hash), oscore_wrong_uri_path, "");
+
+	/* Empty options and no URI-Path option. */
+	struct o_coap_option empty_option[] = {
+		{ .option_number = URI_PATH, .value = "path", .len = 4 },
+		{ .option_number = URI_PATH, .value = NULL, .len = 0 },
+		{ .option_number = URI_PATH, .value = "rsc", .len = 3 },
+	};
+	uri_path_hash_and_compare(empty_option, GET_ARRAY_SIZE(empty_option), "path//rsc");
+	uri_path_hash_and_compare(&empty_option[1], 1, "");
+	uri_path_hash_and_compare(default_options, 1, "/");
+
+	/* Paths longer than OSCORE_MAX_URI_PATH_LEN are hashed too. */
+	uint8_t long_segment[OSCORE_MAX_URI_PATH_LEN + 1];
+	memset(long_segment, 'a', sizeof(long_segment));
+	struct o_coap_option long_option[] = {
+		{ .option_number = URI_PATH, .value = long_segment, .len = sizeof(long_segment) },
+	};
+	zassert_equal(uri_path_hash(long_option, 1, &hash), ok, "");
+	zassert_equal(hash, uri_path_hash_update(URI_PATH_HASH_INIT, long_segment, sizeof(long_segment)), "");
+}
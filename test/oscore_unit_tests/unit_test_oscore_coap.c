@@ -459,6 +459,39 @@ void t201_coap_serialize_deserialize(void)
 	r = coap_deserialize(&in, &out);
 	zassert_equal(r, oscore_inpkt_invalid_tkl,
 		      "Error in coap_deserialize. r: %d", r);
+
+	/*test a packet read up to the OSCORE option and completed afterwards*/
+	uint8_t in_buf_options[] = { 0x41, 0x02, 0x00, 0x01, 0xaa, 0x91, 0x09,
+				     0x22, 0x61, 0x62, 0xff, 0x01, 0x02 };
+	in.ptr = in_buf_options;
+	in.len = sizeof(in_buf_options);
+	struct o_coap_packet expected;
+	r = coap_deserialize(&in, &expected);
+	zassert_equal(r, ok, "Error in coap_deserialize. r: %d", r);
+
+	r = coap_header_deserialize(&in, OSCORE, &out);
+	zassert_equal(r, ok, "Error in coap_header_deserialize. r: %d", r);
+	zassert_equal(out.options_cnt, 1, "wrong options_cnt");
+	r = coap_deserialize_rest(&in, &out);
+	zassert_equal(r, ok, "Error in coap_deserialize_rest. r: %d", r);
+	zassert_equal(out.options_cnt, expected.options_cnt,
+		      "wrong options_cnt");
+	zassert_equal(out.options[1].option_number, URI_PATH,
+		      "wrong option number");
+	zassert_equal_ptr(out.options[1].value, expected.options[1].value,
+			  "wrong option value");
+	zassert_equal(out.payload.len, expected.payload.len,
+		      "wrong payload length");
+	zassert_equal_ptr(out.payload.ptr, expected.payload.ptr,
+			  "wrong payload");
+
+	/*a payload marker without payload*/
+	in.len = sizeof(in_buf_options) - 2;
+	r = coap_header_deserialize(&in, OSCORE, &out);
+	zassert_equal(r, ok, "Error in coap_header_deserialize. r: %d", r);
+	r = coap_deserialize_rest(&in, &out);
+	zassert_equal(r, not_valid_input_packet,
+		      "Error in coap_deserialize_rest. r: %d", r);
 }
 
 void t202_options_deserialize_corner_cases(void)
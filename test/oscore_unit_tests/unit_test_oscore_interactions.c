@@ -16,7 +16,6 @@
 #include "oscore/oscore_interactions.h"
 
 #define DUMMY_BYTE 10
-#define INTERACTIONS_ARRAY_SIZE (OSCORE_INTERACTIONS_COUNT * sizeof(struct oscore_interaction_t))
 
 #define URI_PATHS_DEFAULT "some/resource"
 #define TOKEN_DEFAULT "123456"
@@ -28,8 +27,6 @@ static struct oscore_interaction_t default_record =
 {
 	.token = TOKEN_DEFAULT,
 	.token_len = sizeof(TOKEN_DEFAULT),
-	.uri_paths = URI_PATHS_DEFAULT,
-	.uri_paths_len = sizeof(URI_PATHS_DEFAULT),
 	.request_piv = {0x01, 0x02, 0x03},
 	.request_piv_len = 3,
 	.request_kid = {0x10, 0x20},
@@ -37,28 +34,45 @@ static struct oscore_interaction_t default_record =
 };
 
 /**
- * @brief Call set_record and check its result.
+ * @brief Default record for given resource.
  */
-static void set_record_and_expect(struct oscore_interaction_t * interactions, struct oscore_interaction_t * record, enum err expected_result)
+static struct oscore_interaction_t record_for(const char * uri_paths, uint32_t uri_paths_len)
 {
-	PRINTF("set_record; expected result = %d\n", expected_result);
-	enum err result = oscore_interactions_set_record(interactions, record);
-	zassert_equal(expected_result, result, "");
+	struct oscore_interaction_t record = default_record;
+	record.uri_paths_hash = oscore_interactions_uri_paths_hash((uint8_t *)uri_paths, uri_paths_len);
+	return record;
 }
 
 /**
- * @brief Call set_record and compare resulting interactions array with expected data.
+ * @brief Compare the data fields of two records, the hash chain fields are managed by the table.
  */
-static void set_record_and_compare(struct oscore_interaction_t * interactions, struct oscore_interaction_t * record, enum err expected_result, struct oscore_interaction_t * expected_interactions)
+static void compare_records(struct oscore_interaction_t * actual, struct oscore_interaction_t * expected)
 {
-	set_record_and_expect(interactions, record, expected_result);
-	zassert_mem_equal(interactions, expected_interactions, INTERACTIONS_ARRAY_SIZE, "");
+	zassert_equal(actual->uri_paths_hash, expected->uri_paths_hash, "");
+	zassert_equal(actual->request_type, expected->request_type, "");
+	zassert_equal(actual->token_len, expected->token_len, "");
+	zassert_mem_equal(actual->token, expected->token, expected->token_len, "");
+	zassert_equal(actual->request_piv_len, expected->request_piv_len, "");
+	zassert_mem_equal(actual->request_piv, expected->request_piv, expected->request_piv_len, "");
+	zassert_equal(actual->request_kid_len, expected->request_kid_len, "");
+	zassert_mem_equal(actual->request_kid, expected->request_kid, expected->request_kid_len, "");
+	zassert_true(actual->is_occupied, "");
+}
+
+/**
+ * @brief Call set_record and check its result.
+ */
+static void set_record_and_expect(struct oscore_interactions * interactions, struct oscore_interaction_t * record, enum err expected_result)
+{
+	PRINTF("set_record; expected result = %d\n", expected_result);
+	enum err result = oscore_interactions_set_record(interactions, record);
+	zassert_equal(expected_result, result, "");
 }
 
 /**
  * @brief Call get_record and check its result. Pointer to resulting record will be written to given handle.
  */
-static void get_record_and_expect(struct oscore_interaction_t * interactions, uint8_t * token, uint8_t token_len, struct oscore_interaction_t ** record, enum err expected_result)
+static void get_record_and_expect(struct oscore_interactions * interactions, uint8_t * token, uint8_t token_len, struct oscore_interaction_t ** record, enum err expected_result)
 {
 	PRINTF("get_record; expected result = %d\n", expected_result);
 	enum err result = oscore_interactions_get_record(interactions, token, token_len, record);
@@ -68,17 +82,31 @@ static void get_record_and_expect(struct oscore_interaction_t * interactions, ui
 /**
  * @brief Call get_record and compare resulting record with expected data.
  */
-static void get_record_and_compare(struct oscore_interaction_t * interactions, struct oscore_interaction_t * record)
+static void get_record_and_compare(struct oscore_interactions * interactions, struct oscore_interaction_t * record)
 {
 	struct oscore_interaction_t * received_record;
 	get_record_and_expect(interactions, record->token, record->token_len, &received_record, ok);
-	zassert_mem_equal(received_record, record, sizeof(struct oscore_interaction_t), "");
+	compare_records(received_record, record);
+}
+
+/**
+ * @brief Count the occupied records of the table.
+ */
+static uint32_t occupied_count(struct oscore_interactions * interactions)
+{
+	struct oscore_interaction_t * records = (NULL != interactions->records_ext) ? interactions->records_ext : interactions->records_buf;
+	uint32_t count = 0;
+	for (uint32_t index = 0; index < interactions->count; index++)
+	{
+		count += records[index].is_occupied ? 1 : 0;
+	}
+	return count;
 }
 
 /**
  * @brief Call remove_record and check its result.
  */
-static void remove_record_and_expect(struct oscore_interaction_t * interactions, uint8_t * token, uint8_t token_len, enum err expected_result)
+static void remove_record_and_expect(struct oscore_interactions * interactions, uint8_t * token, uint8_t token_len, enum err expected_result)
 {
 	PRINTF("remove_record; expected result = %d\n", expected_result);
 	enum err result = oscore_interactions_remove_record(interactions, token, token_len);
@@ -86,18 +114,19 @@ static void remove_record_and_expect(struct oscore_interaction_t * interactions,
 }
 
 /**
- * @brief Fill given interactions array with generated records, which will be additionally stored at records_array for later checks.
+ * @brief Fill given interactions table with generated records, which will be additionally stored at records_array for later checks.
  */
-static void generate_and_fill(struct oscore_interaction_t * interactions, struct oscore_interaction_t * records_array)
+static void generate_and_fill(struct oscore_interactions * interactions, struct oscore_interaction_t * records_array, uint32_t count)
 {
-	oscore_interactions_init(interactions);
-	for (size_t entry = 0; entry < OSCORE_INTERACTIONS_COUNT; entry++)
+	for (size_t entry = 0; entry < count; entry++)
 	{
 		struct oscore_interaction_t * record = &(records_array[entry]);
-		memcpy(record, &default_record, sizeof(struct oscore_interaction_t));
+		uint8_t uri_paths[] = URI_PATHS_DEFAULT;
 		//adding one to make sure that only records other than the default one will be stored
-		record->uri_paths[0] += entry + 1;
-		record->token[0] += entry + 1;
+		uri_paths[0] += entry + 1;
+		*record = record_for((char *)uri_paths, sizeof(uri_paths));
+		record->token[0] += (entry + 1) & 0xff;
+		record->token[1] += ((entry + 1) >> 8) & 0xff;
 		record->request_piv[0] += entry;
 		record->request_kid[0] += entry;
 		set_record_and_expect(interactions, record, ok);
@@ -105,180 +134,226 @@ static void generate_and_fill(struct oscore_interaction_t * interactions, struct
 }
 
 /**
- * @brief Test interactions array initialization.
+ * @brief Test interactions table initialization.
  */
 void t700_interactions_init_test(void)
 {
-	struct oscore_interaction_t interactions[OSCORE_INTERACTIONS_COUNT];
-	struct oscore_interaction_t interactions_expected[OSCORE_INTERACTIONS_COUNT] = {0};
+	struct oscore_interactions interactions;
 
 	/* set random data to all fields */
-	memset(interactions, DUMMY_BYTE, INTERACTIONS_ARRAY_SIZE);
+	memset(&interactions, DUMMY_BYTE, sizeof(interactions));
 
 	enum err result = oscore_interactions_init(NULL);
 	zassert_equal(wrong_parameter, result, "");
 
-	result = oscore_interactions_init(interactions);
+	result = oscore_interactions_init(&interactions);
+	zassert_equal(ok, result, "");
+	zassert_equal(interactions.count, OSCORE_INTERACTIONS_COUNT, "");
+	zassert_is_null(interactions.records_ext, "");
+	zassert_equal(occupied_count(&interactions), 0, "");
+
+	/* a larger table needs a pool */
+	struct oscore_interaction_t pool[OSCORE_INTERACTIONS_COUNT + 1];
+	result = oscore_interactions_init_size(&interactions, OSCORE_INTERACTIONS_COUNT + 1, NULL);
+	zassert_equal(wrong_parameter, result, "");
+	result = oscore_interactions_init_size(&interactions, 0, pool);
+	zassert_equal(wrong_parameter, result, "");
+	result = oscore_interactions_init_size(&interactions, OSCORE_INTERACTIONS_MAX_COUNT + 1, pool);
+	zassert_equal(wrong_parameter, result, "");
+	memset(pool, DUMMY_BYTE, sizeof(pool));
+	result = oscore_interactions_init_size(&interactions, OSCORE_INTERACTIONS_COUNT + 1, pool);
 	zassert_equal(ok, result, "");
-	zassert_mem_equal(interactions, interactions_expected, INTERACTIONS_ARRAY_SIZE, "");
+	zassert_equal_ptr(interactions.records_ext, pool, "");
+	zassert_equal(occupied_count(&interactions), 0, "");
 }
 
 /**
- * @brief Test setting the record into interactions array.
+ * @brief Test setting the record into interactions table.
  */
 void t701_interactions_set_record_test(void)
 {
-	struct oscore_interaction_t interactions[OSCORE_INTERACTIONS_COUNT];
-	oscore_interactions_init(interactions);
+	struct oscore_interactions interactions;
+	oscore_interactions_init(&interactions);
 
 	/* Test null pointers. */
 	set_record_and_expect(NULL, NULL, wrong_parameter);
-	set_record_and_expect(interactions, NULL, wrong_parameter);
+	set_record_and_expect(&interactions, NULL, wrong_parameter);
 	set_record_and_expect(NULL, &default_record, wrong_parameter);
 
 	/* Test record with too big buffers. */
 	struct oscore_interaction_t wrong_record = default_record;
 	wrong_record.token_len = MAX_TOKEN_LEN + 1;
-	set_record_and_expect(interactions, &wrong_record, wrong_parameter);
-
-	wrong_record = default_record;
-	wrong_record.uri_paths_len = OSCORE_MAX_URI_PATH_LEN + 1;
-	set_record_and_expect(interactions, &wrong_record, wrong_parameter);
+	set_record_and_expect(&interactions, &wrong_record, wrong_parameter);
 
 	wrong_record = default_record;
 	wrong_record.request_piv_len = MAX_PIV_LEN + 1;
-	set_record_and_expect(interactions, &wrong_record, wrong_parameter);
+	set_record_and_expect(&interactions, &wrong_record, wrong_parameter);
 
 	wrong_record = default_record;
 	wrong_record.request_kid_len = MAX_KID_LEN + 1;
-	set_record_and_expect(interactions, &wrong_record, wrong_parameter);
+	set_record_and_expect(&interactions, &wrong_record, wrong_parameter);
 
-	/* Writing record to interactions array. */
-	struct oscore_interaction_t interactions_expected[OSCORE_INTERACTIONS_COUNT] = {0};
-	struct oscore_interaction_t record_1 = default_record;
-	interactions_expected[0] = record_1;
-	interactions_expected[0].is_occupied = true;
-	set_record_and_compare(interactions, &record_1, ok, interactions_expected);
+	/* Writing record to interactions table. */
+	struct oscore_interaction_t record_1 = record_for(URI_PATHS_DEFAULT, sizeof(URI_PATHS_DEFAULT));
+	set_record_and_expect(&interactions, &record_1, ok);
+	get_record_and_compare(&interactions, &record_1);
+	zassert_equal(occupied_count(&interactions), 1, "");
 
 	/* Writing an existing record with the same data should change nothing. */
-	set_record_and_compare(interactions, &record_1, ok, interactions_expected);
+	set_record_and_expect(&interactions, &record_1, ok);
+	get_record_and_compare(&interactions, &record_1);
+	zassert_equal(occupied_count(&interactions), 1, "");
 
 	/* Writing a record with different key (URI paths), but with already used token, should fail. */
-	struct oscore_interaction_t record_2 = default_record;
-	memcpy(record_2.uri_paths, URI_PATHS_2, sizeof(URI_PATHS_2));
-	record_2.uri_paths_len = sizeof(URI_PATHS_2);
-	set_record_and_expect(interactions, &record_2, oscore_interaction_duplicated_token);
+	struct oscore_interaction_t record_2 = record_for(URI_PATHS_2, sizeof(URI_PATHS_2));
+	set_record_and_expect(&interactions, &record_2, oscore_interaction_duplicated_token);
 
 	/* Writing a record with different key (URI paths) and token should pass. */	
 	memcpy(record_2.token, TOKEN_2, sizeof(TOKEN_2));
 	record_2.token_len = sizeof(TOKEN_2);
-	interactions_expected[1] = record_2;
-	interactions_expected[1].is_occupied = true;
-	set_record_and_compare(interactions, &record_2, ok, interactions_expected);
+	set_record_and_expect(&interactions, &record_2, ok);
+	get_record_and_compare(&interactions, &record_1);
+	get_record_and_compare(&interactions, &record_2);
+	zassert_equal(occupied_count(&interactions), 2, "");
 
 	/* Writing an existing record with changed values should change the entry accordingly. */
 	record_1.request_piv[3] = 0x04;
 	record_1.request_piv_len = 4;
-	interactions_expected[0] = record_1;
-	interactions_expected[0].is_occupied = true;
-	set_record_and_compare(interactions, &record_1, ok, interactions_expected);
-
-	/* Reset the array and fill all entries with generated records.
+	set_record_and_expect(&interactions, &record_1, ok);
+	get_record_and_compare(&interactions, &record_1);
+	zassert_equal(occupied_count(&interactions), 2, "");
+
+	/* The same resource with another request type is another record. */
+	struct oscore_interaction_t record_3 = record_1;
+	record_3.request_type = COAP_MSG_REGISTRATION;
+	record_3.token[0] += 1;
+	set_record_and_expect(&interactions, &record_3, ok);
+	get_record_and_compare(&interactions, &record_1);
+	get_record_and_compare(&interactions, &record_3);
+
+	/* A new token for an existing resource replaces the old one. */
+	struct oscore_interaction_t * received_record;
+	record_3.token[0] += 1;
+	set_record_and_expect(&interactions, &record_3, ok);
+	get_record_and_compare(&interactions, &record_3);
+	record_3.token[0] -= 1;
+	get_record_and_expect(&interactions, record_3.token, record_3.token_len, &received_record, oscore_interaction_not_found);
+	zassert_equal(occupied_count(&interactions), 3, "");
+
+	/* Reset the table and fill all entries with generated records.
 	   Adding another one should fail. */
 	struct oscore_interaction_t generated_records[OSCORE_INTERACTIONS_COUNT];
-	generate_and_fill(interactions, generated_records);
-	set_record_and_expect(interactions, &default_record, oscore_max_interactions);
+	oscore_interactions_init(&interactions);
+	generate_and_fill(&interactions, generated_records, OSCORE_INTERACTIONS_COUNT);
+	set_record_and_expect(&interactions, &default_record, oscore_max_interactions);
 }
 
 /**
- * @brief Test getting the record from interactions array.
+ * @brief Test getting the record from interactions table.
  */
 void t702_interactions_get_record_test(void)
 {
-	struct oscore_interaction_t interactions[OSCORE_INTERACTIONS_COUNT];
-	oscore_interactions_init(interactions);
+	struct oscore_interactions interactions;
+	oscore_interactions_init(&interactions);
 
 	/* Test null pointers. Null token is a valid value. */
 	struct oscore_interaction_t * received_record;
 	get_record_and_expect(NULL, TOKEN_DEFAULT, sizeof(TOKEN_DEFAULT), &received_record, wrong_parameter);
-	get_record_and_expect(interactions, TOKEN_DEFAULT, sizeof(TOKEN_DEFAULT), NULL, wrong_parameter);
+	get_record_and_expect(&interactions, TOKEN_DEFAULT, sizeof(TOKEN_DEFAULT), NULL, wrong_parameter);
 
 	/* Test too big token size. */
-	get_record_and_expect(interactions, TOKEN_DEFAULT, MAX_TOKEN_LEN + 1, &received_record, wrong_parameter);
+	get_record_and_expect(&interactions, TOKEN_DEFAULT, MAX_TOKEN_LEN + 1, &received_record, wrong_parameter);
 
 	/* Getting a not-stored record should fail. */
-	get_record_and_expect(interactions, TOKEN_DEFAULT, sizeof(TOKEN_DEFAULT), &received_record, oscore_interaction_not_found);
-	get_record_and_expect(interactions, NULL, 0, &received_record, oscore_interaction_not_found);
-	get_record_and_expect(interactions, NULL, 1, &received_record, oscore_interaction_not_found);
+	get_record_and_expect(&interactions, TOKEN_DEFAULT, sizeof(TOKEN_DEFAULT), &received_record, oscore_interaction_not_found);
+	get_record_and_expect(&interactions, NULL, 0, &received_record, oscore_interaction_not_found);
+	get_record_and_expect(&interactions, NULL, 1, &received_record, oscore_interaction_not_found);
 
 	/* Writing a record, then getting it back should return the same data.
 	   Updating a record, then getting it back should return updated data. */
-	struct oscore_interaction_t record = default_record;
-	set_record_and_expect(interactions, &record, ok);
-	get_record_and_compare(interactions, &record);
+	struct oscore_interaction_t record = record_for(URI_PATHS_DEFAULT, sizeof(URI_PATHS_DEFAULT));
+	set_record_and_expect(&interactions, &record, ok);
+	get_record_and_compare(&interactions, &record);
 	record.request_piv[0] += 10;
-	set_record_and_expect(interactions, &record, ok);
-	get_record_and_compare(interactions, &record);
-
-	/* Reset the array and fill all entries with generated records.
+	set_record_and_expect(&interactions, &record, ok);
+	get_record_and_compare(&interactions, &record);
+
+	/* Updating a record in place, with its token and resource changed, moves it to the new keys. */
+	struct oscore_interaction_t * stored_record;
+	get_record_and_expect(&interactions, record.token, record.token_len, &stored_record, ok);
+	memcpy(stored_record->token, TOKEN_2, sizeof(TOKEN_2));
+	stored_record->token_len = sizeof(TOKEN_2);
+	stored_record->uri_paths_hash = oscore_interactions_uri_paths_hash((uint8_t *)URI_PATHS_2, sizeof(URI_PATHS_2));
+	record = *stored_record;
+	set_record_and_expect(&interactions, stored_record, ok);
+	get_record_and_compare(&interactions, &record);
+	get_record_and_expect(&interactions, TOKEN_DEFAULT, sizeof(TOKEN_DEFAULT), &received_record, oscore_interaction_not_found);
+	zassert_equal(occupied_count(&interactions), 1, "");
+	remove_record_and_expect(&interactions, TOKEN_2, sizeof(TOKEN_2), ok);
+	zassert_equal(occupied_count(&interactions), 0, "");
+
+	/* Reset the table and fill all entries with generated records.
 	   Reading all records should pass, but reading a non-stored record should fail. */
 	struct oscore_interaction_t generated_records[OSCORE_INTERACTIONS_COUNT];
-	generate_and_fill(interactions, generated_records);
+	oscore_interactions_init(&interactions);
+	generate_and_fill(&interactions, generated_records, OSCORE_INTERACTIONS_COUNT);
 	for (size_t entry = 0; entry < OSCORE_INTERACTIONS_COUNT; entry++)
 	{
-		get_record_and_compare(interactions, &generated_records[entry]);
+		get_record_and_compare(&interactions, &generated_records[entry]);
 	}
-	get_record_and_expect(interactions, default_record.token, default_record.token_len, &received_record, oscore_interaction_not_found);
+	get_record_and_expect(&interactions, default_record.token, default_record.token_len, &received_record, oscore_interaction_not_found);
 }
 
 /**
- * @brief Test removing the record from interactions array.
+ * @brief Test removing the record from interactions table.
  */
 void t703_interactions_remove_record_test(void)
 {
-	struct oscore_interaction_t interactions[OSCORE_INTERACTIONS_COUNT];
-	oscore_interactions_init(interactions);
+	struct oscore_interactions interactions;
+	oscore_interactions_init(&interactions);
 
 	/* Test null pointers. Null token is a valid value. */
 	remove_record_and_expect(NULL, TOKEN_DEFAULT, sizeof(TOKEN_DEFAULT), wrong_parameter);
 
 	/* Test too big token size. */
-	remove_record_and_expect(interactions, TOKEN_DEFAULT, MAX_TOKEN_LEN + 1, wrong_parameter);
+	remove_record_and_expect(&interactions, TOKEN_DEFAULT, MAX_TOKEN_LEN + 1, wrong_parameter);
 
 	/* Removing a not-stored record should fail. */
-	remove_record_and_expect(interactions, TOKEN_DEFAULT, sizeof(TOKEN_DEFAULT), oscore_interaction_not_found);
-	remove_record_and_expect(interactions, NULL, 0, oscore_interaction_not_found);
-	remove_record_and_expect(interactions, NULL, 1, oscore_interaction_not_found);
+	remove_record_and_expect(&interactions, TOKEN_DEFAULT, sizeof(TOKEN_DEFAULT), oscore_interaction_not_found);
+	remove_record_and_expect(&interactions, NULL, 0, oscore_interaction_not_found);
+	remove_record_and_expect(&interactions, NULL, 1, oscore_interaction_not_found);
 
 	/* Adding, then removing a record should pass. */
 	struct oscore_interaction_t * received_record;
-	set_record_and_expect(interactions, &default_record, ok);
-	get_record_and_expect(interactions, TOKEN_DEFAULT, sizeof(TOKEN_DEFAULT), &received_record, ok);
-	remove_record_and_expect(interactions, TOKEN_DEFAULT, sizeof(TOKEN_DEFAULT), ok);
-	get_record_and_expect(interactions, TOKEN_DEFAULT, sizeof(TOKEN_DEFAULT), &received_record, oscore_interaction_not_found);
+	set_record_and_expect(&interactions, &default_record, ok);
+	get_record_and_expect(&interactions, TOKEN_DEFAULT, sizeof(TOKEN_DEFAULT), &received_record, ok);
+	remove_record_and_expect(&interactions, TOKEN_DEFAULT, sizeof(TOKEN_DEFAULT), ok);
+	get_record_and_expect(&interactions, TOKEN_DEFAULT, sizeof(TOKEN_DEFAULT), &received_record, oscore_interaction_not_found);
+	zassert_equal(occupied_count(&interactions), 0, "");
 	
-	/* Reset the array and fill all entries with generated records.
+	/* Reset the table and fill all entries with generated records.
 	   Check if all generated records are properly stored.
 	   Remove the first two records, check if they're gone.
 	   Add the same two records, check if they're accessible.
 	   Add another record, it should fail due to lack of free slots.
 	   Check again if all generated records are properly stored. */
 	struct oscore_interaction_t generated_records[OSCORE_INTERACTIONS_COUNT];
-	generate_and_fill(interactions, generated_records);
+	oscore_interactions_init(&interactions);
+	generate_and_fill(&interactions, generated_records, OSCORE_INTERACTIONS_COUNT);
 	for (size_t entry = 0; entry < OSCORE_INTERACTIONS_COUNT; entry++)
 	{
-		get_record_and_compare(interactions, &generated_records[entry]);
+		get_record_and_compare(&interactions, &generated_records[entry]);
 	}
-	remove_record_and_expect(interactions, generated_records[0].token, generated_records[0].token_len, ok);
-	remove_record_and_expect(interactions, generated_records[1].token, generated_records[1].token_len, ok);
-	get_record_and_expect(interactions, generated_records[0].token, generated_records[0].token_len, &received_record, oscore_interaction_not_found);
-	get_record_and_expect(interactions, generated_records[1].token, generated_records[1].token_len, &received_record, oscore_interaction_not_found);
-	set_record_and_expect(interactions, &generated_records[0], ok);
-	set_record_and_expect(interactions, &generated_records[1], ok);
-	set_record_and_expect(interactions, &default_record, oscore_max_interactions);
+	remove_record_and_expect(&interactions, generated_records[0].token, generated_records[0].token_len, ok);
+	remove_record_and_expect(&interactions, generated_records[1].token, generated_records[1].token_len, ok);
+	get_record_and_expect(&interactions, generated_records[0].token, generated_records[0].token_len, &received_record, oscore_interaction_not_found);
+	get_record_and_expect(&interactions, generated_records[1].token, generated_records[1].token_len, &received_record, oscore_interaction_not_found);
+	set_record_and_expect(&interactions, &generated_records[0], ok);
+	set_record_and_expect(&interactions, &generated_records[1], ok);
+	set_record_and_expect(&interactions, &default_record, oscore_max_interactions);
 	for (size_t entry = 0; entry < OSCORE_INTERACTIONS_COUNT; entry++)
 	{
-		get_record_and_compare(interactions, &generated_records[entry]);
+		get_record_and_compare(&interactions, &generated_records[entry]);
 	}
 }
 
@@ -287,29 +362,167 @@ void t703_interactions_remove_record_test(void)
  */
 void t704_interactions_usecases_test(void)
 {
-	struct oscore_interaction_t interactions[OSCORE_INTERACTIONS_COUNT];
-	oscore_interactions_init(interactions);
-	set_record_and_expect(interactions, &default_record, ok);
+	struct oscore_interactions interactions;
+	oscore_interactions_init(&interactions);
+	struct oscore_interaction_t stored_record = default_record;
+	set_record_and_expect(&interactions, &stored_record, ok);
 
 	// Get the record, then set it again using the same pointer (without change).
 	struct oscore_interaction_t new_record_1 = default_record;
 	struct oscore_interaction_t * record_1;
-	get_record_and_expect(interactions, new_record_1.token, new_record_1.token_len, &record_1, ok);
-	zassert_mem_equal(record_1, &default_record, sizeof(struct oscore_interaction_t), "");
-	set_record_and_expect(interactions, record_1, ok); 
-		/* set_record call is redundant since record_1 already points to specific entry in interactions array.
+	get_record_and_expect(&interactions, new_record_1.token, new_record_1.token_len, &record_1, ok);
+	compare_records(record_1, &stored_record);
+	set_record_and_expect(&interactions, record_1, ok); 
+		/* set_record call is redundant since record_1 already points to specific entry in interactions table.
 		Only called for test purposes. */
 
 	// Get the record, then set it again using the same pointer (with change).
 	struct oscore_interaction_t new_record_2 = default_record;
 	struct oscore_interaction_t * record_2;
-	get_record_and_expect(interactions, new_record_1.token, new_record_1.token_len, &record_1, ok);
-	zassert_mem_equal(record_1, &default_record, sizeof(struct oscore_interaction_t), "");
+	get_record_and_expect(&interactions, new_record_1.token, new_record_1.token_len, &record_1, ok);
+	compare_records(record_1, &stored_record);
 	record_1->request_piv[0] += 1;
 	new_record_2.request_piv[0] += 1;
-	set_record_and_expect(interactions, record_1, ok);
-		/* set_record call is redundant since record_1 already points to specific entry in interactions array.
+	set_record_and_expect(&interactions, record_1, ok);
+		/* set_record call is redundant since record_1 already points to specific entry in interactions table.
 		Only called for test purposes. */
-	get_record_and_expect(interactions, new_record_2.token, new_record_2.token_len, &record_2, ok);
-	zassert_mem_equal(record_2, &new_record_2, sizeof(struct oscore_interaction_t), "");
+	get_record_and_expect(&interactions, new_record_2.token, new_record_2.token_len, &record_2, ok);
+	compare_records(record_2, &new_record_2);
+}
+
+#define POOL_COUNT 500
+
+/**
+ * @brief Test a table with a pool provided by the user: many records, removal from the middle of hash chains.
+ */
+void t705_interactions_pool_test(void)
+{
+	static struct oscore_interaction_t pool[POOL_COUNT];
+	static struct oscore_interaction_t generated_records[POOL_COUNT];
+	struct oscore_interactions interactions;
+	struct oscore_interaction_t * received_record;
+
+	enum err result = oscore_interactions_init_size(&interactions, POOL_COUNT, pool);
+	zassert_equal(ok, result, "");
+
+	/* the uri paths of the generated records repeat, the request types make them unique */
+	for (size_t entry = 0; entry < POOL_COUNT; entry++)
+	{
+		struct oscore_interaction_t * record = &generated_records[entry];
+		*record = default_record;
+		uint32_t resource = (uint32_t)(entry / 3);
+		record->uri_paths_hash = oscore_interactions_uri_paths_hash((uint8_t *)&resource, sizeof(resource));
+		record->request_type = (uint8_t)(entry % 3);
+		record->token[0] = (uint8_t)entry;
+		record->token[1] = (uint8_t)(entry >> 8);
+		set_record_and_expect(&interactions, record, ok);
+	}
+	set_record_and_expect(&interactions, &default_record, oscore_max_interactions);
+	zassert_equal(occupied_count(&interactions), POOL_COUNT, "");
+
+	/* remove every second record, all others stay reachable */
+	for (size_t entry = 0; entry < POOL_COUNT; entry += 2)
+	{
+		remove_record_and_expect(&interactions, generated_records[entry].token, generated_records[entry].token_len, ok);
+	}
+	for (size_t entry = 0; entry < POOL_COUNT; entry++)
+	{
+		if (entry % 2)
+		{
+			get_record_and_compare(&interactions, &generated_records[entry]);
+		}
+		else
+		{
+			get_record_and_expect(&interactions, generated_records[entry].token, generated_records[entry].token_len, &received_record, oscore_interaction_not_found);
+		}
+	}
+
+	/* the freed records are used again */
+	for (size_t entry = 0; entry < POOL_COUNT; entry += 2)
+	{
+		set_record_and_expect(&interactions, &generated_records[entry], ok);
+	}
+	for (size_t entry = 0; entry < POOL_COUNT; entry++)
+	{
+		get_record_and_compare(&interactions, &generated_records[entry]);
+	}
+	zassert_equal(occupied_count(&interactions), POOL_COUNT, "");
+}
+
+#define IDLE_TIMEOUT 10
+
+static uint32_t test_time;
+
+static uint32_t test_clock(void)
+{
+	return test_time;
+}
+
+/**
+ * @brief Test the expiry of idle records, the eviction of the least recently used record and sweeping.
+ */
+void t706_interactions_expiry_test(void)
+{
+	struct oscore_interactions interactions;
+	struct oscore_interaction_t generated_records[OSCORE_INTERACTIONS_COUNT + 1];
+	struct oscore_interaction_t * received_record;
+	uint32_t removed;
+
+	enum err result = oscore_interactions_init(&interactions);
+	zassert_equal(ok, result, "");
+	result = oscore_interactions_expiry_set(NULL, test_clock, IDLE_TIMEOUT);
+	zassert_equal(wrong_parameter, result, "");
+
+	/* the clock may wrap around */
+	test_time = 0xFFFFFFF0;
+	result = oscore_interactions_expiry_set(&interactions, test_clock, IDLE_TIMEOUT);
+	zassert_equal(ok, result, "");
+
+	/* record i is set at time i, so record 0 is the least recently used one */
+	generate_and_fill(&interactions, generated_records, OSCORE_INTERACTIONS_COUNT);
+	for (uint32_t entry = 0; entry < OSCORE_INTERACTIONS_COUNT; entry++)
+	{
+		test_time++;
+		set_record_and_expect(&interactions, &generated_records[entry], ok);
+	}
+
+	/* getting record 0 makes record 1 the least recently used one, it is evicted by a new record */
+	get_record_and_compare(&interactions, &generated_records[0]);
+	test_time++;
+	generated_records[OSCORE_INTERACTIONS_COUNT] = record_for(URI_PATHS_2, sizeof(URI_PATHS_2));
+	memcpy(generated_records[OSCORE_INTERACTIONS_COUNT].token, TOKEN_2, sizeof(TOKEN_2));
+	generated_records[OSCORE_INTERACTIONS_COUNT].token_len = sizeof(TOKEN_2);
+	set_record_and_expect(&interactions, &generated_records[OSCORE_INTERACTIONS_COUNT], ok);
+	zassert_equal(occupied_count(&interactions), OSCORE_INTERACTIONS_COUNT, "");
+	get_record_and_expect(&interactions, generated_records[1].token, generated_records[1].token_len, &received_record, oscore_interaction_not_found);
+	get_record_and_compare(&interactions, &generated_records[OSCORE_INTERACTIONS_COUNT]);
+
+	/* nothing is expired yet */
+	result = oscore_interactions_sweep(&interactions, &removed);
+	zassert_equal(ok, result, "");
+	zassert_equal(0, removed, "");
+
+	/* the records not used since the new record was added expire */
+	test_time += IDLE_TIMEOUT;
+	get_record_and_compare(&interactions, &generated_records[OSCORE_INTERACTIONS_COUNT]);
+	test_time++;
+	result = oscore_interactions_sweep(&interactions, &removed);
+	zassert_equal(ok, result, "");
+	zassert_equal(OSCORE_INTERACTIONS_COUNT - 1, removed, "");
+	zassert_equal(occupied_count(&interactions), 1, "");
+	get_record_and_compare(&interactions, &generated_records[OSCORE_INTERACTIONS_COUNT]);
+
+	/* an expired record is not found */
+	test_time += IDLE_TIMEOUT + 1;
+	get_record_and_expect(&interactions, generated_records[OSCORE_INTERACTIONS_COUNT].token, generated_records[OSCORE_INTERACTIONS_COUNT].token_len, &received_record, oscore_interaction_not_found);
+	zassert_equal(occupied_count(&interactions), 0, "");
+
+	/* without clock, a full table rejects new records */
+	result = oscore_interactions_expiry_set(&interactions, NULL, 0);
+	zassert_equal(ok, result, "");
+	generate_and_fill(&interactions, generated_records, OSCORE_INTERACTIONS_COUNT);
+	set_record_and_expect(&interactions, &generated_records[OSCORE_INTERACTIONS_COUNT], oscore_max_interactions);
+	result = oscore_interactions_sweep(&interactions, NULL);
+	zassert_equal(ok, result, "");
+	zassert_equal(occupied_count(&interactions), OSCORE_INTERACTIONS_COUNT, "");
 }
@@ -16,23 +16,48 @@
 
 #define WINDOW_SIZE OSCORE_SERVER_REPLAY_WINDOW_SIZE
 #define DUMMY_BYTE 10
-#define WINDOW_SIZE_BYTES (WINDOW_SIZE * sizeof(uint64_t))
+#define COUNT(a) (sizeof(a) / sizeof((a)[0]))
 
 static struct server_replay_window_t replay_window;
 
-static void _copy_window(struct server_replay_window_t *dest,
-			 const struct server_replay_window_t *src)
+static bool _contains(const uint64_t *array, uint16_t count, uint64_t value)
 {
-	memcpy(dest, src, sizeof(struct server_replay_window_t));
+	for (uint16_t i = 0; i < count; i++) {
+		if (array[i] == value) {
+			return true;
+		}
+	}
+	return false;
 }
 
+/**
+ * @brief Check that exactly the given sequence numbers are marked as received inside the window
+ *        and that everything behind the window is rejected.
+ */
 static void _compare_windows(struct server_replay_window_t *current,
-			     const struct server_replay_window_t *expected)
+			     const uint64_t *received, uint16_t received_cnt)
 {
-	zassert_mem_equal(current->window, expected->window, WINDOW_SIZE_BYTES,
-			  "");
-	zassert_equal(current->seq_num_zero_received,
-		      expected->seq_num_zero_received, "");
+	uint64_t highest = 0;
+	for (uint16_t i = 0; i < received_cnt; i++) {
+		if (received[i] > highest) {
+			highest = received[i];
+		}
+	}
+	zassert_equal(current->highest, highest, "");
+
+	uint64_t lowest = 0;
+	if (highest >= current->size) {
+		lowest = highest - current->size + 1;
+		zassert_false(server_is_sequence_number_valid(lowest - 1,
+							      current),
+			      "");
+	}
+	for (uint64_t seq_num = lowest; seq_num <= highest; seq_num++) {
+		zassert_equal(
+			!_contains(received, received_cnt, seq_num),
+			server_is_sequence_number_valid(seq_num, current),
+			"wrong state of sequence number %d", (int)seq_num);
+	}
 }
 
 static void
@@ -53,16 +78,25 @@ _validate_window_and_check_result(uint64_t seq_num,
 	zassert_equal(expected_result, result, "");
 }
 
+/**
+ * @brief Bring an initialized window to a starting point by receiving given sequence numbers.
+ */
+static void _fill_window(struct server_replay_window_t *replay_window,
+			 const uint64_t *received, uint16_t received_cnt)
+{
+	for (uint16_t i = 0; i < received_cnt; i++) {
+		_update_window_and_check_result(received[i], replay_window,
+						true);
+	}
+}
+
 /**
  * @brief Test replay window initialization.
  */
 void t600_server_replay_init_test(void)
 {
-	static struct server_replay_window_t compare_window = { 0 };
-
 	/* set random data to all fields */
-	memset(replay_window.window, DUMMY_BYTE, WINDOW_SIZE_BYTES);
-	replay_window.seq_num_zero_received = true;
+	memset(&replay_window, DUMMY_BYTE, sizeof(replay_window));
 
 	enum err result;
 	result = server_replay_window_init(NULL);
@@ -70,7 +104,9 @@ void t600_server_replay_init_test(void)
 
 	result = server_replay_window_init(&replay_window);
 	zassert_equal(ok, result, "");
-	_compare_windows(&replay_window, &compare_window);
+	zassert_equal(WINDOW_SIZE, replay_window.size, "");
+	zassert_is_null(replay_window.bitmap_ext, "");
+	_compare_windows(&replay_window, NULL, 0);
 
 	/* extra check of helper function */
 	zassert_equal(false, server_is_sequence_number_valid(0, NULL), "");
@@ -81,30 +117,28 @@ void t600_server_replay_init_test(void)
  */
 void t601_server_replay_reinit_test(void)
 {
-	static const struct server_replay_window_t compare_window_1 = {
-		{ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-		  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 3, 4, 5, 6 },
-		true
-	};
+	static const uint64_t compare_window_1[] = { 0, 1, 2, 3, 4, 5, 6 };
 
-	static const struct server_replay_window_t compare_window_2 = {
-		{ 100, 101, 102, 103, 104, 105, 106, 107, 108, 109, 110,
-		  111, 112, 113, 114, 115, 116, 117, 118, 119, 120, 121,
-		  122, 123, 124, 125, 126, 127, 128, 129, 130, 131 },
-		true
+	static const uint64_t compare_window_2[] = {
+		100, 101, 102, 103, 104, 105, 106, 107, 108, 109, 110,
+		111, 112, 113, 114, 115, 116, 117, 118, 119, 120, 121,
+		122, 123, 124, 125, 126, 127, 128, 129, 130, 131
 	};
 
 	enum err result;
 	result = server_replay_window_reinit(6, NULL);
 	zassert_equal(wrong_parameter, result, "");
 
+	server_replay_window_init(&replay_window);
 	result = server_replay_window_reinit(6, &replay_window);
 	zassert_equal(ok, result, "");
-	_compare_windows(&replay_window, &compare_window_1);
+	_compare_windows(&replay_window, compare_window_1,
+			 COUNT(compare_window_1));
 
 	result = server_replay_window_reinit(131, &replay_window);
 	zassert_equal(ok, result, "");
-	_compare_windows(&replay_window, &compare_window_2);
+	_compare_windows(&replay_window, compare_window_2,
+			 COUNT(compare_window_2));
 }
 
 /**
@@ -121,11 +155,7 @@ void t602_server_replay_check_at_start_test(void)
 	// SN 5 is delayed = OK
 	// SN 0 is delayed and still in the window range = OK
 
-	static const struct server_replay_window_t starting_point = {
-		{ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-		  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 4, 6, 7, 8, 10 },
-		false
-	};
+	static const uint64_t starting_point[] = { 4, 6, 7, 8, 10 };
 
 	static const uint64_t numbers_to_check[] = { 11, 12, 10, 9, 8, 5, 0 };
 	static const bool numbers_results[] = { true,  true, false, true,
@@ -133,7 +163,8 @@ void t602_server_replay_check_at_start_test(void)
 	const uint16_t check_count =
 		sizeof(numbers_to_check) / sizeof(numbers_to_check[0]);
 
-	_copy_window(&replay_window, &starting_point);
+	server_replay_window_init(&replay_window);
+	_fill_window(&replay_window, starting_point, COUNT(starting_point));
 
 	for (uint16_t index = 0; index < check_count; index++) {
 		bool result_valid = numbers_results[index];
@@ -149,13 +180,12 @@ void t602_server_replay_check_at_start_test(void)
 void t603_server_replay_check_in_progress_test(void)
 {
 	// missing Sequence Numbers in starting_point: 126, 127, 133
-	// SN 99 and below are behind the window = NOT OK
+	// SN 102 and below are behind the window = NOT OK
 
-	static const struct server_replay_window_t starting_point = {
-		{ 100, 101, 102, 103, 104, 105, 106, 107, 108, 109, 110,
-		  111, 112, 113, 114, 115, 116, 117, 118, 119, 120, 121,
-		  122, 123, 124, 125, 128, 129, 130, 131, 132, 134 },
-		true
+	static const uint64_t starting_point[] = {
+		100, 101, 102, 103, 104, 105, 106, 107, 108, 109, 110,
+		111, 112, 113, 114, 115, 116, 117, 118, 119, 120, 121,
+		122, 123, 124, 125, 128, 129, 130, 131, 132, 134
 	};
 
 	static const uint64_t numbers_to_check[] = { 135, 134, 133, 132,
@@ -165,7 +195,9 @@ void t603_server_replay_check_in_progress_test(void)
 	const uint16_t check_count =
 		sizeof(numbers_to_check) / sizeof(numbers_to_check[0]);
 
-	_copy_window(&replay_window, &starting_point);
+	server_replay_window_init(&replay_window);
+	server_replay_window_reinit(99, &replay_window);
+	_fill_window(&replay_window, starting_point, COUNT(starting_point));
 
 	for (uint16_t index = 0; index < check_count; index++) {
 		bool result_valid = numbers_results[index];
@@ -180,40 +212,39 @@ void t603_server_replay_check_in_progress_test(void)
  */
 void t604_server_replay_insert_zero_test(void)
 {
-	static const struct server_replay_window_t compare_window_1 = { { 0 }, true };
+	static const uint64_t compare_window_1[] = { 0 };
 
-	static const struct server_replay_window_t compare_window_2 = {
-		{ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-		  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1 },
-		true
-	};
+	static const uint64_t compare_window_2[] = { 0, 1 };
 
 	server_replay_window_init(&replay_window);
 
 	/* First, check if sequence number 0 at the beginning of the session doesn't break anything. */
-	/* After inserting 0, window should still be empty, but zero received flag should be true. */
 	_update_window_and_check_result(0, &replay_window, true);
-	_compare_windows(&replay_window, &compare_window_1);
+	_compare_windows(&replay_window, compare_window_1,
+			 COUNT(compare_window_1));
 
 	/* Inserting 0 for the second time should result in error. */
 	_update_window_and_check_result(0, &replay_window, false);
 
 	/* Inserting valid number should be ok. */
 	_update_window_and_check_result(1, &replay_window, true);
-	_compare_windows(&replay_window, &compare_window_2);
+	_compare_windows(&replay_window, compare_window_2,
+			 COUNT(compare_window_2));
 
 	/* Reset replay window and insert SeqNum=1. Later, inserting delayed SeqNum=0 should still be ok. */
 	server_replay_window_init(&replay_window);
 	_update_window_and_check_result(1, &replay_window, true);
 	_update_window_and_check_result(0, &replay_window, true);
-	_compare_windows(&replay_window, &compare_window_2);
+	_compare_windows(&replay_window, compare_window_2,
+			 COUNT(compare_window_2));
 
 	/* Reset replay window and test immunity to simple replay attack using SeqNum=0. */
 	server_replay_window_init(&replay_window);
 	_update_window_and_check_result(0, &replay_window, true);
 	_update_window_and_check_result(1, &replay_window, true);
 	_update_window_and_check_result(0, &replay_window, false);
-	_compare_windows(&replay_window, &compare_window_2);
+	_compare_windows(&replay_window, compare_window_2,
+			 COUNT(compare_window_2));
 
 	/* Reset replay window and insert multiple values that will roll the window. Later, inserting delayed SeqNum=0 should fail. */
 	server_replay_window_init(&replay_window);
@@ -228,56 +259,42 @@ void t604_server_replay_insert_zero_test(void)
  */
 void t605_server_replay_insert_test(void)
 {
-	static const struct server_replay_window_t starting_point = {
-		{ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-		  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 4, 6, 7, 8, 10 },
-		false
-	};
-	static const struct server_replay_window_t compare_window_1 = {
-		{ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-		  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 4, 6, 7, 8, 10 },
-		false
-	};
-	static const struct server_replay_window_t compare_window_2 = {
-		{ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-		  0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 4, 5, 6, 7, 8, 10 },
-		false
-	};
-	static const struct server_replay_window_t compare_window_3 = {
-		{ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-		  0, 0, 0, 0, 0, 0, 0, 0, 1, 4, 5, 6, 7, 8, 9, 10 },
-		false
-	};
-	static const struct server_replay_window_t compare_window_4 = {
-		{ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,	0,
-		  0, 0, 0, 0, 0, 0, 0, 1, 4, 5, 6, 7, 8, 9, 10, 12 },
-		false
-	};
-	static const struct server_replay_window_t compare_window_5 = {
-		{ 69, 70, 71, 72, 73, 74, 75, 76, 77, 78, 79,
-		  80, 81, 82, 83, 84, 85, 86, 87, 88, 89, 90,
-		  91, 92, 93, 94, 95, 96, 97, 98, 99, 100 },
-		false
+	static const uint64_t starting_point[] = { 4, 6, 7, 8, 10 };
+	static const uint64_t compare_window_1[] = { 1, 4, 6, 7, 8, 10 };
+	static const uint64_t compare_window_2[] = { 1, 4, 5, 6, 7, 8, 10 };
+	static const uint64_t compare_window_3[] = { 1, 4, 5, 6, 7, 8, 9, 10 };
+	static const uint64_t compare_window_4[] = { 1, 4, 5, 6,  7,
+						     8, 9, 10, 12 };
+	static const uint64_t compare_window_5[] = {
+		69, 70, 71, 72, 73, 74, 75, 76, 77, 78, 79,
+		80, 81, 82, 83, 84, 85, 86, 87, 88, 89, 90,
+		91, 92, 93, 94, 95, 96, 97, 98, 99, 100
 	};
 
-	_copy_window(&replay_window, &starting_point);
+	server_replay_window_init(&replay_window);
+	_fill_window(&replay_window, starting_point, COUNT(starting_point));
 
 	_update_window_and_check_result(1, &replay_window, true);
-	_compare_windows(&replay_window, &compare_window_1);
+	_compare_windows(&replay_window, compare_window_1,
+			 COUNT(compare_window_1));
 
 	_update_window_and_check_result(5, &replay_window, true);
-	_compare_windows(&replay_window, &compare_window_2);
+	_compare_windows(&replay_window, compare_window_2,
+			 COUNT(compare_window_2));
 
 	_update_window_and_check_result(9, &replay_window, true);
-	_compare_windows(&replay_window, &compare_window_3);
+	_compare_windows(&replay_window, compare_window_3,
+			 COUNT(compare_window_3));
 
 	_update_window_and_check_result(12, &replay_window, true);
-	_compare_windows(&replay_window, &compare_window_4);
+	_compare_windows(&replay_window, compare_window_4,
+			 COUNT(compare_window_4));
 
 	for (uint64_t seq_num = 13; seq_num <= 100; seq_num++) {
 		_update_window_and_check_result(seq_num, &replay_window, true);
 	}
-	_compare_windows(&replay_window, &compare_window_5);
+	_compare_windows(&replay_window, compare_window_5,
+			 COUNT(compare_window_5));
 }
 
 /**
@@ -285,17 +302,12 @@ void t605_server_replay_insert_test(void)
  */
 void t606_server_replay_standard_scenario_test(void)
 {
-	static const struct server_replay_window_t compare_window_1 = {
-		{ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-		  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 3, 4, 5 },
-		true
-	};
+	static const uint64_t compare_window_1[] = { 0, 1, 2, 3, 4, 5 };
 
-	static const struct server_replay_window_t compare_window_2 = {
-		{ 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29,
-		  30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
-		  41, 42, 43, 44, 45, 46, 47, 48, 49, 50 },
-		true
+	static const uint64_t compare_window_2[] = {
+		19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29,
+		30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
+		41, 42, 43, 44, 45, 46, 47, 48, 49, 50
 	};
 
 	static const uint64_t incoming_numbers[] = { 1, 0, 4, 4, 2, 3, 5, 1, 0 };
@@ -320,7 +332,8 @@ void t606_server_replay_standard_scenario_test(void)
 							true);
 		}
 	}
-	_compare_windows(&replay_window, &compare_window_1);
+	_compare_windows(&replay_window, compare_window_1,
+			 COUNT(compare_window_1));
 
 	//proper reception of multiple messages, to make sure that in real scenario window can do its job
 	for (uint64_t seq_num = 10; seq_num <= 50; seq_num++) {
@@ -328,5 +341,82 @@ void t606_server_replay_standard_scenario_test(void)
 						  true);
 		_update_window_and_check_result(seq_num, &replay_window, true);
 	}
-	_compare_windows(&replay_window, &compare_window_2);
+	_compare_windows(&replay_window, compare_window_2,
+			 COUNT(compare_window_2));
+}
+
+/**
+ * @brief Windows with a size selected at runtime, stored inside the structure or in a user buffer.
+ */
+void t607_server_replay_window_size_test(void)
+{
+	static uint64_t bitmap[REPLAY_WINDOW_WORDS(
+		OSCORE_SERVER_REPLAY_WINDOW_MAX_SIZE)];
+	enum err result;
+
+	/* invalid parameters */
+	result = server_replay_window_init_size(NULL, WINDOW_SIZE, NULL);
+	zassert_equal(wrong_parameter, result, "");
+	result = server_replay_window_init_size(&replay_window, 0, NULL);
+	zassert_equal(wrong_parameter, result, "");
+	result = server_replay_window_init_size(
+		&replay_window, OSCORE_SERVER_REPLAY_WINDOW_MAX_SIZE + 1,
+		bitmap);
+	zassert_equal(wrong_parameter, result, "");
+	/* a large window doesn't fit into the structure */
+	result = server_replay_window_init_size(
+		&replay_window, OSCORE_SERVER_REPLAY_WINDOW_MAX_SIZE, NULL);
+	zassert_equal(wrong_parameter, result, "");
+
+	/* the largest window, delayed numbers far behind the highest one are still accepted */
+	result = server_replay_window_init_size(
+		&replay_window, OSCORE_SERVER_REPLAY_WINDOW_MAX_SIZE, bitmap);
+	zassert_equal(ok, result, "");
+	for (uint64_t seq_num = 1; seq_num <= 2000; seq_num++) {
+		if (seq_num != 1500) {
+			_update_window_and_check_result(seq_num,
+							&replay_window, true);
+		}
+	}
+	_validate_window_and_check_result(2001, &replay_window, true);
+	_validate_window_and_check_result(1999, &replay_window, false);
+	_validate_window_and_check_result(1500, &replay_window, true);
+	_validate_window_and_check_result(
+		2001 - OSCORE_SERVER_REPLAY_WINDOW_MAX_SIZE, &replay_window,
+		false);
+	_validate_window_and_check_result(
+		2000 - OSCORE_SERVER_REPLAY_WINDOW_MAX_SIZE, &replay_window,
+		false);
+
+	/* a jump over the whole window */
+	_update_window_and_check_result(100000, &replay_window, true);
+	_validate_window_and_check_result(1500, &replay_window, false);
+	_validate_window_and_check_result(99999, &replay_window, true);
+	_update_window_and_check_result(99999, &replay_window, true);
+	_update_window_and_check_result(99999, &replay_window, false);
+
+	/* re-initialization keeps size and storage */
+	result = server_replay_window_reinit(5000, &replay_window);
+	zassert_equal(ok, result, "");
+	zassert_equal(OSCORE_SERVER_REPLAY_WINDOW_MAX_SIZE, replay_window.size,
+		      "");
+	zassert_equal_ptr(bitmap, replay_window.bitmap_ext, "");
+	_validate_window_and_check_result(4000, &replay_window, false);
+	_validate_window_and_check_result(5000, &replay_window, false);
+	_validate_window_and_check_result(5001, &replay_window, true);
+
+	/* a size which is not a multiple of 64 */
+	result = server_replay_window_init_size(&replay_window, 100, bitmap);
+	zassert_equal(ok, result, "");
+	for (uint64_t seq_num = 1; seq_num <= 300; seq_num++) {
+		if ((seq_num != 201) && (seq_num != 250)) {
+			_update_window_and_check_result(seq_num,
+							&replay_window, true);
+		}
+	}
+	_validate_window_and_check_result(250, &replay_window, true);
+	_validate_window_and_check_result(201, &replay_window, true);
+	_validate_window_and_check_result(200, &replay_window, false);
+	_update_window_and_check_result(201, &replay_window, true);
+	_validate_window_and_check_result(201, &replay_window, false);
 }
@@ -0,0 +1,120 @@
+/*
+   Copyright (c) 2026 Fraunhofer AISEC. See the COPYRIGHT
+   file at the top-level directory of this distribution.
+
+   Licensed under the Apache License, Version 2.0 <LICENSE-APACHE or
+   http://www.apache.org/licenses/LICENSE-2.0> or the MIT license
+   <LICENSE-MIT or http://opensource.org/licenses/MIT>, at your
+   option. This file may not be copied, modified, or distributed
+   except according to those terms.
+*/
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+
+#include "oscore/oscore_response_cache.h"
+
+#define ENTRIES_CNT 2
+
+static uint32_t now;
+
+static uint32_t test_clock(void)
+{
+	return now;
+}
+
+void t1000_response_cache_test(void)
+{
+	enum err r;
+	struct oscore_response_cache cache;
+	struct oscore_cached_response entries[ENTRIES_CNT];
+	uint8_t piv_buf[] = { 0x01, 0x02 };
+	struct byte_array piv = BYTE_ARRAY_INIT(piv_buf, sizeof(piv_buf));
+	uint8_t response_buf[OSCORE_RESPONSE_CACHE_MAX_LEN + 1] = { 0x64, 0x44 };
+	struct byte_array response = BYTE_ARRAY_INIT(response_buf, 2);
+	uint8_t digest_buf[OSCORE_RESPONSE_CACHE_DIGEST_LEN] = { 0xd1 };
+	struct byte_array digest =
+		BYTE_ARRAY_INIT(digest_buf, sizeof(digest_buf));
+	const struct oscore_cached_response *entry;
+
+	/*wrong parameters*/
+	r = oscore_response_cache_init(&cache, entries, 0, test_clock, 10);
+	zassert_equal(r, wrong_parameter, "r: %d", r);
+	r = oscore_response_cache_init(&cache, entries, ENTRIES_CNT, NULL, 10);
+	zassert_equal(r, wrong_parameter, "r: %d", r);
+	r = oscore_response_cache_init(&cache, entries, ENTRIES_CNT, test_clock,
+				       0);
+	zassert_equal(r, wrong_parameter, "r: %d", r);
+
+	/*without entries nothing is cached*/
+	r = oscore_response_cache_init(&cache, NULL, 0, NULL, 0);
+	zassert_equal(r, ok, "Error in oscore_response_cache_init. r: %d", r);
+	r = oscore_response_cache_put(&cache, &piv, 1, &digest, &response);
+	zassert_equal(r, ok, "Error in oscore_response_cache_put. r: %d", r);
+	zassert_is_null(oscore_response_cache_get(&cache, &piv, 1, &digest),
+			"response cached");
+
+	now = 0;
+	r = oscore_response_cache_init(&cache, entries, ENTRIES_CNT, test_clock,
+				       10);
+	zassert_equal(r, ok, "Error in oscore_response_cache_init. r: %d", r);
+
+	/*the key is the PIV and the Message ID*/
+	r = oscore_response_cache_put(&cache, &piv, 1, &digest, &response);
+	zassert_equal(r, ok, "Error in oscore_response_cache_put. r: %d", r);
+	entry = oscore_response_cache_get(&cache, &piv, 1, &digest);
+	zassert_not_null(entry, "response not cached");
+	zassert_equal(entry->len, response.len, "wrong length");
+	zassert_mem_equal__(entry->buf, response_buf, response.len,
+			    "wrong response");
+	zassert_is_null(oscore_response_cache_get(&cache, &piv, 2, &digest),
+			"wrong Message ID matched");
+	piv.len = 1;
+	zassert_is_null(oscore_response_cache_get(&cache, &piv, 1, &digest),
+			"wrong PIV matched");
+	piv.len = 2;
+
+	/*only the same request gets the response, another one with the same 
+	key is no retransmission, and the response is kept*/
+	digest_buf[0] ^= 0x01;
+	zassert_is_null(oscore_response_cache_get(&cache, &piv, 1, &digest),
+			"wrong digest matched");
+	digest_buf[0] ^= 0x01;
+	zassert_not_null(oscore_response_cache_get(&cache, &piv, 1, &digest),
+			 "response dropped");
+	digest.len = 1;
+	r = oscore_response_cache_put(&cache, &piv, 1, &digest, &response);
+	zassert_equal(r, wrong_parameter, "r: %d", r);
+	digest.len = sizeof(digest_buf);
+	piv.len = 1;
+
+	/*the oldest response is replaced*/
+	now = 1;
+	r = oscore_response_cache_put(&cache, &piv, 1, &digest, &response);
+	zassert_equal(r, ok, "Error in oscore_response_cache_put. r: %d", r);
+	now = 2;
+	piv.len = 2;
+	r = oscore_response_cache_put(&cache, &piv, 2, &digest, &response);
+	zassert_equal(r, ok, "Error in oscore_response_cache_put. r: %d", r);
+	zassert_is_null(oscore_response_cache_get(&cache, &piv, 1, &digest),
+			"oldest response not replaced");
+	zassert_not_null(oscore_response_cache_get(&cache, &piv, 2, &digest),
+			 "response not cached");
+
+	/*too long responses are not cached*/
+	response.len = sizeof(response_buf);
+	r = oscore_response_cache_put(&cache, &piv, 3, &digest, &response);
+	zassert_equal(r, ok, "Error in oscore_response_cache_put. r: %d", r);
+	zassert_is_null(oscore_response_cache_get(&cache, &piv, 3, &digest),
+			"too long response cached");
+
+	/*responses expire after the lifetime*/
+	now = 11;
+	zassert_not_null(oscore_response_cache_get(&cache, &piv, 2, &digest),
+			 "response expired early");
+	now = 12;
+	zassert_is_null(oscore_response_cache_get(&cache, &piv, 2, &digest),
+			"response not expired");
+}
@@ -143,7 +143,7 @@ void t503_derive_corner_case(void)
 	cc.id_context.ptr = id_context;
 	cc.id_context.len = sizeof(id_context);
 
-	r = derive(&cc, &id, KEY, &out);
+	r = derive(&cc, NULL, &id, KEY, &out);
 	zassert_equal(r, oscore_unknown_hkdf, "Error in derive. r: %d", r);
 }
 
@@ -168,3 +168,59 @@ void t504_context_freshness(void)
 	result = check_context_freshness(&security_context);
 	zassert_equal(result, oscore_ssn_overflow, "");
 }
+
+/**
+ * @brief Test releasing the AEAD key handles bound by oscore_context_init.
+ * 
+ */
+void t505_oscore_context_deinit(void)
+{
+	enum err r;
+	struct context c;
+	uint8_t master_secret[] = { 0x01, 0x02, 0x03, 0x04, 0x05, 0x06,
+				    0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c,
+				    0x0d, 0x0e, 0x0f, 0x10 };
+	uint8_t sender_id[] = { 0x01 };
+	uint8_t recipient_id[] = { 0x02 };
+	struct oscore_init_params params = {
+		.master_secret.ptr = master_secret,
+		.master_secret.len = sizeof(master_secret),
+		.sender_id.ptr = sender_id,
+		.sender_id.len = sizeof(sender_id),
+		.recipient_id.ptr = recipient_id,
+		.recipient_id.len = sizeof(recipient_id),
+		.master_salt.ptr = NULL,
+		.master_salt.len = 0,
+		.id_context.ptr = NULL,
+		.id_context.len = 0,
+		.aead_alg = OSCORE_AES_CCM_16_64_128,
+		.hkdf = OSCORE_SHA_256,
+		.fresh_master_secret_salt = true,
+	};
+
+	r = oscore_context_deinit(NULL);
+	zassert_equal(r, wrong_parameter, "Error in oscore_context_deinit. r: %d", r);
+
+	r = oscore_context_init(&params, &c);
+	zassert_equal(r, ok, "Error in oscore_context_init. r: %d", r);
+	zassert_equal_ptr(c.sc.sender_key_handle.key.ptr, c.sc.sender_key.ptr,
+			  "sender key not bound");
+	zassert_equal_ptr(c.rc.recipient_key_handle.key.ptr,
+			  c.rc.recipient_key.ptr, "recipient key not bound");
+
+	r = oscore_context_deinit(&c);
+	zassert_equal(r, ok, "Error in oscore_context_deinit. r: %d", r);
+	zassert_equal(c.sc.sender_key_handle.handle, 0, "sender key not released");
+	zassert_equal(c.rc.recipient_key_handle.handle, 0,
+		      "recipient key not released");
+
+	/*releasing twice has no effect*/
+	r = oscore_context_deinit(&c);
+	zassert_equal(r, ok, "Error in oscore_context_deinit. r: %d", r);
+
+	/*the context can be initialized again after releasing it*/
+	r = oscore_context_init(&params, &c);
+	zassert_equal(r, ok, "Error in oscore_context_init. r: %d", r);
+	r = oscore_context_deinit(&c);
+	zassert_equal(r, ok, "Error in oscore_context_deinit. r: %d", r);
+}